@@ -125,7 +125,13 @@ def _sizeof_fmt(num, suffix="B"):
     return "%.1f%s%s" % (num, "Yi", suffix)  # pragma: no cover
 
 
-def debug_mode(log_filename="log.txt", log_level="INFO", native_debug=True, simd=True):
+def debug_mode(
+    log_filename="log.txt",
+    log_level="INFO",
+    native_debug=True,
+    simd=True,
+    simd_objectives=False,
+):
     """Sets package into debug mode.
 
     Args:
@@ -133,6 +139,7 @@ def debug_mode(log_filename="log.txt", log_level="INFO", native_debug=True, simd
         log_level: Logging level. For example, "DEBUG".
         native_debug: Load debug versions of native libraries if True.
         simd: Turns on or off the use of SIMD on systems that support it.
+        simd_objectives: Also compute the objectives in SIMD, which uses float32 and changes the models slightly.
 
     Returns:
         Logging handler.
@@ -157,7 +164,9 @@ def debug_mode(log_filename="log.txt", log_level="INFO", native_debug=True, simd
     root.info(debug_str)
 
     # Load native libraries in debug mode if needed
-    native = Native.get_native_singleton(is_debug=native_debug, simd=simd)
+    native = Native.get_native_singleton(
+        is_debug=native_debug, simd=simd, simd_objectives=simd_objectives
+    )
     native.set_logging(log_level)
 
     return handler
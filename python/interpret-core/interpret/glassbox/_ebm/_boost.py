@@ -47,6 +47,37 @@ def boost(
             objective,
             experimental_params,
         ) as booster:
+            if not noise_scale:
+                # without differential privacy noise nothing needs to happen in python
+                # between the boosting steps, so run the whole schedule natively
+                _log.info("Start boosting")
+                n_rounds, min_metric = booster.boost_rounds(
+                    rng,
+                    term_boost_flags,
+                    learning_rate,
+                    min_samples_leaf,
+                    max_leaves,
+                    greediness,
+                    smoothing_rounds,
+                    max_rounds,
+                    early_stopping_rounds,
+                    early_stopping_tolerance,
+                )
+                # keep returning the index of the last round like the python loop below
+                episode_index = max(0, n_rounds - 1)
+                _log.info(
+                    "End boosting, Best Metric: {0}, Num Rounds: {1}".format(
+                        min_metric, episode_index
+                    )
+                )
+
+                if early_stopping_rounds > 0:
+                    model_update = booster.get_best_model()
+                else:
+                    model_update = booster.get_current_model()
+
+                return None, model_update, episode_index, rng
+
             # the first round is alwasy cyclic since we need to get the initial gains
             greedy_portion = 0.0
 
@@ -124,6 +155,10 @@ def boost(
                         noisy_update_tensor = -noisy_update_tensor
                         booster.set_term_update(term_idx, noisy_update_tensor)
 
+                    if greedy_portion < 1.0 and term_idx + 1 < len(term_features):
+                        # in cyclic rounds the next term is known, so bin it with the new gradients
+                        booster.prefetch_term(term_idx + 1)
+
                     cur_metric = booster.apply_term_update()
 
                     min_metric = min(cur_metric, min_metric)
@@ -69,6 +69,7 @@ from warnings import warn
 from sklearn.base import is_classifier  # type: ignore
 from sklearn.utils.validation import check_is_fitted  # type: ignore
 from sklearn.isotonic import IsotonicRegression
+from joblib import effective_n_jobs
 
 import heapq
 import operator
@@ -808,6 +809,11 @@ class EBMModel(BaseEstimator):
 
         provider = JobLibProvider(n_jobs=self.n_jobs)
 
+        # Shared memory only pays off when more than one worker process maps the dataset.
+        # Otherwise the single worker receives one pickled copy, which costs the same and
+        # does not consume shared memory.
+        is_shared = 2 <= min(effective_n_jobs(self.n_jobs), self.outer_bags)
+
         dataset = bin_native_by_dimension(
             n_classes,
             1,
@@ -817,55 +823,71 @@ class EBMModel(BaseEstimator):
             sample_weight,
             feature_names_in,
             feature_types_in,
+            is_shared,
         )
 
-        parallel_args = []
-        for idx in range(self.outer_bags):
-            early_stopping_rounds_local = early_stopping_rounds
-            bag = internal_bags[idx]
-            if bag is None or (0 <= bag).all():
-                # if there are no validation samples, turn off early stopping
-                # because the validation metric cannot improve each round
-                early_stopping_rounds_local = 0
-
-            init_score_local = init_score
-            if (
-                init_score_local is not None
-                and bag is not None
-                and np.count_nonzero(bag) != len(bag)
-            ):
-                # TODO: instead of making these copies we should
-                # put init_score into the native shared dataframe
-                init_score_local = init_score_local[bag != 0]
-
-            parallel_args.append(
-                (
-                    dataset,
-                    bag,
-                    init_score_local,
-                    term_features,
-                    inner_bags,
-                    term_boost_flags,
-                    self.learning_rate,
-                    min_samples_leaf,
-                    self.max_leaves,
-                    greediness,
-                    smoothing_rounds,
-                    self.max_rounds,
-                    early_stopping_rounds_local,
-                    early_stopping_tolerance,
-                    noise_scale_boosting,
-                    bin_data_weights,
-                    rngs[idx],
-                    Native.CreateBoosterFlags_DifferentialPrivacy
-                    if is_differential_privacy
-                    else Native.CreateBoosterFlags_Default,
-                    objective,
-                    None,
+        create_booster_flags = (
+            Native.CreateBoosterFlags_DifferentialPrivacy
+            if is_differential_privacy
+            else Native.CreateBoosterFlags_Default
+        )
+        # The bags already run in parallel, so each bag gets a share of the remaining cores.  We always set the
+        # flag since it changes how the sums are grouped, but the models are identical for any thread count, so
+        # the same random_state gives the same model on machines with different numbers of cores.
+        n_threads = max(1, effective_n_jobs(self.n_jobs) // self.outer_bags)
+        create_booster_flags |= Native.CreateBoosterFlags_Multithreaded
+        booster_params = np.array([n_threads], np.float64)
+
+        try:
+            parallel_args = []
+            for idx in range(self.outer_bags):
+                early_stopping_rounds_local = early_stopping_rounds
+                bag = internal_bags[idx]
+                if bag is None or (0 <= bag).all():
+                    # if there are no validation samples, turn off early stopping
+                    # because the validation metric cannot improve each round
+                    early_stopping_rounds_local = 0
+
+                init_score_local = init_score
+                if (
+                    init_score_local is not None
+                    and bag is not None
+                    and np.count_nonzero(bag) != len(bag)
+                ):
+                    # TODO: instead of making these copies we should
+                    # put init_score into the native shared dataframe
+                    init_score_local = init_score_local[bag != 0]
+
+                parallel_args.append(
+                    (
+                        dataset,
+                        bag,
+                        init_score_local,
+                        term_features,
+                        inner_bags,
+                        term_boost_flags,
+                        self.learning_rate,
+                        min_samples_leaf,
+                        self.max_leaves,
+                        greediness,
+                        smoothing_rounds,
+                        self.max_rounds,
+                        early_stopping_rounds_local,
+                        early_stopping_tolerance,
+                        noise_scale_boosting,
+                        bin_data_weights,
+                        rngs[idx],
+                        create_booster_flags,
+                        objective,
+                        booster_params,
+                    )
                 )
-            )
 
-        results = provider.parallel(boost, parallel_args)
+            results = provider.parallel(boost, parallel_args)
+        finally:
+            if is_shared:
+                # free the shared segment even if a bag raised, otherwise it leaks
+                dataset.unlink()
 
         # let python reclaim the dataset memory via reference counting
         del parallel_args  # parallel_args holds references to dataset, so must be deleted
@@ -949,131 +971,151 @@ class EBMModel(BaseEstimator):
                 sample_weight,
                 feature_names_in,
                 feature_types_in,
+                is_shared,
             )
             del y  # we no longer need this, so allow the garbage collector to reclaim it
 
-            if isinstance(interactions, int):
-                _log.info("Estimating with FAST")
+            try:
+                if isinstance(interactions, int):
+                    _log.info("Estimating with FAST")
+
+                    create_interaction_flags = (
+                        Native.CreateInteractionFlags_DifferentialPrivacy
+                        if is_differential_privacy
+                        else Native.CreateInteractionFlags_Default
+                    )
+                    # like the boosters, always set the flag so that the strengths do not depend on
+                    # the number of cores, and give each bag a share of the cores
+                    n_threads = max(1, effective_n_jobs(self.n_jobs) // self.outer_bags)
+                    create_interaction_flags |= (
+                        Native.CreateInteractionFlags_Multithreaded
+                    )
+                    interaction_params = np.array([n_threads], np.float64)
+
+                    parallel_args = []
+                    for idx in range(self.outer_bags):
+                        # TODO: the combinations below should be selected from the non-excluded features
+                        parallel_args.append(
+                            (
+                                dataset,
+                                internal_bags[idx],
+                                scores_bags[idx],
+                                combinations(range(n_features_in), 2),
+                                exclude,
+                                Native.CalcInteractionFlags_Default,
+                                max_cardinality,
+                                min_samples_leaf,
+                                create_interaction_flags,
+                                objective,
+                                interaction_params,
+                            )
+                        )
+
+                    bagged_ranked_interaction = provider.parallel(
+                        rank_interactions, parallel_args
+                    )
+
+                    # this holds references to dataset, internal_bags, and scores_bags which we want python to reclaim later
+                    del parallel_args
+
+                    # Select merged pairs
+                    pair_ranks = {}
+                    for n, interaction_strengths_and_indices in enumerate(
+                        bagged_ranked_interaction
+                    ):
+                        if isinstance(interaction_strengths_and_indices, Exception):
+                            raise interaction_strengths_and_indices
+
+                        interaction_indices = list(
+                            map(
+                                operator.itemgetter(1),
+                                interaction_strengths_and_indices,
+                            )
+                        )
+                        for rank, indices in enumerate(interaction_indices):
+                            old_mean = pair_ranks.get(indices, 0)
+                            pair_ranks[indices] = old_mean + (
+                                (rank - old_mean) / (n + 1)
+                            )
+
+                    final_ranks = []
+                    total_interactions = 0
+                    for indices in pair_ranks:
+                        heapq.heappush(final_ranks, (pair_ranks[indices], indices))
+                        total_interactions += 1
+
+                    n_interactions = min(interactions, total_interactions)
+                    boost_groups = [
+                        heapq.heappop(final_ranks)[1] for _ in range(n_interactions)
+                    ]
+                else:
+                    # Check and remove duplicate interaction terms
+                    uniquifier = set()
+                    boost_groups = []
+                    max_dimensions = 0
+
+                    for feature_idxs in interactions:
+                        # clean these up since we expose them publically inside self.term_features_
+                        feature_idxs = tuple(map(int, feature_idxs))
+
+                        max_dimensions = max(max_dimensions, len(feature_idxs))
+                        sorted_tuple = tuple(sorted(feature_idxs))
+                        if (
+                            sorted_tuple not in uniquifier
+                            and sorted_tuple not in exclude
+                        ):
+                            uniquifier.add(sorted_tuple)
+                            boost_groups.append(feature_idxs)
+
+                    # Warn the users that we have made change to the interactions list
+                    if len(boost_groups) != len(interactions):
+                        warn("Removed interaction terms")
+
+                    if 2 < max_dimensions:
+                        warn(
+                            "Interactions with 3 or more terms are not graphed in "
+                            "global explanations. Local explanations are still "
+                            "available and exact."
+                        )
 
                 parallel_args = []
                 for idx in range(self.outer_bags):
-                    # TODO: the combinations below should be selected from the non-excluded features
+                    early_stopping_rounds_local = early_stopping_rounds
+                    if internal_bags[idx] is None or (0 <= internal_bags[idx]).all():
+                        # if there are no validation samples, turn off early stopping
+                        # because the validation metric cannot improve each round
+                        early_stopping_rounds_local = 0
+
                     parallel_args.append(
                         (
                             dataset,
                             internal_bags[idx],
                             scores_bags[idx],
-                            combinations(range(n_features_in), 2),
-                            exclude,
-                            Native.CalcInteractionFlags_Default,
-                            max_cardinality,
+                            boost_groups,
+                            inner_bags,
+                            term_boost_flags,
+                            self.learning_rate,
                             min_samples_leaf,
-                            Native.CreateInteractionFlags_DifferentialPrivacy
-                            if is_differential_privacy
-                            else Native.CreateInteractionFlags_Default,
+                            self.max_leaves,
+                            greediness,
+                            0,  # no smoothing rounds for interactions
+                            self.max_rounds,
+                            early_stopping_rounds_local,
+                            early_stopping_tolerance,
+                            noise_scale_boosting,
+                            bin_data_weights,
+                            rngs[idx],
+                            create_booster_flags,
                             objective,
-                            None,
-                        )
-                    )
-
-                bagged_ranked_interaction = provider.parallel(
-                    rank_interactions, parallel_args
-                )
-
-                # this holds references to dataset, internal_bags, and scores_bags which we want python to reclaim later
-                del parallel_args
-
-                # Select merged pairs
-                pair_ranks = {}
-                for n, interaction_strengths_and_indices in enumerate(
-                    bagged_ranked_interaction
-                ):
-                    if isinstance(interaction_strengths_and_indices, Exception):
-                        raise interaction_strengths_and_indices
-
-                    interaction_indices = list(
-                        map(
-                            operator.itemgetter(1),
-                            interaction_strengths_and_indices,
+                            booster_params,
                         )
                     )
-                    for rank, indices in enumerate(interaction_indices):
-                        old_mean = pair_ranks.get(indices, 0)
-                        pair_ranks[indices] = old_mean + ((rank - old_mean) / (n + 1))
-
-                final_ranks = []
-                total_interactions = 0
-                for indices in pair_ranks:
-                    heapq.heappush(final_ranks, (pair_ranks[indices], indices))
-                    total_interactions += 1
-
-                n_interactions = min(interactions, total_interactions)
-                boost_groups = [
-                    heapq.heappop(final_ranks)[1] for _ in range(n_interactions)
-                ]
-            else:
-                # Check and remove duplicate interaction terms
-                uniquifier = set()
-                boost_groups = []
-                max_dimensions = 0
-
-                for feature_idxs in interactions:
-                    # clean these up since we expose them publically inside self.term_features_
-                    feature_idxs = tuple(map(int, feature_idxs))
-
-                    max_dimensions = max(max_dimensions, len(feature_idxs))
-                    sorted_tuple = tuple(sorted(feature_idxs))
-                    if sorted_tuple not in uniquifier and sorted_tuple not in exclude:
-                        uniquifier.add(sorted_tuple)
-                        boost_groups.append(feature_idxs)
-
-                # Warn the users that we have made change to the interactions list
-                if len(boost_groups) != len(interactions):
-                    warn("Removed interaction terms")
-
-                if 2 < max_dimensions:
-                    warn(
-                        "Interactions with 3 or more terms are not graphed in "
-                        "global explanations. Local explanations are still "
-                        "available and exact."
-                    )
-
-            parallel_args = []
-            for idx in range(self.outer_bags):
-                early_stopping_rounds_local = early_stopping_rounds
-                if internal_bags[idx] is None or (0 <= internal_bags[idx]).all():
-                    # if there are no validation samples, turn off early stopping
-                    # because the validation metric cannot improve each round
-                    early_stopping_rounds_local = 0
-
-                parallel_args.append(
-                    (
-                        dataset,
-                        internal_bags[idx],
-                        scores_bags[idx],
-                        boost_groups,
-                        inner_bags,
-                        term_boost_flags,
-                        self.learning_rate,
-                        min_samples_leaf,
-                        self.max_leaves,
-                        greediness,
-                        0,  # no smoothing rounds for interactions
-                        self.max_rounds,
-                        early_stopping_rounds_local,
-                        early_stopping_tolerance,
-                        noise_scale_boosting,
-                        bin_data_weights,
-                        rngs[idx],
-                        Native.CreateBoosterFlags_DifferentialPrivacy
-                        if is_differential_privacy
-                        else Native.CreateBoosterFlags_Default,
-                        objective,
-                        None,
-                    )
-                )
 
-            results = provider.parallel(boost, parallel_args)
+                results = provider.parallel(boost, parallel_args)
+            finally:
+                if is_shared:
+                    # free the shared segment even if a bag raised, otherwise it leaks
+                    dataset.unlink()
 
             # allow python to reclaim these big memory items via reference counting
             del parallel_args  # this holds references to dataset, scores_bags, and bags
@@ -5,7 +5,7 @@ import logging
 
 import numpy as np
 
-from ._native import Native
+from ._native import Native, SharedDataset
 from ._clean_x import unify_columns
 
 _log = logging.getLogger(__name__)
@@ -21,9 +21,14 @@ def bin_native(
     sample_weight,
     feature_names_in,
     feature_types_in,
+    shared=False,
 ):
     # called under: fit
 
+    # When shared is True the dataset is built directly into a shared memory segment and a
+    # SharedDataset is returned. Worker processes then map the segment by name instead of
+    # each receiving a pickled copy, and the caller must call unlink() once they are done.
+
     _log.info("Creating native dataset")
 
     n_samples = len(y)
@@ -82,7 +87,12 @@ def bin_native(
     else:
         n_bytes += native.measure_regression_target(y)
 
-    dataset = np.empty(n_bytes, np.ubyte)  # joblib loky doesn't support RawArray
+    if shared:
+        shared_dataset = SharedDataset(n_bytes)
+        dataset = shared_dataset.attach()
+    else:
+        shared_dataset = None
+        dataset = np.empty(n_bytes, np.ubyte)  # joblib loky doesn't support RawArray
 
     native.fill_dataset_header(len(requests), n_weights, 1, dataset)
 
@@ -127,7 +137,7 @@ def bin_native(
     else:
         native.fill_regression_target(y, dataset)
 
-    return dataset
+    return dataset if shared_dataset is None else shared_dataset
 
 
 def bin_native_by_dimension(
@@ -139,6 +149,7 @@ def bin_native_by_dimension(
     sample_weight,
     feature_names_in,
     feature_types_in,
+    shared=False,
 ):
     # called under: fit
 
@@ -158,4 +169,5 @@ def bin_native_by_dimension(
         sample_weight,
         feature_names_in,
         feature_types_in,
+        shared,
     )
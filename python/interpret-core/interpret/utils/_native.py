@@ -19,6 +19,11 @@ class Native:
     CreateBoosterFlags_Default = 0x00000000
     CreateBoosterFlags_DifferentialPrivacy = 0x00000001
     CreateBoosterFlags_DisableApprox = 0x00000002
+    CreateBoosterFlags_Multithreaded = 0x00000008
+    CreateBoosterFlags_PinThreads = 0x00000010
+    CreateBoosterFlags_Bfloat16Gradients = 0x00000020
+    CreateBoosterFlags_Autotune = 0x00000080
+    CreateBoosterFlags_EnableSIMD = 0x00000100
 
     # TermBoostFlags
     TermBoostFlags_Default = 0x00000000
@@ -31,6 +36,8 @@ class Native:
     CreateInteractionFlags_Default = 0x00000000
     CreateInteractionFlags_DifferentialPrivacy = 0x00000001
     CreateInteractionFlags_DisableApprox = 0x00000002
+    CreateInteractionFlags_Multithreaded = 0x00000008
+    CreateInteractionFlags_EnableSIMD = 0x00000010
 
     # CalcInteractionFlags
     CalcInteractionFlags_Default = 0x00000000
@@ -41,7 +48,10 @@ class Native:
     ComputeFlags_Nvidia = 0x00000002
     ComputeFlags_AVX2 = 0x00000004
     ComputeFlags_AVX512F = 0x00000008
-    ComputeFlags_IntelSIMD = ComputeFlags_AVX2 | ComputeFlags_AVX512F
+    ComputeFlags_AVX2_64 = 0x00000010
+    ComputeFlags_IntelSIMD = (
+        ComputeFlags_AVX2 | ComputeFlags_AVX512F | ComputeFlags_AVX2_64
+    )
     ComputeFlags_SIMD = ComputeFlags_IntelSIMD
     ComputeFlags_GPU = ComputeFlags_Nvidia
     ComputeFlags_ALL = 0xFFFFFFFF
@@ -62,11 +72,13 @@ class Native:
         pass
 
     @staticmethod
-    def get_native_singleton(is_debug=False, simd=True):
+    def get_native_singleton(is_debug=False, simd=True, simd_objectives=False):
         if Native._native is None:
             _log.info("EBM lib loading.")
             native = Native()
-            native._initialize(is_debug=is_debug, simd=simd)
+            native._initialize(
+                is_debug=is_debug, simd=simd, simd_objectives=simd_objectives
+            )
             Native._native = native
         return Native._native
 
@@ -685,12 +697,15 @@ class Native:
             _log.error(msg)
             raise Exception(msg)
 
-    def _initialize(self, is_debug, simd):
+    def _initialize(self, is_debug, simd, simd_objectives):
         self.is_debug = is_debug
         self.disable_compute = (
             Native.ComputeFlags_Default if simd else Native.ComputeFlags_ALL
         )
         self.approximates = True
+        # the SIMD objectives use float32 with approximate exp and log, so the models
+        # differ slightly from the default float64 objectives
+        self.simd_objectives = simd_objectives
 
         self._log_callback_func = None
         self._unsafe = ct.cdll.LoadLibrary(Native._get_ebm_lib_path(debug=is_debug))
@@ -1154,6 +1169,54 @@ class Native:
         ]
         self._unsafe.ApplyTermUpdate.restype = ct.c_int32
 
+        self._unsafe.GetValidationMetrics.argtypes = [
+            # void * boosterHandle
+            ct.c_void_p,
+            # int64_t countMetrics
+            ct.c_int64,
+            # double * validationMetricsOut
+            ct.c_void_p,
+        ]
+        self._unsafe.GetValidationMetrics.restype = ct.c_int32
+
+        self._unsafe.PrefetchTerm.argtypes = [
+            # void * boosterHandle
+            ct.c_void_p,
+            # int64_t indexTerm
+            ct.c_int64,
+        ]
+        self._unsafe.PrefetchTerm.restype = ct.c_int32
+
+        self._unsafe.BoostRounds.argtypes = [
+            # void * rng
+            ct.c_void_p,
+            # void * boosterHandle
+            ct.c_void_p,
+            # TermBoostFlags flags
+            ct.c_int32,
+            # double learningRate
+            ct.c_double,
+            # int64_t minSamplesLeaf
+            ct.c_int64,
+            # int64_t leavesMax
+            ct.c_int64,
+            # double greediness
+            ct.c_double,
+            # int64_t smoothingRounds
+            ct.c_int64,
+            # int64_t maxRounds
+            ct.c_int64,
+            # int64_t earlyStoppingRounds
+            ct.c_int64,
+            # double earlyStoppingTolerance
+            ct.c_double,
+            # int64_t * countRoundsOut
+            ct.POINTER(ct.c_int64),
+            # double * bestMetricOut
+            ct.POINTER(ct.c_double),
+        ]
+        self._unsafe.BoostRounds.restype = ct.c_int32
+
         self._unsafe.GetBestTermScores.argtypes = [
             # void * boosterHandle
             ct.c_void_p,
@@ -1218,6 +1281,142 @@ class Native:
         ]
         self._unsafe.CalcInteractionStrength.restype = ct.c_int32
 
+        self._unsafe.CalcInteractionStrengths.argtypes = [
+            # void * interactionHandle
+            ct.c_void_p,
+            # int64_t countTerms
+            ct.c_int64,
+            # int64_t * dimensionCounts
+            ct.c_void_p,
+            # int64_t * featureIndexes
+            ct.c_void_p,
+            # CalcInteractionFlags flags
+            ct.c_int32,
+            # int64_t maxCardinality
+            ct.c_int64,
+            # int64_t minSamplesLeaf
+            ct.c_int64,
+            # double * avgInteractionStrengthsOut
+            ct.c_void_p,
+            # int64_t countTopTerms
+            ct.c_int64,
+            # int64_t * topTermIndexesOut
+            ct.c_void_p,
+        ]
+        self._unsafe.CalcInteractionStrengths.restype = ct.c_int32
+
+
+class SharedDataset:
+    """Native dataset that is filled once and then shared read-only across processes.
+
+    Pickling a SharedDataset only sends the name of the shared memory segment, so each
+    worker process maps the same physical pages instead of receiving its own copy of
+    the dataset. If shared memory is unavailable or too small to hold the dataset we fall
+    back to a regular ndarray, which is then pickled along with the object as before.
+    """
+
+    def __init__(self, n_bytes):
+        self.n_bytes = n_bytes
+        self._is_owner = True
+        self._shm = None
+        self._array = None
+
+        if not SharedDataset._has_room(n_bytes):
+            _log.info("Not enough shared memory for the dataset, using a pickled copy")
+            self._array = np.empty(n_bytes, np.ubyte)
+            return
+
+        try:
+            from multiprocessing import shared_memory
+
+            # SharedMemory does not allow zero sized segments, but datasets always have a header
+            self._shm = shared_memory.SharedMemory(create=True, size=max(n_bytes, 1))
+            self._array = np.frombuffer(self._shm.buf, np.ubyte, n_bytes)
+        except (ImportError, OSError):  # pragma: no cover
+            # python before 3.8, or the OS refused to create the segment
+            self._shm = None
+            self._array = np.empty(n_bytes, np.ubyte)
+
+    @staticmethod
+    def _has_room(n_bytes):
+        # On Linux the segment lives in the /dev/shm tmpfs, which is often small inside
+        # containers (64MB by default in docker).  tmpfs allocates pages on first write, so an
+        # oversized segment is created without error and we would instead get a SIGBUS while
+        # filling it.  Other platforms back the segment differently and fail on creation.
+        if not hasattr(os, "statvfs") or not os.path.isdir("/dev/shm"):
+            return True
+        try:
+            stats = os.statvfs("/dev/shm")
+        except OSError:  # pragma: no cover
+            return True
+        return n_bytes <= stats.f_bavail * stats.f_frsize
+
+    def __getstate__(self):
+        if self._shm is None:  # pragma: no cover
+            return {"n_bytes": self.n_bytes, "array": self._array}
+        return {"n_bytes": self.n_bytes, "name": self._shm.name}
+
+    def __setstate__(self, state):
+        self.n_bytes = state["n_bytes"]
+        self._is_owner = False
+        self._shm = None
+        self._array = state.get("array", None)
+        self._name = state.get("name", None)
+
+    def attach(self):
+        """Returns an ndarray view of the dataset, mapping the shared segment if needed."""
+
+        if self._array is not None:
+            return self._array
+
+        from multiprocessing import shared_memory
+
+        try:
+            # python 3.13+ can skip registering with the resource tracker directly
+            self._shm = shared_memory.SharedMemory(name=self._name, track=False)
+        except TypeError:
+            self._shm = shared_memory.SharedMemory(name=self._name)
+            if os.name == "posix":
+                # the resource tracker would otherwise unlink the segment when this worker
+                # exits, even though the parent process owns it
+                from multiprocessing import resource_tracker
+
+                resource_tracker.unregister(self._shm._name, "shared_memory")
+
+        array = np.frombuffer(self._shm.buf, np.ubyte, self.n_bytes)
+        array.flags.writeable = False
+        self._array = array
+        return array
+
+    def detach(self):
+        """Releases the mapping in a worker. The owner keeps its mapping until unlink."""
+
+        if self._is_owner or self._shm is None:
+            return
+
+        self._array = None
+        try:
+            self._shm.close()
+            self._shm = None
+        except BufferError:  # pragma: no cover
+            # something still holds a view.  The mapping is released when the process exits
+            pass
+
+    def unlink(self):
+        """Frees the shared segment. Only the process that created the dataset calls this."""
+
+        if not self._is_owner or self._shm is None:
+            return
+
+        self._array = None
+        shm = self._shm
+        self._shm = None
+        try:
+            shm.close()
+        except BufferError:  # pragma: no cover
+            pass
+        shm.unlink()
+
 
 class Booster(AbstractContextManager):
     """Lightweight wrapper for EBM C boosting code."""
@@ -1265,6 +1464,10 @@ class Booster(AbstractContextManager):
     def __enter__(self):
         _log.info("Booster allocation start")
 
+        if isinstance(self.dataset, SharedDataset):
+            self._shared_dataset = self.dataset
+            self.dataset = self._shared_dataset.attach()
+
         if self.objective is None or len(self.objective.strip()) == 0:
             msg = "objective must be specified"
             _log.error(msg)
@@ -1333,6 +1536,8 @@ class Booster(AbstractContextManager):
         flags = self.create_booster_flags
         if not native.approximates:
             flags |= Native.CreateBoosterFlags_DisableApprox
+        if native.simd_objectives:
+            flags |= Native.CreateBoosterFlags_EnableSIMD
 
         # Allocate external resources
         booster_handle = ct.c_void_p(0)
@@ -1374,6 +1579,12 @@ class Booster(AbstractContextManager):
             self._booster_handle = None
             native._unsafe.FreeBooster(booster_handle)
 
+        shared_dataset = getattr(self, "_shared_dataset", None)
+        if shared_dataset is not None:
+            self.dataset = shared_dataset
+            self._shared_dataset = None
+            shared_dataset.detach()
+
         _log.info("Deallocation boosting end")
 
     def generate_term_update(
@@ -1452,6 +1663,98 @@ class Booster(AbstractContextManager):
         # _log.debug("Boosting step end")
         return avg_validation_metric.value
 
+    def get_validation_metrics(self, n_metrics):
+        """Returns all the validation metrics from the last apply_term_update
+
+        Args:
+            n_metrics: The number of metrics listed after the objective, or 1 if none were listed
+
+        Returns:
+            An ndarray of the metrics in the order they were listed. The first is the one that
+            apply_term_update returns. Metrics that are better when higher are negated.
+        """
+
+        native = Native.get_native_singleton()
+
+        metrics = np.empty(n_metrics, dtype=np.float64, order="C")
+        return_code = native._unsafe.GetValidationMetrics(
+            self._booster_handle, n_metrics, Native._make_pointer(metrics, np.float64)
+        )
+        if return_code:  # pragma: no cover
+            raise Native._get_native_exception(return_code, "GetValidationMetrics")
+
+        return metrics
+
+    def prefetch_term(self, term_idx):
+        """Hints that the next call to generate_term_update will be for term_idx
+
+        Args:
+            term_idx: The index of the next term, or -1 to cancel the hint
+        """
+
+        native = Native.get_native_singleton()
+
+        return_code = native._unsafe.PrefetchTerm(self._booster_handle, term_idx)
+        if return_code:  # pragma: no cover
+            raise Native._get_native_exception(return_code, "PrefetchTerm")
+
+    def boost_rounds(
+        self,
+        rng,
+        term_boost_flags,
+        learning_rate,
+        min_samples_leaf,
+        max_leaves,
+        greediness,
+        smoothing_rounds,
+        max_rounds,
+        early_stopping_rounds,
+        early_stopping_tolerance,
+    ):
+        """Runs the cyclic/greedy boosting rounds natively.
+
+        Args:
+            rng: native random number generator or None
+            term_boost_flags: C interface options
+            learning_rate: Learning rate as a float.
+            min_samples_leaf: Min observations required to split.
+            max_leaves: Max leaf nodes on feature step.
+            greediness: portion of greedy rounds added per cyclic round
+            smoothing_rounds: number of initial rounds with random splits
+            max_rounds: maximum number of rounds
+            early_stopping_rounds: rounds without improvement before stopping, or 0 to disable
+            early_stopping_tolerance: minimum improvement to reset the early stopping count
+
+        Returns:
+            Tuple of the number of rounds completed and the best validation metric.
+        """
+
+        self._term_idx = -1
+
+        native = Native.get_native_singleton()
+
+        count_rounds = ct.c_int64(0)
+        best_metric = ct.c_double(np.inf)
+        return_code = native._unsafe.BoostRounds(
+            Native._make_pointer(rng, np.ubyte, is_null_allowed=True),
+            self._booster_handle,
+            term_boost_flags,
+            learning_rate,
+            int(min_samples_leaf),
+            int(max_leaves),
+            greediness,
+            int(smoothing_rounds),
+            int(max_rounds),
+            int(early_stopping_rounds),
+            early_stopping_tolerance,
+            ct.byref(count_rounds),
+            ct.byref(best_metric),
+        )
+        if return_code:  # pragma: no cover
+            raise Native._get_native_exception(return_code, "BoostRounds")
+
+        return count_rounds.value, best_metric.value
+
     def get_best_model(self):
         model = []
         for term_idx in range(len(self.term_features)):
@@ -1629,6 +1932,10 @@ class InteractionDetector(AbstractContextManager):
     def __enter__(self):
         _log.info("Allocation interaction start")
 
+        if isinstance(self.dataset, SharedDataset):
+            self._shared_dataset = self.dataset
+            self.dataset = self._shared_dataset.attach()
+
         if self.objective is None or len(self.objective.strip()) == 0:
             msg = "objective must be specified"
             _log.error(msg)
@@ -1679,6 +1986,8 @@ class InteractionDetector(AbstractContextManager):
         flags = self.create_interaction_flags
         if not native.approximates:
             flags |= Native.CreateInteractionFlags_DisableApprox
+        if native.simd_objectives:
+            flags |= Native.CreateInteractionFlags_EnableSIMD
 
         # Allocate external resources
         interaction_handle = ct.c_void_p(0)
@@ -1716,6 +2025,12 @@ class InteractionDetector(AbstractContextManager):
             self._interaction_handle = None
             native._unsafe.FreeInteractionDetector(interaction_handle)
 
+        shared_dataset = getattr(self, "_shared_dataset", None)
+        if shared_dataset is not None:
+            self.dataset = shared_dataset
+            self._shared_dataset = None
+            shared_dataset.detach()
+
         _log.info("Deallocation interaction end")
 
     def calc_interaction_strength(
@@ -1743,3 +2058,49 @@ class InteractionDetector(AbstractContextManager):
 
         _log.info("Fast interaction strength end")
         return strength.value
+
+    def calc_interaction_strengths(
+        self,
+        terms,
+        calc_interaction_flags,
+        max_cardinality,
+        min_samples_leaf,
+        n_top=0,
+    ):
+        """Provides the strengths of a list of feature interactions in one native call.
+
+        Returns the strengths in term order, and if n_top is positive the indexes of the
+        n_top strongest terms ordered from strongest to weakest with ties going to the later term.
+        """
+        _log.info("Fast interaction strengths start")
+
+        native = Native.get_native_singleton()
+
+        dimension_counts = np.fromiter(map(len, terms), np.int64, len(terms))
+        feature_idxs = np.fromiter(
+            (idx for term in terms for idx in term),
+            np.int64,
+            int(dimension_counts.sum()),
+        )
+
+        strengths = np.empty(len(terms), np.float64)
+        n_top = min(max(n_top, 0), len(terms))
+        top_idxs = np.empty(n_top, np.int64) if 0 < n_top else None
+
+        return_code = native._unsafe.CalcInteractionStrengths(
+            self._interaction_handle,
+            len(terms),
+            Native._make_pointer(dimension_counts, np.int64),
+            Native._make_pointer(feature_idxs, np.int64, is_null_allowed=True),
+            calc_interaction_flags,
+            max_cardinality,
+            min_samples_leaf,
+            Native._make_pointer(strengths, np.float64),
+            n_top,
+            Native._make_pointer(top_idxs, np.int64, is_null_allowed=True),
+        )
+        if return_code:  # pragma: no cover
+            raise Native._get_native_exception(return_code, "CalcInteractionStrengths")
+
+        _log.info("Fast interaction strengths end")
+        return strengths, top_idxs
@@ -9,8 +9,6 @@ of the interaction of all pairs of features in a dataset.
 [1] https://www.cs.cornell.edu/~yinlou/papers/lou-kdd13.pdf
 """
 
-import heapq
-
 from ._native import InteractionDetector
 
 
@@ -29,7 +27,11 @@ def rank_interactions(
     n_output_interactions=0,
 ):
     try:
-        interaction_strengths = []
+        terms = [
+            feature_idxs
+            for feature_idxs in iter_term_features
+            if tuple(sorted(feature_idxs)) not in exclude
+        ]
         with InteractionDetector(
             dataset,
             bag,
@@ -38,23 +40,20 @@ def rank_interactions(
             objective,
             experimental_params,
         ) as interaction_detector:
-            for feature_idxs in iter_term_features:
-                if tuple(sorted(feature_idxs)) in exclude:
-                    continue
-                strength = interaction_detector.calc_interaction_strength(
-                    feature_idxs,
-                    calc_interaction_flags,
-                    max_cardinality,
-                    min_samples_leaf,
-                )
-                item = (strength, feature_idxs)
-                if n_output_interactions <= 0:
-                    interaction_strengths.append(item)
-                else:
-                    if len(interaction_strengths) == n_output_interactions:
-                        heapq.heappushpop(interaction_strengths, item)
-                    else:
-                        heapq.heappush(interaction_strengths, item)
+            # all the terms go to the native code in one call so that it can spread them over its threads
+            strengths, top_idxs = interaction_detector.calc_interaction_strengths(
+                terms,
+                calc_interaction_flags,
+                max_cardinality,
+                min_samples_leaf,
+                n_output_interactions,
+            )
+
+        strengths = strengths.tolist()
+        if top_idxs is None:
+            interaction_strengths = list(zip(strengths, terms))
+        else:
+            interaction_strengths = [(strengths[i], terms[i]) for i in top_idxs]
 
         interaction_strengths.sort(reverse=True)
         return interaction_strengths
@@ -1,12 +1,14 @@
 # Copyright (c) 2023 The InterpretML Contributors
 # Distributed under the MIT software license
 
-from interpret.utils._native import Native
+from interpret.utils._native import Native, SharedDataset
 
 import numpy as np
 
 from scipy.stats import normaltest, shapiro
 
+import pickle
+
 
 def test_hist():
     np.random.seed(0)
@@ -91,3 +93,20 @@ def test_gaussian_random_number_generator():
 
         assert 0.9 < np.mean(norm_results) < 0.99
         assert 0.9 < np.mean(shapiro_results) < 0.99
+
+
+def test_shared_dataset_pickle():
+    shared_dataset = SharedDataset(100)
+    try:
+        array = shared_dataset.attach()
+        array[:] = np.arange(100, dtype=np.ubyte)
+
+        # what a worker process would receive
+        worker_dataset = pickle.loads(pickle.dumps(shared_dataset))
+        worker_array = worker_dataset.attach()
+        assert np.array_equal(worker_array, np.arange(100, dtype=np.ubyte))
+        del worker_array
+        worker_dataset.detach()
+    finally:
+        del array
+        shared_dataset.unlink()
@@ -6,15 +6,20 @@
 
 #include <stddef.h> // size_t, ptrdiff_t
 #include <string.h> // memcpy
+#include <atomic>
 
 #include "libebm.h" // ErrorEbm
 #include "logging.h" // EBM_ASSERT
 #include "zones.h"
 
+#include "Bin.hpp"
+
 #include "Feature.hpp"
 #include "Term.hpp"
 #include "Transpose.hpp"
 #include "Tensor.hpp"
+#include "ThreadPool.hpp"
+#include "AucTracker.hpp"
 #include "BoosterCore.hpp"
 #include "BoosterShell.hpp"
 
@@ -23,6 +28,300 @@ namespace DEFINED_ZONE_NAME {
 #error DEFINED_ZONE_NAME must be defined
 #endif // DEFINED_ZONE_NAME
 
+extern void ConvertAddBin(
+   const size_t cScores,
+   const bool bHessian,
+   const size_t cBins,
+   const bool bUInt64Src,
+   const bool bDoubleSrc,
+   const bool bWeightSrc,
+   const void * const aSrc,
+   const bool bUInt64Dest,
+   const bool bDoubleDest,
+   void * const aAddDest
+);
+
+extern size_t GetCountBytesPerFastBin(
+   const DataSubsetBoosting * const pSubset, 
+   const bool bHessian, 
+   const size_t cScores, 
+   const bool bWeight
+);
+
+// when prefetching, we alternate between updating and binning blocks of roughly this many samples so that the
+// gradients written by ApplyUpdate are still in the cache when BinSumsBoosting reads them
+static constexpr size_t k_cSamplesPrefetchBlock = 4096;
+
+struct ApplyUpdateTask {
+   BoosterCore * m_pBoosterCore;
+   size_t m_iTaskValidationFirst; // tasks before this are training subsets and the rest are validation subsets
+   size_t m_iTerm;
+   size_t m_cPackBits;
+   size_t m_cFloatSize;
+   void * m_aUpdateScores;
+   size_t m_cTensorBins;
+   void * m_aMulticlassMidwayTemp;
+   size_t m_cBytesMulticlassMidwayTemp;
+   double * m_aValidationMetrics;
+   const Term * m_pPrefetchTerm; // if not nullptr, bin this term for the first inner bag while updating the gradients
+   size_t m_iPrefetchTerm;
+   BinBase * m_aPrefetchFastBins;
+   size_t m_cBytesPrefetchFastBins; // the distance between the fast bins of each training subset
+   std::atomic<size_t> * m_pcSamplesApplied;
+};
+
+static void AddValidationMetrics(
+   const ApplyUpdateTask * const pTask, 
+   const size_t iSubset, 
+   const ApplyUpdateBridge * const pData
+) {
+   // each kind of sum is stored contiguously over the subsets so that each can be reduced with SumPairwise.  The
+   // sums start at zero and we add to them since the prefetch path calculates the metric of a subset in blocks
+   BoosterCore * const pBoosterCore = pTask->m_pBoosterCore;
+   double * pSum = &pTask->m_aValidationMetrics[iSubset];
+   *pSum += pData->m_metricOut;
+   if(EBM_FALSE != pData->m_bProbabilityMetrics) {
+      const size_t cValidationSubsets = pBoosterCore->GetValidationSet()->GetCountSubsets();
+      pSum += cValidationSubsets;
+      *pSum += pData->m_brierOut;
+      for(size_t iBin = 0; iBin < k_cCalibrationBins; ++iBin) {
+         pSum += cValidationSubsets;
+         *pSum += pData->m_aCalibrationOut[iBin];
+      }
+   }
+}
+
+static size_t GreatestCommonDivisor(size_t a, size_t b) {
+   while(size_t { 0 } != b) {
+      const size_t c = a % b;
+      a = b;
+      b = c;
+   }
+   return a;
+}
+
+static size_t LeastCommonMultiple(const size_t a, const size_t b) {
+   return a / GreatestCommonDivisor(a, b) * b;
+}
+
+static bool IsPackBoundary(const size_t cRows, const size_t iRow, const size_t cItemsPerBitPack, const size_t cPacksAlign) {
+   // The first bit pack of each SIMD lane is partially filled, so the rows after iRow start on a bit pack boundary
+   // if the number of rows remaining is a multiple of the items per bit pack.  We also need the packed data that
+   // starts at iRow to be aligned.
+   return size_t { 0 } == (cRows - iRow) % cItemsPerBitPack &&
+      size_t { 0 } == (iRow + cItemsPerBitPack - size_t { 1 }) / cItemsPerBitPack % cPacksAlign;
+}
+
+static ErrorEbm ApplyUpdatePrefetch(
+   const ApplyUpdateTask * const pTask,
+   const size_t iSubset,
+   DataSubsetBoosting * const pSubset,
+   ApplyUpdateBridge * const pData
+) {
+   // Apply the update to the training subset and bin the prefetch term in blocks of samples.  Each block is first 
+   // updated and then binned while its fresh gradients are still in the cache, so the gradients only stream 
+   // through memory once.  Binning is sequential within each bin, so the fast bins are identical to binning 
+   // the whole subset in one call.
+
+   BoosterCore * const pBoosterCore = pTask->m_pBoosterCore;
+   const ObjectiveWrapper * const pObjective = pSubset->GetObjectiveWrapper();
+   const bool bHessian = pBoosterCore->IsHessian();
+   const size_t cScores = pData->m_cScores;
+   const size_t cSIMDPack = pObjective->m_cSIMDPack;
+   const size_t cFloatBytes = pObjective->m_cFloatBytes;
+   const size_t cUIntBytes = pObjective->m_cUIntBytes;
+   const size_t cTargetBytes = IsClassificationOutput(pObjective->m_linkFunction) ? cUIntBytes : cFloatBytes;
+
+   const Term * const pTerm = pTask->m_pPrefetchTerm;
+   const size_t cBins = pTerm->GetCountTensorBins();
+   EBM_ASSERT(1 <= pTerm->GetBitsRequiredMin());
+
+   const void * const aWeights = pSubset->GetInnerBag(0)->GetWeights();
+   const size_t cBytesPerFastBin = GetCountBytesPerFastBin(pSubset, bHessian, cScores, nullptr != aWeights);
+   EBM_ASSERT(!IsMultiplyError(cBytesPerFastBin, cBins));
+   EBM_ASSERT(cBytesPerFastBin * cBins <= pTask->m_cBytesPrefetchFastBins);
+   BinBase * const aFastBins = IndexBin(pTask->m_aPrefetchFastBins, pTask->m_cBytesPrefetchFastBins * iSubset);
+   aFastBins->ZeroMem(cBytesPerFastBin, cBins);
+
+   BinSumsBoostingBridge params;
+   params.m_bHessian = bHessian ? EBM_TRUE : EBM_FALSE;
+   params.m_gradHessFormat = pBoosterCore->GetGradHessFormat();
+   params.m_cScores = cScores;
+   params.m_cPack = GetCountItemsBitPacked(pTerm->GetBitsRequiredMin(), cUIntBytes);
+   params.m_aGradientsAndHessians = pSubset->GetGradHess();
+   params.m_aWeights = aWeights;
+   params.m_pCountOccurrences = pSubset->GetInnerBag(0)->GetCountOccurrences();
+   params.m_aPacked = pSubset->GetTermData(pTask->m_iPrefetchTerm);
+   params.m_cBins = cBins;
+   params.m_aFastBins = aFastBins;
+   // we bin in blocks between the score updates, so we cannot sort the whole subset by bin range
+   params.m_aSortScratch = nullptr;
+   params.m_cBinRangeShift = 0;
+#ifndef NDEBUG
+   params.m_pDebugFastBinsEnd = IndexBin(aFastBins, cBytesPerFastBin * cBins);
+#endif // NDEBUG
+
+   // Every block after the first needs to start with aligned data.  The count of occurrences has the smallest
+   // items at one byte per sample, and the packed data needs whole bit packs.
+   const size_t cRows = pSubset->GetCountSamples() / cSIMDPack;
+   const size_t cRowsAlign = SIMD_BYTE_ALIGNMENT / GreatestCommonDivisor(SIMD_BYTE_ALIGNMENT, cSIMDPack);
+   const size_t cPacksAlign = SIMD_BYTE_ALIGNMENT / GreatestCommonDivisor(SIMD_BYTE_ALIGNMENT, cSIMDPack * cUIntBytes);
+
+   const size_t cItemsPerBitPackBins = static_cast<size_t>(params.m_cPack);
+   size_t cRowsUnit = LeastCommonMultiple(cRowsAlign, cItemsPerBitPackBins * cPacksAlign);
+   size_t cItemsPerBitPackUpdate = 1;
+   if(k_cItemsPerBitPackNone != pData->m_cPack) {
+      cItemsPerBitPackUpdate = static_cast<size_t>(pData->m_cPack);
+      cRowsUnit = LeastCommonMultiple(cRowsUnit, cItemsPerBitPackUpdate * cPacksAlign);
+   }
+   const size_t cRowsBlock = cRowsUnit * EbmMax(size_t { 1 }, k_cSamplesPrefetchBlock / (cSIMDPack * cRowsUnit));
+
+   // the first block absorbs the partially filled bit packs.  If no boundary exists we process the subset whole
+   size_t cRowsCur = cRowsAlign;
+   while(cRowsCur < cRows && !(IsPackBoundary(cRows, cRowsCur, cItemsPerBitPackBins, cPacksAlign) &&
+      (k_cItemsPerBitPackNone == pData->m_cPack || IsPackBoundary(cRows, cRowsCur, cItemsPerBitPackUpdate, cPacksAlign))))
+   {
+      cRowsCur += cRowsAlign;
+   }
+   cRowsCur = EbmMin(cRowsCur, cRows);
+   if(IsLaneBins(cSIMDPack, cFloatBytes, bHessian, cScores, cBins)) {
+      // the per-lane histograms are added into the bins at the end of each call, so binning in blocks would 
+      // round differently than GenerateTermUpdate binning the whole subset
+      cRowsCur = cRows;
+   }
+
+   size_t cRowsRemaining = cRows;
+   while(true) {
+      pData->m_cSamples = cRowsCur * cSIMDPack;
+      params.m_cSamples = cRowsCur * cSIMDPack;
+
+      ErrorEbm error = pSubset->ObjectiveApplyUpdate(pData);
+      if(Error_None != error) {
+         return error;
+      }
+      if(nullptr != pData->m_aWeights) {
+         // the validation set is an alias, so this pass also calculates the metric
+         AddValidationMetrics(pTask, iSubset, pData);
+      }
+      error = pSubset->BinSumsBoosting(&params);
+      if(Error_None != error) {
+         return error;
+      }
+
+      cRowsRemaining -= cRowsCur;
+      if(size_t { 0 } == cRowsRemaining) {
+         break;
+      }
+
+      const size_t cBytesSamples = cRowsCur * cSIMDPack;
+      if(k_cItemsPerBitPackNone != pData->m_cPack) {
+         pData->m_aPacked = IndexByte(pData->m_aPacked, 
+            (cRowsCur + cItemsPerBitPackUpdate - size_t { 1 }) / cItemsPerBitPackUpdate * cSIMDPack * cUIntBytes);
+      }
+      if(nullptr != pData->m_aTargets) {
+         pData->m_aTargets = IndexByte(pData->m_aTargets, cBytesSamples * cTargetBytes);
+      }
+      if(nullptr != pData->m_aSampleScores) {
+         pData->m_aSampleScores = IndexByte(pData->m_aSampleScores, cBytesSamples * cScores * cFloatBytes);
+      }
+      if(nullptr != pData->m_aWeights) {
+         pData->m_aWeights = IndexByte(pData->m_aWeights, cBytesSamples * cFloatBytes);
+      }
+      const size_t cBytesGradHess = cBytesSamples * cScores * (bHessian ? size_t { 2 } : size_t { 1 }) *
+         GetCountBytesGradHessItem(pBoosterCore->GetGradHessFormat(), cFloatBytes);
+      pData->m_aGradientsAndHessians = IndexByte(pData->m_aGradientsAndHessians, cBytesGradHess);
+
+      params.m_aGradientsAndHessians = IndexByte(params.m_aGradientsAndHessians, cBytesGradHess);
+      params.m_aPacked = IndexByte(params.m_aPacked,
+         (cRowsCur + cItemsPerBitPackBins - size_t { 1 }) / cItemsPerBitPackBins * cSIMDPack * cUIntBytes);
+      if(nullptr != params.m_aWeights) {
+         params.m_aWeights = IndexByte(params.m_aWeights, cBytesSamples * cFloatBytes);
+      }
+      if(nullptr != params.m_pCountOccurrences) {
+         params.m_pCountOccurrences = IndexByte(params.m_pCountOccurrences, cBytesSamples);
+      }
+
+      cRowsCur = EbmMin(cRowsBlock, cRowsRemaining);
+   }
+   return Error_None;
+}
+
+static ErrorEbm ApplyUpdateSubset(void * const pContext, const size_t iThread, const size_t iTask) {
+   const ApplyUpdateTask * const pTask = static_cast<const ApplyUpdateTask *>(pContext);
+   BoosterCore * const pBoosterCore = pTask->m_pBoosterCore;
+
+   const bool bValidation = pTask->m_iTaskValidationFirst <= iTask;
+   const size_t iSubset = bValidation ? iTask - pTask->m_iTaskValidationFirst : iTask;
+   DataSubsetBoosting * const pSubset = bValidation ? 
+      &pBoosterCore->GetValidationSet()->GetSubsets()[iSubset] : &pBoosterCore->GetTrainingSet()->GetSubsets()[iSubset];
+
+   if(pSubset->GetObjectiveWrapper()->m_cFloatBytes != pTask->m_cFloatSize) {
+      // handled in another pass with the update scores converted to the other float size
+      return Error_None;
+   }
+
+   // When the validation set is an alias it holds the same samples as the training set, so the training pass
+   // calculates the metric of the matching validation subset with its weights, which are zero for the samples 
+   // that we train on.  This way each sample is only updated once.
+   const DataSubsetBoosting * const pSubsetAlias = !bValidation && pBoosterCore->GetValidationSet()->IsAlias() ?
+      &pBoosterCore->GetValidationSet()->GetSubsets()[iSubset] : nullptr;
+   EBM_ASSERT(nullptr == pSubsetAlias || pSubsetAlias->GetCountSamples() == pSubset->GetCountSamples());
+   const bool bMetric = bValidation || nullptr != pSubsetAlias;
+
+   ApplyUpdateBridge data;
+   data.m_cScores = pBoosterCore->GetCountScores();
+   data.m_cPack = size_t { 0 } == pTask->m_cPackBits ? k_cItemsPerBitPackNone :
+      GetCountItemsBitPacked(pTask->m_cPackBits, pSubset->GetObjectiveWrapper()->m_cUIntBytes);
+   // for the validation set we're calculating the metric and updating the scores, but we don't use
+   // the gradients, except for the special case of RMSE where the gradients are also the error
+   data.m_bHessianNeeded = !bValidation && pBoosterCore->IsHessian() ? EBM_TRUE : EBM_FALSE;
+   data.m_gradHessFormat = bValidation ? k_gradHessFloat : pBoosterCore->GetGradHessFormat();
+   data.m_bDisableApprox = pBoosterCore->IsDisableApprox();
+   data.m_bValidation = bValidation ? EBM_TRUE : EBM_FALSE;
+   data.m_bProbabilityMetrics = bMetric && pBoosterCore->IsProbabilityMetrics() ? EBM_TRUE : EBM_FALSE;
+   data.m_aMulticlassMidwayTemp = IndexByte(pTask->m_aMulticlassMidwayTemp, pTask->m_cBytesMulticlassMidwayTemp * iThread);
+   data.m_aUpdateTensorScores = pTask->m_aUpdateScores;
+   data.m_cTensorBins = pTask->m_cTensorBins;
+   data.m_cSamples = pSubset->GetCountSamples();
+   data.m_aPacked = pSubset->GetTermData(pTask->m_iTerm);
+   data.m_aTargets = pSubset->GetTargetData();
+   data.m_aWeights = bValidation ? pSubset->GetInnerBag(0)->GetWeights() : 
+      nullptr != pSubsetAlias ? pSubsetAlias->GetInnerBag(0)->GetWeights() : nullptr;
+   EBM_ASSERT(nullptr == pSubsetAlias || nullptr != data.m_aWeights);
+   data.m_aSampleScores = pSubset->GetSampleScores();
+   data.m_aGradientsAndHessians = pSubset->GetGradHess();
+
+   pTask->m_pcSamplesApplied->fetch_add(pSubset->GetCountSamples(), std::memory_order_relaxed);
+
+   if(!bValidation && nullptr != pTask->m_pPrefetchTerm) {
+      return ApplyUpdatePrefetch(pTask, iSubset, pSubset, &data);
+   }
+   const ErrorEbm error = pSubset->ObjectiveApplyUpdate(&data);
+   if(Error_None != error) {
+      return error;
+   }
+   if(bMetric) {
+      AddValidationMetrics(pTask, iSubset, &data);
+   }
+   return Error_None;
+}
+
+static double SumPairwise(double * const aValues, const size_t cValues) {
+   // Sum in a fixed tree order that depends only on the number of subsets, which is independent of the
+   // number of threads, so that the floating point rounding is the same regardless of how the work was divided.
+   // The pairwise tree also has better numeric accuracy than summing sequentially.
+   EBM_ASSERT(size_t { 1 } <= cValues);
+   size_t cStride = 1;
+   while(cStride < cValues) {
+      const size_t cStep = cStride << 1;
+      for(size_t i = 0; i < cValues - cStride; i += cStep) {
+         aValues[i] += aValues[i + cStride];
+      }
+      cStride = cStep;
+   }
+   return aValues[0];
+}
+
 // we made this a global because if we had put this variable inside the BoosterCore object, then we would need to dereference that before 
 // getting the count.  By making this global we can send a log message incase a bad BoosterCore object is sent into us
 // we only decrease the count if the count is non-zero, so at worst if there is a race condition then we'll output this log message more 
@@ -70,8 +369,17 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION ApplyTermUpdate(
    EBM_ASSERT(iTerm < pBoosterCore->GetCountTerms());
    EBM_ASSERT(nullptr != pBoosterCore->GetTerms());
 
+   // like avgValidationMetricOut, the metrics are +inf if we exit before calculating them
+   for(size_t iMetric = 0; iMetric < pBoosterCore->GetCountMetrics(); ++iMetric) {
+      pBoosterShell->GetValidationMetrics()[iMetric] = std::numeric_limits<double>::infinity();
+   }
+
    pBoosterShell->SetTermIndex(BoosterShell::k_illegalTermIndex);
 
+   // the prefetch hint only applies to this call
+   const size_t iPrefetchTerm = pBoosterShell->GetPrefetchTerm();
+   pBoosterShell->SetPrefetchTerm(BoosterShell::k_illegalTermIndex);
+
    Term * const pTerm = pBoosterCore->GetTerms()[iTerm];
 
    LOG_COUNTED_0(
@@ -131,94 +439,76 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION ApplyTermUpdate(
    // This is an acceptable compromise.  We protect our term scores since the user might want to extract them AFTER we overlfow our measurment metric
    // so we don't want to overflow the values to NaN or +-infinity there, and it's very cheap for us to check for overflows when applying the term score updates
    pBoosterCore->GetCurrentModel()[iTerm]->AddExpandedWithBadValueProtection(aUpdateScores);
+   pBoosterCore->MarkTermDirty(iTerm);
 
    double validationMetricAvg = 0.0;
 
+   const size_t cTrainingSubsets = 0 == pBoosterCore->GetTrainingSet()->GetCountSamples() ? size_t { 0 } :
+      pBoosterCore->GetTrainingSet()->GetCountSubsets();
+   const size_t cValidationSubsets = 0 == pBoosterCore->GetValidationSet()->GetCountSamples() ? size_t { 0 } :
+      pBoosterCore->GetValidationSet()->GetCountSubsets();
+
+   if(size_t { 0 } != cValidationSubsets) {
+      EBM_ASSERT(nullptr != pBoosterShell->GetValidationMetricsTemp());
+      // subsets with a float size that we do not process contribute nothing
+      memset(pBoosterShell->GetValidationMetricsTemp(), 0, 
+         sizeof(double) * pBoosterCore->GetCountValidationSums() * cValidationSubsets);
+   }
+
+   // any histograms that were built from the current gradients are stale after this
+   pBoosterCore->NextGradientsVersion();
+
+   ApplyUpdateTask task;
+   task.m_pBoosterCore = pBoosterCore;
+   task.m_iTaskValidationFirst = cTrainingSubsets;
+   task.m_iTerm = iTerm;
+   task.m_cPackBits = pTerm->GetBitsRequiredMin();
+   task.m_aUpdateScores = aUpdateScores;
+   task.m_cTensorBins = pTerm->GetCountTensorBins();
+   task.m_aMulticlassMidwayTemp = pBoosterShell->GetMulticlassMidwayTemp();
+   task.m_cBytesMulticlassMidwayTemp = pBoosterShell->GetCountBytesMulticlassMidwayTemp();
+   task.m_aValidationMetrics = pBoosterShell->GetValidationMetricsTemp();
+   task.m_pPrefetchTerm = nullptr;
+   task.m_iPrefetchTerm = iPrefetchTerm;
+   task.m_aPrefetchFastBins = pBoosterShell->GetPrefetchFastBins();
+   task.m_cBytesPrefetchFastBins = pBoosterShell->GetCountBytesPrefetchFastBins();
+   std::atomic<size_t> cSamplesApplied(size_t { 0 });
+   task.m_pcSamplesApplied = &cSamplesApplied;
+   if(BoosterShell::k_illegalTermIndex != iPrefetchTerm) {
+      EBM_ASSERT(size_t { 0 } != cTrainingSubsets);
+      EBM_ASSERT(nullptr != pBoosterShell->GetPrefetchFastBins());
+      task.m_pPrefetchTerm = pBoosterCore->GetTerms()[iPrefetchTerm];
+   }
 
    static_assert(std::is_same<FloatBig, FloatScore>::value || std::is_same<FloatSmall, FloatScore>::value,
       "FloatScore must be either FloatBig or FloatSmall");
    size_t cFloatSize = sizeof(aUpdateScores[0]);
-   bool bIgnored = false;
    while(true) {
-      if(0 != pBoosterCore->GetTrainingSet()->GetCountSamples()) {
-         EBM_ASSERT(1 <= pBoosterCore->GetTrainingSet()->GetCountSubsets());
-
-         DataSubsetBoosting * pSubset = pBoosterCore->GetTrainingSet()->GetSubsets();
-         const DataSubsetBoosting * const pSubsetsEnd = pSubset + pBoosterCore->GetTrainingSet()->GetCountSubsets();
-         do {
-            if(pSubset->GetObjectiveWrapper()->m_cFloatBytes != cFloatSize) {
-               bIgnored = true;
-            } else {
-               ApplyUpdateBridge data;
-               data.m_cScores = pBoosterCore->GetCountScores();
-               data.m_cPack = 0 == pTerm->GetBitsRequiredMin() ? k_cItemsPerBitPackNone :
-                  GetCountItemsBitPacked(pTerm->GetBitsRequiredMin(), pSubset->GetObjectiveWrapper()->m_cUIntBytes);
-               data.m_bHessianNeeded = pBoosterCore->IsHessian() ? EBM_TRUE : EBM_FALSE;
-               data.m_bDisableApprox = pBoosterCore->IsDisableApprox();
-               data.m_bValidation = EBM_FALSE;
-               data.m_aMulticlassMidwayTemp = pBoosterShell->GetMulticlassMidwayTemp();
-               data.m_aUpdateTensorScores = aUpdateScores;
-               data.m_cSamples = pSubset->GetCountSamples();
-               data.m_aPacked = pSubset->GetTermData(iTerm);
-               data.m_aTargets = pSubset->GetTargetData();
-               data.m_aWeights = nullptr;
-               data.m_aSampleScores = pSubset->GetSampleScores();
-               data.m_aGradientsAndHessians = pSubset->GetGradHess();
-               error = pSubset->ObjectiveApplyUpdate(&data);
-               if(Error_None != error) {
-                  return error;
-               }
-            }
-            ++pSubset;
-         } while(pSubsetsEnd != pSubset);
+      bool bIgnored = false;
+      for(size_t iSubset = 0; iSubset < cTrainingSubsets; ++iSubset) {
+         if(pBoosterCore->GetTrainingSet()->GetSubsets()[iSubset].GetObjectiveWrapper()->m_cFloatBytes != cFloatSize) {
+            bIgnored = true;
+         }
+      }
+      for(size_t iSubset = 0; iSubset < cValidationSubsets; ++iSubset) {
+         if(pBoosterCore->GetValidationSet()->GetSubsets()[iSubset].GetObjectiveWrapper()->m_cFloatBytes != cFloatSize) {
+            bIgnored = true;
+         }
       }
 
-      if(0 != pBoosterCore->GetValidationSet()->GetCountSamples()) {
-         EBM_ASSERT(1 <= pBoosterCore->GetValidationSet()->GetCountSubsets());
-
-         DataSubsetBoosting * pSubset = pBoosterCore->GetValidationSet()->GetSubsets();
-         const DataSubsetBoosting * const pSubsetsEnd = pSubset + pBoosterCore->GetValidationSet()->GetCountSubsets();
-         do {
-            if(pSubset->GetObjectiveWrapper()->m_cFloatBytes != cFloatSize) {
-               bIgnored = true;
-            } else {
-               // if there is no validation set, it's pretty hard to know what the metric we'll get for our validation set
-               // we could in theory return anything from zero to infinity or possibly, NaN (probably legally the best), but we return 0 here
-               // because we want to kick our caller out of any loop it might be calling us in.  Infinity and NaN are odd values that might cause problems in
-               // a caller that isn't expecting those values, so 0 is the safest option, and our caller can avoid the situation entirely by not calling
-               // us with zero count validation sets
-
-               // if the count of training samples is zero, don't update the best term scores (it will stay as all zeros), and we don't need to update our 
-               // non-existant training set either C++ doesn't define what happens when you compare NaN to annother number.  It probably follows IEEE 754, 
-               // but it isn't guaranteed, so let's check for zero samples in the validation set this better way
-               // https://stackoverflow.com/questions/31225264/what-is-the-result-of-comparing-a-number-with-nan
-
-               ApplyUpdateBridge data;
-               data.m_cScores = pBoosterCore->GetCountScores();
-               data.m_cPack = 0 == pTerm->GetBitsRequiredMin() ? k_cItemsPerBitPackNone :
-                  GetCountItemsBitPacked(pTerm->GetBitsRequiredMin(), pSubset->GetObjectiveWrapper()->m_cUIntBytes);
-               // for the validation set we're calculating the metric and updating the scores, but we don't use
-               // the gradients, except for the special case of RMSE where the gradients are also the error
-               data.m_bHessianNeeded = EBM_FALSE;
-               data.m_bDisableApprox = pBoosterCore->IsDisableApprox();
-               data.m_bValidation = EBM_TRUE;
-               data.m_aMulticlassMidwayTemp = pBoosterShell->GetMulticlassMidwayTemp();
-               data.m_aUpdateTensorScores = aUpdateScores;
-               data.m_cSamples = pSubset->GetCountSamples();
-               data.m_aPacked = pSubset->GetTermData(iTerm);
-               data.m_aTargets = pSubset->GetTargetData();
-               data.m_aWeights = pSubset->GetInnerBag(0)->GetWeights();
-               data.m_aSampleScores = pSubset->GetSampleScores();
-               data.m_aGradientsAndHessians = pSubset->GetGradHess();
-               error = pSubset->ObjectiveApplyUpdate(&data);
-               if(Error_None != error) {
-                  return error;
-               }
-               validationMetricAvg += data.m_metricOut;
-            }
-            ++pSubset;
-         } while(pSubsetsEnd != pSubset);
+      task.m_cFloatSize = cFloatSize;
+      // an alias validation set has its metric calculated by the training subsets that hold its samples
+      error = ThreadPool::Execute(
+         pBoosterCore->GetThreadPool(),
+         cTrainingSubsets + (pBoosterCore->GetValidationSet()->IsAlias() ? size_t { 0 } : cValidationSubsets),
+         ApplyUpdateSubset,
+         &task
+      );
+      if(Error_None != error) {
+         LOG_0(Trace_Warning, "WARNING ApplyTermUpdate ObjectiveApplyUpdate failed");
+         return error;
       }
+
       if(!bIgnored) {
          break;
       }
@@ -247,22 +537,96 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION ApplyTermUpdate(
       } while(pUpdateBigEnd != pUpdateBig);
    }
 
-   if(0 != pBoosterCore->GetValidationSet()->GetCountSamples()) {
-      validationMetricAvg = pBoosterCore->FinishMetric(validationMetricAvg);
-
-      if(EBM_FALSE != pBoosterCore->MaximizeMetric()) {
-         // make it so that we always return values such that the caller wants to minimize them. If the caller
-         // wants more information they can determine if they should negate the values we return them.
-         validationMetricAvg = -validationMetricAvg;
+   if(nullptr != task.m_pPrefetchTerm) {
+      // add the fast bins in subset order, which is the same order that GenerateTermUpdate would add them
+      const bool bHessian = pBoosterCore->IsHessian();
+      const size_t cScores = pBoosterCore->GetCountScores();
+      const size_t cBins = task.m_pPrefetchTerm->GetCountTensorBins();
+      BinBase * const aPrefetchBins = pBoosterShell->GetPrefetchBins();
+      EBM_ASSERT(nullptr != aPrefetchBins);
+      memset(aPrefetchBins, 0, GetBinSize<FloatMain, UIntMain>(bHessian, cScores) * cBins);
+      for(size_t iSubset = 0; iSubset < cTrainingSubsets; ++iSubset) {
+         const DataSubsetBoosting * const pSubset = &pBoosterCore->GetTrainingSet()->GetSubsets()[iSubset];
+         ConvertAddBin(
+            cScores,
+            bHessian,
+            cBins,
+            sizeof(UIntBig) == pSubset->GetObjectiveWrapper()->m_cUIntBytes,
+            sizeof(FloatBig) == pSubset->GetObjectiveWrapper()->m_cFloatBytes,
+            nullptr != pSubset->GetInnerBag(0)->GetWeights(),
+            IndexBin(task.m_aPrefetchFastBins, task.m_cBytesPrefetchFastBins * iSubset),
+            std::is_same<UIntMain, uint64_t>::value,
+            std::is_same<FloatMain, double>::value,
+            aPrefetchBins
+         );
       }
+      pBoosterShell->SetPrefetchBinsCurrent(iPrefetchTerm, pBoosterCore->GetGradientsVersion());
+   }
 
-      EBM_ASSERT(!std::isnan(validationMetricAvg)); // NaNs can happen, but we should have cleaned them up
+   if(size_t { 0 } != cValidationSubsets) {
+      // if there is no validation set, it's pretty hard to know what the metric we'll get for our validation set
+      // we could in theory return anything from zero to infinity or possibly, NaN (probably legally the best), but we return 0 here
+      // because we want to kick our caller out of any loop it might be calling us in.  Infinity and NaN are odd values that might cause problems in
+      // a caller that isn't expecting those values, so 0 is the safest option, and our caller can avoid the situation entirely by not calling
+      // us with zero count validation sets
 
       const double totalWeight = pBoosterCore->GetValidationSet()->GetBagWeightTotal(0);
       EBM_ASSERT(!std::isnan(totalWeight));
       EBM_ASSERT(!std::isinf(totalWeight));
       EBM_ASSERT(0.0 < totalWeight);
-      validationMetricAvg /= totalWeight; // if totalWeight < 1.0 then this can overflow to +inf
+
+      double * const aValidationSums = pBoosterShell->GetValidationMetricsTemp();
+
+      double objectiveMetricAvg = SumPairwise(aValidationSums, cValidationSubsets);
+      objectiveMetricAvg = pBoosterCore->FinishMetric(objectiveMetricAvg);
+
+      if(EBM_FALSE != pBoosterCore->MaximizeMetric()) {
+         // make it so that we always return values such that the caller wants to minimize them. If the caller
+         // wants more information they can determine if they should negate the values we return them.
+         objectiveMetricAvg = -objectiveMetricAvg;
+      }
+
+      EBM_ASSERT(!std::isnan(objectiveMetricAvg)); // NaNs can happen, but we should have cleaned them up
+
+      objectiveMetricAvg /= totalWeight; // if totalWeight < 1.0 then this can overflow to +inf
+
+      double brierAvg = 0.0;
+      double calibrationErrorAvg = 0.0;
+      if(pBoosterCore->IsProbabilityMetrics()) {
+         brierAvg = SumPairwise(&aValidationSums[cValidationSubsets], cValidationSubsets) / totalWeight;
+
+         // the calibration error is the weighted average of |mean probability - fraction positive| over the bins,
+         // which is the sum of |sum of (probability - target)| in each bin divided by the total weight
+         double calibrationError = 0.0;
+         for(size_t iBin = 0; iBin < k_cCalibrationBins; ++iBin) {
+            const size_t iSums = (size_t { 2 } + iBin) * cValidationSubsets;
+            calibrationError += std::abs(SumPairwise(&aValidationSums[iSums], cValidationSubsets));
+         }
+         calibrationErrorAvg = calibrationError / totalWeight;
+      }
+
+      double aucNegated = 0.0;
+      if(nullptr != pBoosterCore->GetAucTracker()) {
+         // AUC is better when higher, so negate it like the other metrics that we maximize
+         aucNegated = -pBoosterCore->GetAucTracker()->Compute(pBoosterCore->GetValidationSet());
+      }
+
+      double * const aValidationMetrics = pBoosterShell->GetValidationMetrics();
+      for(size_t iMetric = 0; iMetric < pBoosterCore->GetCountMetrics(); ++iMetric) {
+         const int metric = pBoosterCore->GetMetricTypes()[iMetric];
+         double metricAvg = objectiveMetricAvg; // k_metricObjective or k_metricLogLoss
+         if(k_metricAuc == metric) {
+            metricAvg = aucNegated;
+         } else if(k_metricBrier == metric) {
+            metricAvg = brierAvg;
+         } else if(k_metricCalibrationError == metric) {
+            metricAvg = calibrationErrorAvg;
+         }
+         aValidationMetrics[iMetric] = metricAvg;
+      }
+
+      // the first metric listed decides which model is best
+      validationMetricAvg = aValidationMetrics[0];
 
       EBM_ASSERT(!std::isnan(validationMetricAvg)); // NaNs can happen, but we should have cleaned them up
 
@@ -270,35 +634,17 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION ApplyTermUpdate(
          // we keep on improving, so this is more likely than not, and we'll exit if it becomes negative a lot
          pBoosterCore->SetBestModelMetric(validationMetricAvg);
 
-         // TODO: We're doing a lot more work here than necessary.  Typically in the early phases we improve
-         // on each boosting step, and in that case we should only need to copy over the term's tensor that
-         // we just improved on since all the other ones are up to date.  Later though we'll get into a stage
-         // where some of the terms will improve on the metric but others won't. At that point if we see
-         // two terms not improve the stopping metric, then we see one that does, we'd need to copy over the
-         // last 3 terms to maintain consistency.  That requires that we keep track of the terms we boosted
-         // on since the last improvement.  This can get even more interesting if we do more than a full boosting
-         // round where a term might have been boosted on a few times.  In that case we only need to overwrite
-         // it once.  We can do this by keeping a set that holds the terms that have been bosted on since the last
-         // improvement and then we would overwrite only those whenever we see an improvement. Instead of a set though
-         // we could instead maintan a reversed linked list of terms that we've boosted on using a flat array
-         // with 1 pointer entry for each term.  If a term is already in the linked list there is no need to add it
-         // again.  This way we can avoid a sweep of the entire list of terms on each boosting round.
-
-         size_t iTermCopy = 0;
-         size_t iTermCopyEnd = pBoosterCore->GetCountTerms();
-         do {
-            if(nullptr != pBoosterCore->GetCurrentModel()[iTermCopy]) {
-               EBM_ASSERT(nullptr != pBoosterCore->GetBestModel()[iTermCopy]);
-               error = pBoosterCore->GetBestModel()[iTermCopy]->Copy(*pBoosterCore->GetCurrentModel()[iTermCopy]);
-               if(Error_None != error) {
-                  LOG_0(Trace_Verbose, "Exited ApplyTermUpdateInternal with memory allocation error in copy");
-                  return error;
-               }
-            } else {
-               EBM_ASSERT(nullptr == pBoosterCore->GetBestModel()[iTermCopy]);
-            }
-            ++iTermCopy;
-         } while(iTermCopy != iTermCopyEnd);
+         // only the terms boosted on since the previous improvement differ from the best model
+         error = pBoosterCore->CopyDirtyTermsToBestModel();
+         if(Error_None != error) {
+            LOG_0(Trace_Verbose, "Exited ApplyTermUpdateInternal with memory allocation error in copy");
+            return error;
+         }
+      }
+   } else {
+      double * const aValidationMetrics = pBoosterShell->GetValidationMetrics();
+      for(size_t iMetric = 0; iMetric < pBoosterCore->GetCountMetrics(); ++iMetric) {
+         aValidationMetrics[iMetric] = 0.0;
       }
    }
    
@@ -311,14 +657,62 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION ApplyTermUpdate(
       Trace_Info,
       Trace_Verbose,
       "Exited ApplyTermUpdate: "
+      "cSamplesApplied=%zu, "
       "validationMetricAvg=%le"
       , 
+      cSamplesApplied.load(std::memory_order_relaxed),
       validationMetricAvg
    );
 
    return Error_None;
 }
 
+// we made this a global because if we had put this variable inside the BoosterCore object, then we would need to dereference that before 
+// getting the count.  By making this global we can send a log message incase a bad BoosterCore object is sent into us
+// we only decrease the count if the count is non-zero, so at worst if there is a race condition then we'll output this log message more 
+// times than desired, but we can live with that
+static int g_cLogGetValidationMetrics = 10;
+
+EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION GetValidationMetrics(
+   BoosterHandle boosterHandle,
+   IntEbm countMetrics,
+   double * validationMetricsOut
+) {
+   LOG_COUNTED_N(
+      &g_cLogGetValidationMetrics,
+      Trace_Info,
+      Trace_Verbose,
+      "GetValidationMetrics: "
+      "boosterHandle=%p, "
+      "countMetrics=%" IntEbmPrintf ", "
+      "validationMetricsOut=%p"
+      ,
+      static_cast<void *>(boosterHandle),
+      countMetrics,
+      static_cast<void *>(validationMetricsOut)
+   );
+
+   BoosterShell * const pBoosterShell = BoosterShell::GetBoosterShellFromHandle(boosterHandle);
+   if(nullptr == pBoosterShell) {
+      // already logged
+      return Error_IllegalParamVal;
+   }
+   const BoosterCore * const pBoosterCore = pBoosterShell->GetBoosterCore();
+
+   if(IsConvertError<size_t>(countMetrics) || pBoosterCore->GetCountMetrics() != static_cast<size_t>(countMetrics)) {
+      LOG_0(Trace_Error, "ERROR GetValidationMetrics countMetrics must match the number of metrics in the objective, or be 1 if none were listed");
+      return Error_IllegalParamVal;
+   }
+   if(nullptr == validationMetricsOut) {
+      LOG_0(Trace_Error, "ERROR GetValidationMetrics validationMetricsOut cannot be nullptr");
+      return Error_IllegalParamVal;
+   }
+
+   memcpy(validationMetricsOut, pBoosterShell->GetValidationMetrics(), sizeof(*validationMetricsOut) * pBoosterCore->GetCountMetrics());
+
+   return Error_None;
+}
+
 // we made this a global because if we had put this variable inside the BoosterCore object, then we would need to dereference that before 
 // getting the count.  By making this global we can send a log message incase a bad BoosterCore object is sent into us
 // we only decrease the count if the count is non-zero, so at worst if there is a race condition then we'll output this log message more 
@@ -613,4 +1007,71 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION SetTermUpdate(
    return Error_None;
 }
 
+// we made this a global because if we had put this variable inside the BoosterCore object, then we would need to dereference that before 
+// getting the count.  By making this global we can send a log message incase a bad BoosterCore object is sent into us
+// we only decrease the count if the count is non-zero, so at worst if there is a race condition then we'll output this log message more 
+// times than desired, but we can live with that
+static int g_cLogPrefetchTerm = 10;
+
+EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION PrefetchTerm(
+   BoosterHandle boosterHandle,
+   IntEbm indexTerm
+) {
+   LOG_COUNTED_N(
+      &g_cLogPrefetchTerm,
+      Trace_Info,
+      Trace_Verbose,
+      "PrefetchTerm: "
+      "boosterHandle=%p, "
+      "indexTerm=%" IntEbmPrintf
+      ,
+      static_cast<void *>(boosterHandle),
+      indexTerm
+   );
+
+   BoosterShell * const pBoosterShell = BoosterShell::GetBoosterShellFromHandle(boosterHandle);
+   if(nullptr == pBoosterShell) {
+      // already logged
+      return Error_IllegalParamVal;
+   }
+
+   pBoosterShell->SetPrefetchTerm(BoosterShell::k_illegalTermIndex);
+
+   if(IntEbm { -1 } == indexTerm) {
+      // the caller is cancelling a previous hint
+      return Error_None;
+   }
+
+   BoosterCore * const pBoosterCore = pBoosterShell->GetBoosterCore();
+   EBM_ASSERT(nullptr != pBoosterCore);
+
+   if(indexTerm < 0) {
+      LOG_0(Trace_Error, "ERROR PrefetchTerm indexTerm must be positive or -1");
+      return Error_IllegalParamVal;
+   }
+   if(IsConvertError<size_t>(indexTerm)) {
+      // we wouldn't have allowed the creation of an feature set larger than size_t
+      LOG_0(Trace_Error, "ERROR PrefetchTerm indexTerm is too high to index");
+      return Error_IllegalParamVal;
+   }
+   const size_t iTerm = static_cast<size_t>(indexTerm);
+   if(pBoosterCore->GetCountTerms() <= iTerm) {
+      LOG_0(Trace_Error, "ERROR PrefetchTerm indexTerm above the number of terms that we have");
+      return Error_IllegalParamVal;
+   }
+
+   if(!pBoosterShell->IsPrefetchable(iTerm)) {
+      // this is only a hint, so there is nothing wrong with asking for a term that we do not prefetch
+      return Error_None;
+   }
+
+   const ErrorEbm error = pBoosterShell->AllocatePrefetch();
+   if(Error_None != error) {
+      return error;
+   }
+
+   pBoosterShell->SetPrefetchTerm(iTerm);
+   return Error_None;
+}
+
 } // DEFINED_ZONE_NAME
@@ -0,0 +1,288 @@
+// Copyright (c) 2023 The InterpretML Contributors
+// Licensed under the MIT license.
+// Author: Paul Koch <code@koch.ninja>
+
+#include "pch.hpp"
+
+#include <stdlib.h> // malloc, free
+#include <stddef.h> // size_t, ptrdiff_t
+#include <string.h> // memset
+#include <limits> // numeric_limits
+#include <cmath> // isnan
+#include <algorithm> // sort
+
+#include "logging.h" // EBM_ASSERT
+
+#include "common.hpp" // IsMultiplyError
+#include "bridge.h" // FloatBig, UIntBig
+
+#include "InnerBag.hpp"
+#include "DataSetBoosting.hpp"
+#include "AucTracker.hpp"
+
+namespace DEFINED_ZONE_NAME {
+#ifndef DEFINED_ZONE_NAME
+#error DEFINED_ZONE_NAME must be defined
+#endif // DEFINED_ZONE_NAME
+
+// buckets with more samples than this are sorted with std::sort instead of an insertion sort
+static constexpr size_t k_cInsertionSortMax = 32;
+
+inline static size_t GetBucket(const double score, const double scoreMin, const double scale, const size_t iBucketLast) {
+   // scale is zero when there is only one bucket, and then we cannot subtract since the scores might be infinite
+   return 0.0 == scale ? size_t { 0 } : EbmMin(static_cast<size_t>((score - scoreMin) * scale), iBucketLast);
+}
+
+void AucTracker::Free(AucTracker * const pAucTracker) {
+   if(nullptr != pAucTracker) {
+      free(pAucTracker->m_pMemory);
+      delete pAucTracker;
+   }
+}
+
+ErrorEbm AucTracker::Create(DataSetBoosting * const pValidationSet, AucTracker ** const ppAucTrackerOut) {
+   LOG_0(Trace_Info, "Entered AucTracker::Create");
+
+   EBM_ASSERT(nullptr != pValidationSet);
+   EBM_ASSERT(nullptr != ppAucTrackerOut);
+   EBM_ASSERT(nullptr == *ppAucTrackerOut);
+
+   const size_t cSamples = pValidationSet->GetCountSamples();
+   EBM_ASSERT(size_t { 1 } <= cSamples);
+
+   AucTracker * pAucTracker;
+   try {
+      pAucTracker = new AucTracker();
+   } catch(const std::bad_alloc &) {
+      LOG_0(Trace_Warning, "WARNING AucTracker::Create Out of memory allocating AucTracker");
+      return Error_OutOfMemory;
+   } catch(...) {
+      LOG_0(Trace_Warning, "WARNING AucTracker::Create Unknown error");
+      return Error_UnexpectedInternal;
+   }
+   if(nullptr == pAucTracker) {
+      // this should be impossible since bad_alloc should have been thrown, but let's be untrusting
+      LOG_0(Trace_Warning, "WARNING AucTracker::Create nullptr == pAucTracker");
+      return Error_OutOfMemory;
+   }
+   // give ownership of our object back to the caller, even if there is a failure
+   *ppAucTrackerOut = pAucTracker;
+
+   // we use at most one bucket per sample
+   static constexpr size_t cBytesPerSample =
+      sizeof(size_t) + sizeof(size_t) + sizeof(size_t) + sizeof(double) + sizeof(double) + sizeof(bool);
+   if(IsMultiplyError(cBytesPerSample, cSamples)) {
+      LOG_0(Trace_Warning, "WARNING AucTracker::Create IsMultiplyError(cBytesPerSample, cSamples)");
+      return Error_OutOfMemory;
+   }
+   void * const pMemory = malloc(cBytesPerSample * cSamples);
+   if(nullptr == pMemory) {
+      LOG_0(Trace_Warning, "WARNING AucTracker::Create nullptr == pMemory");
+      return Error_OutOfMemory;
+   }
+   pAucTracker->m_pMemory = pMemory;
+   // the 8 byte items go first so that everything stays aligned
+   pAucTracker->m_aOrder = static_cast<size_t *>(pMemory);
+   pAucTracker->m_aOrderNext = pAucTracker->m_aOrder + cSamples;
+   pAucTracker->m_aBucketEnds = pAucTracker->m_aOrderNext + cSamples;
+   pAucTracker->m_aScores = reinterpret_cast<double *>(pAucTracker->m_aBucketEnds + cSamples);
+   pAucTracker->m_aWeights = pAucTracker->m_aScores + cSamples;
+   pAucTracker->m_aPositive = reinterpret_cast<bool *>(pAucTracker->m_aWeights + cSamples);
+   pAucTracker->m_cSamples = cSamples;
+
+   double weightPositive = 0.0;
+   double weightNegative = 0.0;
+   size_t iSample = 0;
+   DataSubsetBoosting * pSubset = pValidationSet->GetSubsets();
+   const DataSubsetBoosting * const pSubsetsEnd = pSubset + pValidationSet->GetCountSubsets();
+   do {
+      const size_t cSubsetSamples = pSubset->GetCountSamples();
+      const bool bUIntBig = sizeof(UIntBig) == pSubset->GetObjectiveWrapper()->m_cUIntBytes;
+      const bool bFloatBig = sizeof(FloatBig) == pSubset->GetObjectiveWrapper()->m_cFloatBytes;
+      const void * const aTargets = pSubset->GetTargetData();
+      EBM_ASSERT(nullptr != aTargets);
+      const void * const aWeights = pSubset->GetInnerBag(0)->GetWeights();
+      for(size_t iSubsetSample = 0; iSubsetSample < cSubsetSamples; ++iSubsetSample) {
+         const bool bPositive = bUIntBig ?
+            UIntBig { 0 } != static_cast<const UIntBig *>(aTargets)[iSubsetSample] :
+            UIntSmall { 0 } != static_cast<const UIntSmall *>(aTargets)[iSubsetSample];
+         double weight = 1.0;
+         if(nullptr != aWeights) {
+            weight = bFloatBig ? static_cast<double>(static_cast<const FloatBig *>(aWeights)[iSubsetSample]) :
+               static_cast<double>(static_cast<const FloatSmall *>(aWeights)[iSubsetSample]);
+         }
+         if(bPositive) {
+            weightPositive += weight;
+         } else {
+            weightNegative += weight;
+         }
+         pAucTracker->m_aPositive[iSample] = bPositive;
+         pAucTracker->m_aWeights[iSample] = weight;
+         pAucTracker->m_aOrder[iSample] = iSample;
+         ++iSample;
+      }
+      ++pSubset;
+   } while(pSubsetsEnd != pSubset);
+   EBM_ASSERT(cSamples == iSample);
+
+   pAucTracker->m_weightPositive = weightPositive;
+   pAucTracker->m_weightNegative = weightNegative;
+
+   LOG_0(Trace_Info, "Exited AucTracker::Create");
+   return Error_None;
+}
+
+double AucTracker::SumSortedBucket(const size_t iStart, const size_t iEnd, double * const pWeightNegativeBelowInOut) {
+   EBM_ASSERT(iStart < iEnd);
+
+   const double * const aScores = m_aScores;
+   size_t * const aOrder = m_aOrderNext;
+
+   if(iEnd - iStart <= k_cInsertionSortMax) {
+      // the samples are still in the order of the previous scores, so this is close to linear
+      for(size_t i = iStart + size_t { 1 }; i < iEnd; ++i) {
+         const size_t iSample = aOrder[i];
+         const double score = aScores[iSample];
+         size_t j = i;
+         while(iStart != j && score < aScores[aOrder[j - size_t { 1 }]]) {
+            aOrder[j] = aOrder[j - size_t { 1 }];
+            --j;
+         }
+         aOrder[j] = iSample;
+      }
+   } else {
+      std::sort(aOrder + iStart, aOrder + iEnd, [aScores](const size_t iLeft, const size_t iRight) {
+         return aScores[iLeft] < aScores[iRight];
+      });
+   }
+
+   // pairs of positive and negative samples with tied scores count as half correctly ordered
+   double sum = 0.0;
+   double weightNegativeBelow = *pWeightNegativeBelowInOut;
+   size_t i = iStart;
+   do {
+      const double score = aScores[aOrder[i]];
+      double weightPositiveTied = 0.0;
+      double weightNegativeTied = 0.0;
+      do {
+         const size_t iSample = aOrder[i];
+         if(m_aPositive[iSample]) {
+            weightPositiveTied += m_aWeights[iSample];
+         } else {
+            weightNegativeTied += m_aWeights[iSample];
+         }
+         ++i;
+      } while(iEnd != i && score == aScores[aOrder[i]]);
+      sum += weightPositiveTied * (weightNegativeBelow + 0.5 * weightNegativeTied);
+      weightNegativeBelow += weightNegativeTied;
+   } while(iEnd != i);
+   *pWeightNegativeBelowInOut = weightNegativeBelow;
+   return sum;
+}
+
+double AucTracker::Compute(DataSetBoosting * const pValidationSet) {
+   EBM_ASSERT(nullptr != pValidationSet);
+   EBM_ASSERT(m_cSamples == pValidationSet->GetCountSamples());
+
+   const size_t cSamples = m_cSamples;
+   double * const aScores = m_aScores;
+
+   double scoreMin = std::numeric_limits<double>::infinity();
+   double scoreMax = -std::numeric_limits<double>::infinity();
+   size_t iSample = 0;
+   DataSubsetBoosting * pSubset = pValidationSet->GetSubsets();
+   const DataSubsetBoosting * const pSubsetsEnd = pSubset + pValidationSet->GetCountSubsets();
+   do {
+      // binary classification has 1 score per sample, so the scores are in sample order within each subset
+      const size_t cSubsetSamples = pSubset->GetCountSamples();
+      const bool bFloatBig = sizeof(FloatBig) == pSubset->GetObjectiveWrapper()->m_cFloatBytes;
+      const void * const aSampleScores = pSubset->GetSampleScores();
+      EBM_ASSERT(nullptr != aSampleScores);
+      for(size_t iSubsetSample = 0; iSubsetSample < cSubsetSamples; ++iSubsetSample) {
+         double score = bFloatBig ? static_cast<double>(static_cast<const FloatBig *>(aSampleScores)[iSubsetSample]) :
+            static_cast<double>(static_cast<const FloatSmall *>(aSampleScores)[iSubsetSample]);
+         if(std::isnan(score)) {
+            // an overflowed score has no rank, so put it below everything else
+            score = -std::numeric_limits<double>::infinity();
+         }
+         scoreMin = score < scoreMin ? score : scoreMin;
+         scoreMax = scoreMax < score ? score : scoreMax;
+         aScores[iSample] = score;
+         ++iSample;
+      }
+      ++pSubset;
+   } while(pSubsetsEnd != pSubset);
+   EBM_ASSERT(cSamples == iSample);
+
+   // if all the scores are the same or the range overflows then everything goes into the first bucket
+   const double range = scoreMax - scoreMin;
+   const bool bSpread = 0.0 < range && range <= std::numeric_limits<double>::max();
+   const size_t cBuckets = bSpread ? cSamples : size_t { 1 };
+   const double scale = bSpread ? static_cast<double>(cBuckets) / range : 0.0;
+   const size_t iBucketLast = cBuckets - size_t { 1 };
+
+   size_t * const aBucketEnds = m_aBucketEnds;
+   memset(aBucketEnds, 0, sizeof(*aBucketEnds) * cBuckets);
+   for(size_t i = 0; i < cSamples; ++i) {
+      const size_t iBucket = GetBucket(aScores[i], scoreMin, scale, iBucketLast);
+      ++aBucketEnds[iBucket];
+   }
+   size_t iBucketStart = 0;
+   for(size_t iBucket = 0; iBucket < cBuckets; ++iBucket) {
+      const size_t cBucketSamples = aBucketEnds[iBucket];
+      aBucketEnds[iBucket] = iBucketStart;
+      iBucketStart += cBucketSamples;
+   }
+   EBM_ASSERT(cSamples == iBucketStart);
+
+   // place the samples in their previous order, which leaves each bucket nearly sorted.  Afterwards each
+   // entry in aBucketEnds has advanced from the start of its bucket to the end
+   const size_t * const aOrder = m_aOrder;
+   size_t * const aOrderNext = m_aOrderNext;
+   for(size_t i = 0; i < cSamples; ++i) {
+      const size_t iSampleOrdered = aOrder[i];
+      const size_t iBucket = GetBucket(aScores[iSampleOrdered], scoreMin, scale, iBucketLast);
+      aOrderNext[aBucketEnds[iBucket]] = iSampleOrdered;
+      ++aBucketEnds[iBucket];
+   }
+
+   double sum = 0.0;
+   double weightNegativeBelow = 0.0;
+   size_t iStart = 0;
+   for(size_t iBucket = 0; iBucket < cBuckets; ++iBucket) {
+      const size_t iEnd = aBucketEnds[iBucket];
+      if(iStart != iEnd) {
+         double weightPositive = 0.0;
+         double weightNegative = 0.0;
+         for(size_t i = iStart; i < iEnd; ++i) {
+            const size_t iSampleOrdered = aOrderNext[i];
+            if(m_aPositive[iSampleOrdered]) {
+               weightPositive += m_aWeights[iSampleOrdered];
+            } else {
+               weightNegative += m_aWeights[iSampleOrdered];
+            }
+         }
+         if(0.0 == weightPositive || 0.0 == weightNegative) {
+            // every positive sample in the bucket is above all the negative samples in the buckets below it
+            sum += weightPositive * weightNegativeBelow;
+            weightNegativeBelow += weightNegative;
+         } else {
+            sum += SumSortedBucket(iStart, iEnd, &weightNegativeBelow);
+         }
+         iStart = iEnd;
+      }
+   }
+   EBM_ASSERT(cSamples == iStart);
+
+   m_aOrderNext = m_aOrder;
+   m_aOrder = aOrderNext;
+
+   const double weightPairs = m_weightPositive * m_weightNegative;
+   if(!(0.0 < weightPairs)) {
+      // with only one class in the validation set there are no pairs to rank, which is the same as random guessing
+      return 0.5;
+   }
+   return sum / weightPairs;
+}
+
+} // DEFINED_ZONE_NAME
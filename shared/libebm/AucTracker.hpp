@@ -0,0 +1,74 @@
+// Copyright (c) 2023 The InterpretML Contributors
+// Licensed under the MIT license.
+// Author: Paul Koch <code@koch.ninja>
+
+#ifndef AUC_TRACKER_HPP
+#define AUC_TRACKER_HPP
+
+#include <stddef.h> // size_t, ptrdiff_t
+
+#include "libebm.h" // ErrorEbm
+#include "logging.h" // EBM_ASSERT
+#include "unzoned.h"
+
+#include "zones.h"
+
+namespace DEFINED_ZONE_NAME {
+#ifndef DEFINED_ZONE_NAME
+#error DEFINED_ZONE_NAME must be defined
+#endif // DEFINED_ZONE_NAME
+
+struct DataSetBoosting;
+
+class AucTracker final {
+   // Computes the exact weighted ROC AUC of a binary classification validation set after each update.
+   //
+   // AUC is a rank statistic over all the validation samples, so unlike the objective metrics it cannot be summed
+   // per sample inside the compute zones.  Sorting the scores from scratch after every ApplyTermUpdate would cost
+   // O(N log N), but one term update only moves the scores a little, so we keep the order the samples had after
+   // the previous update and counting sort them in that order into buckets that evenly divide the current score
+   // range.  A bucket holding only one class adds its weight without needing its samples to be ordered.  A bucket
+   // holding both classes is nearly sorted already and an insertion sort finishes it exactly, with std::sort
+   // as the fallback when many samples land in the same bucket.
+
+   size_t m_cSamples;
+   double m_weightPositive;
+   double m_weightNegative;
+
+   void * m_pMemory; // holds all the arrays below
+   size_t * m_aOrder; // sample indexes in the order that we sorted them into during the previous update
+   size_t * m_aOrderNext;
+   size_t * m_aBucketEnds;
+   double * m_aScores;
+   double * m_aWeights;
+   bool * m_aPositive;
+
+   inline AucTracker() noexcept :
+      m_cSamples(0),
+      m_weightPositive(0.0),
+      m_weightNegative(0.0),
+      m_pMemory(nullptr),
+      m_aOrder(nullptr),
+      m_aOrderNext(nullptr),
+      m_aBucketEnds(nullptr),
+      m_aScores(nullptr),
+      m_aWeights(nullptr),
+      m_aPositive(nullptr) {
+   }
+
+   ~AucTracker() = default;
+
+   double SumSortedBucket(const size_t iStart, const size_t iEnd, double * const pWeightNegativeBelowInOut);
+
+public:
+
+   static void Free(AucTracker * const pAucTracker);
+   static ErrorEbm Create(DataSetBoosting * const pValidationSet, AucTracker ** const ppAucTrackerOut);
+
+   // pValidationSet must be the same one given to Create, with the sample scores after the latest update
+   double Compute(DataSetBoosting * const pValidationSet);
+};
+
+} // DEFINED_ZONE_NAME
+
+#endif // AUC_TRACKER_HPP
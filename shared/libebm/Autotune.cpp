@@ -0,0 +1,400 @@
+// Copyright (c) 2023 The InterpretML Contributors
+// Licensed under the MIT license.
+// Author: Paul Koch <code@koch.ninja>
+
+#include "pch.hpp"
+
+#include <stdlib.h> // malloc, free
+#include <stddef.h> // size_t, ptrdiff_t
+#include <string.h> // memset
+#include <chrono>
+
+#include "libebm.h" // ErrorEbm
+#include "logging.h" // EBM_ASSERT
+#include "unzoned.h" // AlignedAlloc
+#include "zones.h"
+
+#include "bridge.h" // ObjectiveWrapper
+#include "GradientPair.hpp"
+#include "Bin.hpp"
+
+#include "ebm_internal.hpp"
+#include "Term.hpp"
+#include "InnerBag.hpp"
+#include "DataSetBoosting.hpp"
+
+namespace DEFINED_ZONE_NAME {
+#ifndef DEFINED_ZONE_NAME
+#error DEFINED_ZONE_NAME must be defined
+#endif // DEFINED_ZONE_NAME
+
+extern size_t GetCountBytesPerFastBin(
+   const DataSubsetBoosting * const pSubset,
+   const bool bHessian,
+   const size_t cScores,
+   const bool bWeight
+);
+
+extern int GetBinRangeShift(
+   const size_t cBytesPerFastBin,
+   const size_t cTensorBins,
+   const size_t cBytesHistogramCache
+);
+
+// enough samples for the kernel timings to be well above the clock resolution while keeping CreateBooster fast
+static constexpr size_t k_cAutotuneSamplesMax = size_t { 1 } << 14;
+// we keep the fastest of several runs since the slower runs are the ones that were interrupted
+static constexpr int k_cAutotuneRepeats = 3;
+
+static const char * GetZoneName(const ObjectiveWrapper * const pObjectiveSIMD) {
+   // m_zones holds the zones that the objective supports, so we identify the zone by its SIMD shape
+   if(nullptr == pObjectiveSIMD->m_pObjective) {
+      return "cpu_64";
+   } else if(sizeof(FloatSmall) == pObjectiveSIMD->m_cFloatBytes && size_t { 16 } == pObjectiveSIMD->m_cSIMDPack) {
+      return "avx512f_32";
+   } else if(sizeof(FloatSmall) == pObjectiveSIMD->m_cFloatBytes && size_t { 8 } == pObjectiveSIMD->m_cSIMDPack) {
+      return "avx2_32";
+   } else if(sizeof(FloatBig) == pObjectiveSIMD->m_cFloatBytes && size_t { 4 } == pObjectiveSIMD->m_cSIMDPack) {
+      return "avx2_64";
+   }
+   return "unknown";
+}
+
+static const char * GetBinSumsPlanName(const int binSumsPlan) {
+   if(k_binSumsPlanSorted == binSumsPlan) {
+      return "sorted";
+   } else if(k_binSumsPlanDirect == binSumsPlan) {
+      return "direct";
+   }
+   return "heuristic";
+}
+
+static ErrorEbm TimeBinSums(
+   DataSetBoosting * const pDataSet,
+   const bool bHessian,
+   const int gradHessFormat,
+   const size_t cScores,
+   const size_t cBytesHistogramCache,
+   const Term * const pTerm,
+   const size_t iTerm,
+   BinBase * const aFastBins,
+   void * const aSortScratch,
+   double * const pSecondsOut
+) {
+   // times one pass of BinSumsBoosting over every subset, sorting the samples by bin range if aSortScratch is
+   // not nullptr
+
+   const size_t cTensorBins = pTerm->GetCountTensorBins();
+
+   double secondsMin = 0.0;
+   for(int iRepeat = 0; iRepeat < k_cAutotuneRepeats; ++iRepeat) {
+      const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+      DataSubsetBoosting * pSubset = pDataSet->GetSubsets();
+      const DataSubsetBoosting * const pSubsetsEnd = pSubset + pDataSet->GetCountSubsets();
+      do {
+         const void * const aWeights = pSubset->GetInnerBag(0)->GetWeights();
+         const size_t cBytesPerFastBin = GetCountBytesPerFastBin(pSubset, bHessian, cScores, nullptr != aWeights);
+         aFastBins->ZeroMem(cBytesPerFastBin, cTensorBins);
+
+         BinSumsBoostingBridge params;
+         params.m_bHessian = bHessian ? EBM_TRUE : EBM_FALSE;
+         params.m_gradHessFormat = gradHessFormat;
+         params.m_cScores = cScores;
+         params.m_cPack = GetCountItemsBitPacked(pTerm->GetBitsRequiredMin(), pSubset->GetObjectiveWrapper()->m_cUIntBytes);
+         params.m_cSamples = pSubset->GetCountSamples();
+         params.m_aGradientsAndHessians = pSubset->GetGradHess();
+         params.m_aWeights = aWeights;
+         params.m_pCountOccurrences = pSubset->GetInnerBag(0)->GetCountOccurrences();
+         params.m_aPacked = pSubset->GetTermData(iTerm);
+         params.m_cBins = cTensorBins;
+         params.m_aFastBins = aFastBins;
+         params.m_aSortScratch = aSortScratch;
+         params.m_cBinRangeShift = nullptr == aSortScratch ? 0 :
+            GetBinRangeShift(cBytesPerFastBin, cTensorBins, cBytesHistogramCache);
+#ifndef NDEBUG
+         params.m_pDebugFastBinsEnd = IndexBin(aFastBins, cBytesPerFastBin * cTensorBins);
+#endif // NDEBUG
+         const ErrorEbm error = pSubset->BinSumsBoosting(&params);
+         if(Error_None != error) {
+            return error;
+         }
+         ++pSubset;
+      } while(pSubsetsEnd != pSubset);
+
+      const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+      const double seconds = elapsed.count();
+      secondsMin = 0 == iRepeat || seconds < secondsMin ? seconds : secondsMin;
+   }
+
+   *pSecondsOut = secondsMin;
+   return Error_None;
+}
+
+static ErrorEbm TimeCandidate(
+   const bool bHessian,
+   const int gradHessFormat,
+   const size_t cScores,
+   const size_t cBytesHistogramCache,
+   const ObjectiveWrapper * const pObjectiveCpu,
+   const ObjectiveWrapper * const pObjectiveSIMD,
+   const unsigned char * const pDataSetShared,
+   const size_t cSharedSamples,
+   const BagEbm * const aBagCalibration,
+   const size_t cCalibrationSamples,
+   const size_t cWeights,
+   const size_t cTerms,
+   const Term * const * const apTerms,
+   const IntEbm * const aiTermFeatures,
+   int * const aBinSumsPlansOut,
+   double * const pSecondsOut
+) {
+   ErrorEbm error;
+
+   DataSetBoosting dataSet;
+   dataSet.SafeInitDataSetBoosting();
+
+   // a single subset per zone is enough since the subsets are binned one at a time
+   error = dataSet.InitDataSetBoosting(
+      true,
+      bHessian,
+      gradHessFormat,
+      false,
+      false,
+      nullptr,
+      cScores,
+      SIZE_MAX,
+      pObjectiveCpu,
+      pObjectiveSIMD,
+      pDataSetShared,
+      BagEbm { 1 },
+      cSharedSamples,
+      aBagCalibration,
+      nullptr,
+      cCalibrationSamples,
+      0,
+      cWeights,
+      cTerms,
+      apTerms,
+      aiTermFeatures,
+      nullptr,
+      nullptr
+   );
+   if(Error_None != error) {
+      dataSet.DestructDataSetBoosting(cTerms, 0);
+      return error;
+   }
+
+   size_t cBytesFastBinsMax = 0;
+   size_t cBytesSortScratchMax = 0;
+   DataSubsetBoosting * pSubset = dataSet.GetSubsets();
+   const DataSubsetBoosting * const pSubsetsEnd = pSubset + dataSet.GetCountSubsets();
+   do {
+      // the gradients are never calculated, but the kernels should not be summing uninitialized memory.  All our
+      // gradient formats represent zero with zeroed bytes
+      const size_t cBytesGradHess = GetCountBytesGradHessItem(gradHessFormat, pSubset->GetObjectiveWrapper()->m_cFloatBytes) *
+         (bHessian ? size_t { 2 } : size_t { 1 }) * cScores * pSubset->GetCountSamples();
+      memset(pSubset->GetGradHess(), 0, cBytesGradHess);
+
+      const size_t cBytesPerFastBin =
+         GetCountBytesPerFastBin(pSubset, bHessian, cScores, nullptr != pSubset->GetInnerBag(0)->GetWeights());
+      for(size_t iTerm = 0; iTerm < cTerms; ++iTerm) {
+         // BoosterCore::Create checked that the fast bins of the biggest term fit in memory
+         cBytesFastBinsMax = EbmMax(cBytesFastBinsMax, cBytesPerFastBin * apTerms[iTerm]->GetCountTensorBins());
+      }
+      cBytesSortScratchMax = EbmMax(cBytesSortScratchMax,
+         size_t { 2 } * pSubset->GetObjectiveWrapper()->m_cUIntBytes * pSubset->GetCountSamples());
+      ++pSubset;
+   } while(pSubsetsEnd != pSubset);
+
+   BinBase * const aFastBins = static_cast<BinBase *>(AlignedAlloc(cBytesFastBinsMax));
+   void * const aSortScratch = AlignedAlloc(cBytesSortScratchMax);
+   if(nullptr == aFastBins || nullptr == aSortScratch) {
+      LOG_0(Trace_Warning, "WARNING TimeCandidate out of memory");
+      AlignedFree(aFastBins);
+      AlignedFree(aSortScratch);
+      dataSet.DestructDataSetBoosting(cTerms, 0);
+      return Error_OutOfMemory;
+   }
+
+   double secondsTotal = 0.0;
+   for(size_t iTerm = 0; iTerm < cTerms; ++iTerm) {
+      const Term * const pTerm = apTerms[iTerm];
+      aBinSumsPlansOut[iTerm] = k_binSumsPlanHeuristic;
+      if(0 == pTerm->GetCountRealDimensions()) {
+         // there is no term data to bin, so GenerateTermUpdate sums these into a single bin
+         continue;
+      }
+
+      double secondsDirect;
+      error = TimeBinSums(
+         &dataSet,
+         bHessian,
+         gradHessFormat,
+         cScores,
+         cBytesHistogramCache,
+         pTerm,
+         iTerm,
+         aFastBins,
+         nullptr,
+         &secondsDirect
+      );
+      if(Error_None != error) {
+         break;
+      }
+
+      double secondsSorted;
+      error = TimeBinSums(
+         &dataSet,
+         bHessian,
+         gradHessFormat,
+         cScores,
+         cBytesHistogramCache,
+         pTerm,
+         iTerm,
+         aFastBins,
+         aSortScratch,
+         &secondsSorted
+      );
+      if(Error_None != error) {
+         break;
+      }
+
+      if(secondsSorted < secondsDirect) {
+         aBinSumsPlansOut[iTerm] = k_binSumsPlanSorted;
+         secondsTotal += secondsSorted;
+      } else {
+         aBinSumsPlansOut[iTerm] = k_binSumsPlanDirect;
+         secondsTotal += secondsDirect;
+      }
+   }
+
+   AlignedFree(aFastBins);
+   AlignedFree(aSortScratch);
+   dataSet.DestructDataSetBoosting(cTerms, 0);
+
+   *pSecondsOut = secondsTotal;
+   return error;
+}
+
+extern ErrorEbm Autotune(
+   const bool bHessian,
+   const int gradHessFormat,
+   const size_t cScores,
+   const size_t cBytesHistogramCache,
+   const ObjectiveWrapper * const pObjectiveCpu,
+   const size_t cCandidates,
+   const ObjectiveWrapper * const aObjectivesSIMD,
+   const unsigned char * const pDataSetShared,
+   const size_t cSharedSamples,
+   const BagEbm * const aBag,
+   const size_t cWeights,
+   const size_t cTerms,
+   Term * const * const apTerms,
+   const IntEbm * const aiTermFeatures,
+   size_t * const piCandidateOut
+) {
+   // Times BinSumsBoosting for each candidate SIMD zone on the first training samples, with and without sorting
+   // the samples by bin range.  The zone is shared by all terms since the gradients and term data of each subset
+   // are laid out for a single zone, but the kernel is chosen per term.  We return the index of the fastest
+   // candidate and set the BinSums plan of each term to the fastest kernel of that candidate.
+
+   LOG_N(Trace_Info, "Entered Autotune: cCandidates=%zu", cCandidates);
+
+   EBM_ASSERT(1 <= cCandidates);
+   EBM_ASSERT(1 <= cSharedSamples);
+   EBM_ASSERT(1 <= cTerms);
+   EBM_ASSERT(nullptr != piCandidateOut);
+
+   if(IsMultiplyError(sizeof(BagEbm), cSharedSamples) || IsMultiplyError(sizeof(int), cTerms, cCandidates)) {
+      LOG_0(Trace_Warning, "WARNING Autotune IsMultiplyError(sizeof(BagEbm), cSharedSamples)");
+      return Error_OutOfMemory;
+   }
+   BagEbm * const aBagCalibration = static_cast<BagEbm *>(malloc(sizeof(BagEbm) * cSharedSamples));
+   int * const aaBinSumsPlans = static_cast<int *>(malloc(sizeof(int) * cTerms * cCandidates));
+   if(nullptr == aBagCalibration || nullptr == aaBinSumsPlans) {
+      LOG_0(Trace_Warning, "WARNING Autotune out of memory");
+      free(aBagCalibration);
+      free(aaBinSumsPlans);
+      return Error_OutOfMemory;
+   }
+
+   size_t cCalibrationSamples = 0;
+   for(size_t iSample = 0; iSample < cSharedSamples; ++iSample) {
+      const BagEbm replication = nullptr == aBag ? BagEbm { 1 } : aBag[iSample];
+      BagEbm calibration = 0;
+      if(BagEbm { 0 } < replication && cCalibrationSamples < k_cAutotuneSamplesMax) {
+         calibration = 1;
+         ++cCalibrationSamples;
+      }
+      aBagCalibration[iSample] = calibration;
+   }
+   EBM_ASSERT(1 <= cCalibrationSamples);
+
+   ErrorEbm error = Error_None;
+   size_t iCandidateBest = 0;
+   double secondsBest = 0.0;
+   for(size_t iCandidate = 0; iCandidate < cCandidates; ++iCandidate) {
+      const ObjectiveWrapper * const pObjectiveSIMD = &aObjectivesSIMD[iCandidate];
+      double seconds;
+      error = TimeCandidate(
+         bHessian,
+         gradHessFormat,
+         cScores,
+         cBytesHistogramCache,
+         pObjectiveCpu,
+         pObjectiveSIMD,
+         pDataSetShared,
+         cSharedSamples,
+         aBagCalibration,
+         cCalibrationSamples,
+         cWeights,
+         cTerms,
+         apTerms,
+         aiTermFeatures,
+         &aaBinSumsPlans[cTerms * iCandidate],
+         &seconds
+      );
+      if(Error_None != error) {
+         break;
+      }
+      LOG_N(Trace_Info, "INFO Autotune zone %s binned %zu samples in %le seconds",
+         GetZoneName(pObjectiveSIMD), cCalibrationSamples, seconds);
+
+      // on ties keep the earlier candidate, which is the zone we would have used without autotuning
+      if(0 == iCandidate || seconds < secondsBest) {
+         iCandidateBest = iCandidate;
+         secondsBest = seconds;
+      }
+   }
+
+   if(Error_None == error) {
+      const ObjectiveWrapper * const pObjectiveBest = &aObjectivesSIMD[iCandidateBest];
+      const size_t cUIntBytes =
+         nullptr == pObjectiveBest->m_pObjective ? pObjectiveCpu->m_cUIntBytes : pObjectiveBest->m_cUIntBytes;
+      LOG_N(Trace_Info, "INFO Autotune chose zone %s", GetZoneName(pObjectiveBest));
+      for(size_t iTerm = 0; iTerm < cTerms; ++iTerm) {
+         Term * const pTerm = apTerms[iTerm];
+         const int binSumsPlan = aaBinSumsPlans[cTerms * iCandidateBest + iTerm];
+         pTerm->SetBinSumsPlan(binSumsPlan);
+         if(0 != pTerm->GetCountRealDimensions()) {
+            LOG_N(Trace_Info, "INFO Autotune term %zu: bins=%zu, scores=%zu, pack=%d, plan=%s",
+               iTerm,
+               pTerm->GetCountTensorBins(),
+               cScores,
+               GetCountItemsBitPacked(pTerm->GetBitsRequiredMin(), cUIntBytes),
+               GetBinSumsPlanName(binSumsPlan)
+            );
+         }
+      }
+      *piCandidateOut = iCandidateBest;
+   }
+
+   free(aBagCalibration);
+   free(aaBinSumsPlans);
+
+   LOG_0(Trace_Info, "Exited Autotune");
+   return error;
+}
+
+} // DEFINED_ZONE_NAME
@@ -0,0 +1,288 @@
+// Copyright (c) 2023 The InterpretML Contributors
+// Licensed under the MIT license.
+// Author: Paul Koch <code@koch.ninja>
+
+#include "pch.hpp"
+
+#include <stdlib.h> // malloc, free
+#include <stddef.h> // size_t, ptrdiff_t
+#include <limits> // numeric_limits
+#include <cmath> // isnan
+
+#include "libebm.h" // ErrorEbm
+#include "logging.h" // EBM_ASSERT
+#include "zones.h"
+
+#include "ebm_internal.hpp" // k_cDimensionsMax
+#include "Term.hpp"
+#include "BoosterCore.hpp"
+#include "BoosterShell.hpp"
+
+namespace DEFINED_ZONE_NAME {
+#ifndef DEFINED_ZONE_NAME
+#error DEFINED_ZONE_NAME must be defined
+#endif // DEFINED_ZONE_NAME
+
+// the greedy rounds pick the term with the highest gain, and on ties the lowest term index
+INLINE_ALWAYS static bool IsHigherPriority(const double * const aGains, const size_t iTerm1, const size_t iTerm2) {
+   return aGains[iTerm2] < aGains[iTerm1] || (aGains[iTerm1] == aGains[iTerm2] && iTerm1 < iTerm2);
+}
+
+static void SiftDown(const double * const aGains, size_t * const aHeap, const size_t cHeap, size_t iHeap) {
+   while(true) {
+      size_t iBest = iHeap;
+      const size_t iLeft = (iHeap << 1) + size_t { 1 };
+      const size_t iRight = iLeft + size_t { 1 };
+      if(iLeft < cHeap && IsHigherPriority(aGains, aHeap[iLeft], aHeap[iBest])) {
+         iBest = iLeft;
+      }
+      if(iRight < cHeap && IsHigherPriority(aGains, aHeap[iRight], aHeap[iBest])) {
+         iBest = iRight;
+      }
+      if(iBest == iHeap) {
+         return;
+      }
+      const size_t iTerm = aHeap[iHeap];
+      aHeap[iHeap] = aHeap[iBest];
+      aHeap[iBest] = iTerm;
+      iHeap = iBest;
+   }
+}
+
+// we made this a global because if we had put this variable inside the BoosterCore object, then we would need to dereference that before
+// getting the count.  By making this global we can send a log message incase a bad BoosterCore object is sent into us
+// we only decrease the count if the count is non-zero, so at worst if there is a race condition then we'll output this log message more
+// times than desired, but we can live with that
+static int g_cLogBoostRounds = 10;
+
+EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION BoostRounds(
+   void * rng,
+   BoosterHandle boosterHandle,
+   TermBoostFlags flags,
+   double learningRate,
+   IntEbm minSamplesLeaf,
+   IntEbm leavesMax,
+   double greediness,
+   IntEbm smoothingRounds,
+   IntEbm maxRounds,
+   IntEbm earlyStoppingRounds,
+   double earlyStoppingTolerance,
+   IntEbm * countRoundsOut,
+   double * bestMetricOut
+) {
+   LOG_COUNTED_N(
+      &g_cLogBoostRounds,
+      Trace_Info,
+      Trace_Verbose,
+      "BoostRounds: "
+      "rng=%p, "
+      "boosterHandle=%p, "
+      "flags=0x%" UTermBoostFlagsPrintf ", "
+      "learningRate=%le, "
+      "minSamplesLeaf=%" IntEbmPrintf ", "
+      "leavesMax=%" IntEbmPrintf ", "
+      "greediness=%le, "
+      "smoothingRounds=%" IntEbmPrintf ", "
+      "maxRounds=%" IntEbmPrintf ", "
+      "earlyStoppingRounds=%" IntEbmPrintf ", "
+      "earlyStoppingTolerance=%le, "
+      "countRoundsOut=%p, "
+      "bestMetricOut=%p"
+      ,
+      rng,
+      static_cast<void *>(boosterHandle),
+      static_cast<UTermBoostFlags>(flags), // signed to unsigned conversion is defined behavior in C++
+      learningRate,
+      minSamplesLeaf,
+      leavesMax,
+      greediness,
+      smoothingRounds,
+      maxRounds,
+      earlyStoppingRounds,
+      earlyStoppingTolerance,
+      static_cast<void *>(countRoundsOut),
+      static_cast<void *>(bestMetricOut)
+   );
+
+   ErrorEbm error;
+
+   if(nullptr != countRoundsOut) {
+      *countRoundsOut = IntEbm { 0 };
+   }
+   if(nullptr != bestMetricOut) {
+      *bestMetricOut = std::numeric_limits<double>::infinity();
+   }
+
+   BoosterShell * const pBoosterShell = BoosterShell::GetBoosterShellFromHandle(boosterHandle);
+   if(nullptr == pBoosterShell) {
+      // already logged
+      return Error_IllegalParamVal;
+   }
+   BoosterCore * const pBoosterCore = pBoosterShell->GetBoosterCore();
+   EBM_ASSERT(nullptr != pBoosterCore);
+
+   if(maxRounds < IntEbm { 0 }) {
+      LOG_0(Trace_Error, "ERROR BoostRounds maxRounds cannot be negative");
+      return Error_IllegalParamVal;
+   }
+   if(std::isnan(greediness) || greediness < 0.0) {
+      LOG_0(Trace_Error, "ERROR BoostRounds greediness must be zero or positive");
+      return Error_IllegalParamVal;
+   }
+
+   IntEbm aLeavesMax[k_cDimensionsMax];
+   for(size_t iDimension = 0; iDimension < k_cDimensionsMax; ++iDimension) {
+      aLeavesMax[iDimension] = leavesMax;
+   }
+
+   const size_t cTerms = pBoosterCore->GetCountTerms();
+
+   double * aGains = nullptr;
+   size_t * aHeap = nullptr;
+   if(size_t { 0 } != cTerms) {
+      if(IsMultiplyError(sizeof(*aGains), cTerms) || IsMultiplyError(sizeof(*aHeap), cTerms)) {
+         LOG_0(Trace_Warning, "WARNING BoostRounds IsMultiplyError(sizeof(*aGains), cTerms)");
+         return Error_OutOfMemory;
+      }
+      aGains = static_cast<double *>(malloc(sizeof(*aGains) * cTerms));
+      aHeap = static_cast<size_t *>(malloc(sizeof(*aHeap) * cTerms));
+      if(nullptr == aGains || nullptr == aHeap) {
+         LOG_0(Trace_Warning, "WARNING BoostRounds out of memory");
+         free(aGains);
+         free(aHeap);
+         return Error_OutOfMemory;
+      }
+   }
+
+   // The schedule below intentionally matches the boosting loop in python's _boost.py exactly, including how
+   // the early stopping window is reset, so that the python code can switch between the two without changing
+   // the models it builds.
+
+   // the first round is always cyclic since we need to get the initial gains
+   double greedyPortion = 0.0;
+   double minMetric = std::numeric_limits<double>::infinity();
+   double bpMetric = std::numeric_limits<double>::infinity();
+   IntEbm cNoChangeRun = 0;
+   IntEbm cSmoothingRoundsRemaining = smoothingRounds;
+
+   IntEbm iRound = 0;
+   while(iRound < maxRounds) {
+      TermBoostFlags flagsLocal = flags;
+      if(IntEbm { 0 } < cSmoothingRoundsRemaining) {
+         flagsLocal = static_cast<TermBoostFlags>(static_cast<UTermBoostFlags>(flagsLocal) |
+            static_cast<UTermBoostFlags>(TermBoostFlags_DisableNewtonGain) |
+            static_cast<UTermBoostFlags>(TermBoostFlags_DisableNewtonUpdate) |
+            static_cast<UTermBoostFlags>(TermBoostFlags_RandomSplits));
+      }
+
+      const bool bGreedy = 1.0 <= greedyPortion;
+      for(size_t iStep = 0; iStep < cTerms; ++iStep) {
+         // when greedy we boost the term at the top of the heap, otherwise we cycle through the terms in order
+         const size_t iTerm = bGreedy ? aHeap[0] : iStep;
+
+         double gain;
+         error = GenerateTermUpdate(
+            rng,
+            boosterHandle,
+            static_cast<IntEbm>(iTerm),
+            flagsLocal,
+            learningRate,
+            minSamplesLeaf,
+            aLeavesMax,
+            &gain
+         );
+         if(Error_None != error) {
+            free(aGains);
+            free(aHeap);
+            return error;
+         }
+         aGains[iTerm] = gain;
+         if(bGreedy) {
+            SiftDown(aGains, aHeap, cTerms, 0);
+         }
+
+         if(iStep + size_t { 1 } < cTerms) {
+            // we already know the next term in this round, so let ApplyTermUpdate bin it with the new gradients
+            const size_t iTermNext = bGreedy ? aHeap[0] : iStep + size_t { 1 };
+            error = PrefetchTerm(boosterHandle, static_cast<IntEbm>(iTermNext));
+            if(Error_None != error) {
+               free(aGains);
+               free(aHeap);
+               return error;
+            }
+         }
+
+         double metric;
+         error = ApplyTermUpdate(boosterHandle, &metric);
+         if(Error_None != error) {
+            free(aGains);
+            free(aHeap);
+            return error;
+         }
+         minMetric = minMetric < metric ? minMetric : metric;
+      }
+      if(!bGreedy && size_t { 0 } != cTerms) {
+         // we only need a valid heap at the end of the cyclic round since greedy rounds only start on a round boundary
+         for(size_t iHeap = 0; iHeap < cTerms; ++iHeap) {
+            aHeap[iHeap] = iHeap;
+         }
+         size_t iHeap = cTerms >> 1;
+         while(size_t { 0 } != iHeap) {
+            --iHeap;
+            SiftDown(aGains, aHeap, cTerms, iHeap);
+         }
+      }
+      ++iRound;
+
+      if(IntEbm { 0 } == cNoChangeRun) {
+         bpMetric = minMetric;
+      }
+      if(minMetric + earlyStoppingTolerance < bpMetric) {
+         cNoChangeRun = 0;
+      } else {
+         ++cNoChangeRun;
+      }
+
+      if(bGreedy) {
+         greedyPortion -= 1.0;
+      }
+
+      if(IntEbm { 0 } < cSmoothingRoundsRemaining) {
+         // disable early stopping progress during the smoothing rounds since cuts are chosen randomly,
+         // which will lead to high variance on the validation metric
+         cNoChangeRun = 0;
+         --cSmoothingRoundsRemaining;
+      } else {
+         // do not progress into greedy rounds until we're done with the smoothing rounds
+         greedyPortion += greediness;
+      }
+
+      if(IntEbm { 0 } < earlyStoppingRounds && earlyStoppingRounds <= cNoChangeRun) {
+         break;
+      }
+   }
+
+   free(aGains);
+   free(aHeap);
+
+   if(nullptr != countRoundsOut) {
+      *countRoundsOut = iRound;
+   }
+   if(nullptr != bestMetricOut) {
+      *bestMetricOut = minMetric;
+   }
+
+   LOG_N(
+      Trace_Verbose,
+      "Exited BoostRounds: "
+      "countRounds=%" IntEbmPrintf ", "
+      "bestMetric=%le"
+      ,
+      iRound,
+      minMetric
+   );
+
+   return Error_None;
+}
+
+} // DEFINED_ZONE_NAME
@@ -5,10 +5,16 @@
 #include "pch.hpp"
 
 #include <stdlib.h> // free
+#include <string.h> // memset
 #include <stddef.h> // size_t, ptrdiff_t
 #include <limits> // numeric_limits
+#include <cmath> // isnan
 #include <thread>
 
+#if defined(__linux__)
+#include <unistd.h> // sysconf
+#endif // __linux__
+
 #include "logging.h" // EBM_ASSERT
 
 #include "common.hpp" // IsConvertError, IsMultiplyError
@@ -22,6 +28,8 @@
 #include "InnerBag.hpp" // InnerBag
 #include "TreeNode.hpp" // IsOverflowTreeNodeSize
 #include "SplitPosition.hpp" // IsOverflowSplitPositionSize
+#include "ThreadPool.hpp"
+#include "AucTracker.hpp"
 #include "BoosterCore.hpp"
 
 namespace DEFINED_ZONE_NAME {
@@ -38,6 +46,8 @@ extern ErrorEbm Unbag(
    size_t * const pcValidationSamplesOut
 );
 
+extern ErrorEbm GetMetrics(const char * sObjective, size_t * const pcMetricsOut, int * const aMetricsOut);
+
 extern ErrorEbm GetObjective(
    const Config * const pConfig,
    const char * sObjective,
@@ -46,6 +56,35 @@ extern ErrorEbm GetObjective(
    ObjectiveWrapper * const pSIMDObjectiveWrapperOut
 ) noexcept;
 
+extern ErrorEbm Autotune(
+   const bool bHessian,
+   const int gradHessFormat,
+   const size_t cScores,
+   const size_t cBytesHistogramCache,
+   const ObjectiveWrapper * const pObjectiveCpu,
+   const size_t cCandidates,
+   const ObjectiveWrapper * const aObjectivesSIMD,
+   const unsigned char * const pDataSetShared,
+   const size_t cSharedSamples,
+   const BagEbm * const aBag,
+   const size_t cWeights,
+   const size_t cTerms,
+   Term * const * const apTerms,
+   const IntEbm * const aiTermFeatures,
+   size_t * const piCandidateOut
+);
+
+static size_t DetectCountBytesHistogramCache() {
+   // the fast bins of each subset are filled by a single thread, so the per-core L2 cache is what we want them to fit in
+#if defined(__linux__) && defined(_SC_LEVEL2_CACHE_SIZE)
+   const long cBytes = sysconf(_SC_LEVEL2_CACHE_SIZE);
+   if(0 < cBytes) {
+      return static_cast<size_t>(cBytes);
+   }
+#endif // __linux__
+   return k_cBytesHistogramCacheDefault;
+}
+
 void BoosterCore::DeleteTensors(const size_t cTerms, Tensor ** const apTensors) {
    LOG_0(Trace_Info, "Entered DeleteTensors");
 
@@ -62,6 +101,28 @@ void BoosterCore::DeleteTensors(const size_t cTerms, Tensor ** const apTensors)
    LOG_0(Trace_Info, "Exited DeleteTensors");
 }
 
+ErrorEbm BoosterCore::CopyDirtyTermsToBestModel() {
+   EBM_ASSERT(nullptr != m_apCurrentTermTensors);
+   EBM_ASSERT(nullptr != m_apBestTermTensors);
+
+   size_t iTerm = m_iDirtyTermFirst;
+   while(k_iDirtyTermEnd != iTerm) {
+      EBM_ASSERT(iTerm < m_cTerms);
+      EBM_ASSERT(nullptr != m_apCurrentTermTensors[iTerm]);
+      EBM_ASSERT(nullptr != m_apBestTermTensors[iTerm]);
+      const ErrorEbm error = m_apBestTermTensors[iTerm]->Copy(*m_apCurrentTermTensors[iTerm]);
+      if(Error_None != error) {
+         // the terms not yet copied remain in the list so that the next improvement copies them
+         return error;
+      }
+      const size_t iTermNext = m_aiDirtyTermNext[iTerm];
+      m_aiDirtyTermNext[iTerm] = k_iTermClean;
+      m_iDirtyTermFirst = iTermNext;
+      iTerm = iTermNext;
+   }
+   return Error_None;
+}
+
 ErrorEbm BoosterCore::InitializeTensors(
    const size_t cTerms, 
    const Term * const * const apTerms, 
@@ -128,6 +189,11 @@ ErrorEbm BoosterCore::InitializeTensors(
 BoosterCore::~BoosterCore() {
    // this only gets called after our reference count has been decremented to zero
 
+   // stop the workers before freeing any memory that they could reference
+   if(nullptr == m_pBoosterCoreShared) {
+      ThreadPool::Free(m_pThreadPool);
+   }
+
    m_trainingSet.DestructDataSetBoosting(m_cTerms, m_cInnerBags);
    m_validationSet.DestructDataSetBoosting(m_cTerms, 0);
 
@@ -137,11 +203,21 @@ BoosterCore::~BoosterCore() {
 
    DeleteTensors(m_cTerms, m_apCurrentTermTensors);
    DeleteTensors(m_cTerms, m_apBestTermTensors);
+   free(m_aiDirtyTermNext);
+
+   AucTracker::Free(m_pAucTracker);
 
    FreeObjectiveWrapperInternals(&m_objectiveCpu);
    FreeObjectiveWrapperInternals(&m_objectiveSIMD);
+
+   // release the BoosterCore that owns our thread pool and training term data after we stop using them
+   BoosterCore::Free(m_pBoosterCoreShared);
 };
 
+size_t BoosterCore::GetCountThreads() const {
+   return nullptr == m_pThreadPool ? size_t { 1 } : m_pThreadPool->GetCountThreads();
+}
+
 void BoosterCore::Free(BoosterCore * const pBoosterCore) {
    LOG_0(Trace_Info, "Entered BoosterCore::Free");
    if(nullptr != pBoosterCore) {
@@ -264,6 +340,106 @@ static bool CheckBoosterRestrictions(
    }
 }
 
+ErrorEbm BoosterCore::AutotuneZone(
+   const Config * const pConfig,
+   const char * const sObjective,
+   const size_t cTensorBinsMax,
+   const unsigned char * const pDataSetShared,
+   const size_t cSamples,
+   const BagEbm * const aBag,
+   const size_t cWeights,
+   const IntEbm * const aiTermFeatures
+) {
+   // The candidates are the zone we would normally use, the best zone without AVX-512, which avoids the 
+   // frequency drop that some CPUs take when running AVX-512 instructions, and the CPU zone, which has no 
+   // SIMD setup costs.  Disabling a zone can give us one we already have, so we keep only the distinct ones.
+   static constexpr size_t k_cCandidatesMax = 3;
+   const ComputeFlags aDisableCompute[k_cCandidatesMax] = {
+      m_disableCompute,
+      m_disableCompute | ComputeFlags_AVX512F,
+      m_disableCompute | ComputeFlags_SIMD
+   };
+
+   ErrorEbm error = Error_None;
+
+   ObjectiveWrapper aObjectivesSIMD[k_cCandidatesMax];
+   ComputeFlags aDisableComputeCandidates[k_cCandidatesMax];
+   size_t cCandidates = 0;
+
+   // take ownership of our current SIMD zone. It is returned below if it is the fastest
+   aObjectivesSIMD[0] = m_objectiveSIMD;
+   aDisableComputeCandidates[0] = aDisableCompute[0];
+   InitializeObjectiveWrapperUnfailing(&m_objectiveSIMD);
+   cCandidates = 1;
+
+   for(size_t iDisable = 1; iDisable < k_cCandidatesMax; ++iDisable) {
+      ObjectiveWrapper objectiveCpu;
+      ObjectiveWrapper objectiveSIMD;
+      InitializeObjectiveWrapperUnfailing(&objectiveCpu);
+      InitializeObjectiveWrapperUnfailing(&objectiveSIMD);
+      error = GetObjective(pConfig, sObjective, aDisableCompute[iDisable], &objectiveCpu, &objectiveSIMD);
+      FreeObjectiveWrapperInternals(&objectiveCpu);
+      if(Error_None != error) {
+         FreeObjectiveWrapperInternals(&objectiveSIMD);
+         break;
+      }
+      if(0 != objectiveSIMD.m_cUIntBytes && CheckBoosterRestrictions(this, &objectiveSIMD, cTensorBinsMax)) {
+         FreeObjectiveWrapperInternals(&objectiveSIMD);
+         InitializeObjectiveWrapperUnfailing(&objectiveSIMD);
+      }
+
+      bool bDuplicate = false;
+      for(size_t iCandidate = 0; iCandidate < cCandidates; ++iCandidate) {
+         const ObjectiveWrapper * const pCandidate = &aObjectivesSIMD[iCandidate];
+         // m_zones holds the zones that the objective supports, so we tell the zones apart by their SIMD shape
+         if(nullptr == objectiveSIMD.m_pObjective ? nullptr == pCandidate->m_pObjective : 
+            nullptr != pCandidate->m_pObjective && objectiveSIMD.m_cSIMDPack == pCandidate->m_cSIMDPack && 
+            objectiveSIMD.m_cFloatBytes == pCandidate->m_cFloatBytes) 
+         {
+            bDuplicate = true;
+         }
+      }
+      if(bDuplicate) {
+         FreeObjectiveWrapperInternals(&objectiveSIMD);
+      } else {
+         aObjectivesSIMD[cCandidates] = objectiveSIMD;
+         aDisableComputeCandidates[cCandidates] = aDisableCompute[iDisable];
+         ++cCandidates;
+      }
+   }
+
+   size_t iCandidateBest = 0;
+   if(Error_None == error) {
+      error = Autotune(
+         IsHessian(),
+         m_gradHessFormat,
+         m_cScores,
+         m_cBytesHistogramCache,
+         &m_objectiveCpu,
+         cCandidates,
+         aObjectivesSIMD,
+         pDataSetShared,
+         cSamples,
+         aBag,
+         cWeights,
+         m_cTerms,
+         m_apTerms,
+         aiTermFeatures,
+         &iCandidateBest
+      );
+   }
+
+   for(size_t iCandidate = 0; iCandidate < cCandidates; ++iCandidate) {
+      if(Error_None == error && iCandidateBest == iCandidate) {
+         m_objectiveSIMD = aObjectivesSIMD[iCandidate];
+         m_disableCompute = aDisableComputeCandidates[iCandidate];
+      } else {
+         FreeObjectiveWrapperInternals(&aObjectivesSIMD[iCandidate]);
+      }
+   }
+   return error;
+}
+
 //static int g_TODO_removeThisThreadTest = 0;
 //void TODO_removeThisThreadTest() {
 //   g_TODO_removeThisThreadTest = 1;
@@ -279,14 +455,26 @@ ErrorEbm BoosterCore::Create(
    const unsigned char * const pDataSetShared,
    const BagEbm * const aBag,
    const double * const aInitScores,
+   const BagEbm * const aBagIncluded,
+   const double * const aInitScoresIncluded,
+   BoosterCore * const pBoosterCoreShared,
+   const bool bShareTermData,
    const CreateBoosterFlags flags,
    const ComputeFlags disableCompute,
    const char * const sObjective,
    BoosterCore ** const ppBoosterCoreOut
 ) {
    // experimentalParams isn't used by default.  It's meant to provide an easy way for python or other higher
-   // level languages to pass EXPERIMENTAL temporary parameters easily to the C++ code.
-   UNUSED(experimentalParams);
+   // level languages to pass EXPERIMENTAL temporary parameters easily to the C++ code.  The exception is
+   // when CreateBoosterFlags_Multithreaded is set, in which case a non-NULL experimentalParams[0] holds
+   // the number of threads to use.
+   //
+   // aBagIncluded is nullptr for a normal booster.  When training several outer bags together it holds a 1 for
+   // each sample that aBag includes in either direction, and aInitScoresIncluded holds the init scores of those
+   // samples.  The training set then holds all the included samples with aBag supplying their weights, and the
+   // validation set aliases the training set with the weights of the validation samples, so each sample is
+   // stored once.  If pBoosterCoreShared is non-null we borrow its thread pool and zone, and if bShareTermData
+   // is also true it was created with the same aBagIncluded and we borrow its term data instead of packing our own.
 
    LOG_0(Trace_Info, "Entered BoosterCore::Create");
 
@@ -335,6 +523,38 @@ ErrorEbm BoosterCore::Create(
 
    pBoosterCore->m_bDisableApprox = 0 != (CreateBoosterFlags_DisableApprox & flags) ? EBM_TRUE : EBM_FALSE;
 
+   pBoosterCore->m_bMultithreaded = 0 != (CreateBoosterFlags_Multithreaded & flags);
+   if(nullptr != pBoosterCoreShared) {
+      EBM_ASSERT(nullptr != aBagIncluded);
+      pBoosterCoreShared->AddReferenceCount();
+      pBoosterCore->m_pBoosterCoreShared = pBoosterCoreShared;
+      pBoosterCore->m_pThreadPool = pBoosterCoreShared->m_pThreadPool;
+   } else if(pBoosterCore->m_bMultithreaded) {
+      size_t cThreads = ThreadPool::GetCountThreadsDefault();
+      if(nullptr != experimentalParams) {
+         const double countThreads = experimentalParams[0];
+         if(std::isnan(countThreads) || countThreads < 1.0) {
+            LOG_0(Trace_Error, "ERROR BoosterCore::Create experimentalParams[0] must be a thread count of 1 or more");
+            return Error_IllegalParamVal;
+         }
+         // cap at something reasonable. Each thread gets its own fast bins, so more threads cost memory
+         static constexpr size_t k_cThreadsMax = 4096;
+         cThreads = countThreads < static_cast<double>(k_cThreadsMax) ? static_cast<size_t>(countThreads) : k_cThreadsMax;
+      }
+      LOG_N(Trace_Info, "INFO BoosterCore::Create using %zu threads", cThreads);
+      if(size_t { 2 } <= cThreads) {
+         error = ThreadPool::Create(
+            cThreads,
+            0 != (CreateBoosterFlags_PinThreads & flags),
+            &pBoosterCore->m_pThreadPool
+         );
+         if(Error_None != error) {
+            // already logged
+            return error;
+         }
+      }
+   }
+
    UIntShared countSamples;
    size_t cFeatures;
    size_t cWeights;
@@ -614,10 +834,21 @@ ErrorEbm BoosterCore::Create(
       Config config;
       config.cOutputs = cScores;
       config.isDifferentialPrivacy = 0 != (CreateBoosterFlags_DifferentialPrivacy & flags) ? EBM_TRUE : EBM_FALSE;
+      // boosters that share term data need to use the same zone, which the autotuner might have changed
+      if(nullptr != pBoosterCoreShared) {
+         pBoosterCore->m_disableCompute = pBoosterCoreShared->m_disableCompute;
+      } else if(0 != ((CreateBoosterFlags_EnableSIMD | CreateBoosterFlags_Autotune) & flags)) {
+         // the autotuner starts from this zone and picks among the zones that disableCompute leaves enabled, so 
+         // masking off the SIMD zones here would leave it with only the CPU zone to choose from
+         pBoosterCore->m_disableCompute = disableCompute;
+      } else {
+         // the SIMD zones round differently than the CPU zone, so they are opt-in
+         pBoosterCore->m_disableCompute = disableCompute | ComputeFlags_SIMD;
+      }
       error = GetObjective(
          &config,
          sObjective, 
-         disableCompute,
+         pBoosterCore->m_disableCompute,
          &pBoosterCore->m_objectiveCpu,
          &pBoosterCore->m_objectiveSIMD
       );
@@ -639,6 +870,34 @@ ErrorEbm BoosterCore::Create(
             return Error_IllegalParamVal;
          }
       }
+
+      error = GetMetrics(sObjective, &pBoosterCore->m_cMetrics, pBoosterCore->m_aMetrics);
+      if(Error_None != error) {
+         // already logged
+         return error;
+      }
+      bool bAuc = false;
+      for(size_t iMetric = 0; iMetric < pBoosterCore->m_cMetrics; ++iMetric) {
+         const int metric = pBoosterCore->m_aMetrics[iMetric];
+         if(k_metricLogLoss == metric) {
+            // both of the classification objectives are log_loss, so their metric is the log loss
+            if(!IsClassification(cClasses)) {
+               LOG_0(Trace_Error, "ERROR BoosterCore::Create the log_loss metric requires classification");
+               return Error_ObjectiveParamMismatchWithConfig;
+            }
+         } else if(k_metricObjective != metric) {
+            // the probability metrics are fused into the binary log_loss objective's validation pass
+            if(!IsClassification(cClasses) || size_t { 1 } != cScores) {
+               LOG_0(Trace_Error, "ERROR BoosterCore::Create the auc, brier, and calibration_error metrics require binary classification");
+               return Error_ObjectiveParamMismatchWithConfig;
+            }
+            if(k_metricAuc == metric) {
+               bAuc = true;
+            } else {
+               pBoosterCore->m_bProbabilityMetrics = true;
+            }
+         }
+      }
       if(0 != cTerms) {
          if(0 != cSamples) {
             if(EBM_FALSE != pBoosterCore->CheckTargets(cSamples, aTargets)) {
@@ -665,21 +924,68 @@ ErrorEbm BoosterCore::Create(
                // already logged
                return error;
             }
+            if(nullptr != aBagIncluded) {
+               if(size_t { 0 } != cInnerBags) {
+                  LOG_0(Trace_Error, "ERROR BoosterCore::Create inner bags are not supported when training outer bags together");
+                  return Error_IllegalParamVal;
+               }
+               size_t cValidationSamplesUnused;
+               error = Unbag(cSamples, aBagIncluded, &cTrainingSamples, &cValidationSamplesUnused);
+               if(Error_None != error) {
+                  // already logged
+                  return error;
+               }
+               EBM_ASSERT(size_t { 0 } == cValidationSamplesUnused);
+            }
+
+            const bool bHessian = pBoosterCore->IsHessian();
+            // objectives without hessians (RMSE) accumulate residuals in their gradients, so keep them in full precision
+            if(bHessian && 0 != (CreateBoosterFlags_Bfloat16Gradients & flags)) {
+               pBoosterCore->m_gradHessFormat = k_gradHessBfloat16;
+            }
+
+            pBoosterCore->m_cBytesHistogramCache = DetectCountBytesHistogramCache();
+
+            if(0 != (CreateBoosterFlags_Autotune & flags) && 0 != cTrainingSamples) {
+               if(nullptr != pBoosterCoreShared) {
+                  // we already have the zone of the shared booster, and its terms were timed on similar samples
+                  for(size_t iTerm = 0; iTerm < cTerms; ++iTerm) {
+                     pBoosterCore->m_apTerms[iTerm]->SetBinSumsPlan(pBoosterCoreShared->m_apTerms[iTerm]->GetBinSumsPlan());
+                  }
+               } else {
+                  error = pBoosterCore->AutotuneZone(
+                     &config,
+                     sObjective,
+                     cTensorBinsMax,
+                     pDataSetShared,
+                     cSamples,
+                     nullptr == aBagIncluded ? aBag : aBagIncluded,
+                     cWeights,
+                     aiTermFeatures
+                  );
+                  if(Error_None != error) {
+                     return error;
+                  }
+               }
+            }
 
             // if we have 32 bit floats or ints, then we need to break large datasets into smaller data subsets
             // because float32 values stop incrementing at 2^24 where the value 1 is below the threshold incrementing a float
+            // When multithreaded we also need multiple subsets since the subsets are the unit of work handed to
+            // the threads.  The subset size does not depend on the thread count, so our results are identical
+            // for any number of threads.
             const bool bForceMultipleSubsets =
+               pBoosterCore->m_bMultithreaded ||
                sizeof(UIntSmall) == pBoosterCore->m_objectiveCpu.m_cUIntBytes ||
                sizeof(FloatSmall) == pBoosterCore->m_objectiveCpu.m_cFloatBytes ||
                sizeof(UIntSmall) == pBoosterCore->m_objectiveSIMD.m_cUIntBytes ||
                sizeof(FloatSmall) == pBoosterCore->m_objectiveSIMD.m_cFloatBytes;
 
-            const bool bHessian = pBoosterCore->IsHessian();
-
             pBoosterCore->m_cInnerBags = cInnerBags; // this is used to destruct m_trainingSet, so store it first
             error = pBoosterCore->m_trainingSet.InitDataSetBoosting(
                true,
                bHessian,
+               pBoosterCore->m_gradHessFormat,
                !pBoosterCore->IsRmse(),
                !pBoosterCore->IsRmse(),
                rng,
@@ -690,43 +996,111 @@ ErrorEbm BoosterCore::Create(
                pDataSetShared,
                BagEbm { 1 },
                cSamples,
-               aBag,
-               aInitScores,
+               nullptr == aBagIncluded ? aBag : aBagIncluded,
+               nullptr == aBagIncluded ? aInitScores : aInitScoresIncluded,
                cTrainingSamples,
                cInnerBags,
                cWeights,
                cTerms,
                pBoosterCore->m_apTerms,
-               aiTermFeatures
+               aiTermFeatures,
+               nullptr == aBagIncluded ? nullptr : aBag,
+               bShareTermData ? &pBoosterCoreShared->m_trainingSet : nullptr
             );
             if(Error_None != error) {
                return error;
             }
 
-            error = pBoosterCore->m_validationSet.InitDataSetBoosting(
-               pBoosterCore->IsRmse(),
-               false,
-               !pBoosterCore->IsRmse(),
-               !pBoosterCore->IsRmse(),
-               rng,
-               cScores,
-               bForceMultipleSubsets ? k_cSubsetSamplesMax : SIZE_MAX,
-               &pBoosterCore->m_objectiveCpu,
-               &pBoosterCore->m_objectiveSIMD,
-               pDataSetShared,
-               BagEbm { -1 },
-               cSamples,
-               aBag,
-               aInitScores,
-               cValidationSamples,
-               0,
-               cWeights,
-               cTerms,
-               pBoosterCore->m_apTerms,
-               aiTermFeatures
-            );
-            if(Error_None != error) {
-               return error;
+            const bool bAlias = nullptr != aBagIncluded && 0 != cValidationSamples;
+            if(!bAlias) {
+               error = pBoosterCore->m_validationSet.InitDataSetBoosting(
+                  pBoosterCore->IsRmse(),
+                  false,
+                  k_gradHessFloat,
+                  !pBoosterCore->IsRmse(),
+                  !pBoosterCore->IsRmse(),
+                  rng,
+                  cScores,
+                  bForceMultipleSubsets ? k_cSubsetSamplesMax : SIZE_MAX,
+                  &pBoosterCore->m_objectiveCpu,
+                  &pBoosterCore->m_objectiveSIMD,
+                  pDataSetShared,
+                  BagEbm { -1 },
+                  cSamples,
+                  aBag,
+                  aInitScores,
+                  cValidationSamples,
+                  0,
+                  cWeights,
+                  cTerms,
+                  pBoosterCore->m_apTerms,
+                  aiTermFeatures,
+                  nullptr,
+                  nullptr
+               );
+               if(Error_None != error) {
+                  return error;
+               }
+            }
+
+            const bool bPinned = nullptr != pBoosterCore->m_pThreadPool && pBoosterCore->m_pThreadPool->IsPinned();
+            if(bPinned) {
+               // ApplyTermUpdate and the binning run training subset iSubset as task iSubset, and ApplyTermUpdate
+               // runs the validation subsets as the tasks after the training subsets, so place them the same way
+               error = pBoosterCore->m_trainingSet.PlaceSubsets(
+                  pBoosterCore->m_pThreadPool,
+                  0,
+                  bHessian,
+                  pBoosterCore->m_gradHessFormat,
+                  IsClassification(cClasses),
+                  cScores,
+                  cTerms,
+                  pBoosterCore->m_apTerms,
+                  cInnerBags
+               );
+               if(Error_None != error) {
+                  return error;
+               }
+            }
+
+            if(bAlias) {
+               // the samples were already placed, so alias them after PlaceSubsets moved them
+               error = pBoosterCore->m_validationSet.InitDataSetBoostingAlias(
+                  &pBoosterCore->m_trainingSet,
+                  pDataSetShared,
+                  BagEbm { -1 },
+                  aBagIncluded,
+                  aBag,
+                  cWeights
+               );
+               if(Error_None != error) {
+                  return error;
+               }
+            }
+
+            if(bPinned) {
+               // an alias runs its subsets on the same tasks as the training subsets since they share the samples
+               error = pBoosterCore->m_validationSet.PlaceSubsets(
+                  pBoosterCore->m_pThreadPool,
+                  bAlias ? size_t { 0 } : pBoosterCore->m_trainingSet.GetCountSubsets(),
+                  false,
+                  k_gradHessFloat,
+                  IsClassification(cClasses),
+                  cScores,
+                  cTerms,
+                  pBoosterCore->m_apTerms,
+                  0
+               );
+               if(Error_None != error) {
+                  return error;
+               }
+            }
+
+            if(bAuc && 0 != cValidationSamples) {
+               error = AucTracker::Create(&pBoosterCore->m_validationSet, &pBoosterCore->m_pAucTracker);
+               if(Error_None != error) {
+                  return error;
+               }
             }
 
             size_t cBytesPerFastBinMax = 0;
@@ -787,7 +1161,54 @@ ErrorEbm BoosterCore::Create(
                LOG_0(Trace_Warning, "WARNING BoosterCore::Create IsMultiplyError(cBytesPerFastBinMax, cTensorBinsMax)");
                return Error_OutOfMemory;
             }
-            pBoosterCore->m_cBytesFastBins = cBytesPerFastBinMax * cTensorBinsMax;
+            size_t cBytesFastBins = cBytesPerFastBinMax * cTensorBinsMax;
+            if(size_t { 2 } <= pBoosterCore->GetCountFastBinsParallel()) {
+               // each thread gets its own fast bins. Keep them aligned for SIMD and on separate cache lines
+               if(IsAddError(cBytesFastBins, SIMD_BYTE_ALIGNMENT - size_t { 1 })) {
+                  LOG_0(Trace_Warning, "WARNING BoosterCore::Create IsAddError(cBytesFastBins, SIMD_BYTE_ALIGNMENT - 1)");
+                  return Error_OutOfMemory;
+               }
+               cBytesFastBins = (cBytesFastBins + SIMD_BYTE_ALIGNMENT - size_t { 1 }) & ~(SIMD_BYTE_ALIGNMENT - size_t { 1 });
+               if(IsMultiplyError(cBytesFastBins, pBoosterCore->GetCountFastBinsParallel())) {
+                  LOG_0(Trace_Warning, "WARNING BoosterCore::Create IsMultiplyError(cBytesFastBins, GetCountFastBinsParallel())");
+                  return Error_OutOfMemory;
+               }
+            }
+            pBoosterCore->m_cBytesFastBins = cBytesFastBins;
+
+            bool bSortedPlan = false;
+            for(size_t iTerm = 0; iTerm < cTerms; ++iTerm) {
+               bSortedPlan = bSortedPlan || k_binSumsPlanSorted == pBoosterCore->m_apTerms[iTerm]->GetBinSumsPlan();
+            }
+            if(0 != cTrainingSamples && 
+               (bSortedPlan || pBoosterCore->m_cBytesHistogramCache < cBytesPerFastBinMax * cTensorBinsMax)) {
+               // terms with fast bins that do not fit in the cache, or that the autotuner found faster to sort, are 
+               // binned by first sorting the samples by bin range, which needs space for the bin and the sorted 
+               // position of each sample in the subset
+               size_t cBytesSortScratch = 0;
+               DataSubsetBoosting * pSubset = pBoosterCore->GetTrainingSet()->GetSubsets();
+               const DataSubsetBoosting * const pSubsetsEnd = pSubset + pBoosterCore->GetTrainingSet()->GetCountSubsets();
+               do {
+                  const size_t cUIntBytes = pSubset->GetObjectiveWrapper()->m_cUIntBytes;
+                  if(IsMultiplyError(size_t { 2 } * cUIntBytes, pSubset->GetCountSamples())) {
+                     LOG_0(Trace_Warning, "WARNING BoosterCore::Create IsMultiplyError(size_t { 2 } * cUIntBytes, pSubset->GetCountSamples())");
+                     return Error_OutOfMemory;
+                  }
+                  cBytesSortScratch = EbmMax(cBytesSortScratch, size_t { 2 } * cUIntBytes * pSubset->GetCountSamples());
+                  ++pSubset;
+               } while(pSubsetsEnd != pSubset);
+
+               if(IsAddError(cBytesSortScratch, SIMD_BYTE_ALIGNMENT - size_t { 1 })) {
+                  LOG_0(Trace_Warning, "WARNING BoosterCore::Create IsAddError(cBytesSortScratch, SIMD_BYTE_ALIGNMENT - 1)");
+                  return Error_OutOfMemory;
+               }
+               cBytesSortScratch = (cBytesSortScratch + SIMD_BYTE_ALIGNMENT - size_t { 1 }) & ~(SIMD_BYTE_ALIGNMENT - size_t { 1 });
+               if(IsMultiplyError(cBytesSortScratch, pBoosterCore->GetCountFastBinsParallel())) {
+                  LOG_0(Trace_Warning, "WARNING BoosterCore::Create IsMultiplyError(cBytesSortScratch, GetCountFastBinsParallel())");
+                  return Error_OutOfMemory;
+               }
+               pBoosterCore->m_cBytesSortScratch = cBytesSortScratch;
+            }
 
             if(IsOverflowBinSize<FloatMain, UIntMain>(bHessian, cScores)) {
                LOG_0(Trace_Warning, "WARNING BoosterCore::Create bin size overflow");
@@ -851,6 +1272,22 @@ ErrorEbm BoosterCore::Create(
          if(Error_None != error) {
             return error;
          }
+
+         if(IsMultiplyError(sizeof(*pBoosterCore->m_aiDirtyTermNext), cTerms)) {
+            LOG_0(Trace_Warning, "WARNING BoosterCore::Create IsMultiplyError(sizeof(*m_aiDirtyTermNext), cTerms)");
+            return Error_OutOfMemory;
+         }
+         size_t * const aiDirtyTermNext = static_cast<size_t *>(malloc(sizeof(*aiDirtyTermNext) * cTerms));
+         if(UNLIKELY(nullptr == aiDirtyTermNext)) {
+            LOG_0(Trace_Warning, "WARNING BoosterCore::Create nullptr == aiDirtyTermNext");
+            return Error_OutOfMemory;
+         }
+         pBoosterCore->m_aiDirtyTermNext = aiDirtyTermNext;
+         size_t iTermInit = 0;
+         do {
+            aiDirtyTermNext[iTermInit] = k_iTermNeverBoosted;
+            ++iTermInit;
+         } while(cTerms != iTermInit);
       }
    }
 
@@ -886,14 +1323,17 @@ ErrorEbm BoosterCore::InitializeBoosterGradientsAndHessians(
          data.m_cScores = cScores;
          data.m_cPack = k_cItemsPerBitPackNone;
          data.m_bHessianNeeded = IsHessian() ? EBM_TRUE : EBM_FALSE;
+         data.m_gradHessFormat = GetGradHessFormat();
          data.m_bDisableApprox = IsDisableApprox();
          data.m_bValidation = EBM_FALSE;
+         data.m_bProbabilityMetrics = EBM_FALSE;
          data.m_aMulticlassMidwayTemp = aMulticlassMidwayTemp;
          // if FloatScore is type FloatSmall then some of the zones might use FloatBig as their type and then read 
          // past the end of the aUpdateScores memory, which should always contain zeros.If we want to handle this 
          // scenario then we need to allocate a larger buffer of memory to zero out instead of using aUpdateScores
          EBM_ASSERT(pSubset->GetObjectiveWrapper()->m_cFloatBytes <= sizeof(FloatScore));
          data.m_aUpdateTensorScores = aUpdateScores;
+         data.m_cTensorBins = 1;
          data.m_cSamples = pSubset->GetCountSamples();
          data.m_aPacked = nullptr;
          data.m_aTargets = pSubset->GetTargetData();
@@ -11,6 +11,7 @@
 #include <atomic>
 
 #include "libebm.h" // ErrorEbm
+#include "logging.h" // EBM_ASSERT
 #include "unzoned.h"
 
 #include "zones.h"
@@ -29,6 +30,8 @@ class FeatureBoosting;
 class Term;
 struct InnerBag;
 class Tensor;
+class ThreadPool;
+class AucTracker;
 
 class BoosterCore final {
 
@@ -41,6 +44,8 @@ class BoosterCore final {
 
    size_t m_cScores;
    BoolEbm m_bDisableApprox;
+   bool m_bMultithreaded;
+   int m_gradHessFormat;
 
    size_t m_cFeatures;
    FeatureBoosting * m_aFeatures;
@@ -53,11 +58,32 @@ class BoosterCore final {
    Tensor ** m_apCurrentTermTensors;
    Tensor ** m_apBestTermTensors;
 
+   // Terms boosted on since the best model was last updated form a reversed linked list through this flat array
+   // so that an improvement only needs to copy those terms into the best model.  A term already in the list is not
+   // added again.  Each entry holds the index of the next dirty term, k_iDirtyTermEnd for the last one in the list,
+   // k_iTermClean if the best model holds the current tensor, or k_iTermNeverBoosted if no update has been applied
+   // to the term yet, in which case both of its tensors are still zero.
+   static constexpr size_t k_iDirtyTermEnd = std::numeric_limits<size_t>::max();
+   static constexpr size_t k_iTermClean = std::numeric_limits<size_t>::max() - size_t { 1 };
+   static constexpr size_t k_iTermNeverBoosted = std::numeric_limits<size_t>::max() - size_t { 2 };
+   size_t * m_aiDirtyTermNext;
+   size_t m_iDirtyTermFirst;
+
    double m_bestModelMetric;
 
+   // the validation metrics listed after the objective, or just k_metricObjective if none were listed.  They are 
+   // all computed in the same pass over the validation set and the first one drives the best model tracking
+   size_t m_cMetrics;
+   int m_aMetrics[k_cMetricsMax];
+   bool m_bProbabilityMetrics; // true if the brier or calibration_error metrics are fused into ApplyUpdate
+   AucTracker * m_pAucTracker; // not nullptr if one of the metrics is the AUC
+
    size_t m_cBytesFastBins;
    size_t m_cBytesMainBins;
 
+   size_t m_cBytesHistogramCache;
+   size_t m_cBytesSortScratch;
+
    size_t m_cBytesSplitPositions;
    size_t m_cBytesTreeNodes;
 
@@ -66,6 +92,16 @@ class BoosterCore final {
 
    ObjectiveWrapper m_objectiveCpu;
    ObjectiveWrapper m_objectiveSIMD;
+   // the zones disabled when creating m_objectiveSIMD, which CreateBoosterFlags_Autotune can add to
+   ComputeFlags m_disableCompute;
+
+   ThreadPool * m_pThreadPool;
+
+   // if non-null we hold a reference on this BoosterCore and borrow its thread pool, and possibly its term data
+   BoosterCore * m_pBoosterCoreShared;
+
+   // incremented each time the gradients change so that BoosterShells can tell if histograms they built are stale
+   size_t m_iGradientsVersion;
 
    static void DeleteTensors(const size_t cTerms, Tensor ** const apTensors);
 
@@ -76,12 +112,25 @@ class BoosterCore final {
       Tensor *** papTensorsOut
    );
 
+   ErrorEbm AutotuneZone(
+      const Config * const pConfig,
+      const char * const sObjective,
+      const size_t cTensorBinsMax,
+      const unsigned char * const pDataSetShared,
+      const size_t cSamples,
+      const BagEbm * const aBag,
+      const size_t cWeights,
+      const IntEbm * const aiTermFeatures
+   );
+
    ~BoosterCore();
 
    inline BoosterCore() noexcept :
       m_REFERENCE_COUNT(1), // we're not visible on any other thread yet, so no synchronization required
       m_cScores(0),
       m_bDisableApprox(EBM_FALSE),
+      m_bMultithreaded(false),
+      m_gradHessFormat(k_gradHessFloat),
       m_cFeatures(0),
       m_aFeatures(nullptr),
       m_cTerms(0),
@@ -89,11 +138,22 @@ class BoosterCore final {
       m_cInnerBags(0),
       m_apCurrentTermTensors(nullptr),
       m_apBestTermTensors(nullptr),
+      m_aiDirtyTermNext(nullptr),
+      m_iDirtyTermFirst(k_iDirtyTermEnd),
       m_bestModelMetric(std::numeric_limits<double>::infinity()),
+      m_cMetrics(0),
+      m_bProbabilityMetrics(false),
+      m_pAucTracker(nullptr),
       m_cBytesFastBins(0),
       m_cBytesMainBins(0),
+      m_cBytesHistogramCache(k_cBytesHistogramCacheDefault),
+      m_cBytesSortScratch(0),
       m_cBytesSplitPositions(0),
-      m_cBytesTreeNodes(0)
+      m_cBytesTreeNodes(0),
+      m_disableCompute(ComputeFlags_Default),
+      m_pThreadPool(nullptr),
+      m_pBoosterCoreShared(nullptr),
+      m_iGradientsVersion(0)
    {
       m_trainingSet.SafeInitDataSetBoosting();
       m_validationSet.SafeInitDataSetBoosting();
@@ -118,10 +178,40 @@ public:
       return m_cBytesFastBins;
    }
 
+   inline ThreadPool * GetThreadPool() {
+      // nullptr if we are single threaded
+      return m_pThreadPool;
+   }
+
+   size_t GetCountThreads() const;
+
+   inline size_t GetCountFastBinsParallel() const {
+      // we bin at most one subset per thread at a time, and there is no point allocating fast bins for
+      // more threads than there are subsets
+      return EbmMax(size_t { 1 }, EbmMin(GetCountThreads(), m_trainingSet.GetCountSubsets()));
+   }
+
+   inline size_t GetGradientsVersion() const {
+      return m_iGradientsVersion;
+   }
+
+   inline void NextGradientsVersion() {
+      ++m_iGradientsVersion;
+   }
+
    inline size_t GetCountBytesMainBins() const {
       return m_cBytesMainBins;
    }
 
+   inline size_t GetCountBytesHistogramCache() const {
+      return m_cBytesHistogramCache;
+   }
+
+   inline size_t GetCountBytesSortScratch() const {
+      // zero if no term has fast bins larger than GetCountBytesHistogramCache()
+      return m_cBytesSortScratch;
+   }
+
    inline size_t GetCountBytesSplitPositions() const {
       return m_cBytesSplitPositions;
    }
@@ -166,6 +256,45 @@ public:
       m_bestModelMetric = bestModelMetric;
    }
 
+   inline void MarkTermDirty(const size_t iTerm) {
+      EBM_ASSERT(iTerm < m_cTerms);
+      EBM_ASSERT(nullptr != m_aiDirtyTermNext);
+      const size_t iNext = m_aiDirtyTermNext[iTerm];
+      if(k_iTermClean == iNext || k_iTermNeverBoosted == iNext) {
+         m_aiDirtyTermNext[iTerm] = m_iDirtyTermFirst;
+         m_iDirtyTermFirst = iTerm;
+      }
+   }
+
+   inline bool IsTermNeverBoosted(const size_t iTerm) const {
+      EBM_ASSERT(iTerm < m_cTerms);
+      EBM_ASSERT(nullptr != m_aiDirtyTermNext);
+      return k_iTermNeverBoosted == m_aiDirtyTermNext[iTerm];
+   }
+
+   ErrorEbm CopyDirtyTermsToBestModel();
+
+   inline size_t GetCountMetrics() const {
+      return m_cMetrics;
+   }
+
+   inline const int * GetMetricTypes() const {
+      return m_aMetrics;
+   }
+
+   inline bool IsProbabilityMetrics() const {
+      return m_bProbabilityMetrics;
+   }
+
+   inline size_t GetCountValidationSums() const {
+      // the objective's metric, then the brier sum and the calibration bins if we have the probability metrics
+      return m_bProbabilityMetrics ? size_t { 2 } + k_cCalibrationBins : size_t { 1 };
+   }
+
+   inline AucTracker * GetAucTracker() {
+      return m_pAucTracker;
+   }
+
    static void Free(BoosterCore * const pBoosterCore);
 
    static ErrorEbm Create(
@@ -178,6 +307,10 @@ public:
       const unsigned char * const pDataSetShared,
       const BagEbm * const aBag,
       const double * const aInitScores,
+      const BagEbm * const aBagIncluded,
+      const double * const aInitScoresIncluded,
+      BoosterCore * const pBoosterCoreShared,
+      const bool bShareTermData,
       const CreateBoosterFlags flags,
       const ComputeFlags disableCompute,
       const char * const sObjective,
@@ -214,6 +347,17 @@ public:
       return m_bDisableApprox;
    }
 
+   inline int GetGradHessFormat() const {
+      // how the training gradients and hessians are stored.  Always k_gradHessFloat if !IsHessian()
+      return m_gradHessFormat;
+   }
+
+   inline bool IsMultithreaded() const {
+      // true if the caller asked for multithreading, even if we ended up with only 1 thread.  Anything that
+      // changes our results when multithreaded should key off this so that the thread count does not matter
+      return m_bMultithreaded;
+   }
+
    inline double LearningRateAdjustmentDifferentialPrivacy() const noexcept {
       EBM_ASSERT(nullptr != m_objectiveCpu.m_pObjective);
       return m_objectiveCpu.m_learningRateAdjustmentDifferentialPrivacy;
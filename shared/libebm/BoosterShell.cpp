@@ -9,6 +9,7 @@
 #include <string.h> // memcpy
 
 #include "RandomDeterministic.hpp" // RandomDeterministic
+#include "dataset_shared.hpp" // GetDataSetSharedHeader
 
 #include "Feature.hpp" // Feature
 #include "Term.hpp" // Term
@@ -33,18 +34,35 @@ extern void InitializeRmseGradientsAndHessiansBoosting(
    DataSetBoosting * const pDataSet
 );
 
+void BoosterShell::FreeAllocations() {
+   if(nullptr != m_aBagShells) {
+      for(size_t iBagShell = 0; iBagShell < m_cBagShells; ++iBagShell) {
+         m_aBagShells[iBagShell].FreeAllocations();
+      }
+      free(m_aBagShells);
+   }
+   Tensor::Free(m_pTermUpdate);
+   Tensor::Free(m_pInnerTermUpdate);
+   AlignedFree(m_aBoostingFastBinsTemp);
+   AlignedFree(m_aBoostingMainBins);
+   AlignedFree(m_aSortScratchTemp);
+   AlignedFree(m_aMulticlassMidwayTemp);
+   AlignedFree(m_aValidationMetricsTemp);
+   AlignedFree(m_aSplitPositionsTemp);
+   AlignedFree(m_aTreeNodesTemp);
+   AlignedFree(m_aMainsBinsCache);
+   free(m_aiMainsBinsCacheOffset);
+   AlignedFree(m_aMainsFastBinsTemp);
+   AlignedFree(m_aPrefetchFastBins);
+   AlignedFree(m_aPrefetchBins);
+   BoosterCore::Free(m_pBoosterCore);
+}
+
 void BoosterShell::Free(BoosterShell * const pBoosterShell) {
    LOG_0(Trace_Info, "Entered BoosterShell::Free");
 
    if(nullptr != pBoosterShell) {
-      Tensor::Free(pBoosterShell->m_pTermUpdate);
-      Tensor::Free(pBoosterShell->m_pInnerTermUpdate);
-      AlignedFree(pBoosterShell->m_aBoostingFastBinsTemp);
-      AlignedFree(pBoosterShell->m_aBoostingMainBins);
-      AlignedFree(pBoosterShell->m_aMulticlassMidwayTemp);
-      AlignedFree(pBoosterShell->m_aSplitPositionsTemp);
-      AlignedFree(pBoosterShell->m_aTreeNodesTemp);
-      BoosterCore::Free(pBoosterShell->m_pBoosterCore);
+      pBoosterShell->FreeAllocations();
 
       // before we free our memory, indicate it was freed so if our higher level language attempts to use it we have
       // a chance to detect the error
@@ -71,16 +89,19 @@ BoosterShell * BoosterShell::Create(BoosterCore * const pBoosterCore) {
    return pNew;
 }
 
-ErrorEbm BoosterShell::FillAllocations() {
-   EBM_ASSERT(nullptr != m_pBoosterCore);
+ErrorEbm BoosterShell::FillAllocationsInternal(const bool bBagShell) {
+   // bag shells only boost a single inner bag on a single thread, so they do not need the term update, 
+   // more than one set of fast bins, or anything that ApplyTermUpdate uses
 
-   LOG_0(Trace_Info, "Entered BoosterShell::FillAllocations");
+   EBM_ASSERT(nullptr != m_pBoosterCore);
 
    const size_t cScores = m_pBoosterCore->GetCountScores();
    if(size_t { 0 } != cScores) {
-      m_pTermUpdate = Tensor::Allocate(k_cDimensionsMax, cScores);
-      if(nullptr == m_pTermUpdate) {
-         goto failed_allocation;
+      if(!bBagShell) {
+         m_pTermUpdate = Tensor::Allocate(k_cDimensionsMax, cScores);
+         if(nullptr == m_pTermUpdate) {
+            goto failed_allocation;
+         }
       }
 
       m_pInnerTermUpdate = Tensor::Allocate(k_cDimensionsMax, cScores);
@@ -89,12 +110,27 @@ ErrorEbm BoosterShell::FillAllocations() {
       }
 
       if(0 != m_pBoosterCore->GetCountBytesFastBins()) {
-         m_aBoostingFastBinsTemp = static_cast<BinBase *>(AlignedAlloc(m_pBoosterCore->GetCountBytesFastBins()));
+         // BoosterCore::Create checked that this multiplication does not overflow
+         EBM_ASSERT(!IsMultiplyError(m_pBoosterCore->GetCountBytesFastBins(), m_pBoosterCore->GetCountFastBinsParallel()));
+         const size_t cBytesFastBins = m_pBoosterCore->GetCountBytesFastBins() * 
+            (bBagShell ? size_t { 1 } : m_pBoosterCore->GetCountFastBinsParallel());
+         m_aBoostingFastBinsTemp = static_cast<BinBase *>(AlignedAlloc(cBytesFastBins));
          if(nullptr == m_aBoostingFastBinsTemp) {
             goto failed_allocation;
          }
       }
 
+      if(0 != m_pBoosterCore->GetCountBytesSortScratch()) {
+         // BoosterCore::Create checked that this multiplication does not overflow
+         EBM_ASSERT(!IsMultiplyError(m_pBoosterCore->GetCountBytesSortScratch(), m_pBoosterCore->GetCountFastBinsParallel()));
+         const size_t cBytesSortScratch = m_pBoosterCore->GetCountBytesSortScratch() * 
+            (bBagShell ? size_t { 1 } : m_pBoosterCore->GetCountFastBinsParallel());
+         m_aSortScratchTemp = AlignedAlloc(cBytesSortScratch);
+         if(nullptr == m_aSortScratchTemp) {
+            goto failed_allocation;
+         }
+      }
+
       if(0 != m_pBoosterCore->GetCountBytesMainBins()) {
          m_aBoostingMainBins = static_cast<BinBase *>(AlignedAlloc(m_pBoosterCore->GetCountBytesMainBins()));
          if(nullptr == m_aBoostingMainBins) {
@@ -102,7 +138,7 @@ ErrorEbm BoosterShell::FillAllocations() {
          }
       }
 
-      if(size_t { 1 } != cScores) {
+      if(!bBagShell && size_t { 1 } != cScores) {
          size_t cBytesMulticlassMidwayMax = 0;
          if(0 != GetBoosterCore()->GetTrainingSet()->GetCountSamples()) {
             DataSubsetBoosting * pSubset = GetBoosterCore()->GetTrainingSet()->GetSubsets();
@@ -140,13 +176,107 @@ ErrorEbm BoosterShell::FillAllocations() {
 
          // if there are zero samples, cFloatBytesMax will be zero
          if(0 != cBytesMulticlassMidwayMax) {
-            m_aMulticlassMidwayTemp = AlignedAlloc(cBytesMulticlassMidwayMax);
+            const size_t cThreads = m_pBoosterCore->GetCountThreads();
+            if(size_t { 2 } <= cThreads) {
+               // each thread gets its own scratch space. Keep them aligned for SIMD and on separate cache lines
+               if(IsAddError(cBytesMulticlassMidwayMax, SIMD_BYTE_ALIGNMENT - size_t { 1 })) {
+                  goto failed_allocation;
+               }
+               cBytesMulticlassMidwayMax = 
+                  (cBytesMulticlassMidwayMax + SIMD_BYTE_ALIGNMENT - size_t { 1 }) & ~(SIMD_BYTE_ALIGNMENT - size_t { 1 });
+               if(IsMultiplyError(cBytesMulticlassMidwayMax, cThreads)) {
+                  goto failed_allocation;
+               }
+            }
+            m_cBytesMulticlassMidwayTemp = cBytesMulticlassMidwayMax;
+            m_aMulticlassMidwayTemp = AlignedAlloc(cBytesMulticlassMidwayMax * cThreads);
             if(nullptr == m_aMulticlassMidwayTemp) {
                goto failed_allocation;
             }
          }
       }
 
+      if(!bBagShell && 0 != GetBoosterCore()->GetValidationSet()->GetCountSamples()) {
+         const size_t cValidationSubsets = GetBoosterCore()->GetValidationSet()->GetCountSubsets();
+         const size_t cValidationSums = GetBoosterCore()->GetCountValidationSums();
+         if(IsMultiplyError(sizeof(*m_aValidationMetricsTemp), cValidationSums, cValidationSubsets)) {
+            goto failed_allocation;
+         }
+         m_aValidationMetricsTemp = static_cast<double *>(
+            AlignedAlloc(sizeof(*m_aValidationMetricsTemp) * cValidationSums * cValidationSubsets));
+         if(nullptr == m_aValidationMetricsTemp) {
+            goto failed_allocation;
+         }
+      }
+
+      if(!bBagShell && size_t { 1 } >= m_pBoosterCore->GetCountInnerBags() && 
+         0 != GetBoosterCore()->GetTrainingSet()->GetCountSamples()) 
+      {
+         // we only cache the main term histograms of the first inner bag, so do not bother with inner bags
+         const size_t cTerms = m_pBoosterCore->GetCountTerms();
+         const size_t cBytesPerMainBin = GetBinSize<FloatMain, UIntMain>(m_pBoosterCore->IsHessian(), cScores);
+         // the fast bins are largest when both the float and the int are big
+         const size_t cBytesPerFastBinMax = GetBinSize<FloatBig, UIntBig>(m_pBoosterCore->IsHessian(), cScores);
+
+         size_t cMainTerms = 0;
+         size_t cBytesMainsBins = 0;
+         size_t cBytesMainsFastBins = 0;
+         for(size_t iTerm = 0; iTerm < cTerms; ++iTerm) {
+            const Term * const pTerm = m_pBoosterCore->GetTerms()[iTerm];
+            if(size_t { 1 } == pTerm->GetCountDimensions() && size_t { 1 } == pTerm->GetCountRealDimensions()) {
+               const size_t cBins = pTerm->GetCountTensorBins();
+               if(IsMultiplyError(cBytesPerMainBin, cBins) || IsMultiplyError(cBytesPerFastBinMax, cBins)) {
+                  goto failed_allocation;
+               }
+               // keep each term's fast bins aligned for SIMD
+               const size_t cBytesFastBins = cBytesPerFastBinMax * cBins;
+               if(IsAddError(cBytesFastBins, SIMD_BYTE_ALIGNMENT - size_t { 1 })) {
+                  goto failed_allocation;
+               }
+               const size_t cBytesFastBinsAligned = 
+                  (cBytesFastBins + SIMD_BYTE_ALIGNMENT - size_t { 1 }) & ~(SIMD_BYTE_ALIGNMENT - size_t { 1 });
+               if(IsAddError(cBytesMainsBins, cBytesPerMainBin * cBins) || 
+                  IsAddError(cBytesMainsFastBins, cBytesFastBinsAligned)) 
+               {
+                  goto failed_allocation;
+               }
+               cBytesMainsBins += cBytesPerMainBin * cBins;
+               cBytesMainsFastBins += cBytesFastBinsAligned;
+               ++cMainTerms;
+            }
+         }
+
+         // there is nothing to gain from binning the main terms together unless there are at least two of them
+         if(size_t { 2 } <= cMainTerms) {
+            if(IsMultiplyError(sizeof(*m_aiMainsBinsCacheOffset), cTerms)) {
+               goto failed_allocation;
+            }
+            m_aiMainsBinsCacheOffset = static_cast<size_t *>(malloc(sizeof(*m_aiMainsBinsCacheOffset) * cTerms));
+            if(nullptr == m_aiMainsBinsCacheOffset) {
+               goto failed_allocation;
+            }
+            size_t iByte = 0;
+            for(size_t iTerm = 0; iTerm < cTerms; ++iTerm) {
+               const Term * const pTerm = m_pBoosterCore->GetTerms()[iTerm];
+               if(size_t { 1 } == pTerm->GetCountDimensions() && size_t { 1 } == pTerm->GetCountRealDimensions()) {
+                  m_aiMainsBinsCacheOffset[iTerm] = iByte;
+                  iByte += cBytesPerMainBin * pTerm->GetCountTensorBins();
+               } else {
+                  m_aiMainsBinsCacheOffset[iTerm] = k_notCached;
+               }
+            }
+            EBM_ASSERT(cBytesMainsBins == iByte);
+
+            // each subset that we bin concurrently gets its own fast bins for all the main terms
+            if(IsMultiplyError(cBytesMainsFastBins, m_pBoosterCore->GetCountFastBinsParallel())) {
+               goto failed_allocation;
+            }
+            // the bins themselves are allocated by AllocateMainsBinsCache once our caller reuses the gradients
+            m_cBytesMainsBins = cBytesMainsBins;
+            m_cBytesMainsFastBins = cBytesMainsFastBins;
+         }
+      }
+
       if(0 != m_pBoosterCore->GetCountBytesSplitPositions()) {
          m_aSplitPositionsTemp = AlignedAlloc(m_pBoosterCore->GetCountBytesSplitPositions());
          if(nullptr == m_aSplitPositionsTemp) {
@@ -162,14 +292,262 @@ ErrorEbm BoosterShell::FillAllocations() {
       }
    }
 
-   LOG_0(Trace_Info, "Exited BoosterShell::FillAllocations");
    return Error_None;
 
 failed_allocation:;
-   LOG_0(Trace_Warning, "WARNING Exited BoosterShell::FillAllocations with allocation failure");
+   LOG_0(Trace_Warning, "WARNING BoosterShell::FillAllocationsInternal allocation failure");
    return Error_OutOfMemory;
 }
 
+ErrorEbm BoosterShell::FillAllocations() {
+   EBM_ASSERT(nullptr != m_pBoosterCore);
+
+   LOG_0(Trace_Info, "Entered BoosterShell::FillAllocations");
+
+   ErrorEbm error;
+
+   error = FillAllocationsInternal(false);
+   if(Error_None != error) {
+      return error;
+   }
+
+   const size_t cInnerBags = m_pBoosterCore->GetCountInnerBags();
+   if(m_pBoosterCore->IsMultithreaded() && size_t { 2 } <= cInnerBags && 
+      size_t { 0 } != m_pBoosterCore->GetCountScores() && 0 != m_pBoosterCore->GetTrainingSet()->GetCountSamples()) {
+
+      // we boost up to one inner bag per thread at a time.  We create the bag shells even if we only have 1 thread
+      // so that the inner bags get the same random number streams regardless of the thread count
+      const size_t cBagShells = EbmMin(m_pBoosterCore->GetCountThreads(), cInnerBags);
+      if(IsMultiplyError(sizeof(BoosterShell), cBagShells)) {
+         LOG_0(Trace_Warning, "WARNING BoosterShell::FillAllocations IsMultiplyError(sizeof(BoosterShell), cBagShells)");
+         return Error_OutOfMemory;
+      }
+      BoosterShell * const aBagShells = static_cast<BoosterShell *>(malloc(sizeof(BoosterShell) * cBagShells));
+      if(nullptr == aBagShells) {
+         LOG_0(Trace_Warning, "WARNING BoosterShell::FillAllocations nullptr == aBagShells");
+         return Error_OutOfMemory;
+      }
+      for(size_t iBagShell = 0; iBagShell < cBagShells; ++iBagShell) {
+         // each bag shell holds a reference on the BoosterCore, which it releases in FreeAllocations
+         aBagShells[iBagShell].InitializeUnfailing(m_pBoosterCore);
+         m_pBoosterCore->AddReferenceCount();
+      }
+      m_aBagShells = aBagShells;
+      m_cBagShells = cBagShells;
+
+      for(size_t iBagShell = 0; iBagShell < cBagShells; ++iBagShell) {
+         error = aBagShells[iBagShell].FillAllocationsInternal(true);
+         if(Error_None != error) {
+            return error;
+         }
+      }
+   }
+
+   LOG_0(Trace_Info, "Exited BoosterShell::FillAllocations");
+   return Error_None;
+}
+
+bool BoosterShell::IsPrefetchable(const size_t iTerm) {
+   // we only prefetch main terms, and only for the first inner bag since that is the only one that GenerateTermUpdate
+   // could use when there is exactly one inner bag
+   EBM_ASSERT(nullptr != m_pBoosterCore);
+   EBM_ASSERT(iTerm < m_pBoosterCore->GetCountTerms());
+
+   if(size_t { 0 } == m_pBoosterCore->GetCountScores() || size_t { 1 } < m_pBoosterCore->GetCountInnerBags() ||
+      0 == m_pBoosterCore->GetTrainingSet()->GetCountSamples())
+   {
+      return false;
+   }
+   const Term * const pTerm = m_pBoosterCore->GetTerms()[iTerm];
+   return size_t { 1 } == pTerm->GetCountDimensions() && size_t { 1 } == pTerm->GetCountRealDimensions();
+}
+
+ErrorEbm BoosterShell::AllocatePrefetch() {
+   EBM_ASSERT(nullptr != m_pBoosterCore);
+
+   if(nullptr != m_aPrefetchBins) {
+      return Error_None;
+   }
+
+   LOG_0(Trace_Info, "Entered BoosterShell::AllocatePrefetch");
+
+   const size_t cScores = m_pBoosterCore->GetCountScores();
+   const bool bHessian = m_pBoosterCore->IsHessian();
+   const size_t cBytesPerMainBin = GetBinSize<FloatMain, UIntMain>(bHessian, cScores);
+   // the fast bins are largest when both the float and the int are big
+   const size_t cBytesPerFastBinMax = GetBinSize<FloatBig, UIntBig>(bHessian, cScores);
+
+   size_t cBinsMax = 0;
+   for(size_t iTerm = 0; iTerm < m_pBoosterCore->GetCountTerms(); ++iTerm) {
+      if(IsPrefetchable(iTerm)) {
+         cBinsMax = EbmMax(cBinsMax, m_pBoosterCore->GetTerms()[iTerm]->GetCountTensorBins());
+      }
+   }
+   EBM_ASSERT(size_t { 1 } <= cBinsMax);
+
+   const size_t cSubsets = m_pBoosterCore->GetTrainingSet()->GetCountSubsets();
+   if(IsMultiplyError(cBytesPerMainBin, cBinsMax) || IsMultiplyError(cBytesPerFastBinMax, cBinsMax)) {
+      LOG_0(Trace_Warning, "WARNING BoosterShell::AllocatePrefetch IsMultiplyError(cBytesPerFastBinMax, cBinsMax)");
+      return Error_OutOfMemory;
+   }
+   // keep each subset's fast bins aligned for SIMD and on separate cache lines
+   const size_t cBytesFastBins = cBytesPerFastBinMax * cBinsMax;
+   if(IsAddError(cBytesFastBins, SIMD_BYTE_ALIGNMENT - size_t { 1 })) {
+      LOG_0(Trace_Warning, "WARNING BoosterShell::AllocatePrefetch IsAddError(cBytesFastBins, SIMD_BYTE_ALIGNMENT - 1)");
+      return Error_OutOfMemory;
+   }
+   const size_t cBytesFastBinsAligned =
+      (cBytesFastBins + SIMD_BYTE_ALIGNMENT - size_t { 1 }) & ~(SIMD_BYTE_ALIGNMENT - size_t { 1 });
+   if(IsMultiplyError(cBytesFastBinsAligned, cSubsets)) {
+      LOG_0(Trace_Warning, "WARNING BoosterShell::AllocatePrefetch IsMultiplyError(cBytesFastBinsAligned, cSubsets)");
+      return Error_OutOfMemory;
+   }
+
+   BinBase * const aPrefetchFastBins = static_cast<BinBase *>(AlignedAlloc(cBytesFastBinsAligned * cSubsets));
+   if(nullptr == aPrefetchFastBins) {
+      LOG_0(Trace_Warning, "WARNING BoosterShell::AllocatePrefetch nullptr == aPrefetchFastBins");
+      return Error_OutOfMemory;
+   }
+   BinBase * const aPrefetchBins = static_cast<BinBase *>(AlignedAlloc(cBytesPerMainBin * cBinsMax));
+   if(nullptr == aPrefetchBins) {
+      AlignedFree(aPrefetchFastBins);
+      LOG_0(Trace_Warning, "WARNING BoosterShell::AllocatePrefetch nullptr == aPrefetchBins");
+      return Error_OutOfMemory;
+   }
+   m_aPrefetchFastBins = aPrefetchFastBins;
+   m_cBytesPrefetchFastBins = cBytesFastBinsAligned;
+   m_aPrefetchBins = aPrefetchBins;
+
+   LOG_0(Trace_Info, "Exited BoosterShell::AllocatePrefetch");
+   return Error_None;
+}
+
+ErrorEbm BoosterShell::AllocateMainsBinsCache() {
+   EBM_ASSERT(nullptr != m_pBoosterCore);
+   EBM_ASSERT(IsMainsBinsCacheEnabled());
+
+   if(nullptr != m_aMainsBinsCache) {
+      return Error_None;
+   }
+
+   LOG_0(Trace_Info, "Entered BoosterShell::AllocateMainsBinsCache");
+
+   // FillAllocations already checked that this multiplication does not overflow
+   BinBase * const aMainsFastBinsTemp = static_cast<BinBase *>(
+      AlignedAlloc(m_cBytesMainsFastBins * m_pBoosterCore->GetCountFastBinsParallel()));
+   if(nullptr == aMainsFastBinsTemp) {
+      LOG_0(Trace_Warning, "WARNING BoosterShell::AllocateMainsBinsCache nullptr == aMainsFastBinsTemp");
+      return Error_OutOfMemory;
+   }
+   BinBase * const aMainsBinsCache = static_cast<BinBase *>(AlignedAlloc(m_cBytesMainsBins));
+   if(nullptr == aMainsBinsCache) {
+      AlignedFree(aMainsFastBinsTemp);
+      LOG_0(Trace_Warning, "WARNING BoosterShell::AllocateMainsBinsCache nullptr == aMainsBinsCache");
+      return Error_OutOfMemory;
+   }
+   m_aMainsFastBinsTemp = aMainsFastBinsTemp;
+   m_aMainsBinsCache = aMainsBinsCache;
+
+   LOG_0(Trace_Info, "Exited BoosterShell::AllocateMainsBinsCache");
+   return Error_None;
+}
+
+static ErrorEbm CreateBoosterInternal(
+   void * const rng,
+   const void * const dataSet,
+   const BagEbm * const bag,
+   const double * const initScores,
+   const BagEbm * const bagIncluded,
+   const double * const initScoresIncluded,
+   BoosterCore * const pBoosterCoreShared,
+   const bool bShareTermData,
+   const size_t cTerms,
+   const IntEbm * const dimensionCounts,
+   const IntEbm * const featureIndexes,
+   const size_t cInnerBags,
+   const CreateBoosterFlags flags,
+   const ComputeFlags disableCompute,
+   const char * const objective,
+   const double * const experimentalParams,
+   BoosterHandle * const boosterHandleOut
+) {
+   ErrorEbm error;
+
+   // TODO: since BoosterCore is a non-POD C++ class, we should probably move the call to new from inside
+   //       BoosterCore::Create to here and wrap it with a try catch at this level and rely on standard C++ behavior
+   BoosterCore * pBoosterCore = nullptr;
+   error = BoosterCore::Create(
+      rng,
+      cTerms,
+      cInnerBags,
+      experimentalParams,
+      dimensionCounts,
+      featureIndexes,
+      static_cast<const unsigned char *>(dataSet),
+      bag,
+      initScores,
+      bagIncluded,
+      initScoresIncluded,
+      pBoosterCoreShared,
+      bShareTermData,
+      flags,
+      disableCompute,
+      objective,
+      &pBoosterCore
+   );
+   if(UNLIKELY(Error_None != error)) {
+      BoosterCore::Free(pBoosterCore); // legal if nullptr.  On error we can get back a legal pBoosterCore to delete
+      return error;
+   }
+
+   BoosterShell * const pBoosterShell = BoosterShell::Create(pBoosterCore);
+   if(UNLIKELY(nullptr == pBoosterShell)) {
+      // if the memory allocation for pBoosterShell failed then there was no place to put the pBoosterCore, so free it
+      BoosterCore::Free(pBoosterCore);
+      return Error_OutOfMemory;
+   }
+
+   error = pBoosterShell->FillAllocations();
+   if(Error_None != error) {
+      BoosterShell::Free(pBoosterShell);
+      return error;
+   }
+
+   if(size_t { 0 } != pBoosterCore->GetCountScores()) {
+      if(!pBoosterCore->IsRmse()) {
+         error = pBoosterCore->InitializeBoosterGradientsAndHessians(
+            pBoosterShell->GetMulticlassMidwayTemp(),
+            pBoosterShell->GetTermUpdate()->GetTensorScoresPointer() // initialized to zero at this point
+         );
+         if(UNLIKELY(Error_None != error)) {
+            BoosterShell::Free(pBoosterShell);
+            return error;
+         }
+      } else {
+         InitializeRmseGradientsAndHessiansBoosting(
+            static_cast<const unsigned char *>(dataSet),
+            BagEbm { 1 },
+            nullptr == bagIncluded ? bag : bagIncluded,
+            nullptr == bagIncluded ? initScores : initScoresIncluded,
+            pBoosterCore->GetTrainingSet()
+         );
+         if(!pBoosterCore->GetValidationSet()->IsAlias()) {
+            // an alias shares the residuals of the training set, which are the same in both directions
+            InitializeRmseGradientsAndHessiansBoosting(
+               static_cast<const unsigned char *>(dataSet),
+               BagEbm { -1 },
+               bag,
+               initScores,
+               pBoosterCore->GetValidationSet()
+            );
+         }
+      }
+   }
+
+   *boosterHandleOut = pBoosterShell->GetHandle();
+   return Error_None;
+}
+
 EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION CreateBooster(
    void * rng,
    const void * dataSet,
@@ -228,7 +606,12 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION CreateBooster(
    if(0 != (static_cast<UCreateBoosterFlags>(flags) & static_cast<UCreateBoosterFlags>(~(
       static_cast<UCreateBoosterFlags>(CreateBoosterFlags_DifferentialPrivacy) | 
       static_cast<UCreateBoosterFlags>(CreateBoosterFlags_DisableApprox) |
-      static_cast<UCreateBoosterFlags>(CreateBoosterFlags_BinaryAsMulticlass)
+      static_cast<UCreateBoosterFlags>(CreateBoosterFlags_BinaryAsMulticlass) |
+      static_cast<UCreateBoosterFlags>(CreateBoosterFlags_Multithreaded) |
+      static_cast<UCreateBoosterFlags>(CreateBoosterFlags_PinThreads) |
+      static_cast<UCreateBoosterFlags>(CreateBoosterFlags_Bfloat16Gradients) |
+      static_cast<UCreateBoosterFlags>(CreateBoosterFlags_Autotune) |
+      static_cast<UCreateBoosterFlags>(CreateBoosterFlags_EnableSIMD)
    )))) {
       LOG_0(Trace_Error, "ERROR CreateBooster flags contains unknown flags. Ignoring extras.");
    }
@@ -260,75 +643,316 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION CreateBooster(
    }
    const size_t cInnerBags = static_cast<size_t>(countInnerBags);
 
-   // TODO: since BoosterCore is a non-POD C++ class, we should probably move the call to new from inside
-   //       BoosterCore::Create to here and wrap it with a try catch at this level and rely on standard C++ behavior
-   BoosterCore * pBoosterCore = nullptr;
-   error = BoosterCore::Create(
+   BoosterHandle handle;
+   error = CreateBoosterInternal(
       rng,
+      dataSet,
+      bag,
+      initScores,
+      nullptr,
+      nullptr,
+      nullptr,
+      false,
       cTerms,
-      cInnerBags,
-      experimentalParams,
       dimensionCounts,
       featureIndexes,
-      static_cast<const unsigned char *>(dataSet),
-      bag,
-      initScores,
+      cInnerBags,
       flags,
       disableCompute,
       objective,
-      &pBoosterCore
+      experimentalParams,
+      &handle
    );
-   if(UNLIKELY(Error_None != error)) {
-      BoosterCore::Free(pBoosterCore); // legal if nullptr.  On error we can get back a legal pBoosterCore to delete
+   if(Error_None != error) {
       return error;
    }
 
-   BoosterShell * const pBoosterShell = BoosterShell::Create(pBoosterCore);
-   if(UNLIKELY(nullptr == pBoosterShell)) {
-      // if the memory allocation for pBoosterShell failed then there was no place to put the pBoosterCore, so free it
-      BoosterCore::Free(pBoosterCore);
-      return Error_OutOfMemory;
+   LOG_N(Trace_Info, "Exited CreateBooster: *boosterHandleOut=%p", static_cast<void *>(handle));
+
+   *boosterHandleOut = handle;
+   return Error_None;
+}
+
+static void CompactInitScores(
+   const size_t cSamples,
+   const BagEbm * const aBag,
+   const size_t cScores,
+   const double * const aInitScores,
+   double * const aInitScoresOut
+) {
+   // CreateBooster expects one set of init scores per sample that is included in the bag
+   double * pInitScoresOut = aInitScoresOut;
+   for(size_t iSample = 0; iSample < cSamples; ++iSample) {
+      if(BagEbm { 0 } != aBag[iSample]) {
+         memcpy(pInitScoresOut, &aInitScores[iSample * cScores], sizeof(*pInitScoresOut) * cScores);
+         pInitScoresOut += cScores;
+      }
    }
+}
 
-   error = pBoosterShell->FillAllocations();
+EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION CreateBoosterBags(
+   const void * dataSet,
+   IntEbm countBags,
+   const BagEbm * bags,
+   const double * initScores,
+   IntEbm countTerms,
+   const IntEbm * dimensionCounts,
+   const IntEbm * featureIndexes,
+   CreateBoosterFlags flags,
+   ComputeFlags disableCompute,
+   const char * objective,
+   const double * experimentalParams,
+   BoosterHandle * boosterHandlesOut
+) {
+   LOG_N(
+      Trace_Info,
+      "Entered CreateBoosterBags: "
+      "dataSet=%p, "
+      "countBags=%" IntEbmPrintf ", "
+      "bags=%p, "
+      "initScores=%p, "
+      "countTerms=%" IntEbmPrintf ", "
+      "dimensionCounts=%p, "
+      "featureIndexes=%p, "
+      "flags=0x%" UCreateBoosterFlagsPrintf ", "
+      "disableCompute=0x%" UComputeFlagsPrintf ", "
+      "objective=%p, "
+      "experimentalParams=%p, "
+      "boosterHandlesOut=%p"
+      ,
+      dataSet,
+      countBags,
+      static_cast<const void *>(bags),
+      static_cast<const void *>(initScores),
+      countTerms,
+      static_cast<const void *>(dimensionCounts),
+      static_cast<const void *>(featureIndexes),
+      static_cast<UCreateBoosterFlags>(flags), // signed to unsigned conversion is defined behavior in C++
+      static_cast<UComputeFlags>(disableCompute), // signed to unsigned conversion is defined behavior in C++
+      static_cast<const void *>(objective), // do not print the string for security reasons
+      static_cast<const void *>(experimentalParams),
+      static_cast<const void *>(boosterHandlesOut)
+   );
+
+   ErrorEbm error;
+
+   if(nullptr == boosterHandlesOut) {
+      LOG_0(Trace_Error, "ERROR CreateBoosterBags nullptr == boosterHandlesOut");
+      return Error_IllegalParamVal;
+   }
+
+   if(countBags <= IntEbm { 0 }) {
+      LOG_0(Trace_Error, "ERROR CreateBoosterBags countBags must be 1 or more");
+      return Error_IllegalParamVal;
+   }
+   if(IsConvertError<size_t>(countBags)) {
+      LOG_0(Trace_Error, "ERROR CreateBoosterBags IsConvertError<size_t>(countBags)");
+      return Error_IllegalParamVal;
+   }
+   const size_t cBags = static_cast<size_t>(countBags);
+   // set these to nullptr as soon as possible so the caller doesn't attempt to free them
+   for(size_t iBag = 0; iBag < cBags; ++iBag) {
+      boosterHandlesOut[iBag] = nullptr;
+   }
+
+   if(0 != (static_cast<UCreateBoosterFlags>(flags) & static_cast<UCreateBoosterFlags>(~(
+      static_cast<UCreateBoosterFlags>(CreateBoosterFlags_DifferentialPrivacy) | 
+      static_cast<UCreateBoosterFlags>(CreateBoosterFlags_DisableApprox) |
+      static_cast<UCreateBoosterFlags>(CreateBoosterFlags_BinaryAsMulticlass) |
+      static_cast<UCreateBoosterFlags>(CreateBoosterFlags_Multithreaded) |
+      static_cast<UCreateBoosterFlags>(CreateBoosterFlags_PinThreads) |
+      static_cast<UCreateBoosterFlags>(CreateBoosterFlags_Bfloat16Gradients) |
+      static_cast<UCreateBoosterFlags>(CreateBoosterFlags_Autotune) |
+      static_cast<UCreateBoosterFlags>(CreateBoosterFlags_EnableSIMD)
+   )))) {
+      LOG_0(Trace_Error, "ERROR CreateBoosterBags flags contains unknown flags. Ignoring extras.");
+   }
+
+   if(nullptr == dataSet) {
+      LOG_0(Trace_Error, "ERROR CreateBoosterBags nullptr == dataSet");
+      return Error_IllegalParamVal;
+   }
+
+   if(nullptr == bags) {
+      LOG_0(Trace_Error, "ERROR CreateBoosterBags nullptr == bags");
+      return Error_IllegalParamVal;
+   }
+
+   if(IsConvertError<size_t>(countTerms)) {
+      LOG_0(Trace_Error, "ERROR CreateBoosterBags IsConvertError<size_t>(countTerms)");
+      return Error_IllegalParamVal;
+   }
+   const size_t cTerms = static_cast<size_t>(countTerms);
+
+   if(nullptr == dimensionCounts && size_t { 0 } != cTerms) {
+      LOG_0(Trace_Error, "ERROR CreateBoosterBags dimensionCounts cannot be null if 0 < countTerms");
+      return Error_IllegalParamVal;
+   }
+
+   UIntShared countSamples;
+   size_t cFeaturesUnused;
+   size_t cWeightsUnused;
+   size_t cTargetsUnused;
+   error = GetDataSetSharedHeader(
+      static_cast<const unsigned char *>(dataSet),
+      &countSamples,
+      &cFeaturesUnused,
+      &cWeightsUnused,
+      &cTargetsUnused
+   );
    if(Error_None != error) {
-      BoosterShell::Free(pBoosterShell);
+      // already logged
       return error;
    }
+   if(IsConvertError<size_t>(countSamples)) {
+      LOG_0(Trace_Error, "ERROR CreateBoosterBags IsConvertError<size_t>(countSamples)");
+      return Error_IllegalParamVal;
+   }
+   const size_t cSamples = static_cast<size_t>(countSamples);
+   if(IsMultiplyError(cSamples, cBags)) {
+      LOG_0(Trace_Error, "ERROR CreateBoosterBags IsMultiplyError(cSamples, cBags)");
+      return Error_IllegalParamVal;
+   }
 
-   if(size_t { 0 } != pBoosterCore->GetCountScores()) {
-      if(!pBoosterCore->IsRmse()) {
-         error = pBoosterCore->InitializeBoosterGradientsAndHessians(
-            pBoosterShell->GetMulticlassMidwayTemp(),
-            pBoosterShell->GetTermUpdate()->GetTensorScoresPointer() // initialized to zero at this point
-         );
-         if(UNLIKELY(Error_None != error)) {
-            BoosterShell::Free(pBoosterShell);
-            return error;
+   // Each outer bag holds the samples that it includes in either direction once, and its validation set aliases
+   // them.  Outer bags that include the same samples, which is normal since bags usually include every sample,
+   // also share one copy of the packed term data.  aiBagOwner holds the first outer bag with the same samples.
+   BagEbm * aBagIncluded = nullptr;
+   size_t * aiBagOwner = nullptr;
+   if(size_t { 0 } != cSamples) {
+      if(IsMultiplyError(sizeof(*aiBagOwner), cBags)) {
+         LOG_0(Trace_Warning, "WARNING CreateBoosterBags IsMultiplyError(sizeof(*aiBagOwner), cBags)");
+         return Error_OutOfMemory;
+      }
+      aBagIncluded = static_cast<BagEbm *>(malloc(sizeof(*aBagIncluded) * cSamples));
+      aiBagOwner = static_cast<size_t *>(malloc(sizeof(*aiBagOwner) * cBags));
+      if(nullptr == aBagIncluded || nullptr == aiBagOwner) {
+         LOG_0(Trace_Warning, "WARNING CreateBoosterBags out of memory");
+         free(aiBagOwner);
+         free(aBagIncluded);
+         return Error_OutOfMemory;
+      }
+      for(size_t iBag = 0; iBag < cBags; ++iBag) {
+         const BagEbm * const aBag = &bags[iBag * cSamples];
+         bool bTraining = false;
+         for(size_t iSample = 0; iSample < cSamples; ++iSample) {
+            if(BagEbm { 0 } < aBag[iSample]) {
+               bTraining = true;
+               break;
+            }
          }
-      } else {
-         InitializeRmseGradientsAndHessiansBoosting(
-            static_cast<const unsigned char *>(dataSet),
-            BagEbm { 1 },
-            bag,
-            initScores,
-            pBoosterCore->GetTrainingSet()
-         );
-         InitializeRmseGradientsAndHessiansBoosting(
-            static_cast<const unsigned char *>(dataSet),
-            BagEbm { -1 },
-            bag,
-            initScores,
-            pBoosterCore->GetValidationSet()
-         );
+         if(!bTraining) {
+            LOG_0(Trace_Error, "ERROR CreateBoosterBags each bag must have at least one training sample");
+            free(aiBagOwner);
+            free(aBagIncluded);
+            return Error_IllegalParamVal;
+         }
+
+         size_t iBagOwner = 0;
+         while(iBagOwner != iBag) {
+            const BagEbm * const aBagOwner = &bags[iBagOwner * cSamples];
+            size_t iSample = 0;
+            while(iSample != cSamples && (BagEbm { 0 } == aBag[iSample]) == (BagEbm { 0 } == aBagOwner[iSample])) {
+               ++iSample;
+            }
+            if(cSamples == iSample) {
+               break;
+            }
+            ++iBagOwner;
+         }
+         aiBagOwner[iBag] = iBagOwner;
       }
    }
 
-   const BoosterHandle handle = pBoosterShell->GetHandle();
+   double * aInitScoresIncluded = nullptr;
+   size_t cScores = 0;
+   if(nullptr != initScores && size_t { 0 } != cSamples) {
+      ptrdiff_t cClasses;
+      if(nullptr == GetDataSetSharedTarget(static_cast<const unsigned char *>(dataSet), 0, &cClasses)) {
+         LOG_0(Trace_Warning, "WARNING CreateBoosterBags cClasses cannot fit into ptrdiff_t");
+         free(aiBagOwner);
+         free(aBagIncluded);
+         return Error_IllegalParamVal;
+      }
+      if(ptrdiff_t { 0 } != cClasses && ptrdiff_t { 1 } != cClasses) {
+         // same as BoosterCore::Create
+         if(0 != (CreateBoosterFlags_BinaryAsMulticlass & flags)) {
+            cScores = cClasses < ptrdiff_t { 2 } ? size_t { 1 } : static_cast<size_t>(cClasses);
+         } else {
+            cScores = cClasses <= ptrdiff_t { 2 } ? size_t { 1 } : static_cast<size_t>(cClasses);
+         }
+         if(IsMultiplyError(sizeof(double), cScores, cSamples)) {
+            LOG_0(Trace_Warning, "WARNING CreateBoosterBags IsMultiplyError(sizeof(double), cScores, cSamples)");
+            free(aiBagOwner);
+            free(aBagIncluded);
+            return Error_OutOfMemory;
+         }
+         aInitScoresIncluded = static_cast<double *>(malloc(sizeof(double) * cScores * cSamples));
+         if(nullptr == aInitScoresIncluded) {
+            LOG_0(Trace_Warning, "WARNING CreateBoosterBags nullptr == aInitScoresIncluded");
+            free(aiBagOwner);
+            free(aBagIncluded);
+            return Error_OutOfMemory;
+         }
+      }
+   }
 
-   LOG_N(Trace_Info, "Exited CreateBooster: *boosterHandleOut=%p", static_cast<void *>(handle));
+   for(size_t iBag = 0; iBag < cBags; ++iBag) {
+      const BagEbm * const aBag = &bags[iBag * cSamples];
+      // the first outer bag creates the thread pool and picks the zone, which the others borrow
+      BoosterCore * pBoosterCoreShared = nullptr;
+      bool bShareTermData = false;
+      if(nullptr != aBagIncluded) {
+         for(size_t iSample = 0; iSample < cSamples; ++iSample) {
+            aBagIncluded[iSample] = BagEbm { 0 } == aBag[iSample] ? BagEbm { 0 } : BagEbm { 1 };
+         }
+         if(nullptr != aInitScoresIncluded) {
+            CompactInitScores(cSamples, aBagIncluded, cScores, initScores, aInitScoresIncluded);
+         }
+         if(size_t { 0 } != iBag) {
+            const size_t iBagOwner = aiBagOwner[iBag];
+            bShareTermData = iBag != iBagOwner;
+            pBoosterCoreShared = BoosterShell::GetBoosterShellFromHandle(
+               boosterHandlesOut[bShareTermData ? iBagOwner : size_t { 0 }])->GetBoosterCore();
+         }
+      }
 
-   *boosterHandleOut = handle;
+      error = CreateBoosterInternal(
+         nullptr, // inner bags are not supported, so we do not need an rng
+         dataSet,
+         size_t { 0 } == cSamples ? nullptr : aBag,
+         nullptr,
+         aBagIncluded,
+         aInitScoresIncluded,
+         pBoosterCoreShared,
+         bShareTermData,
+         cTerms,
+         dimensionCounts,
+         featureIndexes,
+         0,
+         flags,
+         disableCompute,
+         objective,
+         experimentalParams,
+         &boosterHandlesOut[iBag]
+      );
+      if(Error_None != error) {
+         for(size_t iBagFree = 0; iBagFree < iBag; ++iBagFree) {
+            FreeBooster(boosterHandlesOut[iBagFree]);
+            boosterHandlesOut[iBagFree] = nullptr;
+         }
+         free(aInitScoresIncluded);
+         free(aiBagOwner);
+         free(aBagIncluded);
+         return error;
+      }
+   }
+
+   free(aInitScoresIncluded);
+   free(aiBagOwner);
+   free(aBagIncluded);
+
+   LOG_0(Trace_Info, "Exited CreateBoosterBags");
    return Error_None;
 }
 
@@ -449,6 +1073,29 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION GetBestTermScores(
       return Error_IllegalParamVal;
    }
 
+   if(pBoosterCore->IsTermNeverBoosted(iTerm)) {
+      // the best tensor is still all zeros, so skip the transpose and zero the caller's tensor directly, which
+      // includes the missing and unseen cells that the transpose would have filled with zeros too
+      size_t cScores = pBoosterCore->GetCountScores();
+      const TermFeature * pTermFeature = pTerm->GetTermFeatures();
+      const TermFeature * const pTermFeaturesEnd = &pTermFeature[pTerm->GetCountDimensions()];
+      for(; pTermFeaturesEnd != pTermFeature; ++pTermFeature) {
+         const FeatureBoosting * const pFeature = pTermFeature->m_pFeature;
+         const size_t cBins = pFeature->GetCountBins() + (pFeature->IsMissing() ? size_t { 0 } : size_t { 1 }) +
+            (pFeature->IsUnknown() ? size_t { 0 } : size_t { 1 });
+         cScores *= cBins;
+      }
+      double * pScore = termScoresTensorOut;
+      const double * const pScoresEnd = &termScoresTensorOut[cScores];
+      do {
+         *pScore = 0.0;
+         ++pScore;
+      } while(pScoresEnd != pScore);
+
+      LOG_0(Trace_Info, "Exited GetBestTermScores never boosted");
+      return Error_None;
+   }
+
    Tensor * const pTensor = pBoosterCore->GetBestModel()[iTerm];
    EBM_ASSERT(nullptr != pTensor);
    EBM_ASSERT(pTensor->GetExpanded()); // the tensor should have been expanded at startup
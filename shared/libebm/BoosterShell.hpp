@@ -13,6 +13,9 @@
 #include "unzoned.h"
 
 #include "zones.h"
+#include "bridge.h" // k_cMetricsMax
+
+#include "RandomDeterministic.hpp"
 
 namespace DEFINED_ZONE_NAME {
 #ifndef DEFINED_ZONE_NAME
@@ -44,17 +47,60 @@ class BoosterShell final {
    // TODO: try to merge some of this memory so that we get more CPU cache residency
    BinBase * m_aBoostingFastBinsTemp;
    BinBase * m_aBoostingMainBins;
+   void * m_aSortScratchTemp; // see BoosterCore::GetCountBytesSortScratch
 
    // TODO: I think this can share memory with m_aBoostingFastBinsTemp since the GradientPair always contains a FLOAT, and it always contains enough for the multiclass scores in the first bin, and we always have at least 1 bin, right?
    void * m_aMulticlassMidwayTemp;
+   size_t m_cBytesMulticlassMidwayTemp; // per thread stride.  Each thread gets its own scratch space
+
+   // the metric partial sums of each validation subset, which we then reduce in a fixed order.  Each kind of sum 
+   // (see BoosterCore::GetCountValidationSums) is stored contiguously over the subsets
+   double * m_aValidationMetricsTemp;
+
+   // the metrics from the latest ApplyTermUpdate in the order that they were listed in the objective
+   double m_aValidationMetrics[k_cMetricsMax];
 
    void * m_aTreeNodesTemp;
    void * m_aSplitPositionsTemp;
 
+   // When multithreaded we boost the inner bags concurrently. Each bag shell has its own scratch space and 
+   // holds the results of one inner bag until they are added to our term update in bag order.
+   size_t m_cBagShells;
+   BoosterShell * m_aBagShells;
+   RandomDeterministic m_rngBag;
+   double m_gainBag;
+
+   // When the caller boosts several main terms without changing the gradients in between (for instance when 
+   // ranking the terms by gain) we bin all the main terms in one pass over the gradients with BinSumsBoostingMulti
+   // and keep their histograms here until the gradients change.  The bins are only allocated the first time 
+   // that happens, since most callers boost a single term per gradient update.
+   BinBase * m_aMainsBinsCache;
+   size_t * m_aiMainsBinsCacheOffset; // byte offset of each term in m_aMainsBinsCache, or k_notCached
+   size_t m_cBytesMainsBins;
+   BinBase * m_aMainsFastBinsTemp;
+   size_t m_cBytesMainsFastBins; // the distance between the fast bins of each subset binned concurrently
+   bool m_bMainsBinsCacheCurrent;
+   size_t m_iMainsBinsCacheVersion;
+   size_t m_iMainsTermPrev;
+   size_t m_iMainsVersionPrev;
+
+   // When our caller tells us which main term it will boost next, ApplyTermUpdate bins that term for the first
+   // inner bag while it updates the gradients.  Each training subset gets its own fast bins so that we can add
+   // them in subset order afterwards.  The prefetch memory is only allocated if our caller asks for it.
+   size_t m_iPrefetchTerm; // the term hinted by our caller, or k_illegalTermIndex
+   BinBase * m_aPrefetchFastBins;
+   size_t m_cBytesPrefetchFastBins; // the distance between the fast bins of each training subset
+   BinBase * m_aPrefetchBins;
+   size_t m_iPrefetchBinsTerm; // the term held in m_aPrefetchBins, or k_illegalTermIndex
+   size_t m_iPrefetchBinsVersion;
+
 #ifndef NDEBUG
    const BinBase * m_pDebugMainBinsEnd;
 #endif // NDEBUG
 
+   void FreeAllocations();
+   ErrorEbm FillAllocationsInternal(const bool bBagShell);
+
 public:
 
    BoosterShell() = default; // preserve our POD status
@@ -63,6 +109,7 @@ public:
    void operator delete (void *) = delete; // we only use malloc/free in this library
 
    static constexpr size_t k_illegalTermIndex = std::numeric_limits<size_t>::max();
+   static constexpr size_t k_notCached = std::numeric_limits<size_t>::max();
 
    INLINE_ALWAYS void InitializeUnfailing(BoosterCore * const pBoosterCore) {
       m_handleVerification = k_handleVerificationOk;
@@ -72,14 +119,40 @@ public:
       m_pInnerTermUpdate = nullptr;
       m_aBoostingFastBinsTemp = nullptr;
       m_aBoostingMainBins = nullptr;
+      m_aSortScratchTemp = nullptr;
       m_aMulticlassMidwayTemp = nullptr;
+      m_cBytesMulticlassMidwayTemp = 0;
+      m_aValidationMetricsTemp = nullptr;
+      for(size_t iMetric = 0; iMetric < k_cMetricsMax; ++iMetric) {
+         m_aValidationMetrics[iMetric] = std::numeric_limits<double>::infinity();
+      }
       m_aTreeNodesTemp = nullptr;
       m_aSplitPositionsTemp = nullptr;
+      m_cBagShells = 0;
+      m_aBagShells = nullptr;
+      m_aMainsBinsCache = nullptr;
+      m_aiMainsBinsCacheOffset = nullptr;
+      m_cBytesMainsBins = 0;
+      m_aMainsFastBinsTemp = nullptr;
+      m_cBytesMainsFastBins = 0;
+      m_bMainsBinsCacheCurrent = false;
+      m_iMainsBinsCacheVersion = 0;
+      m_iMainsTermPrev = k_illegalTermIndex;
+      m_iMainsVersionPrev = 0;
+      m_iPrefetchTerm = k_illegalTermIndex;
+      m_aPrefetchFastBins = nullptr;
+      m_cBytesPrefetchFastBins = 0;
+      m_aPrefetchBins = nullptr;
+      m_iPrefetchBinsTerm = k_illegalTermIndex;
+      m_iPrefetchBinsVersion = 0;
    }
 
    static void Free(BoosterShell * const pBoosterShell);
    static BoosterShell * Create(BoosterCore * const pBoosterCore);
    ErrorEbm FillAllocations();
+   bool IsPrefetchable(const size_t iTerm);
+   ErrorEbm AllocatePrefetch();
+   ErrorEbm AllocateMainsBinsCache();
 
    INLINE_ALWAYS static BoosterShell * GetBoosterShellFromHandle(const BoosterHandle boosterHandle) {
       if(nullptr == boosterHandle) {
@@ -132,10 +205,114 @@ public:
       return m_aBoostingMainBins;
    }
 
+   INLINE_ALWAYS void * GetSortScratchTemp() {
+      // nullptr if no term has fast bins that are too large for the cache
+      return m_aSortScratchTemp;
+   }
+
    INLINE_ALWAYS void * GetMulticlassMidwayTemp() {
       return m_aMulticlassMidwayTemp;
    }
 
+   INLINE_ALWAYS size_t GetCountBytesMulticlassMidwayTemp() const {
+      return m_cBytesMulticlassMidwayTemp;
+   }
+
+   INLINE_ALWAYS double * GetValidationMetricsTemp() {
+      return m_aValidationMetricsTemp;
+   }
+
+   INLINE_ALWAYS double * GetValidationMetrics() {
+      return m_aValidationMetrics;
+   }
+
+   INLINE_ALWAYS size_t GetCountBagShells() const {
+      return m_cBagShells;
+   }
+
+   INLINE_ALWAYS BoosterShell * GetBagShells() {
+      return m_aBagShells;
+   }
+
+   INLINE_ALWAYS RandomDeterministic * GetBagRng() {
+      return &m_rngBag;
+   }
+
+   INLINE_ALWAYS double * GetBagGainPointer() {
+      return &m_gainBag;
+   }
+
+   INLINE_ALWAYS bool IsMainsBinsCacheEnabled() const {
+      // false if we never cache the main term histograms
+      return nullptr != m_aiMainsBinsCacheOffset;
+   }
+
+   INLINE_ALWAYS BinBase * GetMainsBinsCache() {
+      // nullptr until AllocateMainsBinsCache
+      return m_aMainsBinsCache;
+   }
+
+   INLINE_ALWAYS size_t GetMainsBinsCacheOffset(const size_t iTerm) const {
+      EBM_ASSERT(nullptr != m_aiMainsBinsCacheOffset);
+      return m_aiMainsBinsCacheOffset[iTerm];
+   }
+
+   INLINE_ALWAYS BinBase * GetMainsFastBinsTemp() {
+      return m_aMainsFastBinsTemp;
+   }
+
+   INLINE_ALWAYS size_t GetCountBytesMainsFastBins() const {
+      return m_cBytesMainsFastBins;
+   }
+
+   INLINE_ALWAYS bool IsMainsBinsCacheCurrent(const size_t iGradientsVersion) const {
+      return m_bMainsBinsCacheCurrent && iGradientsVersion == m_iMainsBinsCacheVersion;
+   }
+
+   INLINE_ALWAYS void SetMainsBinsCacheCurrent(const size_t iGradientsVersion) {
+      m_bMainsBinsCacheCurrent = true;
+      m_iMainsBinsCacheVersion = iGradientsVersion;
+   }
+
+   INLINE_ALWAYS bool IsMainsGradientsReused(const size_t iTerm, const size_t iGradientsVersion) const {
+      // true if we already boosted a different main term on these same gradients
+      return k_illegalTermIndex != m_iMainsTermPrev && iTerm != m_iMainsTermPrev && iGradientsVersion == m_iMainsVersionPrev;
+   }
+
+   INLINE_ALWAYS void SetMainsPrev(const size_t iTerm, const size_t iGradientsVersion) {
+      m_iMainsTermPrev = iTerm;
+      m_iMainsVersionPrev = iGradientsVersion;
+   }
+
+   INLINE_ALWAYS size_t GetPrefetchTerm() const {
+      return m_iPrefetchTerm;
+   }
+
+   INLINE_ALWAYS void SetPrefetchTerm(const size_t iTerm) {
+      m_iPrefetchTerm = iTerm;
+   }
+
+   INLINE_ALWAYS BinBase * GetPrefetchFastBins() {
+      return m_aPrefetchFastBins;
+   }
+
+   INLINE_ALWAYS size_t GetCountBytesPrefetchFastBins() const {
+      return m_cBytesPrefetchFastBins;
+   }
+
+   INLINE_ALWAYS BinBase * GetPrefetchBins() {
+      return m_aPrefetchBins;
+   }
+
+   INLINE_ALWAYS bool IsPrefetchBinsCurrent(const size_t iTerm, const size_t iGradientsVersion) const {
+      return iTerm == m_iPrefetchBinsTerm && iGradientsVersion == m_iPrefetchBinsVersion;
+   }
+
+   INLINE_ALWAYS void SetPrefetchBinsCurrent(const size_t iTerm, const size_t iGradientsVersion) {
+      m_iPrefetchBinsTerm = iTerm;
+      m_iPrefetchBinsVersion = iGradientsVersion;
+   }
+
    template<bool bHessian, size_t cCompilerScores = 1>
    INLINE_ALWAYS TreeNode<bHessian, cCompilerScores> * GetTreeNodesTemp() {
       return static_cast<TreeNode<bHessian, cCompilerScores> *>(m_aTreeNodesTemp);
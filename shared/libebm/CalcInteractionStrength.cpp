@@ -7,6 +7,7 @@
 #include <stddef.h> // size_t, ptrdiff_t
 #include <limits> // numeric_limits
 #include <string.h> // memcpy
+#include <stdlib.h> // malloc, free
 
 #include "libebm.h" // ErrorEbm
 #include "logging.h" // EBM_ASSERT
@@ -20,6 +21,7 @@
 #include "DataSetInteraction.hpp"
 #include "InteractionCore.hpp"
 #include "InteractionShell.hpp"
+#include "ThreadPool.hpp"
 
 namespace DEFINED_ZONE_NAME {
 #ifndef DEFINED_ZONE_NAME
@@ -32,6 +34,7 @@ extern void ConvertAddBin(
    const size_t cBins,
    const bool bUInt64Src,
    const bool bDoubleSrc,
+   const bool bWeightSrc,
    const void * const aSrc,
    const bool bUInt64Dest,
    const bool bDoubleDest,
@@ -65,66 +68,12 @@ extern double PartitionTwoDimensionalInteraction(
 #endif // NDEBUG
 );
 
-// there is a race condition for decrementing this variable, but if a thread loses the 
-// race then it just doesn't get decremented as quickly, which we can live with
-static int g_cLogCalcInteractionStrength = 10;
-
-EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION CalcInteractionStrength(
-   InteractionHandle interactionHandle,
-   IntEbm countDimensions,
-   const IntEbm * featureIndexes,
-   CalcInteractionFlags flags,
-   IntEbm maxCardinality,
-   IntEbm minSamplesLeaf,
-   double * avgInteractionStrengthOut
+static void ConvertInteractionLimits(
+   const IntEbm maxCardinality,
+   const IntEbm minSamplesLeaf,
+   size_t * const pcCardinalityMaxOut,
+   size_t * const pcSamplesLeafMinOut
 ) {
-   LOG_COUNTED_N(
-      &g_cLogCalcInteractionStrength,
-      Trace_Info,
-      Trace_Verbose,
-      "CalcInteractionStrength: "
-      "interactionHandle=%p, "
-      "countDimensions=%" IntEbmPrintf ", "
-      "featureIndexes=%p, "
-      "flags=0x%" UCalcInteractionFlagsPrintf ", "
-      "maxCardinality=%" IntEbmPrintf ", "
-      "minSamplesLeaf=%" IntEbmPrintf ", "
-      "avgInteractionStrengthOut=%p"
-      ,
-      static_cast<void *>(interactionHandle),
-      countDimensions,
-      static_cast<const void *>(featureIndexes),
-      static_cast<UCalcInteractionFlags>(flags), // signed to unsigned conversion is defined behavior in C++
-      maxCardinality,
-      minSamplesLeaf,
-      static_cast<void *>(avgInteractionStrengthOut)
-   );
-
-   ErrorEbm error;
-
-   if(LIKELY(nullptr != avgInteractionStrengthOut)) {
-      *avgInteractionStrengthOut = k_illegalGainDouble;
-   }
-
-   InteractionShell * const pInteractionShell = InteractionShell::GetInteractionShellFromHandle(interactionHandle);
-   if(nullptr == pInteractionShell) {
-      // already logged
-      return Error_IllegalParamVal;
-   }
-   LOG_COUNTED_0(
-      pInteractionShell->GetPointerCountLogEnterMessages(), 
-      Trace_Info, 
-      Trace_Verbose, 
-      "Entered CalcInteractionStrength"
-   );
-
-   if(0 != (static_cast<UCalcInteractionFlags>(flags) & static_cast<UCalcInteractionFlags>(~(
-      static_cast<UCalcInteractionFlags>(CalcInteractionFlags_Pure) | 
-      static_cast<UCalcInteractionFlags>(CalcInteractionFlags_EnableNewton)
-   )))) {
-      LOG_0(Trace_Error, "ERROR CalcInteractionStrength flags contains unknown flags. Ignoring extras.");
-   }
-
    size_t cCardinalityMax = std::numeric_limits<size_t>::max(); // set off by default
    if(IntEbm { 0 } <= maxCardinality) {
       if(IntEbm { 0 } != maxCardinality) {
@@ -137,6 +86,7 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION CalcInteractionStrength(
    } else {
       LOG_0(Trace_Warning, "WARNING CalcInteractionStrength maxCardinality can't be less than 0. Turning off.");
    }
+   *pcCardinalityMaxOut = cCardinalityMax;
 
    size_t cSamplesLeafMin = size_t { 1 }; // this is the min value
    if(IntEbm { 1 } <= minSamplesLeaf) {
@@ -149,37 +99,32 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION CalcInteractionStrength(
    } else {
       LOG_0(Trace_Warning, "WARNING CalcInteractionStrength minSamplesLeaf can't be less than 1. Adjusting to 1.");
    }
+   *pcSamplesLeafMinOut = cSamplesLeafMin;
+}
 
-   if(countDimensions <= IntEbm { 0 }) {
-      if(IntEbm { 0 } == countDimensions) {
-         LOG_0(Trace_Info, "INFO CalcInteractionStrength empty feature list");
-         if(LIKELY(nullptr != avgInteractionStrengthOut)) {
-            *avgInteractionStrengthOut = 0.0;
-         }
-         return Error_None;
-      } else {
-         LOG_0(Trace_Error, "ERROR CalcInteractionStrength countDimensions must be positive");
-         return Error_IllegalParamVal;
-      }
-   }
-   if(nullptr == featureIndexes) {
-      LOG_0(Trace_Error, "ERROR CalcInteractionStrength featureIndexes cannot be nullptr if 0 < countDimensions");
-      return Error_IllegalParamVal;
-   }
-   if(IntEbm { k_cDimensionsMax } < countDimensions) {
-      LOG_0(Trace_Warning, "WARNING CalcInteractionStrength countDimensions too large and would cause out of memory condition");
-      return Error_OutOfMemory;
-   }
-   size_t cDimensions = static_cast<size_t>(countDimensions);
+static ErrorEbm CalcInteractionStrengthInternal(
+   InteractionShell * const pInteractionShell,
+   const size_t cDimensions,
+   const IntEbm * const featureIndexes,
+   const CalcInteractionFlags flags,
+   const size_t cCardinalityMax,
+   const size_t cSamplesLeafMin,
+   double * const pInteractionStrengthOut
+) {
+   // pInteractionStrengthOut keeps k_illegalGainDouble if we return an error
+   EBM_ASSERT(nullptr != pInteractionShell);
+   EBM_ASSERT(cDimensions <= k_cDimensionsMax);
+   EBM_ASSERT(nullptr != featureIndexes);
+   EBM_ASSERT(nullptr != pInteractionStrengthOut);
+
+   ErrorEbm error;
 
    InteractionCore * const pInteractionCore = pInteractionShell->GetInteractionCore();
 
    const size_t cScores = pInteractionCore->GetCountScores();
    if(size_t { 0 } == cScores) {
       LOG_0(Trace_Info, "INFO CalcInteractionStrength target with 1 class perfectly predicts the target");
-      if(nullptr != avgInteractionStrengthOut) {
-         *avgInteractionStrengthOut = 0.0;
-      }
+      *pInteractionStrengthOut = 0.0;
       return Error_None;
    }
 
@@ -189,15 +134,11 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION CalcInteractionStrength(
    if(size_t { 0 } == pDataSet->GetCountSamples()) {
       // if there are zero samples, there isn't much basis to say whether there are interactions, so just return zero
       LOG_0(Trace_Info, "INFO CalcInteractionStrength zero samples");
-      if(nullptr != avgInteractionStrengthOut) {
-         *avgInteractionStrengthOut = 0.0;
-      }
+      *pInteractionStrengthOut = 0.0;
       return Error_None;
    }
 
-   // TODO : we NEVER use the hessian term (currently) in GradientPair when calculating interaction scores, but we're spending time calculating 
-   // it, and it's taking up precious memory.  We should eliminate the hessian term HERE in our datastructures OR we should think whether we can 
-   // use the hessian as part of the gain function!!!
+   // InteractionCore::IsHessian is false unless we use logitboost, so the bins below normally have no hessians
 
    BinSumsInteractionBridge binSums;
 
@@ -227,9 +168,7 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION CalcInteractionStrength(
       const size_t cBins = pFeature->GetCountBins();
       if(UNLIKELY(cBins <= size_t { 1 })) {
          LOG_0(Trace_Info, "INFO CalcInteractionStrength term contains a feature with only 1 or 0 bins");
-         if(nullptr != avgInteractionStrengthOut) {
-            *avgInteractionStrengthOut = 0.0;
-         }
+         *pInteractionStrengthOut = 0.0;
          return Error_None;
       }
       binSums.m_acBins[iDimension] = cBins;
@@ -248,9 +187,7 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION CalcInteractionStrength(
          // so we need to check if our caller gave us a tensor that overflows multiplication
          // if we overflow this, then we'd be above the cCardinalityMax value, so set it to 0.0
          LOG_0(Trace_Info, "INFO CalcInteractionStrength IsMultiplyError(cTensorBins, cBins)");
-         if (nullptr != avgInteractionStrengthOut) {
-            *avgInteractionStrengthOut = 0.0;
-         }
+         *pInteractionStrengthOut = 0.0;
          return Error_None;
       }
       cTensorBins *= cBins;
@@ -262,9 +199,7 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION CalcInteractionStrength(
 
    if(cCardinalityMax < cTensorBins) {
       LOG_0(Trace_Info, "INFO CalcInteractionStrength cCardinalityMax < cTensorBins");
-      if (nullptr != avgInteractionStrengthOut) {
-         *avgInteractionStrengthOut = 0.0;
-      }
+      *pInteractionStrengthOut = 0.0;
       return Error_None;
    }
 
@@ -373,6 +308,7 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION CalcInteractionStrength(
          cTensorBins,
          sizeof(UIntBig) == pSubset->GetObjectiveWrapper()->m_cUIntBytes,
          sizeof(FloatBig) == pSubset->GetObjectiveWrapper()->m_cFloatBytes,
+         true,
          aFastBins,
          std::is_same<UIntMain, uint64_t>::value,
          std::is_same<FloatMain, double>::value,
@@ -473,20 +409,8 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION CalcInteractionStrength(
          EBM_ASSERT(!std::isinf(bestGain));
       }
 
-      if(nullptr != avgInteractionStrengthOut) {
-         *avgInteractionStrengthOut = bestGain;
-      }
-
       EBM_ASSERT(k_illegalGainDouble == bestGain || 0.0 <= bestGain);
-      LOG_COUNTED_N(
-         pInteractionShell->GetPointerCountLogExitMessages(),
-         Trace_Info,
-         Trace_Verbose,
-         "Exited CalcInteractionStrength: "
-         "bestGain=%le"
-         ,
-         bestGain
-      );
+      *pInteractionStrengthOut = bestGain;
    } else {
       LOG_0(Trace_Warning, "WARNING CalcInteractionStrength We only support pairs for interaction detection currently");
 
@@ -503,4 +427,417 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION CalcInteractionStrength(
    return Error_None;
 }
 
+// there is a race condition for decrementing this variable, but if a thread loses the 
+// race then it just doesn't get decremented as quickly, which we can live with
+static int g_cLogCalcInteractionStrength = 10;
+
+EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION CalcInteractionStrength(
+   InteractionHandle interactionHandle,
+   IntEbm countDimensions,
+   const IntEbm * featureIndexes,
+   CalcInteractionFlags flags,
+   IntEbm maxCardinality,
+   IntEbm minSamplesLeaf,
+   double * avgInteractionStrengthOut
+) {
+   LOG_COUNTED_N(
+      &g_cLogCalcInteractionStrength,
+      Trace_Info,
+      Trace_Verbose,
+      "CalcInteractionStrength: "
+      "interactionHandle=%p, "
+      "countDimensions=%" IntEbmPrintf ", "
+      "featureIndexes=%p, "
+      "flags=0x%" UCalcInteractionFlagsPrintf ", "
+      "maxCardinality=%" IntEbmPrintf ", "
+      "minSamplesLeaf=%" IntEbmPrintf ", "
+      "avgInteractionStrengthOut=%p"
+      ,
+      static_cast<void *>(interactionHandle),
+      countDimensions,
+      static_cast<const void *>(featureIndexes),
+      static_cast<UCalcInteractionFlags>(flags), // signed to unsigned conversion is defined behavior in C++
+      maxCardinality,
+      minSamplesLeaf,
+      static_cast<void *>(avgInteractionStrengthOut)
+   );
+
+   ErrorEbm error;
+
+   if(LIKELY(nullptr != avgInteractionStrengthOut)) {
+      *avgInteractionStrengthOut = k_illegalGainDouble;
+   }
+
+   InteractionShell * const pInteractionShell = InteractionShell::GetInteractionShellFromHandle(interactionHandle);
+   if(nullptr == pInteractionShell) {
+      // already logged
+      return Error_IllegalParamVal;
+   }
+   LOG_COUNTED_0(
+      pInteractionShell->GetPointerCountLogEnterMessages(), 
+      Trace_Info, 
+      Trace_Verbose, 
+      "Entered CalcInteractionStrength"
+   );
+
+   if(0 != (static_cast<UCalcInteractionFlags>(flags) & static_cast<UCalcInteractionFlags>(~(
+      static_cast<UCalcInteractionFlags>(CalcInteractionFlags_Pure) | 
+      static_cast<UCalcInteractionFlags>(CalcInteractionFlags_EnableNewton)
+   )))) {
+      LOG_0(Trace_Error, "ERROR CalcInteractionStrength flags contains unknown flags. Ignoring extras.");
+   }
+
+   size_t cCardinalityMax;
+   size_t cSamplesLeafMin;
+   ConvertInteractionLimits(maxCardinality, minSamplesLeaf, &cCardinalityMax, &cSamplesLeafMin);
+
+   if(countDimensions <= IntEbm { 0 }) {
+      if(IntEbm { 0 } == countDimensions) {
+         LOG_0(Trace_Info, "INFO CalcInteractionStrength empty feature list");
+         if(LIKELY(nullptr != avgInteractionStrengthOut)) {
+            *avgInteractionStrengthOut = 0.0;
+         }
+         return Error_None;
+      } else {
+         LOG_0(Trace_Error, "ERROR CalcInteractionStrength countDimensions must be positive");
+         return Error_IllegalParamVal;
+      }
+   }
+   if(nullptr == featureIndexes) {
+      LOG_0(Trace_Error, "ERROR CalcInteractionStrength featureIndexes cannot be nullptr if 0 < countDimensions");
+      return Error_IllegalParamVal;
+   }
+   if(IntEbm { k_cDimensionsMax } < countDimensions) {
+      LOG_0(Trace_Warning, "WARNING CalcInteractionStrength countDimensions too large and would cause out of memory condition");
+      return Error_OutOfMemory;
+   }
+   size_t cDimensions = static_cast<size_t>(countDimensions);
+
+   double bestGain = k_illegalGainDouble;
+   error = CalcInteractionStrengthInternal(
+      pInteractionShell,
+      cDimensions,
+      featureIndexes,
+      flags,
+      cCardinalityMax,
+      cSamplesLeafMin,
+      &bestGain
+   );
+   if(Error_None != error) {
+      return error;
+   }
+
+   if(nullptr != avgInteractionStrengthOut) {
+      *avgInteractionStrengthOut = bestGain;
+   }
+
+   LOG_COUNTED_N(
+      pInteractionShell->GetPointerCountLogExitMessages(),
+      Trace_Info,
+      Trace_Verbose,
+      "Exited CalcInteractionStrength: "
+      "bestGain=%le"
+      ,
+      bestGain
+   );
+
+   return Error_None;
+}
+
+// the top terms are kept in a heap with the weakest term at the root.  Ties go to the higher term index
+INLINE_ALWAYS static bool IsStronger(const double * const aStrengths, const size_t iTerm1, const size_t iTerm2) {
+   return aStrengths[iTerm2] < aStrengths[iTerm1] || (aStrengths[iTerm1] == aStrengths[iTerm2] && iTerm2 < iTerm1);
+}
+
+static void SiftDownWeakest(const double * const aStrengths, IntEbm * const aHeap, const size_t cHeap, size_t iHeap) {
+   while(true) {
+      size_t iWeakest = iHeap;
+      const size_t iLeft = (iHeap << 1) + size_t { 1 };
+      const size_t iRight = iLeft + size_t { 1 };
+      if(iLeft < cHeap && IsStronger(aStrengths, static_cast<size_t>(aHeap[iWeakest]), static_cast<size_t>(aHeap[iLeft]))) {
+         iWeakest = iLeft;
+      }
+      if(iRight < cHeap && IsStronger(aStrengths, static_cast<size_t>(aHeap[iWeakest]), static_cast<size_t>(aHeap[iRight]))) {
+         iWeakest = iRight;
+      }
+      if(iWeakest == iHeap) {
+         return;
+      }
+      const IntEbm iTerm = aHeap[iHeap];
+      aHeap[iHeap] = aHeap[iWeakest];
+      aHeap[iWeakest] = iTerm;
+      iHeap = iWeakest;
+   }
+}
+
+static void SelectTopTerms(
+   const size_t cTerms,
+   const double * const aStrengths,
+   const size_t cTopTerms,
+   IntEbm * const aTopTermIndexesOut
+) {
+   EBM_ASSERT(1 <= cTopTerms);
+   EBM_ASSERT(cTopTerms <= cTerms);
+
+   // fill the heap with the first terms, then replace the weakest term whenever we find a stronger one
+   for(size_t iTerm = 0; iTerm < cTopTerms; ++iTerm) {
+      aTopTermIndexesOut[iTerm] = static_cast<IntEbm>(iTerm);
+   }
+   size_t iHeap = cTopTerms >> 1;
+   while(size_t { 0 } != iHeap) {
+      --iHeap;
+      SiftDownWeakest(aStrengths, aTopTermIndexesOut, cTopTerms, iHeap);
+   }
+   for(size_t iTerm = cTopTerms; iTerm < cTerms; ++iTerm) {
+      if(IsStronger(aStrengths, iTerm, static_cast<size_t>(aTopTermIndexesOut[0]))) {
+         aTopTermIndexesOut[0] = static_cast<IntEbm>(iTerm);
+         SiftDownWeakest(aStrengths, aTopTermIndexesOut, cTopTerms, 0);
+      }
+   }
+
+   // heapsort, which moves the weakest remaining term to the end each time and leaves the strongest term first
+   size_t cHeap = cTopTerms;
+   while(size_t { 1 } < cHeap) {
+      --cHeap;
+      const IntEbm iTerm = aTopTermIndexesOut[0];
+      aTopTermIndexesOut[0] = aTopTermIndexesOut[cHeap];
+      aTopTermIndexesOut[cHeap] = iTerm;
+      SiftDownWeakest(aStrengths, aTopTermIndexesOut, cHeap, 0);
+   }
+}
+
+// each task handles a block of consecutive terms so that we only need to know where each block starts
+static constexpr size_t k_cTermsPerTask = 64;
+
+struct CalcInteractionStrengthsTask {
+   InteractionShell * m_pInteractionShell;
+   size_t m_cTerms;
+   const IntEbm * m_aDimensionCounts;
+   const IntEbm * m_aFeatureIndexes;
+   const size_t * m_aiFeatureIndexesStart; // the position in m_aFeatureIndexes of the first term of each task
+   CalcInteractionFlags m_flags;
+   size_t m_cCardinalityMax;
+   size_t m_cSamplesLeafMin;
+   double * m_aStrengthsOut;
+};
+
+static ErrorEbm CalcInteractionStrengthsBlock(void * const pContext, const size_t iThread, const size_t iTask) {
+   // each thread has its own shell to hold its bins.  The strengths are written by term index, so the results
+   // do not depend on which thread handled which term
+   const CalcInteractionStrengthsTask * const pTask = static_cast<const CalcInteractionStrengthsTask *>(pContext);
+   InteractionShell * const pThreadShell = pTask->m_pInteractionShell->GetThreadShell(iThread);
+
+   const IntEbm * pFeatureIndexes = &pTask->m_aFeatureIndexes[pTask->m_aiFeatureIndexesStart[iTask]];
+   const size_t iTermStart = iTask * k_cTermsPerTask;
+   const size_t iTermEnd = EbmMin(iTermStart + k_cTermsPerTask, pTask->m_cTerms);
+   for(size_t iTerm = iTermStart; iTerm < iTermEnd; ++iTerm) {
+      const size_t cDimensions = static_cast<size_t>(pTask->m_aDimensionCounts[iTerm]);
+      if(size_t { 0 } == cDimensions) {
+         pTask->m_aStrengthsOut[iTerm] = 0.0;
+      } else {
+         const ErrorEbm error = CalcInteractionStrengthInternal(
+            pThreadShell,
+            cDimensions,
+            pFeatureIndexes,
+            pTask->m_flags,
+            pTask->m_cCardinalityMax,
+            pTask->m_cSamplesLeafMin,
+            &pTask->m_aStrengthsOut[iTerm]
+         );
+         if(Error_None != error) {
+            return error;
+         }
+         pFeatureIndexes += cDimensions;
+      }
+   }
+   return Error_None;
+}
+
+// there is a race condition for decrementing this variable, but if a thread loses the 
+// race then it just doesn't get decremented as quickly, which we can live with
+static int g_cLogCalcInteractionStrengths = 10;
+
+EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION CalcInteractionStrengths(
+   InteractionHandle interactionHandle,
+   IntEbm countTerms,
+   const IntEbm * dimensionCounts,
+   const IntEbm * featureIndexes,
+   CalcInteractionFlags flags,
+   IntEbm maxCardinality,
+   IntEbm minSamplesLeaf,
+   double * avgInteractionStrengthsOut,
+   IntEbm countTopTerms,
+   IntEbm * topTermIndexesOut
+) {
+   LOG_COUNTED_N(
+      &g_cLogCalcInteractionStrengths,
+      Trace_Info,
+      Trace_Verbose,
+      "CalcInteractionStrengths: "
+      "interactionHandle=%p, "
+      "countTerms=%" IntEbmPrintf ", "
+      "dimensionCounts=%p, "
+      "featureIndexes=%p, "
+      "flags=0x%" UCalcInteractionFlagsPrintf ", "
+      "maxCardinality=%" IntEbmPrintf ", "
+      "minSamplesLeaf=%" IntEbmPrintf ", "
+      "avgInteractionStrengthsOut=%p, "
+      "countTopTerms=%" IntEbmPrintf ", "
+      "topTermIndexesOut=%p"
+      ,
+      static_cast<void *>(interactionHandle),
+      countTerms,
+      static_cast<const void *>(dimensionCounts),
+      static_cast<const void *>(featureIndexes),
+      static_cast<UCalcInteractionFlags>(flags), // signed to unsigned conversion is defined behavior in C++
+      maxCardinality,
+      minSamplesLeaf,
+      static_cast<void *>(avgInteractionStrengthsOut),
+      countTopTerms,
+      static_cast<void *>(topTermIndexesOut)
+   );
+
+   ErrorEbm error;
+
+   InteractionShell * const pInteractionShell = InteractionShell::GetInteractionShellFromHandle(interactionHandle);
+   if(nullptr == pInteractionShell) {
+      // already logged
+      return Error_IllegalParamVal;
+   }
+
+   if(0 != (static_cast<UCalcInteractionFlags>(flags) & static_cast<UCalcInteractionFlags>(~(
+      static_cast<UCalcInteractionFlags>(CalcInteractionFlags_Pure) | 
+      static_cast<UCalcInteractionFlags>(CalcInteractionFlags_EnableNewton)
+   )))) {
+      LOG_0(Trace_Error, "ERROR CalcInteractionStrengths flags contains unknown flags. Ignoring extras.");
+   }
+
+   size_t cCardinalityMax;
+   size_t cSamplesLeafMin;
+   ConvertInteractionLimits(maxCardinality, minSamplesLeaf, &cCardinalityMax, &cSamplesLeafMin);
+
+   if(countTerms <= IntEbm { 0 }) {
+      if(IntEbm { 0 } == countTerms) {
+         LOG_0(Trace_Info, "INFO CalcInteractionStrengths empty term list");
+         return Error_None;
+      }
+      LOG_0(Trace_Error, "ERROR CalcInteractionStrengths countTerms must be positive");
+      return Error_IllegalParamVal;
+   }
+   if(IsConvertError<size_t>(countTerms)) {
+      LOG_0(Trace_Error, "ERROR CalcInteractionStrengths IsConvertError<size_t>(countTerms)");
+      return Error_IllegalParamVal;
+   }
+   const size_t cTerms = static_cast<size_t>(countTerms);
+
+   if(nullptr == dimensionCounts) {
+      LOG_0(Trace_Error, "ERROR CalcInteractionStrengths dimensionCounts cannot be nullptr if 0 < countTerms");
+      return Error_IllegalParamVal;
+   }
+   if(nullptr == avgInteractionStrengthsOut) {
+      LOG_0(Trace_Error, "ERROR CalcInteractionStrengths avgInteractionStrengthsOut cannot be nullptr if 0 < countTerms");
+      return Error_IllegalParamVal;
+   }
+   if(countTopTerms < IntEbm { 0 }) {
+      LOG_0(Trace_Error, "ERROR CalcInteractionStrengths countTopTerms cannot be negative");
+      return Error_IllegalParamVal;
+   }
+   const size_t cTopTerms = nullptr == topTermIndexesOut ? size_t { 0 } :
+      static_cast<size_t>(EbmMin(countTopTerms, countTerms));
+
+   for(size_t iTerm = 0; iTerm < cTerms; ++iTerm) {
+      avgInteractionStrengthsOut[iTerm] = k_illegalGainDouble;
+   }
+
+   // check the terms here on the calling thread so that the tasks cannot fail on bad parameters
+   const IntEbm countFeatures = static_cast<IntEbm>(pInteractionShell->GetInteractionCore()->GetCountFeatures());
+   const IntEbm * pFeatureIndex = featureIndexes;
+   for(size_t iTerm = 0; iTerm < cTerms; ++iTerm) {
+      const IntEbm countDimensions = dimensionCounts[iTerm];
+      if(countDimensions < IntEbm { 0 }) {
+         LOG_0(Trace_Error, "ERROR CalcInteractionStrengths dimensionCounts value cannot be negative");
+         return Error_IllegalParamVal;
+      }
+      if(IntEbm { k_cDimensionsMax } < countDimensions) {
+         LOG_0(Trace_Warning, "WARNING CalcInteractionStrengths dimensionCounts value too large and would cause out of memory condition");
+         return Error_OutOfMemory;
+      }
+      if(IntEbm { 0 } != countDimensions && nullptr == featureIndexes) {
+         LOG_0(Trace_Error, "ERROR CalcInteractionStrengths featureIndexes cannot be nullptr if there are features");
+         return Error_IllegalParamVal;
+      }
+      const IntEbm * const pFeatureIndexEnd = pFeatureIndex + static_cast<size_t>(countDimensions);
+      while(pFeatureIndexEnd != pFeatureIndex) {
+         const IntEbm indexFeature = *pFeatureIndex;
+         if(indexFeature < IntEbm { 0 }) {
+            LOG_0(Trace_Error, "ERROR CalcInteractionStrengths featureIndexes value cannot be negative");
+            return Error_IllegalParamVal;
+         }
+         if(countFeatures <= indexFeature) {
+            LOG_0(Trace_Error, "ERROR CalcInteractionStrengths featureIndexes value must be less than the number of features");
+            return Error_IllegalParamVal;
+         }
+         ++pFeatureIndex;
+      }
+   }
+
+   const size_t cTasks = (cTerms - size_t { 1 }) / k_cTermsPerTask + size_t { 1 };
+   if(IsMultiplyError(sizeof(size_t), cTasks)) {
+      LOG_0(Trace_Warning, "WARNING CalcInteractionStrengths IsMultiplyError(sizeof(size_t), cTasks)");
+      return Error_OutOfMemory;
+   }
+   size_t * const aiFeatureIndexesStart = static_cast<size_t *>(malloc(sizeof(size_t) * cTasks));
+   if(nullptr == aiFeatureIndexesStart) {
+      LOG_0(Trace_Warning, "WARNING CalcInteractionStrengths nullptr == aiFeatureIndexesStart");
+      return Error_OutOfMemory;
+   }
+   size_t iFeatureIndex = 0;
+   for(size_t iTerm = 0; iTerm < cTerms; ++iTerm) {
+      if(size_t { 0 } == iTerm % k_cTermsPerTask) {
+         aiFeatureIndexesStart[iTerm / k_cTermsPerTask] = iFeatureIndex;
+      }
+      iFeatureIndex += static_cast<size_t>(dimensionCounts[iTerm]);
+   }
+
+   InteractionCore * const pInteractionCore = pInteractionShell->GetInteractionCore();
+   error = pInteractionShell->AllocateThreadShells(pInteractionCore->GetCountThreads());
+   if(Error_None != error) {
+      free(aiFeatureIndexesStart);
+      return error;
+   }
+
+   CalcInteractionStrengthsTask task;
+   task.m_pInteractionShell = pInteractionShell;
+   task.m_cTerms = cTerms;
+   task.m_aDimensionCounts = dimensionCounts;
+   task.m_aFeatureIndexes = featureIndexes;
+   task.m_aiFeatureIndexesStart = aiFeatureIndexesStart;
+   task.m_flags = flags;
+   task.m_cCardinalityMax = cCardinalityMax;
+   task.m_cSamplesLeafMin = cSamplesLeafMin;
+   task.m_aStrengthsOut = avgInteractionStrengthsOut;
+
+   error = ThreadPool::Execute(pInteractionCore->GetThreadPool(), cTasks, CalcInteractionStrengthsBlock, &task);
+   free(aiFeatureIndexesStart);
+   if(Error_None != error) {
+      return error;
+   }
+
+   if(size_t { 0 } != cTopTerms) {
+      SelectTopTerms(cTerms, avgInteractionStrengthsOut, cTopTerms, topTermIndexesOut);
+   }
+
+   LOG_COUNTED_N(
+      pInteractionShell->GetPointerCountLogExitMessages(),
+      Trace_Info,
+      Trace_Verbose,
+      "Exited CalcInteractionStrengths: "
+      "cTerms=%zu"
+      ,
+      cTerms
+   );
+
+   return Error_None;
+}
+
 } // DEFINED_ZONE_NAME
@@ -19,258 +19,117 @@ namespace DEFINED_ZONE_NAME {
 #error DEFINED_ZONE_NAME must be defined
 #endif // DEFINED_ZONE_NAME
 
+struct BinLayout final {
+   size_t m_cBinBytes;
+   ptrdiff_t m_iSamples;
+   ptrdiff_t m_iWeight; // negative if the bins do not store the weight, in which case it equals the sample count
+   ptrdiff_t m_iArray;
+   size_t m_cArrayItemBytes;
+   ptrdiff_t m_iGradient;
+   ptrdiff_t m_iHessian; // negative if the bins do not store hessians
+};
+
+template<typename TFloat, typename TUInt, bool bHessian, bool bWeight>
+static void GetBinLayout(const size_t cScores, BinLayout * const pLayout) {
+   typedef Bin<TFloat, TUInt, bHessian, 1, bWeight> BinSpecific;
+   typedef GradientPair<TFloat, bHessian> GradientPairSpecific;
+   typedef GradientPair<TFloat, true> GradientPairHessian;
+
+   pLayout->m_cBinBytes = GetBinSize<TFloat, TUInt>(bHessian, cScores, bWeight);
+   pLayout->m_iSamples = BinSpecific::GetOffsetCountSamples();
+   pLayout->m_iWeight = BinSpecific::GetOffsetWeight();
+   pLayout->m_iArray = BinSpecific::GetOffsetGradientPairs();
+   pLayout->m_cArrayItemBytes = sizeof(GradientPairSpecific);
+   pLayout->m_iGradient = offsetof(GradientPairSpecific, m_sumGradients);
+   pLayout->m_iHessian = bHessian ? static_cast<ptrdiff_t>(offsetof(GradientPairHessian, m_sumHessians)) : ptrdiff_t { -1 };
+}
+
+template<typename TFloat, typename TUInt>
+static void GetBinLayout(const bool bHessian, const bool bWeight, const size_t cScores, BinLayout * const pLayout) {
+   if(bHessian) {
+      if(bWeight) {
+         GetBinLayout<TFloat, TUInt, true, true>(cScores, pLayout);
+      } else {
+         GetBinLayout<TFloat, TUInt, true, false>(cScores, pLayout);
+      }
+   } else {
+      if(bWeight) {
+         GetBinLayout<TFloat, TUInt, false, true>(cScores, pLayout);
+      } else {
+         GetBinLayout<TFloat, TUInt, false, false>(cScores, pLayout);
+      }
+   }
+}
+
+static void GetBinLayout(
+   const bool bUInt64,
+   const bool bDouble,
+   const bool bHessian,
+   const bool bWeight,
+   const size_t cScores,
+   BinLayout * const pLayout
+) {
+   if(bUInt64) {
+      if(bDouble) {
+         GetBinLayout<double, uint64_t>(bHessian, bWeight, cScores, pLayout);
+      } else {
+         GetBinLayout<float, uint64_t>(bHessian, bWeight, cScores, pLayout);
+      }
+   } else {
+      if(bDouble) {
+         GetBinLayout<double, uint32_t>(bHessian, bWeight, cScores, pLayout);
+      } else {
+         GetBinLayout<float, uint32_t>(bHessian, bWeight, cScores, pLayout);
+      }
+   }
+}
+
 extern void ConvertAddBin(
    const size_t cScores,
    const bool bHessian,
    const size_t cBins,
    const bool bUInt64Src,
    const bool bDoubleSrc,
+   const bool bWeightSrc,
    const void * const aSrc,
    const bool bUInt64Dest,
    const bool bDoubleDest,
    void * const aAddDest
 ) {
+   // bWeightSrc is false when the source bins were filled without sample weights and do not store the weight.
+   // The destination bins always store the weight.
+
    EBM_ASSERT(0 < cScores);
    EBM_ASSERT(0 < cBins);
    EBM_ASSERT(nullptr != aSrc);
    EBM_ASSERT(nullptr != aAddDest);
 
-   size_t cSrcBinBytes;
-   ptrdiff_t iSrcSamples = -1;
-   ptrdiff_t iSrcWeight = -1;
-   ptrdiff_t iSrcArray;
-   size_t cSrcArrayItemBytes;
-   ptrdiff_t iSrcGradient;
-   ptrdiff_t iSrcHessian = -1;
+   BinLayout layoutSrc;
+   GetBinLayout(bUInt64Src, bDoubleSrc, bHessian, bWeightSrc, cScores, &layoutSrc);
 
-   if(bUInt64Src) {
-      typedef uint64_t TUIntSpecific;
-      if(bDoubleSrc) {
-         typedef double TFloatSpecific;
-         cSrcBinBytes = GetBinSize<TFloatSpecific, TUIntSpecific>(bHessian, cScores);
-         if(bHessian) {
-            constexpr bool bHessianSpecific = true;
-            typedef Bin<TFloatSpecific, TUIntSpecific, bHessianSpecific> BinSpecific;
+   BinLayout layoutDest;
+   GetBinLayout(bUInt64Dest, bDoubleDest, bHessian, true, cScores, &layoutDest);
 
-            iSrcSamples = offsetof(BinSpecific, m_cSamples);
-            iSrcWeight = offsetof(BinSpecific, m_weight);
-            iSrcArray = offsetof(BinSpecific, m_aGradientPairs);
-            cSrcArrayItemBytes = sizeof(BinSpecific::m_aGradientPairs[0]);
-            using GradientPairSpecific = typename std::remove_reference<decltype(BinSpecific::m_aGradientPairs[0])>::type;
-            iSrcGradient = offsetof(GradientPairSpecific, m_sumGradients);
-            iSrcHessian = offsetof(GradientPairSpecific, m_sumHessians);
-         } else {
-            constexpr bool bHessianSpecific = false;
-            typedef Bin<TFloatSpecific, TUIntSpecific, bHessianSpecific> BinSpecific;
+   const size_t cSrcBinBytes = layoutSrc.m_cBinBytes;
+   const ptrdiff_t iSrcSamples = layoutSrc.m_iSamples;
+   const ptrdiff_t iSrcWeight = layoutSrc.m_iWeight;
+   const ptrdiff_t iSrcArray = layoutSrc.m_iArray;
+   const size_t cSrcArrayItemBytes = layoutSrc.m_cArrayItemBytes;
+   const ptrdiff_t iSrcGradient = layoutSrc.m_iGradient;
+   const ptrdiff_t iSrcHessian = layoutSrc.m_iHessian;
 
-            iSrcSamples = offsetof(BinSpecific, m_cSamples);
-            iSrcWeight = offsetof(BinSpecific, m_weight);
-            iSrcArray = offsetof(BinSpecific, m_aGradientPairs);
-            cSrcArrayItemBytes = sizeof(BinSpecific::m_aGradientPairs[0]);
-            using GradientPairSpecific = typename std::remove_reference<decltype(BinSpecific::m_aGradientPairs[0])>::type;
-            iSrcGradient = offsetof(GradientPairSpecific, m_sumGradients);
-         }
-      } else {
-         typedef float TFloatSpecific;
-         cSrcBinBytes = GetBinSize<TFloatSpecific, TUIntSpecific>(bHessian, cScores);
-         if(bHessian) {
-            constexpr bool bHessianSpecific = true;
-            typedef Bin<TFloatSpecific, TUIntSpecific, bHessianSpecific> BinSpecific;
-
-            iSrcSamples = offsetof(BinSpecific, m_cSamples);
-            iSrcWeight = offsetof(BinSpecific, m_weight);
-            iSrcArray = offsetof(BinSpecific, m_aGradientPairs);
-            cSrcArrayItemBytes = sizeof(BinSpecific::m_aGradientPairs[0]);
-            using GradientPairSpecific = typename std::remove_reference<decltype(BinSpecific::m_aGradientPairs[0])>::type;
-            iSrcGradient = offsetof(GradientPairSpecific, m_sumGradients);
-            iSrcHessian = offsetof(GradientPairSpecific, m_sumHessians);
-         } else {
-            constexpr bool bHessianSpecific = false;
-            typedef Bin<TFloatSpecific, TUIntSpecific, bHessianSpecific> BinSpecific;
-
-            iSrcSamples = offsetof(BinSpecific, m_cSamples);
-            iSrcWeight = offsetof(BinSpecific, m_weight);
-            iSrcArray = offsetof(BinSpecific, m_aGradientPairs);
-            cSrcArrayItemBytes = sizeof(BinSpecific::m_aGradientPairs[0]);
-            using GradientPairSpecific = typename std::remove_reference<decltype(BinSpecific::m_aGradientPairs[0])>::type;
-            iSrcGradient = offsetof(GradientPairSpecific, m_sumGradients);
-         }
-      }
-   } else {
-      typedef uint32_t TUIntSpecific;
-      if(bDoubleSrc) {
-         typedef double TFloatSpecific;
-         cSrcBinBytes = GetBinSize<TFloatSpecific, TUIntSpecific>(bHessian, cScores);
-         if(bHessian) {
-            constexpr bool bHessianSpecific = true;
-            typedef Bin<TFloatSpecific, TUIntSpecific, bHessianSpecific> BinSpecific;
-
-            iSrcSamples = offsetof(BinSpecific, m_cSamples);
-            iSrcWeight = offsetof(BinSpecific, m_weight);
-            iSrcArray = offsetof(BinSpecific, m_aGradientPairs);
-            cSrcArrayItemBytes = sizeof(BinSpecific::m_aGradientPairs[0]);
-            using GradientPairSpecific = typename std::remove_reference<decltype(BinSpecific::m_aGradientPairs[0])>::type;
-            iSrcGradient = offsetof(GradientPairSpecific, m_sumGradients);
-            iSrcHessian = offsetof(GradientPairSpecific, m_sumHessians);
-         } else {
-            constexpr bool bHessianSpecific = false;
-            typedef Bin<TFloatSpecific, TUIntSpecific, bHessianSpecific> BinSpecific;
-
-            iSrcSamples = offsetof(BinSpecific, m_cSamples);
-            iSrcWeight = offsetof(BinSpecific, m_weight);
-            iSrcArray = offsetof(BinSpecific, m_aGradientPairs);
-            cSrcArrayItemBytes = sizeof(BinSpecific::m_aGradientPairs[0]);
-            using GradientPairSpecific = typename std::remove_reference<decltype(BinSpecific::m_aGradientPairs[0])>::type;
-            iSrcGradient = offsetof(GradientPairSpecific, m_sumGradients);
-         }
-      } else {
-         typedef float TFloatSpecific;
-         cSrcBinBytes = GetBinSize<TFloatSpecific, TUIntSpecific>(bHessian, cScores);
-         if(bHessian) {
-            constexpr bool bHessianSpecific = true;
-            typedef Bin<TFloatSpecific, TUIntSpecific, bHessianSpecific> BinSpecific;
-
-            iSrcSamples = offsetof(BinSpecific, m_cSamples);
-            iSrcWeight = offsetof(BinSpecific, m_weight);
-            iSrcArray = offsetof(BinSpecific, m_aGradientPairs);
-            cSrcArrayItemBytes = sizeof(BinSpecific::m_aGradientPairs[0]);
-            using GradientPairSpecific = typename std::remove_reference<decltype(BinSpecific::m_aGradientPairs[0])>::type;
-            iSrcGradient = offsetof(GradientPairSpecific, m_sumGradients);
-            iSrcHessian = offsetof(GradientPairSpecific, m_sumHessians);
-         } else {
-            constexpr bool bHessianSpecific = false;
-            typedef Bin<TFloatSpecific, TUIntSpecific, bHessianSpecific> BinSpecific;
-
-            iSrcSamples = offsetof(BinSpecific, m_cSamples);
-            iSrcWeight = offsetof(BinSpecific, m_weight);
-            iSrcArray = offsetof(BinSpecific, m_aGradientPairs);
-            cSrcArrayItemBytes = sizeof(BinSpecific::m_aGradientPairs[0]);
-            using GradientPairSpecific = typename std::remove_reference<decltype(BinSpecific::m_aGradientPairs[0])>::type;
-            iSrcGradient = offsetof(GradientPairSpecific, m_sumGradients);
-         }
-      }
-   }
-
-   size_t cDestBinBytes;
-   ptrdiff_t iDestSamples = -1;
-   ptrdiff_t iDestWeight = -1;
-   ptrdiff_t iDestArray;
-   size_t cDestArrayItemBytes;
-   ptrdiff_t iDestGradient;
-   ptrdiff_t iDestHessian = -1;
-
-   if(bUInt64Dest) {
-      typedef uint64_t TUIntSpecific;
-      if(bDoubleDest) {
-         typedef double TFloatSpecific;
-         cDestBinBytes = GetBinSize<TFloatSpecific, TUIntSpecific>(bHessian, cScores);
-         if(bHessian) {
-            constexpr bool bHessianSpecific = true;
-            typedef Bin<TFloatSpecific, TUIntSpecific, bHessianSpecific> BinSpecific;
-
-            iDestSamples = offsetof(BinSpecific, m_cSamples);
-            iDestWeight = offsetof(BinSpecific, m_weight);
-            iDestArray = offsetof(BinSpecific, m_aGradientPairs);
-            cDestArrayItemBytes = sizeof(BinSpecific::m_aGradientPairs[0]);
-            using GradientPairSpecific = typename std::remove_reference<decltype(BinSpecific::m_aGradientPairs[0])>::type;
-            iDestGradient = offsetof(GradientPairSpecific, m_sumGradients);
-            iDestHessian = offsetof(GradientPairSpecific, m_sumHessians);
-         } else {
-            constexpr bool bHessianSpecific = false;
-            typedef Bin<TFloatSpecific, TUIntSpecific, bHessianSpecific> BinSpecific;
-
-            iDestSamples = offsetof(BinSpecific, m_cSamples);
-            iDestWeight = offsetof(BinSpecific, m_weight);
-            iDestArray = offsetof(BinSpecific, m_aGradientPairs);
-            cDestArrayItemBytes = sizeof(BinSpecific::m_aGradientPairs[0]);
-            using GradientPairSpecific = typename std::remove_reference<decltype(BinSpecific::m_aGradientPairs[0])>::type;
-            iDestGradient = offsetof(GradientPairSpecific, m_sumGradients);
-         }
-      } else {
-         typedef float TFloatSpecific;
-         cDestBinBytes = GetBinSize<TFloatSpecific, TUIntSpecific>(bHessian, cScores);
-         if(bHessian) {
-            constexpr bool bHessianSpecific = true;
-            typedef Bin<TFloatSpecific, TUIntSpecific, bHessianSpecific> BinSpecific;
-
-            iDestSamples = offsetof(BinSpecific, m_cSamples);
-            iDestWeight = offsetof(BinSpecific, m_weight);
-            iDestArray = offsetof(BinSpecific, m_aGradientPairs);
-            cDestArrayItemBytes = sizeof(BinSpecific::m_aGradientPairs[0]);
-            using GradientPairSpecific = typename std::remove_reference<decltype(BinSpecific::m_aGradientPairs[0])>::type;
-            iDestGradient = offsetof(GradientPairSpecific, m_sumGradients);
-            iDestHessian = offsetof(GradientPairSpecific, m_sumHessians);
-         } else {
-            constexpr bool bHessianSpecific = false;
-            typedef Bin<TFloatSpecific, TUIntSpecific, bHessianSpecific> BinSpecific;
-
-            iDestSamples = offsetof(BinSpecific, m_cSamples);
-            iDestWeight = offsetof(BinSpecific, m_weight);
-            iDestArray = offsetof(BinSpecific, m_aGradientPairs);
-            cDestArrayItemBytes = sizeof(BinSpecific::m_aGradientPairs[0]);
-            using GradientPairSpecific = typename std::remove_reference<decltype(BinSpecific::m_aGradientPairs[0])>::type;
-            iDestGradient = offsetof(GradientPairSpecific, m_sumGradients);
-         }
-      }
-   } else {
-      typedef uint32_t TUIntSpecific;
-      if(bDoubleDest) {
-         typedef double TFloatSpecific;
-         cDestBinBytes = GetBinSize<TFloatSpecific, TUIntSpecific>(bHessian, cScores);
-         if(bHessian) {
-            constexpr bool bHessianSpecific = true;
-            typedef Bin<TFloatSpecific, TUIntSpecific, bHessianSpecific> BinSpecific;
-
-            iDestSamples = offsetof(BinSpecific, m_cSamples);
-            iDestWeight = offsetof(BinSpecific, m_weight);
-            iDestArray = offsetof(BinSpecific, m_aGradientPairs);
-            cDestArrayItemBytes = sizeof(BinSpecific::m_aGradientPairs[0]);
-            using GradientPairSpecific = typename std::remove_reference<decltype(BinSpecific::m_aGradientPairs[0])>::type;
-            iDestGradient = offsetof(GradientPairSpecific, m_sumGradients);
-            iDestHessian = offsetof(GradientPairSpecific, m_sumHessians);
-         } else {
-            constexpr bool bHessianSpecific = false;
-            typedef Bin<TFloatSpecific, TUIntSpecific, bHessianSpecific> BinSpecific;
-
-            iDestSamples = offsetof(BinSpecific, m_cSamples);
-            iDestWeight = offsetof(BinSpecific, m_weight);
-            iDestArray = offsetof(BinSpecific, m_aGradientPairs);
-            cDestArrayItemBytes = sizeof(BinSpecific::m_aGradientPairs[0]);
-            using GradientPairSpecific = typename std::remove_reference<decltype(BinSpecific::m_aGradientPairs[0])>::type;
-            iDestGradient = offsetof(GradientPairSpecific, m_sumGradients);
-         }
-      } else {
-         typedef float TFloatSpecific;
-         cDestBinBytes = GetBinSize<TFloatSpecific, TUIntSpecific>(bHessian, cScores);
-         if(bHessian) {
-            constexpr bool bHessianSpecific = true;
-            typedef Bin<TFloatSpecific, TUIntSpecific, bHessianSpecific> BinSpecific;
-
-            iDestSamples = offsetof(BinSpecific, m_cSamples);
-            iDestWeight = offsetof(BinSpecific, m_weight);
-            iDestArray = offsetof(BinSpecific, m_aGradientPairs);
-            cDestArrayItemBytes = sizeof(BinSpecific::m_aGradientPairs[0]);
-            using GradientPairSpecific = typename std::remove_reference<decltype(BinSpecific::m_aGradientPairs[0])>::type;
-            iDestGradient = offsetof(GradientPairSpecific, m_sumGradients);
-            iDestHessian = offsetof(GradientPairSpecific, m_sumHessians);
-         } else {
-            constexpr bool bHessianSpecific = false;
-            typedef Bin<TFloatSpecific, TUIntSpecific, bHessianSpecific> BinSpecific;
-
-            iDestSamples = offsetof(BinSpecific, m_cSamples);
-            iDestWeight = offsetof(BinSpecific, m_weight);
-            iDestArray = offsetof(BinSpecific, m_aGradientPairs);
-            cDestArrayItemBytes = sizeof(BinSpecific::m_aGradientPairs[0]);
-            using GradientPairSpecific = typename std::remove_reference<decltype(BinSpecific::m_aGradientPairs[0])>::type;
-            iDestGradient = offsetof(GradientPairSpecific, m_sumGradients);
-         }
-      }
-   }
+   const size_t cDestBinBytes = layoutDest.m_cBinBytes;
+   const ptrdiff_t iDestSamples = layoutDest.m_iSamples;
+   const ptrdiff_t iDestWeight = layoutDest.m_iWeight;
+   const ptrdiff_t iDestArray = layoutDest.m_iArray;
+   const size_t cDestArrayItemBytes = layoutDest.m_cArrayItemBytes;
+   const ptrdiff_t iDestGradient = layoutDest.m_iGradient;
+   const ptrdiff_t iDestHessian = layoutDest.m_iHessian;
 
    EBM_ASSERT(0 <= iSrcSamples);
    EBM_ASSERT(0 <= iDestSamples);
 
-   EBM_ASSERT(0 <= iSrcWeight);
+   EBM_ASSERT(bWeightSrc == (0 <= iSrcWeight));
    EBM_ASSERT(0 <= iDestWeight);
 
    EBM_ASSERT(0 <= iSrcHessian && 0 <= iDestHessian || iSrcHessian < 0 && iDestHessian < 0);
@@ -280,8 +139,10 @@ extern void ConvertAddBin(
    unsigned char * pAddDest = reinterpret_cast<unsigned char *>(aAddDest);
    const size_t cSrcArrayTotalBytes = cSrcArrayItemBytes * cScores;
    do {
+      uint64_t cSamplesSrc;
       if(bUInt64Src) {
          const uint64_t src = *reinterpret_cast<const uint64_t *>(pSrc + iSrcSamples);
+         cSamplesSrc = src;
          if(bUInt64Dest) {
             *reinterpret_cast<uint64_t *>(pAddDest + iDestSamples) += src;
          } else {
@@ -289,6 +150,7 @@ extern void ConvertAddBin(
          }
       } else {
          const uint32_t src = *reinterpret_cast<const uint32_t *>(pSrc + iSrcSamples);
+         cSamplesSrc = src;
          if(bUInt64Dest) {
             *reinterpret_cast<uint64_t *>(pAddDest + iDestSamples) += src;
          } else {
@@ -296,7 +158,14 @@ extern void ConvertAddBin(
          }
       }
 
-      if(bDoubleSrc) {
+      if(!bWeightSrc) {
+         // without sample weights every sample has a weight of 1.0
+         if(bDoubleDest) {
+            *reinterpret_cast<double *>(pAddDest + iDestWeight) += static_cast<double>(cSamplesSrc);
+         } else {
+            *reinterpret_cast<float *>(pAddDest + iDestWeight) += static_cast<float>(cSamplesSrc);
+         }
+      } else if(bDoubleSrc) {
          const double src = *reinterpret_cast<const double *>(pSrc + iSrcWeight);
          if(bDoubleDest) {
             *reinterpret_cast<double *>(pAddDest + iDestWeight) += static_cast<double>(src);
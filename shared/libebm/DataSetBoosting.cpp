@@ -13,6 +13,7 @@
 #include "Feature.hpp" // Feature
 #include "Term.hpp" // Term
 #include "dataset_shared.hpp" // UIntShared
+#include "ThreadPool.hpp"
 #include "DataSetBoosting.hpp"
 
 namespace DEFINED_ZONE_NAME {
@@ -46,11 +47,13 @@ void DataSubsetBoosting::DestructDataSubsetBoosting(const size_t cTerms, const s
 
 ErrorEbm DataSetBoosting::InitGradHess(
    const bool bAllocateHessians,
+   const int gradHessFormat,
    const size_t cScores
 ) {
    LOG_0(Trace_Info, "Entered DataSetBoosting::InitGradHess");
 
    EBM_ASSERT(1 <= cScores);
+   EBM_ASSERT(bAllocateHessians || k_gradHessFloat == gradHessFormat);
 
    size_t cTotalScores = cScores;
    if(bAllocateHessians) {
@@ -68,11 +71,12 @@ ErrorEbm DataSetBoosting::InitGradHess(
       EBM_ASSERT(1 <= cSubsetSamples);
 
       EBM_ASSERT(nullptr != pSubset->m_pObjective);
-      if(IsMultiplyError(pSubset->m_pObjective->m_cFloatBytes, cTotalScores, cSubsetSamples)) {
-         LOG_0(Trace_Warning, "WARNING DataSetBoosting::InitGradHess IsMultiplyError(pSubset->m_pObjective->m_cFloatBytes, cTotalScores, cSubsetSamples)");
+      const size_t cBytesItem = GetCountBytesGradHessItem(gradHessFormat, pSubset->m_pObjective->m_cFloatBytes);
+      if(IsMultiplyError(cBytesItem, cTotalScores, cSubsetSamples)) {
+         LOG_0(Trace_Warning, "WARNING DataSetBoosting::InitGradHess IsMultiplyError(cBytesItem, cTotalScores, cSubsetSamples)");
          return Error_OutOfMemory;
       }
-      const size_t cBytesGradHess = pSubset->m_pObjective->m_cFloatBytes * cTotalScores * cSubsetSamples;
+      const size_t cBytesGradHess = cBytesItem * cTotalScores * cSubsetSamples;
       ANALYSIS_ASSERT(0 != cBytesGradHess);
 
       void * const aGradHess = AlignedAlloc(cBytesGradHess);
@@ -643,6 +647,174 @@ ErrorEbm DataSetBoosting::InitTermData(
 }
 WARNING_POP
 
+ErrorEbm DataSetBoosting::ShareTermData(const DataSetBoosting * const pTermDataShared, const size_t cTerms) {
+   LOG_0(Trace_Info, "Entered DataSetBoosting::ShareTermData");
+
+   EBM_ASSERT(nullptr != pTermDataShared);
+   EBM_ASSERT(1 <= cTerms);
+
+   // the packed term data only depends on which samples are included and how the samples are split into subsets,
+   // so it can be shared if our subsets are identical to the ones in pTermDataShared
+   if(m_cSamples != pTermDataShared->m_cSamples || m_cSubsets != pTermDataShared->m_cSubsets) {
+      LOG_0(Trace_Error, "ERROR DataSetBoosting::ShareTermData mismatched subsets");
+      return Error_UnexpectedInternal;
+   }
+
+   const DataSubsetBoosting * pSubsetFrom = pTermDataShared->m_aSubsets;
+   DataSubsetBoosting * pSubset = m_aSubsets;
+   const DataSubsetBoosting * const pSubsetsEnd = pSubset + m_cSubsets;
+   do {
+      if(pSubset->m_cSamples != pSubsetFrom->m_cSamples ||
+         pSubset->m_pObjective->m_cUIntBytes != pSubsetFrom->m_pObjective->m_cUIntBytes ||
+         pSubset->m_pObjective->m_cSIMDPack != pSubsetFrom->m_pObjective->m_cSIMDPack
+      ) {
+         LOG_0(Trace_Error, "ERROR DataSetBoosting::ShareTermData mismatched subset");
+         return Error_UnexpectedInternal;
+      }
+      EBM_ASSERT(nullptr != pSubsetFrom->m_aaTermData);
+      memcpy(pSubset->m_aaTermData, pSubsetFrom->m_aaTermData, sizeof(*pSubset->m_aaTermData) * cTerms);
+
+      ++pSubsetFrom;
+      ++pSubset;
+   } while(pSubsetsEnd != pSubset);
+   m_bTermDataShared = true;
+
+   LOG_0(Trace_Info, "Exited DataSetBoosting::ShareTermData");
+   return Error_None;
+}
+
+ErrorEbm DataSetBoosting::InitBagsMultiplied(
+   const unsigned char * const pDataSetShared,
+   const BagEbm direction,
+   const BagEbm * const aBag,
+   const BagEbm * const aBagMultipliers,
+   const size_t cWeights
+) {
+   // aBag selects the samples that we include, which are all the samples that our outer bag aBagMultipliers either
+   // trains or validates on.  The samples in the other direction are kept with zero weight and zero occurrences, 
+   // and the replicated samples have their weight and occurrences multiplied instead of being repeated in the 
+   // term data.
+
+   LOG_0(Trace_Info, "Entered DataSetBoosting::InitBagsMultiplied");
+
+   EBM_ASSERT(nullptr != pDataSetShared);
+   EBM_ASSERT(nullptr != aBag);
+   EBM_ASSERT(nullptr != aBagMultipliers);
+   EBM_ASSERT(1 <= m_cSamples);
+
+   double * pBagWeightTotals = static_cast<double *>(malloc(sizeof(double)));
+   if(nullptr == pBagWeightTotals) {
+      LOG_0(Trace_Warning, "WARNING DataSetBoosting::InitBagsMultiplied nullptr == pBagWeightTotals");
+      return Error_OutOfMemory;
+   }
+   m_aBagWeightTotals = pBagWeightTotals;
+
+   const FloatShared * aWeightsFrom = nullptr;
+   if(size_t { 0 } != cWeights) {
+      aWeightsFrom = GetDataSetSharedWeight(pDataSetShared, 0);
+      EBM_ASSERT(nullptr != aWeightsFrom);
+   }
+
+   EBM_ASSERT(nullptr != m_aSubsets);
+   EBM_ASSERT(1 <= m_cSubsets);
+   const DataSubsetBoosting * const pSubsetsEnd = m_aSubsets + m_cSubsets;
+
+   const BagEbm * pSampleReplication = aBag;
+   double totalWeight = 0.0;
+   size_t cBagSamples = 0;
+   DataSubsetBoosting * pSubset = m_aSubsets;
+   do {
+      const size_t cSubsetSamples = pSubset->GetCountSamples();
+      EBM_ASSERT(1 <= cSubsetSamples);
+
+      if(IsMultiplyError(pSubset->m_pObjective->m_cFloatBytes, cSubsetSamples)) {
+         LOG_0(Trace_Warning, "WARNING DataSetBoosting::InitBagsMultiplied IsMultiplyError(pSubset->m_pObjective->m_cFloatBytes, cSubsetSamples)");
+         return Error_OutOfMemory;
+      }
+      const size_t cBytes = pSubset->m_pObjective->m_cFloatBytes * cSubsetSamples;
+      void * pWeightTo = AlignedAlloc(cBytes);
+      if(nullptr == pWeightTo) {
+         LOG_0(Trace_Warning, "WARNING DataSetBoosting::InitBagsMultiplied nullptr == pWeightTo");
+         return Error_OutOfMemory;
+      }
+      EBM_ASSERT(nullptr != pSubset->m_aInnerBags);
+      InnerBag * const pInnerBag = &pSubset->m_aInnerBags[0];
+      pInnerBag->m_aWeights = pWeightTo;
+
+      uint8_t * pOccurrencesTo = static_cast<uint8_t *>(AlignedAlloc(sizeof(uint8_t) * cSubsetSamples));
+      if(nullptr == pOccurrencesTo) {
+         LOG_0(Trace_Warning, "WARNING DataSetBoosting::InitBagsMultiplied nullptr == pOccurrencesTo");
+         return Error_OutOfMemory;
+      }
+      pInnerBag->m_aCountOccurrences = pOccurrencesTo;
+
+      const void * const pWeightsToEnd = IndexByte(pWeightTo, cBytes);
+
+      // add the weights in 2 stages to preserve precision
+      double subsetWeight = 0.0;
+      do {
+         while(BagEbm { 0 } == *pSampleReplication) {
+            ++pSampleReplication;
+         }
+         EBM_ASSERT(BagEbm { 1 } == *pSampleReplication);
+         const size_t iSample = static_cast<size_t>(pSampleReplication - aBag);
+         ++pSampleReplication;
+
+         const BagEbm multiplier = aBagMultipliers[iSample];
+         uint8_t cOccurrences = uint8_t { 0 };
+         if(BagEbm { 0 } < direction) {
+            if(BagEbm { 0 } < multiplier) {
+               cOccurrences = static_cast<uint8_t>(multiplier);
+            }
+         } else if(multiplier < BagEbm { 0 }) {
+            // -128 fits into uint8_t after negating as an int
+            cOccurrences = static_cast<uint8_t>(-static_cast<int>(multiplier));
+         }
+         *pOccurrencesTo = cOccurrences;
+         ++pOccurrencesTo;
+         cBagSamples += static_cast<size_t>(cOccurrences);
+
+         double result = static_cast<double>(cOccurrences);
+         if(nullptr != aWeightsFrom) {
+            const double weight = static_cast<double>(aWeightsFrom[iSample]);
+
+            // these were checked when creating the shared dataset
+            EBM_ASSERT(!std::isnan(weight));
+            EBM_ASSERT(!std::isinf(weight));
+            EBM_ASSERT(static_cast<double>(std::numeric_limits<float>::min()) <= weight);
+            EBM_ASSERT(weight <= static_cast<double>(std::numeric_limits<float>::max()));
+
+            result *= weight;
+         }
+
+         subsetWeight += result;
+
+         if(sizeof(FloatBig) == pSubset->m_pObjective->m_cFloatBytes) {
+            *reinterpret_cast<FloatBig *>(pWeightTo) = static_cast<FloatBig>(result);
+         } else {
+            EBM_ASSERT(sizeof(FloatSmall) == pSubset->m_pObjective->m_cFloatBytes);
+            *reinterpret_cast<FloatSmall *>(pWeightTo) = static_cast<FloatSmall>(result);
+         }
+         pWeightTo = IndexByte(pWeightTo, pSubset->m_pObjective->m_cFloatBytes);
+      } while(pWeightsToEnd != pWeightTo);
+
+      totalWeight += subsetWeight;
+
+      ++pSubset;
+   } while(pSubsetsEnd != pSubset);
+
+   EBM_ASSERT(!std::isnan(totalWeight));
+   if(std::isinf(totalWeight)) {
+      LOG_0(Trace_Warning, "WARNING DataSetBoosting::InitBagsMultiplied std::isinf(totalWeight)");
+      return Error_UserParamVal;
+   }
+   *pBagWeightTotals = totalWeight;
+   m_cBagSamples = cBagSamples;
+
+   LOG_0(Trace_Info, "Exited DataSetBoosting::InitBagsMultiplied");
+   return Error_None;
+}
+
 WARNING_PUSH
 WARNING_DISABLE_UNINITIALIZED_LOCAL_VARIABLE
 WARNING_DISABLE_UNINITIALIZED_LOCAL_POINTER
@@ -936,6 +1108,7 @@ WARNING_POP
 ErrorEbm DataSetBoosting::InitDataSetBoosting(
    const bool bAllocateGradients,
    const bool bAllocateHessians,
+   const int gradHessFormat,
    const bool bAllocateSampleScores,
    const bool bAllocateTargetData,
    void * const rng,
@@ -953,7 +1126,9 @@ ErrorEbm DataSetBoosting::InitDataSetBoosting(
    const size_t cWeights,
    const size_t cTerms,
    const Term * const * const apTerms,
-   const IntEbm * const aiTermFeatures
+   const IntEbm * const aiTermFeatures,
+   const BagEbm * const aBagMultipliers,
+   const DataSetBoosting * const pTermDataShared
 ) {
    LOG_0(Trace_Info, "Entered DataSetBoosting::InitDataSetBoosting");
 
@@ -977,6 +1152,7 @@ ErrorEbm DataSetBoosting::InitDataSetBoosting(
       EBM_ASSERT(1 <= cSharedSamples);
 
       m_cSamples = cIncludedSamples;
+      m_cBagSamples = cIncludedSamples;
 
       EBM_ASSERT(1 == pObjectiveCpu->m_cSIMDPack);
       EBM_ASSERT(nullptr == pObjectiveSIMD->m_pObjective && 0 == pObjectiveSIMD->m_cSIMDPack ||
@@ -1073,7 +1249,7 @@ ErrorEbm DataSetBoosting::InitDataSetBoosting(
       EBM_ASSERT(0 == cIncludedSamplesRemaining);
 
       if(bAllocateGradients) {
-         error = InitGradHess(bAllocateHessians, cScores);
+         error = InitGradHess(bAllocateHessians, gradHessFormat, cScores);
          if(Error_None != error) {
             return error;
          }
@@ -1104,27 +1280,43 @@ ErrorEbm DataSetBoosting::InitDataSetBoosting(
          }
       }
 
-      error = InitTermData(
-         pDataSetShared,
-         direction,
-         cSharedSamples,
-         aBag,
-         cTerms,
-         apTerms,
-         aiTermFeatures
-      );
+      if(nullptr != pTermDataShared) {
+         error = ShareTermData(pTermDataShared, cTerms);
+      } else {
+         error = InitTermData(
+            pDataSetShared,
+            direction,
+            cSharedSamples,
+            aBag,
+            cTerms,
+            apTerms,
+            aiTermFeatures
+         );
+      }
       if(Error_None != error) {
          return error;
       }
 
-      error = InitBags(
-         rng,
-         pDataSetShared,
-         direction,
-         aBag,
-         cInnerBags,
-         cWeights
-      );
+      if(nullptr != aBagMultipliers) {
+         EBM_ASSERT(BagEbm { 1 } == direction);
+         EBM_ASSERT(size_t { 0 } == cInnerBags);
+         error = InitBagsMultiplied(
+            pDataSetShared,
+            direction,
+            aBag,
+            aBagMultipliers,
+            cWeights
+         );
+      } else {
+         error = InitBags(
+            rng,
+            pDataSetShared,
+            direction,
+            aBag,
+            cInnerBags,
+            cWeights
+         );
+      }
       if(Error_None != error) {
          return error;
       }
@@ -1134,6 +1326,232 @@ ErrorEbm DataSetBoosting::InitDataSetBoosting(
    return Error_None;
 }
 
+ErrorEbm DataSetBoosting::InitDataSetBoostingAlias(
+   const DataSetBoosting * const pDataSetAliased,
+   const unsigned char * const pDataSetShared,
+   const BagEbm direction,
+   const BagEbm * const aBag,
+   const BagEbm * const aBagMultipliers,
+   const size_t cWeights
+) {
+   // Our subsets point at the samples of pDataSetAliased, which were selected with the same aBag.  Only the
+   // weights and occurrences differ, so the samples that pDataSetAliased includes for the other direction of
+   // aBagMultipliers get zero weight here, and we avoid a second copy of the scores, targets, and term data.
+
+   LOG_0(Trace_Info, "Entered DataSetBoosting::InitDataSetBoostingAlias");
+
+   EBM_ASSERT(nullptr != pDataSetAliased);
+   EBM_ASSERT(!pDataSetAliased->m_bAlias);
+   EBM_ASSERT(1 <= pDataSetAliased->m_cSamples);
+   EBM_ASSERT(1 <= pDataSetAliased->m_cSubsets);
+
+   EBM_ASSERT(0 == m_cSamples);
+   EBM_ASSERT(0 == m_cSubsets);
+   EBM_ASSERT(nullptr == m_aSubsets);
+   EBM_ASSERT(nullptr == m_aBagWeightTotals);
+
+   const size_t cSubsets = pDataSetAliased->m_cSubsets;
+   // this cannot overflow since pDataSetAliased allocated the same amount
+   DataSubsetBoosting * pSubset = static_cast<DataSubsetBoosting *>(malloc(sizeof(DataSubsetBoosting) * cSubsets));
+   if(nullptr == pSubset) {
+      LOG_0(Trace_Warning, "WARNING DataSetBoosting::InitDataSetBoostingAlias nullptr == pSubset");
+      return Error_OutOfMemory;
+   }
+   m_aSubsets = pSubset;
+   m_cSubsets = cSubsets;
+   m_cSamples = pDataSetAliased->m_cSamples;
+   m_bAlias = true;
+
+   const DataSubsetBoosting * const pSubsetsEnd = pSubset + cSubsets;
+
+   DataSubsetBoosting * pSubsetInit = pSubset;
+   do {
+      pSubsetInit->SafeInitDataSubsetBoosting();
+      ++pSubsetInit;
+   } while(pSubsetsEnd != pSubsetInit);
+
+   const DataSubsetBoosting * pSubsetFrom = pDataSetAliased->m_aSubsets;
+   do {
+      pSubset->m_cSamples = pSubsetFrom->m_cSamples;
+      pSubset->m_pObjective = pSubsetFrom->m_pObjective;
+      pSubset->m_aGradHess = pSubsetFrom->m_aGradHess;
+      pSubset->m_aSampleScores = pSubsetFrom->m_aSampleScores;
+      pSubset->m_aTargetData = pSubsetFrom->m_aTargetData;
+      pSubset->m_aaTermData = pSubsetFrom->m_aaTermData;
+
+      InnerBag * const aInnerBags = InnerBag::AllocateInnerBags(0);
+      if(nullptr == aInnerBags) {
+         LOG_0(Trace_Warning, "WARNING DataSetBoosting::InitDataSetBoostingAlias nullptr == aInnerBags");
+         return Error_OutOfMemory;
+      }
+      pSubset->m_aInnerBags = aInnerBags;
+
+      ++pSubsetFrom;
+      ++pSubset;
+   } while(pSubsetsEnd != pSubset);
+
+   const ErrorEbm error = InitBagsMultiplied(pDataSetShared, direction, aBag, aBagMultipliers, cWeights);
+   if(Error_None != error) {
+      return error;
+   }
+
+   LOG_0(Trace_Info, "Exited DataSetBoosting::InitDataSetBoostingAlias");
+   return Error_None;
+}
+
+struct PlaceSubsetsTask final {
+   DataSubsetBoosting * m_aSubsets;
+   size_t m_iTaskFirst;
+   size_t m_cSubsets;
+   size_t m_cGradHessScores;
+   int m_gradHessFormat;
+   size_t m_cScores;
+   bool m_bClassification;
+   size_t m_cTerms;
+   const Term * const * m_apTerms;
+   size_t m_cInnerBagsAfterZero;
+   bool m_bTermDataShared;
+   bool m_bAlias;
+};
+
+// Copy the buffer into memory allocated and first touched by the current thread.  Large allocations come from
+// fresh pages, so the OS places them on the NUMA node of the CPU that the current thread is pinned to.
+static ErrorEbm MoveToCurrentThread(void ** const pa, const size_t cBytes) {
+   void * const aFrom = *pa;
+   if(nullptr != aFrom) {
+      EBM_ASSERT(size_t { 0 } != cBytes);
+      void * const aTo = AlignedAlloc(cBytes);
+      if(nullptr == aTo) {
+         return Error_OutOfMemory;
+      }
+      memcpy(aTo, aFrom, cBytes);
+      AlignedFree(aFrom);
+      *pa = aTo;
+   }
+   return Error_None;
+}
+
+ErrorEbm DataSetBoosting::PlaceSubset(void * const pContext, const size_t iThread, const size_t iTask) {
+   // this runs on the worker threads, so leave the logging to PlaceSubsets
+   UNUSED(iThread);
+
+   const PlaceSubsetsTask * const pTask = static_cast<const PlaceSubsetsTask *>(pContext);
+   if(iTask < pTask->m_iTaskFirst) {
+      // these task indexes belong to a different DataSetBoosting
+      return Error_None;
+   }
+   const size_t iSubset = iTask - pTask->m_iTaskFirst;
+   EBM_ASSERT(iSubset < pTask->m_cSubsets);
+   DataSubsetBoosting * const pSubset = &pTask->m_aSubsets[iSubset];
+
+   const size_t cSamples = pSubset->m_cSamples;
+   const size_t cFloatBytes = pSubset->m_pObjective->m_cFloatBytes;
+   const size_t cUIntBytes = pSubset->m_pObjective->m_cUIntBytes;
+
+   // the sizes below were checked for overflow when we allocated the original buffers
+   ErrorEbm error;
+   if(!pTask->m_bAlias) {
+      // an alias only owns its inner bags.  The DataSetBoosting that it aliases places everything else
+      const size_t cGradHessBytes = GetCountBytesGradHessItem(pTask->m_gradHessFormat, cFloatBytes);
+      error = MoveToCurrentThread(&pSubset->m_aGradHess, cGradHessBytes * pTask->m_cGradHessScores * cSamples);
+      if(Error_None != error) {
+         return error;
+      }
+      error = MoveToCurrentThread(&pSubset->m_aSampleScores, cFloatBytes * pTask->m_cScores * cSamples);
+      if(Error_None != error) {
+         return error;
+      }
+      error = MoveToCurrentThread(&pSubset->m_aTargetData, 
+         (pTask->m_bClassification ? cUIntBytes : cFloatBytes) * cSamples);
+      if(Error_None != error) {
+         return error;
+      }
+
+      if(!pTask->m_bTermDataShared) {
+         // the DataSetBoosting that owns shared term data places it
+         const size_t cSIMDPack = pSubset->m_pObjective->m_cSIMDPack;
+         const size_t cParallelSamples = cSamples / cSIMDPack;
+         for(size_t iTerm = 0; iTerm < pTask->m_cTerms; ++iTerm) {
+            const Term * const pTerm = pTask->m_apTerms[iTerm];
+            if(0 != pTerm->GetCountRealDimensions()) {
+               const int cItemsPerBitPack = GetCountItemsBitPacked(pTerm->GetBitsRequiredMin(), cUIntBytes);
+               const size_t cParallelDataUnits = 
+                  (cParallelSamples - size_t { 1 }) / static_cast<size_t>(cItemsPerBitPack) + size_t { 1 };
+               error = MoveToCurrentThread(&pSubset->m_aaTermData[iTerm], cUIntBytes * cParallelDataUnits * cSIMDPack);
+               if(Error_None != error) {
+                  return error;
+               }
+            }
+         }
+      }
+   }
+
+   InnerBag * pInnerBag = pSubset->m_aInnerBags;
+   const InnerBag * const pInnerBagsEnd = pInnerBag + pTask->m_cInnerBagsAfterZero;
+   do {
+      error = MoveToCurrentThread(&pInnerBag->m_aWeights, cFloatBytes * cSamples);
+      if(Error_None != error) {
+         return error;
+      }
+      void * aCountOccurrences = pInnerBag->m_aCountOccurrences;
+      error = MoveToCurrentThread(&aCountOccurrences, sizeof(uint8_t) * cSamples);
+      pInnerBag->m_aCountOccurrences = static_cast<uint8_t *>(aCountOccurrences);
+      if(Error_None != error) {
+         return error;
+      }
+      ++pInnerBag;
+   } while(pInnerBagsEnd != pInnerBag);
+
+   return Error_None;
+}
+
+ErrorEbm DataSetBoosting::PlaceSubsets(
+   ThreadPool * const pThreadPool,
+   const size_t iTaskFirst,
+   const bool bHessian,
+   const int gradHessFormat,
+   const bool bClassification,
+   const size_t cScores,
+   const size_t cTerms,
+   const Term * const * const apTerms,
+   const size_t cInnerBags
+) {
+   // InitDataSetBoosting fills all the subsets from the calling thread, which puts all of their memory on the NUMA
+   // node of the calling thread.  A pinned ThreadPool runs the task with index iTaskFirst + iSubset on the same
+   // thread every time, so we move each subset into memory first touched by that thread.
+
+   LOG_0(Trace_Info, "Entered DataSetBoosting::PlaceSubsets");
+
+   EBM_ASSERT(nullptr != pThreadPool);
+   EBM_ASSERT(pThreadPool->IsPinned());
+   EBM_ASSERT(1 <= cScores);
+
+   if(size_t { 0 } != m_cSubsets) {
+      PlaceSubsetsTask task;
+      task.m_aSubsets = m_aSubsets;
+      task.m_iTaskFirst = iTaskFirst;
+      task.m_cSubsets = m_cSubsets;
+      task.m_cGradHessScores = bHessian ? cScores << 1 : cScores;
+      task.m_gradHessFormat = gradHessFormat;
+      task.m_cScores = cScores;
+      task.m_bClassification = bClassification;
+      task.m_cTerms = cTerms;
+      task.m_apTerms = apTerms;
+      task.m_cInnerBagsAfterZero = size_t { 0 } == cInnerBags ? size_t { 1 } : cInnerBags;
+      task.m_bTermDataShared = m_bTermDataShared;
+      task.m_bAlias = m_bAlias;
+
+      const ErrorEbm error = ThreadPool::Execute(pThreadPool, iTaskFirst + m_cSubsets, PlaceSubset, &task);
+      if(Error_None != error) {
+         LOG_0(Trace_Warning, "WARNING DataSetBoosting::PlaceSubsets PlaceSubset failed");
+         return error;
+      }
+   }
+
+   LOG_0(Trace_Info, "Exited DataSetBoosting::PlaceSubsets");
+   return Error_None;
+}
+
 void DataSetBoosting::DestructDataSetBoosting(const size_t cTerms, const size_t cInnerBags) {
    LOG_0(Trace_Info, "Entered DataSetBoosting::DestructDataSetBoosting");
 
@@ -1144,6 +1562,19 @@ void DataSetBoosting::DestructDataSetBoosting(const size_t cTerms, const size_t
       EBM_ASSERT(1 <= m_cSubsets);
       const DataSubsetBoosting * const pSubsetsEnd = pSubset + m_cSubsets;
       do {
+         if(m_bAlias) {
+            // the DataSetBoosting that we alias frees everything except our inner bags
+            pSubset->m_aGradHess = nullptr;
+            pSubset->m_aSampleScores = nullptr;
+            pSubset->m_aTargetData = nullptr;
+            pSubset->m_aaTermData = nullptr;
+         } else if(m_bTermDataShared && nullptr != pSubset->m_aaTermData) {
+            // the DataSetBoosting that we borrowed the term data from frees it
+            EBM_ASSERT(1 <= cTerms);
+            for(size_t iTerm = 0; iTerm < cTerms; ++iTerm) {
+               pSubset->m_aaTermData[iTerm] = nullptr;
+            }
+         }
          pSubset->DestructDataSubsetBoosting(cTerms, cInnerBags);
          ++pSubset;
       } while(pSubsetsEnd != pSubset);
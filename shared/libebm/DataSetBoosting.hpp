@@ -22,6 +22,7 @@ namespace DEFINED_ZONE_NAME {
 #endif // DEFINED_ZONE_NAME
 
 class Term;
+class ThreadPool;
 struct DataSetBoosting;
 
 struct DataSubsetBoosting final {
@@ -69,6 +70,14 @@ struct DataSubsetBoosting final {
       return (*m_pObjective->m_pBinSumsBoostingC)(m_pObjective, pParams);
    }
 
+   inline ErrorEbm BinSumsBoostingMulti(BinSumsBoostingMultiBridge * const pParams) {
+      EBM_ASSERT(nullptr != pParams);
+      EBM_ASSERT(nullptr != m_pObjective);
+      EBM_ASSERT(nullptr != m_pObjective->m_pBinSumsBoostingMultiC);
+      EBM_ASSERT(0 == m_cSamples % m_pObjective->m_cSIMDPack);
+      return (*m_pObjective->m_pBinSumsBoostingMultiC)(m_pObjective, pParams);
+   }
+
    inline void * GetGradHess() {
       return m_aGradHess;
    }
@@ -114,14 +123,18 @@ struct DataSetBoosting final {
 
    inline void SafeInitDataSetBoosting() {
       m_cSamples = 0;
+      m_cBagSamples = 0;
       m_cSubsets = 0;
       m_aSubsets = nullptr;
       m_aBagWeightTotals = nullptr;
+      m_bTermDataShared = false;
+      m_bAlias = false;
    }
 
    ErrorEbm InitDataSetBoosting(
       const bool bAllocateGradients,
       const bool bAllocateHessians,
+      const int gradHessFormat,
       const bool bAllocateSampleScores,
       const bool bAllocateTargetData,
       void * const rng,
@@ -139,7 +152,30 @@ struct DataSetBoosting final {
       const size_t cWeights,
       const size_t cTerms,
       const Term * const * const apTerms,
-      const IntEbm * const aiTermFeatures
+      const IntEbm * const aiTermFeatures,
+      const BagEbm * const aBagMultipliers,
+      const DataSetBoosting * const pTermDataShared
+   );
+
+   ErrorEbm InitDataSetBoostingAlias(
+      const DataSetBoosting * const pDataSetAliased,
+      const unsigned char * const pDataSetShared,
+      const BagEbm direction,
+      const BagEbm * const aBag,
+      const BagEbm * const aBagMultipliers,
+      const size_t cWeights
+   );
+
+   ErrorEbm PlaceSubsets(
+      ThreadPool * const pThreadPool,
+      const size_t iTaskFirst,
+      const bool bHessian,
+      const int gradHessFormat,
+      const bool bClassification,
+      const size_t cScores,
+      const size_t cTerms,
+      const Term * const * const apTerms,
+      const size_t cInnerBags
    );
 
    void DestructDataSetBoosting(const size_t cTerms, const size_t cInnerBags);
@@ -147,6 +183,10 @@ struct DataSetBoosting final {
    inline size_t GetCountSamples() const {
       return m_cSamples;
    }
+   inline size_t GetCountBagSamples() const {
+      // the sum of the occurrences in the bags, which only differs from m_cSamples when we hold zero weighted samples
+      return m_cBagSamples;
+   }
    inline size_t GetCountSubsets() const {
       return m_cSubsets;
    }
@@ -158,11 +198,17 @@ struct DataSetBoosting final {
       EBM_ASSERT(nullptr != m_aBagWeightTotals);
       return m_aBagWeightTotals[iBag];
    }
+   inline bool IsAlias() const {
+      return m_bAlias;
+   }
 
 private:
 
+   static ErrorEbm PlaceSubset(void * const pContext, const size_t iThread, const size_t iTask);
+
    ErrorEbm InitGradHess(
       const bool bAllocateHessians,
+      const int gradHessFormat,
       const size_t cScores
    );
 
@@ -189,6 +235,8 @@ private:
       const IntEbm * const aiTermFeatures
    );
 
+   ErrorEbm ShareTermData(const DataSetBoosting * const pTermDataShared, const size_t cTerms);
+
    ErrorEbm InitBags(
       void * const rng,
       const unsigned char * const pDataSetShared,
@@ -198,10 +246,23 @@ private:
       const size_t cWeights
    );
 
+   ErrorEbm InitBagsMultiplied(
+      const unsigned char * const pDataSetShared,
+      const BagEbm direction,
+      const BagEbm * const aBag,
+      const BagEbm * const aBagMultipliers,
+      const size_t cWeights
+   );
+
    size_t m_cSamples;
+   size_t m_cBagSamples;
    size_t m_cSubsets;
    DataSubsetBoosting * m_aSubsets;
    double * m_aBagWeightTotals;
+   // true if m_aaTermData in our subsets points into another DataSetBoosting that owns the memory
+   bool m_bTermDataShared;
+   // true if our subsets hold the samples of another DataSetBoosting and only our inner bags belong to us
+   bool m_bAlias;
 };
 static_assert(std::is_standard_layout<DataSetBoosting>::value,
    "We use the struct hack in several places, so disallow non-standard_layout types in general");
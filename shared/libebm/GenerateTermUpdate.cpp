@@ -24,6 +24,7 @@
 #include "Term.hpp"
 #include "InnerBag.hpp"
 #include "Tensor.hpp"
+#include "ThreadPool.hpp"
 #include "BoosterCore.hpp"
 #include "BoosterShell.hpp"
 
@@ -38,6 +39,7 @@ extern void ConvertAddBin(
    const size_t cBins,
    const bool bUInt64Src,
    const bool bDoubleSrc,
+   const bool bWeightSrc,
    const void * const aSrc,
    const bool bUInt64Dest,
    const bool bDoubleDest,
@@ -163,7 +165,7 @@ static ErrorEbm BoostSingleDimensional(
 
    BoosterCore * const pBoosterCore = pBoosterShell->GetBoosterCore();
 
-   EBM_ASSERT(1 <= pBoosterCore->GetTrainingSet()->GetCountSamples());
+   EBM_ASSERT(1 <= pBoosterCore->GetTrainingSet()->GetCountBagSamples());
 
    error = PartitionOneDimensionalBoosting(
       pRng,
@@ -172,7 +174,7 @@ static ErrorEbm BoostSingleDimensional(
       iDimension,
       cSamplesLeafMin,
       cSplitsMax,
-      pBoosterCore->GetTrainingSet()->GetCountSamples(),
+      pBoosterCore->GetTrainingSet()->GetCountBagSamples(),
       weightTotal,
       pTotalGain
    );
@@ -440,6 +442,508 @@ static ErrorEbm BoostRandom(
    return Error_None;
 }
 
+extern size_t GetCountBytesPerFastBin(
+   const DataSubsetBoosting * const pSubset, 
+   const bool bHessian, 
+   const size_t cScores, 
+   const bool bWeight
+) {
+   // the compute zones drop the weight from the fast bins when the bag has no sample weights
+   if(sizeof(UIntBig) == pSubset->GetObjectiveWrapper()->m_cUIntBytes) {
+      if(sizeof(FloatBig) == pSubset->GetObjectiveWrapper()->m_cFloatBytes) {
+         return GetBinSize<FloatBig, UIntBig>(bHessian, cScores, bWeight);
+      } else {
+         EBM_ASSERT(sizeof(FloatSmall) == pSubset->GetObjectiveWrapper()->m_cFloatBytes);
+         return GetBinSize<FloatSmall, UIntBig>(bHessian, cScores, bWeight);
+      }
+   } else {
+      EBM_ASSERT(sizeof(UIntSmall) == pSubset->GetObjectiveWrapper()->m_cUIntBytes);
+      if(sizeof(FloatBig) == pSubset->GetObjectiveWrapper()->m_cFloatBytes) {
+         return GetBinSize<FloatBig, UIntSmall>(bHessian, cScores, bWeight);
+      } else {
+         EBM_ASSERT(sizeof(FloatSmall) == pSubset->GetObjectiveWrapper()->m_cFloatBytes);
+         return GetBinSize<FloatSmall, UIntSmall>(bHessian, cScores, bWeight);
+      }
+   }
+}
+
+extern int GetBinRangeShift(
+   const size_t cBytesPerFastBin,
+   const size_t cTensorBins,
+   const size_t cBytesHistogramCache
+) {
+   // sort the samples into ranges of bins that each fill about half the cache, leaving the rest for the gradients
+   const size_t cBytesRange = cBytesHistogramCache >> 1;
+   int cBinRangeShift = 0;
+   while(cBytesPerFastBin << (cBinRangeShift + 1) <= cBytesRange) {
+      ++cBinRangeShift;
+   }
+   while(k_cBinSumsSortRangesMax < ((cTensorBins - size_t { 1 }) >> cBinRangeShift) + size_t { 1 }) {
+      ++cBinRangeShift;
+   }
+   return cBinRangeShift;
+}
+
+struct BinSumsBoostingTask {
+   bool m_bHessian;
+   int m_gradHessFormat;
+   size_t m_cScores;
+   bool m_bSingleBin;
+   const Term * m_pTerm;
+   size_t m_iTerm;
+   size_t m_iBag;
+   size_t m_cTensorBins;
+   DataSubsetBoosting * m_aSubsets;
+   BinBase * m_aFastBins;
+   size_t m_cBytesFastBins; // the distance between the fast bins of each task
+   size_t m_cBytesHistogramCache;
+   void * m_aSortScratch; // nullptr if no term needs to be sorted by bin range
+   size_t m_cBytesSortScratch; // the distance between the sort scratch of each task
+};
+
+static ErrorEbm BinSumsBoostingSubset(void * const pContext, const size_t iThread, const size_t iTask) {
+   // each task bins one subset into its own fast bins.  We index the fast bins by iTask instead of iThread
+   // so that the caller can combine them in subset order afterwards
+   UNUSED(iThread);
+
+   const BinSumsBoostingTask * const pTask = static_cast<const BinSumsBoostingTask *>(pContext);
+   DataSubsetBoosting * const pSubset = &pTask->m_aSubsets[iTask];
+
+   int cPack;
+   if(UNLIKELY(pTask->m_bSingleBin)) {
+      // this is kind of hacky where if any one of a number of things occurs (like we have only 1 leaf)
+      // we sum everything into a single bin. The alternative would be to always sum into the tensor bins
+      // but then collapse them afterwards into a single bin, but that's more work.
+      cPack = k_cItemsPerBitPackNone;
+   } else {
+      EBM_ASSERT(1 <= pTask->m_pTerm->GetBitsRequiredMin());
+      cPack = GetCountItemsBitPacked(pTask->m_pTerm->GetBitsRequiredMin(), pSubset->GetObjectiveWrapper()->m_cUIntBytes);
+   }
+
+   const void * const aWeights = pSubset->GetInnerBag(pTask->m_iBag)->GetWeights();
+   const size_t cBytesPerFastBin = 
+      GetCountBytesPerFastBin(pSubset, pTask->m_bHessian, pTask->m_cScores, nullptr != aWeights);
+   EBM_ASSERT(!IsMultiplyError(cBytesPerFastBin, pTask->m_cTensorBins));
+   EBM_ASSERT(cBytesPerFastBin * pTask->m_cTensorBins <= pTask->m_cBytesFastBins);
+
+   BinBase * const aFastBins = IndexBin(pTask->m_aFastBins, pTask->m_cBytesFastBins * iTask);
+   aFastBins->ZeroMem(cBytesPerFastBin, pTask->m_cTensorBins);
+
+   BinSumsBoostingBridge params;
+   params.m_bHessian = pTask->m_bHessian ? EBM_TRUE : EBM_FALSE;
+   params.m_gradHessFormat = pTask->m_gradHessFormat;
+   params.m_cScores = pTask->m_cScores;
+   params.m_cPack = cPack;
+   params.m_cSamples = pSubset->GetCountSamples();
+   params.m_aGradientsAndHessians = pSubset->GetGradHess();
+   params.m_aWeights = aWeights;
+   params.m_pCountOccurrences = pSubset->GetInnerBag(pTask->m_iBag)->GetCountOccurrences();
+   params.m_aPacked = pSubset->GetTermData(pTask->m_iTerm);
+   params.m_cBins = pTask->m_cTensorBins;
+   params.m_aFastBins = aFastBins;
+   params.m_aSortScratch = nullptr;
+   params.m_cBinRangeShift = 0;
+   const int binSumsPlan = pTask->m_pTerm->GetBinSumsPlan();
+   if(k_cItemsPerBitPackNone != cPack && nullptr != pTask->m_aSortScratch && 
+      (k_binSumsPlanSorted == binSumsPlan || (k_binSumsPlanHeuristic == binSumsPlan && 
+      pTask->m_cBytesHistogramCache < cBytesPerFastBin * pTask->m_cTensorBins))) {
+      // Adding each sample to its bin would miss the cache for nearly every sample, so have the kernel sort the 
+      // samples into ranges of bins that each fill about half the cache, leaving the rest for the gradients.
+      EBM_ASSERT(size_t { 2 } * pSubset->GetObjectiveWrapper()->m_cUIntBytes * pSubset->GetCountSamples() <= 
+         pTask->m_cBytesSortScratch);
+      params.m_aSortScratch = IndexByte(pTask->m_aSortScratch, pTask->m_cBytesSortScratch * iTask);
+      params.m_cBinRangeShift = 
+         GetBinRangeShift(cBytesPerFastBin, pTask->m_cTensorBins, pTask->m_cBytesHistogramCache);
+   }
+#ifndef NDEBUG
+   params.m_pDebugFastBinsEnd = IndexBin(aFastBins, cBytesPerFastBin * pTask->m_cTensorBins);
+#endif // NDEBUG
+   return pSubset->BinSumsBoosting(&params);
+}
+
+inline static size_t GetMainsFastBinsStride(const size_t cBytesPerFastBin, const size_t cBins) {
+   // BinSumsMains keeps the fast bins of each main term aligned for SIMD
+   return (cBytesPerFastBin * cBins + SIMD_BYTE_ALIGNMENT - size_t { 1 }) & ~(SIMD_BYTE_ALIGNMENT - size_t { 1 });
+}
+
+struct BinSumsMainsTask {
+   const BoosterShell * m_pBoosterShell;
+   bool m_bHessian;
+   int m_gradHessFormat;
+   size_t m_cScores;
+   size_t m_cTerms;
+   const Term * const * m_apTerms;
+   DataSubsetBoosting * m_aSubsets;
+   BinBase * m_aFastBins;
+   size_t m_cBytesFastBins; // the distance between the fast bins of each task
+};
+
+static ErrorEbm BinSumsMainsSubset(void * const pContext, const size_t iThread, const size_t iTask) {
+   // each task bins every main term of one subset into its own fast bins, which hold the terms one after another.
+   // We index the fast bins by iTask instead of iThread so that the caller can combine them in subset order 
+   // afterwards
+   UNUSED(iThread);
+
+   const BinSumsMainsTask * const pTask = static_cast<const BinSumsMainsTask *>(pContext);
+   DataSubsetBoosting * const pSubset = &pTask->m_aSubsets[iTask];
+
+   const void * const aWeights = pSubset->GetInnerBag(0)->GetWeights();
+   const size_t cBytesPerFastBin = 
+      GetCountBytesPerFastBin(pSubset, pTask->m_bHessian, pTask->m_cScores, nullptr != aWeights);
+
+   BinSumsBoostingMultiBridge params;
+   params.m_bHessian = pTask->m_bHessian ? EBM_TRUE : EBM_FALSE;
+   params.m_gradHessFormat = pTask->m_gradHessFormat;
+   params.m_cScores = pTask->m_cScores;
+   params.m_cSamples = pSubset->GetCountSamples();
+   params.m_aGradientsAndHessians = pSubset->GetGradHess();
+   params.m_aWeights = aWeights;
+   params.m_pCountOccurrences = pSubset->GetInnerBag(0)->GetCountOccurrences();
+
+   BinBase * pFastBins = IndexBin(pTask->m_aFastBins, pTask->m_cBytesFastBins * iTask);
+   size_t iTermNext = 0;
+   while(true) {
+      params.m_cTerms = 0;
+      while(iTermNext < pTask->m_cTerms && params.m_cTerms < k_cBinSumsMultiTermsMax) {
+         if(BoosterShell::k_notCached != pTask->m_pBoosterShell->GetMainsBinsCacheOffset(iTermNext)) {
+            const Term * const pTerm = pTask->m_apTerms[iTermNext];
+            const size_t cBins = pTerm->GetCountTensorBins();
+            EBM_ASSERT(1 <= pTerm->GetBitsRequiredMin());
+
+            pFastBins->ZeroMem(cBytesPerFastBin, cBins);
+
+            params.m_acPack[params.m_cTerms] = 
+               GetCountItemsBitPacked(pTerm->GetBitsRequiredMin(), pSubset->GetObjectiveWrapper()->m_cUIntBytes);
+            params.m_aaPacked[params.m_cTerms] = pSubset->GetTermData(iTermNext);
+            params.m_acBins[params.m_cTerms] = cBins;
+            params.m_aaFastBins[params.m_cTerms] = pFastBins;
+            ++params.m_cTerms;
+
+            // the scratch space was sized with the largest fast bins and with each term aligned for SIMD
+            pFastBins = IndexBin(pFastBins, GetMainsFastBinsStride(cBytesPerFastBin, cBins));
+         }
+         ++iTermNext;
+      }
+      if(size_t { 0 } == params.m_cTerms) {
+         return Error_None;
+      }
+
+      const ErrorEbm error = pSubset->BinSumsBoostingMulti(&params);
+      if(Error_None != error) {
+         return error;
+      }
+   }
+}
+
+static ErrorEbm BinSumsMains(BoosterShell * const pBoosterShell) {
+   // bins every main term of the first inner bag into pBoosterShell->GetMainsBinsCache() with a single pass over 
+   // the gradients of each subset per group of k_cBinSumsMultiTermsMax terms.  The bins of each term are summed 
+   // in the same order as BoostBag would sum them, so the cached histograms are identical to binning each term 
+   // separately.
+
+   LOG_0(Trace_Verbose, "Entered BinSumsMains");
+
+   BoosterCore * const pBoosterCore = pBoosterShell->GetBoosterCore();
+   const size_t cScores = pBoosterCore->GetCountScores();
+   const bool bHessian = pBoosterCore->IsHessian();
+   const size_t cTerms = pBoosterCore->GetCountTerms();
+   const Term * const * const apTerms = pBoosterCore->GetTerms();
+
+   BinBase * const aMainsBins = pBoosterShell->GetMainsBinsCache();
+   EBM_ASSERT(nullptr != aMainsBins);
+   BinBase * const aMainsFastBins = pBoosterShell->GetMainsFastBinsTemp();
+   EBM_ASSERT(nullptr != aMainsFastBins);
+
+   const size_t cBytesPerMainBin = GetBinSize<FloatMain, UIntMain>(bHessian, cScores);
+
+   size_t cBytesMainsBins = 0;
+   for(size_t iTerm = 0; iTerm < cTerms; ++iTerm) {
+      if(BoosterShell::k_notCached != pBoosterShell->GetMainsBinsCacheOffset(iTerm)) {
+         cBytesMainsBins += cBytesPerMainBin * apTerms[iTerm]->GetCountTensorBins();
+      }
+   }
+   memset(aMainsBins, 0, cBytesMainsBins);
+
+   BinSumsMainsTask task;
+   task.m_pBoosterShell = pBoosterShell;
+   task.m_bHessian = bHessian;
+   task.m_gradHessFormat = pBoosterCore->GetGradHessFormat();
+   task.m_cScores = cScores;
+   task.m_cTerms = cTerms;
+   task.m_apTerms = apTerms;
+   task.m_aFastBins = aMainsFastBins;
+   task.m_cBytesFastBins = pBoosterShell->GetCountBytesMainsFastBins();
+
+   const size_t cFastBinsParallel = pBoosterCore->GetCountFastBinsParallel();
+   DataSubsetBoosting * pSubset = pBoosterCore->GetTrainingSet()->GetSubsets();
+   const DataSubsetBoosting * const pSubsetsEnd = pSubset + pBoosterCore->GetTrainingSet()->GetCountSubsets();
+   do {
+      // bin up to cFastBinsParallel subsets concurrently, each into its own fast bins, and then add them
+      // to the main bins in subset order so that our results are identical for any number of threads
+      const size_t cSubsetsParallel = EbmMin(cFastBinsParallel, static_cast<size_t>(pSubsetsEnd - pSubset));
+      task.m_aSubsets = pSubset;
+      const ErrorEbm error = ThreadPool::Execute(
+         pBoosterCore->GetThreadPool(),
+         cSubsetsParallel,
+         BinSumsMainsSubset,
+         &task
+      );
+      if(Error_None != error) {
+         return error;
+      }
+
+      size_t iSubsetParallel = 0;
+      do {
+         const void * const aWeights = pSubset->GetInnerBag(0)->GetWeights();
+         const size_t cBytesPerFastBin = GetCountBytesPerFastBin(pSubset, bHessian, cScores, nullptr != aWeights);
+
+         const BinBase * pFastBins = IndexBin(aMainsFastBins, task.m_cBytesFastBins * iSubsetParallel);
+         for(size_t iTerm = 0; iTerm < cTerms; ++iTerm) {
+            if(BoosterShell::k_notCached != pBoosterShell->GetMainsBinsCacheOffset(iTerm)) {
+               const size_t cBins = apTerms[iTerm]->GetCountTensorBins();
+               ConvertAddBin(
+                  cScores,
+                  bHessian,
+                  cBins,
+                  sizeof(UIntBig) == pSubset->GetObjectiveWrapper()->m_cUIntBytes,
+                  sizeof(FloatBig) == pSubset->GetObjectiveWrapper()->m_cFloatBytes,
+                  nullptr != aWeights,
+                  pFastBins,
+                  std::is_same<UIntMain, uint64_t>::value,
+                  std::is_same<FloatMain, double>::value,
+                  IndexBin(aMainsBins, pBoosterShell->GetMainsBinsCacheOffset(iTerm))
+               );
+               pFastBins = IndexBin(pFastBins, GetMainsFastBinsStride(cBytesPerFastBin, cBins));
+            }
+         }
+         ++pSubset;
+         ++iSubsetParallel;
+      } while(cSubsetsParallel != iSubsetParallel);
+   } while(pSubsetsEnd != pSubset);
+
+   LOG_0(Trace_Verbose, "Exited BinSumsMains");
+   return Error_None;
+}
+
+struct BoostBagTask {
+   BoosterShell * m_pBoosterShell;
+   size_t m_iTerm;
+   TermBoostFlags m_flags;
+   const IntEbm * m_aLeavesMax;
+   IntEbm m_lastDimensionLeavesMax;
+   size_t m_cSignificantBinCount;
+   size_t m_iDimensionImportant;
+   size_t m_cSamplesLeafMin;
+   size_t m_cTensorBins;
+   double m_gainMultiple;
+   size_t m_iBagStart; // the inner bag of the first task in the current call to ThreadPool::Execute
+   const BinBase * m_aMainBinsCached; // if not nullptr, the already summed main bins of our term
+};
+
+static ErrorEbm BoostBag(
+   const BoostBagTask * const pTask,
+   BoosterShell * const pBoosterShell,
+   RandomDeterministic * const pRng,
+   const size_t iBag,
+   const size_t cFastBinsParallel,
+   double * const pGain
+) {
+   // bins the training set for one inner bag into the main bins of pBoosterShell and then partitions them into
+   // pBoosterShell->GetInnerTermUpdate().  pBoosterShell is either the shell that our caller gave us, or one of
+   // its bag shells if we are boosting multiple inner bags at the same time
+
+   ErrorEbm error;
+
+   BoosterCore * const pBoosterCore = pBoosterShell->GetBoosterCore();
+   const size_t cScores = pBoosterCore->GetCountScores();
+   const size_t cTensorBins = pTask->m_cTensorBins;
+   const TermBoostFlags flags = pTask->m_flags;
+   const size_t iTerm = pTask->m_iTerm;
+   const Term * const pTerm = pBoosterCore->GetTerms()[iTerm];
+   const size_t cRealDimensions = pTerm->GetCountRealDimensions();
+
+   *pGain = 0.0;
+
+   BinBase * const aFastBins = pBoosterShell->GetBoostingFastBinsTemp();
+   EBM_ASSERT(nullptr != aFastBins);
+
+   const size_t cBytesPerMainBin = GetBinSize<FloatMain, UIntMain>(pBoosterCore->IsHessian(), cScores);
+   EBM_ASSERT(!IsMultiplyError(cBytesPerMainBin, cTensorBins));
+   const size_t cBytesMainBins = cBytesPerMainBin * cTensorBins;
+
+   BinBase * const aMainBins = pBoosterShell->GetBoostingMainBins();
+   EBM_ASSERT(nullptr != aMainBins);
+
+#ifndef NDEBUG
+   size_t cAuxillaryBins = pTerm->GetCountAuxillaryBins();
+   if(0 != (TermBoostFlags_RandomSplits & flags) || 2 < cRealDimensions) {
+      // if we're doing random boosting we allocated the auxillary memory, but we don't need it
+      cAuxillaryBins = 0;
+   }
+   EBM_ASSERT(!IsAddError(cTensorBins, cAuxillaryBins));
+   EBM_ASSERT(!IsMultiplyError(cBytesPerMainBin, cTensorBins + cAuxillaryBins));
+   pBoosterShell->SetDebugMainBinsEnd(IndexBin(aMainBins, cBytesPerMainBin * (cTensorBins + cAuxillaryBins)));
+#endif // NDEBUG
+
+   BinSumsBoostingTask binSumsTask;
+   binSumsTask.m_bHessian = pBoosterCore->IsHessian();
+   binSumsTask.m_gradHessFormat = pBoosterCore->GetGradHessFormat();
+   binSumsTask.m_cScores = cScores;
+   binSumsTask.m_bSingleBin = IntEbm { 0 } == pTask->m_lastDimensionLeavesMax;
+   binSumsTask.m_pTerm = pTerm;
+   binSumsTask.m_iTerm = iTerm;
+   binSumsTask.m_iBag = iBag;
+   binSumsTask.m_cTensorBins = cTensorBins;
+   binSumsTask.m_aFastBins = aFastBins;
+   binSumsTask.m_cBytesFastBins = pBoosterCore->GetCountBytesFastBins();
+   binSumsTask.m_cBytesHistogramCache = pBoosterCore->GetCountBytesHistogramCache();
+   binSumsTask.m_aSortScratch = pBoosterShell->GetSortScratchTemp();
+   binSumsTask.m_cBytesSortScratch = pBoosterCore->GetCountBytesSortScratch();
+
+   if(nullptr != pTask->m_aMainBinsCached) {
+      EBM_ASSERT(size_t { 0 } == iBag);
+      memcpy(aMainBins, pTask->m_aMainBinsCached, cBytesMainBins);
+   } else {
+      memset(aMainBins, 0, cBytesMainBins);
+
+      EBM_ASSERT(1 <= pBoosterCore->GetTrainingSet()->GetCountSubsets());
+      DataSubsetBoosting * pSubset = pBoosterCore->GetTrainingSet()->GetSubsets();
+      const DataSubsetBoosting * const pSubsetsEnd = pSubset + pBoosterCore->GetTrainingSet()->GetCountSubsets();
+      do {
+         // bin up to cFastBinsParallel subsets concurrently, each into its own fast bins, and then add them
+         // to the main bins in subset order so that our results are identical for any number of threads
+         const size_t cSubsetsParallel = EbmMin(cFastBinsParallel, static_cast<size_t>(pSubsetsEnd - pSubset));
+         binSumsTask.m_aSubsets = pSubset;
+         error = ThreadPool::Execute(
+            pBoosterCore->GetThreadPool(), 
+            cSubsetsParallel, 
+            BinSumsBoostingSubset, 
+            &binSumsTask
+         );
+         if(Error_None != error) {
+            return error;
+         }
+
+         size_t iSubsetParallel = 0;
+         do {
+            ConvertAddBin(
+               cScores,
+               pBoosterCore->IsHessian(),
+               cTensorBins,
+               sizeof(UIntBig) == pSubset->GetObjectiveWrapper()->m_cUIntBytes,
+               sizeof(FloatBig) == pSubset->GetObjectiveWrapper()->m_cFloatBytes,
+               nullptr != pSubset->GetInnerBag(iBag)->GetWeights(),
+               IndexBin(aFastBins, pBoosterCore->GetCountBytesFastBins() * iSubsetParallel),
+               std::is_same<UIntMain, uint64_t>::value,
+               std::is_same<FloatMain, double>::value,
+               aMainBins
+            );
+            ++pSubset;
+            ++iSubsetParallel;
+         } while(cSubsetsParallel != iSubsetParallel);
+      } while(pSubsetsEnd != pSubset);
+   }
+
+   // TODO: we can exit here back to python to allow caller modification to our histograms
+   //       although having inner bags makes this complicated since each inner bag has it's own
+   //       histogram, so we'd need to exit and re-enter 100 times over if we had 100 inner bags
+   //       and we'd need to have the BinBoosting function be called 100 times, followed by 100 calls
+   //       to cut the tensor, then we'd need to have a single final call to combine the results
+   //       which is more complicated.  It will be nicer if we end up eliminated inner bagging
+   //       or use subsampling each boost step to avoid having multiple inner bags
+
+
+   if(UNLIKELY(IntEbm { 0 } == pTask->m_lastDimensionLeavesMax)) {
+      LOG_0(Trace_Warning, "WARNING GenerateTermUpdate boosting zero dimensional");
+      BoostZeroDimensional(pBoosterShell, flags);
+   } else {
+      const double weightTotal = pBoosterCore->GetTrainingSet()->GetBagWeightTotal(iBag);
+      EBM_ASSERT(0 < weightTotal); // if all are zeros we assume there are no weights and use the count
+
+      double gain;
+      if(0 != (TermBoostFlags_RandomSplits & flags) || 2 < cRealDimensions) {
+         if(size_t { 1 } != pTask->m_cSamplesLeafMin) {
+            LOG_0(Trace_Warning,
+               "WARNING GenerateTermUpdate cSamplesLeafMin is ignored when doing random splitting"
+            );
+         }
+         // THIS RANDOM SPLIT OPTION IS PRIMARILY USED FOR DIFFERENTIAL PRIVACY EBMs
+
+         error = BoostRandom(
+            pRng,
+            pBoosterShell,
+            iTerm,
+            flags,
+            pTask->m_aLeavesMax,
+            &gain
+         );
+         if(Error_None != error) {
+            return error;
+         }
+      } else if(1 == cRealDimensions) {
+         EBM_ASSERT(nullptr != pTask->m_aLeavesMax); // otherwise we'd use BoostZeroDimensional above
+         EBM_ASSERT(IntEbm { 2 } <= pTask->m_lastDimensionLeavesMax); // otherwise we'd use BoostZeroDimensional above
+         EBM_ASSERT(size_t { 2 } <= pTask->m_cSignificantBinCount); // otherwise we'd use BoostZeroDimensional above
+
+         EBM_ASSERT(1 == pTerm->GetCountRealDimensions());
+         EBM_ASSERT(pTask->m_cSignificantBinCount == pTerm->GetCountTensorBins());
+         EBM_ASSERT(0 == pTerm->GetCountAuxillaryBins());
+
+         error = BoostSingleDimensional(
+            pRng,
+            pBoosterShell,
+            pTask->m_cSignificantBinCount,
+            static_cast<FloatMain>(weightTotal),
+            pTask->m_iDimensionImportant,
+            pTask->m_cSamplesLeafMin,
+            pTask->m_lastDimensionLeavesMax,
+            &gain
+         );
+         if(Error_None != error) {
+            return error;
+         }
+      } else {
+         error = BoostMultiDimensional(
+            pBoosterShell,
+            iTerm,
+            pTask->m_cSamplesLeafMin,
+            &gain
+         );
+         if(Error_None != error) {
+            return error;
+         }
+      }
+
+      // gain should be +inf if there was an overflow in our callees
+      EBM_ASSERT(!std::isnan(gain));
+      EBM_ASSERT(0 <= gain);
+
+      // this could re-promote gain to be +inf again if weightTotal < 1.0
+      // do the sample count inversion here in case adding all the avgeraged gains pushes us into +inf
+      *pGain = gain / weightTotal * pTask->m_gainMultiple;
+   }
+   return Error_None;
+}
+
+static ErrorEbm BoostBagParallel(void * const pContext, const size_t iThread, const size_t iTask) {
+   // each task boosts one inner bag in its own bag shell.  We index the bag shells by iTask instead of iThread
+   // so that the caller can add the results to the term update in bag order afterwards
+   UNUSED(iThread);
+
+   const BoostBagTask * const pTask = static_cast<const BoostBagTask *>(pContext);
+   BoosterShell * const pBagShell = &pTask->m_pBoosterShell->GetBagShells()[iTask];
+
+   // the pool is busy with the inner bags, so bin the subsets of this bag serially
+   return BoostBag(
+      pTask,
+      pBagShell,
+      pBagShell->GetBagRng(),
+      pTask->m_iBagStart + iTask,
+      size_t { 1 },
+      pBagShell->GetBagGainPointer()
+   );
+}
+
 // we made this a global because if we had put this variable inside the BoosterCore object, then we would need to dereference that before getting 
 // the count.  By making this global we can send a log message incase a bad BoosterCore object is sent into us we only decrease the count if the 
 // count is non-zero, so at worst if there is a race condition then we'll output this log message more times than desired, but we can live with that
@@ -691,6 +1195,11 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION GenerateTermUpdate(
       // we only need to do this once instead of per-loop since any dimensions with 1 bin 
       // are going to remain having 0 splits.
       pBoosterShell->GetInnerTermUpdate()->Reset();
+      for(size_t iBagShell = 0; iBagShell < pBoosterShell->GetCountBagShells(); ++iBagShell) {
+         Tensor * const pBagInnerTermUpdate = pBoosterShell->GetBagShells()[iBagShell].GetInnerTermUpdate();
+         pBagInnerTermUpdate->SetCountDimensions(cDimensions);
+         pBagInnerTermUpdate->Reset();
+      }
 
       EBM_ASSERT(1 <= cTensorBins);
 
@@ -701,191 +1210,127 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION GenerateTermUpdate(
          cTensorBins = 1;
       }
 
-      BinBase * const aFastBins = pBoosterShell->GetBoostingFastBinsTemp();
-      EBM_ASSERT(nullptr != aFastBins);
-
-      const size_t cBytesPerMainBin = GetBinSize<FloatMain, UIntMain>(pBoosterCore->IsHessian(), cScores);
-      EBM_ASSERT(!IsMultiplyError(cBytesPerMainBin, cTensorBins));
-      const size_t cBytesMainBins = cBytesPerMainBin * cTensorBins;
-
-      BinBase * const aMainBins = pBoosterShell->GetBoostingMainBins();
-      EBM_ASSERT(nullptr != aMainBins);
+      BoostBagTask boostBagTask;
+      boostBagTask.m_pBoosterShell = pBoosterShell;
+      boostBagTask.m_iTerm = iTerm;
+      boostBagTask.m_flags = flags;
+      boostBagTask.m_aLeavesMax = leavesMax;
+      boostBagTask.m_lastDimensionLeavesMax = lastDimensionLeavesMax;
+      boostBagTask.m_cSignificantBinCount = cSignificantBinCount;
+      boostBagTask.m_iDimensionImportant = iDimensionImportant;
+      boostBagTask.m_cSamplesLeafMin = cSamplesLeafMin;
+      boostBagTask.m_cTensorBins = cTensorBins;
+      boostBagTask.m_gainMultiple = gainMultiple;
+      boostBagTask.m_aMainBinsCached = nullptr;
+
+      if(IntEbm { 0 } != lastDimensionLeavesMax &&
+         pBoosterShell->IsPrefetchBinsCurrent(iTerm, pBoosterCore->GetGradientsVersion()))
+      {
+         // our caller hinted that we would boost this term, so the last ApplyTermUpdate already binned it
+         boostBagTask.m_aMainBinsCached = pBoosterShell->GetPrefetchBins();
+      } else if(pBoosterShell->IsMainsBinsCacheEnabled() && 
+         BoosterShell::k_notCached != pBoosterShell->GetMainsBinsCacheOffset(iTerm) &&
+         IntEbm { 0 } != lastDimensionLeavesMax)
+      {
+         // If we are asked to boost a second main term without the gradients changing then our caller is probably 
+         // evaluating several terms on the same gradients, so bin all the main terms in one pass and keep them
+         // until the gradients change
+         const size_t iGradientsVersion = pBoosterCore->GetGradientsVersion();
+         if(!pBoosterShell->IsMainsBinsCacheCurrent(iGradientsVersion) && 
+            pBoosterShell->IsMainsGradientsReused(iTerm, iGradientsVersion)) 
+         {
+            error = pBoosterShell->AllocateMainsBinsCache();
+            if(Error_None != error) {
+               return error;
+            }
+            error = BinSumsMains(pBoosterShell);
+            if(Error_None != error) {
+               return error;
+            }
+            pBoosterShell->SetMainsBinsCacheCurrent(iGradientsVersion);
+         }
+         pBoosterShell->SetMainsPrev(iTerm, iGradientsVersion);
 
-#ifndef NDEBUG
-      size_t cAuxillaryBins = pTerm->GetCountAuxillaryBins();
-      if(0 != (TermBoostFlags_RandomSplits & flags) || 2 < cRealDimensions) {
-         // if we're doing random boosting we allocated the auxillary memory, but we don't need it
-         cAuxillaryBins = 0;
+         if(pBoosterShell->IsMainsBinsCacheCurrent(iGradientsVersion)) {
+            boostBagTask.m_aMainBinsCached = IndexBin(pBoosterShell->GetMainsBinsCache(), 
+               pBoosterShell->GetMainsBinsCacheOffset(iTerm));
+         }
       }
-      EBM_ASSERT(!IsAddError(cTensorBins, cAuxillaryBins));
-      EBM_ASSERT(!IsMultiplyError(cBytesPerMainBin, cTensorBins + cAuxillaryBins));
-      pBoosterShell->SetDebugMainBinsEnd(IndexBin(aMainBins, cBytesPerMainBin * (cTensorBins + cAuxillaryBins)));
-#endif // NDEBUG
 
-      size_t iBag = 0;
       EBM_ASSERT(1 <= cInnerBagsAfterZero);
-      do {
-         memset(aMainBins, 0, cBytesMainBins);
-
-         EBM_ASSERT(1 <= pBoosterCore->GetTrainingSet()->GetCountSubsets());
-         DataSubsetBoosting * pSubset = pBoosterCore->GetTrainingSet()->GetSubsets();
-         const DataSubsetBoosting * const pSubsetsEnd = pSubset + pBoosterCore->GetTrainingSet()->GetCountSubsets();
+      const size_t cBagShells = pBoosterShell->GetCountBagShells();
+      if(size_t { 0 } == cBagShells) {
+         // with 2 or more inner bags, each inner bag gets its own random number stream seeded in bag order, the 
+         // same as the bag shells below, so that our results do not depend on CreateBoosterFlags_Multithreaded
+         RandomDeterministic rngBag;
+         RandomDeterministic * const pRngBag = size_t { 2 } <= cInnerBagsAfterZero ? &rngBag : pRng;
+         size_t iBag = 0;
          do {
-            int cPack;
-            if(UNLIKELY(IntEbm { 0 } == lastDimensionLeavesMax)) {
-               // this is kind of hacky where if any one of a number of things occurs (like we have only 1 leaf)
-               // we sum everything into a single bin. The alternative would be to always sum into the tensor bins
-               // but then collapse them afterwards into a single bin, but that's more work.
-               cPack = k_cItemsPerBitPackNone;
-            } else {
-               EBM_ASSERT(1 <= pTerm->GetBitsRequiredMin());
-               cPack = GetCountItemsBitPacked(pTerm->GetBitsRequiredMin(), pSubset->GetObjectiveWrapper()->m_cUIntBytes);
+            if(pRngBag != pRng) {
+               rngBag.Initialize(pRng->Next<uint64_t>());
             }
-
-            size_t cBytesPerFastBin;
-            if(sizeof(UIntBig) == pSubset->GetObjectiveWrapper()->m_cUIntBytes) {
-               if(sizeof(FloatBig) == pSubset->GetObjectiveWrapper()->m_cFloatBytes) {
-                  cBytesPerFastBin = GetBinSize<FloatBig, UIntBig>(pBoosterCore->IsHessian(), cScores);
-               } else {
-                  EBM_ASSERT(sizeof(FloatSmall) == pSubset->GetObjectiveWrapper()->m_cFloatBytes);
-                  cBytesPerFastBin = GetBinSize<FloatSmall, UIntBig>(pBoosterCore->IsHessian(), cScores);
-               }
-            } else {
-               EBM_ASSERT(sizeof(UIntSmall) == pSubset->GetObjectiveWrapper()->m_cUIntBytes);
-               if(sizeof(FloatBig) == pSubset->GetObjectiveWrapper()->m_cFloatBytes) {
-                  cBytesPerFastBin = GetBinSize<FloatBig, UIntSmall>(pBoosterCore->IsHessian(), cScores);
-               } else {
-                  EBM_ASSERT(sizeof(FloatSmall) == pSubset->GetObjectiveWrapper()->m_cFloatBytes);
-                  cBytesPerFastBin = GetBinSize<FloatSmall, UIntSmall>(pBoosterCore->IsHessian(), cScores);
-               }
+            double gain;
+            error = BoostBag(
+               &boostBagTask,
+               pBoosterShell,
+               pRngBag,
+               iBag,
+               pBoosterCore->GetCountFastBinsParallel(),
+               &gain
+            );
+            if(Error_None != error) {
+               return error;
             }
-            EBM_ASSERT(!IsMultiplyError(cBytesPerFastBin, cTensorBins));
-
-            aFastBins->ZeroMem(cBytesPerFastBin, cTensorBins);
-
-            BinSumsBoostingBridge params;
-            params.m_bHessian = pBoosterCore->IsHessian() ? EBM_TRUE : EBM_FALSE;
-            params.m_cScores = cScores;
-            params.m_cPack = cPack;
-            params.m_cSamples = pSubset->GetCountSamples();
-            params.m_aGradientsAndHessians = pSubset->GetGradHess();
-            params.m_aWeights = pSubset->GetInnerBag(iBag)->GetWeights();
-            params.m_pCountOccurrences = pSubset->GetInnerBag(iBag)->GetCountOccurrences();
-            params.m_aPacked = pSubset->GetTermData(iTerm);
-            params.m_aFastBins = aFastBins;
-   #ifndef NDEBUG
-            params.m_pDebugFastBinsEnd = IndexBin(aFastBins, cBytesPerFastBin * cTensorBins);
-   #endif // NDEBUG
-            error = pSubset->BinSumsBoosting(&params);
+            gainAvg += gain;
+            EBM_ASSERT(!std::isnan(gainAvg));
+            EBM_ASSERT(0.0 <= gainAvg);
+
+            error = pBoosterShell->GetTermUpdate()->Add(*pBoosterShell->GetInnerTermUpdate());
             if(Error_None != error) {
                return error;
             }
 
-            ConvertAddBin(
-               cScores,
-               pBoosterCore->IsHessian(),
-               cTensorBins,
-               sizeof(UIntBig) == pSubset->GetObjectiveWrapper()->m_cUIntBytes,
-               sizeof(FloatBig) == pSubset->GetObjectiveWrapper()->m_cFloatBytes,
-               aFastBins,
-               std::is_same<UIntMain, uint64_t>::value,
-               std::is_same<FloatMain, double>::value,
-               aMainBins
-            );
-            ++pSubset;
-         } while(pSubsetsEnd != pSubset);
+            ++iBag;
+         } while(cInnerBagsAfterZero != iBag);
+      } else {
+         EBM_ASSERT(nullptr != pBoosterShell->GetBagShells());
+         size_t iBag = 0;
+         do {
+            // boost up to cBagShells inner bags concurrently, each in its own bag shell, and then add
+            // them to the term update in bag order so that our results are identical for any number of threads
+            const size_t cBagsParallel = EbmMin(cBagShells, cInnerBagsAfterZero - iBag);
 
-         // TODO: we can exit here back to python to allow caller modification to our histograms
-         //       although having inner bags makes this complicated since each inner bag has it's own
-         //       histogram, so we'd need to exit and re-enter 100 times over if we had 100 inner bags
-         //       and we'd need to have the BinBoosting function be called 100 times, followed by 100 calls
-         //       to cut the tensor, then we'd need to have a single final call to combine the results
-         //       which is more complicated.  It will be nicer if we end up eliminated inner bagging
-         //       or use subsampling each boost step to avoid having multiple inner bags
+            // each inner bag gets its own random number stream that we seed in bag order
+            for(size_t iBagParallel = 0; iBagParallel < cBagsParallel; ++iBagParallel) {
+               pBoosterShell->GetBagShells()[iBagParallel].GetBagRng()->Initialize(pRng->Next<uint64_t>());
+            }
 
+            boostBagTask.m_iBagStart = iBag;
+            error = ThreadPool::Execute(
+               pBoosterCore->GetThreadPool(),
+               cBagsParallel,
+               BoostBagParallel,
+               &boostBagTask
+            );
+            if(Error_None != error) {
+               return error;
+            }
 
-         if(UNLIKELY(IntEbm { 0 } == lastDimensionLeavesMax)) {
-            LOG_0(Trace_Warning, "WARNING GenerateTermUpdate boosting zero dimensional");
-            BoostZeroDimensional(pBoosterShell, flags);
-         } else {
-            const double weightTotal = pBoosterCore->GetTrainingSet()->GetBagWeightTotal(iBag);
-            EBM_ASSERT(0 < weightTotal); // if all are zeros we assume there are no weights and use the count
+            for(size_t iBagParallel = 0; iBagParallel < cBagsParallel; ++iBagParallel) {
+               BoosterShell * const pBagShell = &pBoosterShell->GetBagShells()[iBagParallel];
+               gainAvg += *pBagShell->GetBagGainPointer();
+               EBM_ASSERT(!std::isnan(gainAvg));
+               EBM_ASSERT(0.0 <= gainAvg);
 
-            double gain;
-            if(0 != (TermBoostFlags_RandomSplits & flags) || 2 < cRealDimensions) {
-               if(size_t { 1 } != cSamplesLeafMin) {
-                  LOG_0(Trace_Warning,
-                     "WARNING GenerateTermUpdate cSamplesLeafMin is ignored when doing random splitting"
-                  );
-               }
-               // THIS RANDOM SPLIT OPTION IS PRIMARILY USED FOR DIFFERENTIAL PRIVACY EBMs
-
-               error = BoostRandom(
-                  pRng,
-                  pBoosterShell,
-                  iTerm,
-                  flags,
-                  leavesMax,
-                  &gain
-               );
-               if(Error_None != error) {
-                  return error;
-               }
-            } else if(1 == cRealDimensions) {
-               EBM_ASSERT(nullptr != leavesMax); // otherwise we'd use BoostZeroDimensional above
-               EBM_ASSERT(IntEbm { 2 } <= lastDimensionLeavesMax); // otherwise we'd use BoostZeroDimensional above
-               EBM_ASSERT(size_t { 2 } <= cSignificantBinCount); // otherwise we'd use BoostZeroDimensional above
-
-               EBM_ASSERT(1 == pTerm->GetCountRealDimensions());
-               EBM_ASSERT(cSignificantBinCount == pTerm->GetCountTensorBins());
-               EBM_ASSERT(0 == pTerm->GetCountAuxillaryBins());
-
-               error = BoostSingleDimensional(
-                  pRng,
-                  pBoosterShell,
-                  cSignificantBinCount,
-                  static_cast<FloatMain>(weightTotal),
-                  iDimensionImportant,
-                  cSamplesLeafMin,
-                  lastDimensionLeavesMax,
-                  &gain
-               );
-               if(Error_None != error) {
-                  return error;
-               }
-            } else {
-               error = BoostMultiDimensional(
-                  pBoosterShell,
-                  iTerm,
-                  cSamplesLeafMin,
-                  &gain
-               );
+               error = pBoosterShell->GetTermUpdate()->Add(*pBagShell->GetInnerTermUpdate());
                if(Error_None != error) {
                   return error;
                }
             }
 
-            // gain should be +inf if there was an overflow in our callees
-            EBM_ASSERT(!std::isnan(gain));
-            EBM_ASSERT(0 <= gain);
-
-            // this could re-promote gain to be +inf again if weightTotal < 1.0
-            // do the sample count inversion here in case adding all the avgeraged gains pushes us into +inf
-            gain = gain / weightTotal * gainMultiple;
-            gainAvg += gain;
-            EBM_ASSERT(!std::isnan(gainAvg));
-            EBM_ASSERT(0.0 <= gainAvg);
-         }
-
-         // TODO : when we thread this code, let's have each thread take a lock and update the combined line segment.  They'll each do it while the 
-         // others are working, so there should be no blocking and our final result won't require adding by the main thread
-         error = pBoosterShell->GetTermUpdate()->Add(*pBoosterShell->GetInnerTermUpdate());
-         if(Error_None != error) {
-            return error;
-         }
-
-         ++iBag;
-      } while(cInnerBagsAfterZero != iBag);
+            iBag += cBagsParallel;
+         } while(cInnerBagsAfterZero != iBag);
+      }
 
       // gainAvg is +inf on overflow. It cannot be NaN, but check for that anyways since it's free
       EBM_ASSERT(!std::isnan(gainAvg));
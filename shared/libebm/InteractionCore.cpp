@@ -7,6 +7,7 @@
 #include <stdlib.h> // free
 #include <stddef.h> // size_t, ptrdiff_t
 #include <limits> // numeric_limits
+#include <cmath> // isnan
 
 #include "logging.h" // EBM_ASSERT
 
@@ -16,6 +17,7 @@
 #include "ebm_internal.hpp"
 #include "Feature.hpp" // Feature
 #include "dataset_shared.hpp" // GetDataSetSharedHeader
+#include "ThreadPool.hpp"
 #include "InteractionCore.hpp"
 
 namespace DEFINED_ZONE_NAME {
@@ -38,6 +40,22 @@ extern ErrorEbm GetObjective(
    ObjectiveWrapper * const pSIMDObjectiveWrapperOut
 ) noexcept;
 
+InteractionCore::~InteractionCore() {
+   // this only gets called after our reference count has been decremented to zero
+
+   // stop the workers before freeing any memory that they could reference
+   ThreadPool::Free(m_pThreadPool);
+
+   m_dataFrame.DestructDataSetInteraction(m_cFeatures);
+   free(m_aFeatures);
+   FreeObjectiveWrapperInternals(&m_objectiveCpu);
+   FreeObjectiveWrapperInternals(&m_objectiveSIMD);
+}
+
+size_t InteractionCore::GetCountThreads() const {
+   return nullptr == m_pThreadPool ? size_t { 1 } : m_pThreadPool->GetCountThreads();
+}
+
 void InteractionCore::Free(InteractionCore * const pInteractionCore) {
    LOG_0(Trace_Info, "Entered InteractionCore::Free");
 
@@ -158,8 +176,9 @@ ErrorEbm InteractionCore::Create(
    InteractionCore ** const ppInteractionCoreOut
 ) {
    // experimentalParams isn't used by default.  It's meant to provide an easy way for python or other higher
-   // level languages to pass EXPERIMENTAL temporary parameters easily to the C++ code.
-   UNUSED(experimentalParams);
+   // level languages to pass EXPERIMENTAL temporary parameters easily to the C++ code.  The exception is
+   // when CreateInteractionFlags_Multithreaded is set, in which case a non-NULL experimentalParams[0] holds
+   // the number of threads that CalcInteractionStrengths uses.
 
    LOG_0(Trace_Info, "Entered InteractionCore::Create");
 
@@ -189,6 +208,28 @@ ErrorEbm InteractionCore::Create(
 
    pInteractionCore->m_bDisableApprox = 0 != (CreateInteractionFlags_DisableApprox & flags) ? EBM_TRUE : EBM_FALSE;
 
+   if(0 != (CreateInteractionFlags_Multithreaded & flags)) {
+      size_t cThreads = ThreadPool::GetCountThreadsDefault();
+      if(nullptr != experimentalParams) {
+         const double countThreads = experimentalParams[0];
+         if(std::isnan(countThreads) || countThreads < 1.0) {
+            LOG_0(Trace_Error, "ERROR InteractionCore::Create experimentalParams[0] must be a thread count of 1 or more");
+            return Error_IllegalParamVal;
+         }
+         // cap at something reasonable. Each thread gets its own bins, so more threads cost memory
+         static constexpr size_t k_cThreadsMax = 4096;
+         cThreads = countThreads < static_cast<double>(k_cThreadsMax) ? static_cast<size_t>(countThreads) : k_cThreadsMax;
+      }
+      LOG_N(Trace_Info, "INFO InteractionCore::Create using %zu threads", cThreads);
+      if(size_t { 2 } <= cThreads) {
+         error = ThreadPool::Create(cThreads, false, &pInteractionCore->m_pThreadPool);
+         if(Error_None != error) {
+            // already logged
+            return error;
+         }
+      }
+   }
+
    size_t cBinsMax = 0;
 
    LOG_0(Trace_Info, "InteractionCore::Create starting feature processing");
@@ -280,7 +321,8 @@ ErrorEbm InteractionCore::Create(
       error = GetObjective(
          &config, 
          sObjective, 
-         disableCompute,
+         // the SIMD zones round differently than the CPU zone, so they are opt-in
+         0 != (CreateInteractionFlags_EnableSIMD & flags) ? disableCompute : disableCompute | ComputeFlags_SIMD,
          &pInteractionCore->m_objectiveCpu, 
          &pInteractionCore->m_objectiveSIMD
       );
@@ -446,6 +488,7 @@ ErrorEbm InteractionCore::InitializeInteractionGradientsAndHessians(
          goto free_sample_scores;
       }
       data.m_aUpdateTensorScores = aUpdateScores;
+      data.m_cTensorBins = 1;
 
       memset(aUpdateScores, 0, cBytesScoresMax);
 
@@ -553,8 +596,10 @@ ErrorEbm InteractionCore::InitializeInteractionGradientsAndHessians(
             data.m_cScores = cScores;
             data.m_cPack = k_cItemsPerBitPackNone;
             data.m_bHessianNeeded = IsHessian() ? EBM_TRUE : EBM_FALSE;
+            data.m_gradHessFormat = k_gradHessFloat;
             data.m_bDisableApprox = IsDisableApprox();
             data.m_bValidation = EBM_FALSE;
+            data.m_bProbabilityMetrics = EBM_FALSE;
             data.m_cSamples = pSubset->GetCountSamples();
             data.m_aPacked = nullptr;
             data.m_aWeights = nullptr;
@@ -639,8 +684,10 @@ ErrorEbm InteractionCore::InitializeInteractionGradientsAndHessians(
             data.m_cScores = 1;
             data.m_cPack = k_cItemsPerBitPackNone;
             data.m_bHessianNeeded = IsHessian() ? EBM_TRUE : EBM_FALSE;
+            data.m_gradHessFormat = k_gradHessFloat;
             data.m_bDisableApprox = IsDisableApprox();
             data.m_bValidation = EBM_FALSE;
+            data.m_bProbabilityMetrics = EBM_FALSE;
             data.m_cSamples = pSubset->GetCountSamples();
             data.m_aPacked = nullptr;
             data.m_aWeights = nullptr;
@@ -21,6 +21,7 @@ namespace DEFINED_ZONE_NAME {
 #endif // DEFINED_ZONE_NAME
 
 class FeatureInteraction;
+class ThreadPool;
 
 class InteractionCore final {
 
@@ -42,21 +43,17 @@ class InteractionCore final {
    ObjectiveWrapper m_objectiveCpu;
    ObjectiveWrapper m_objectiveSIMD;
 
-   inline ~InteractionCore() {
-      // this only gets called after our reference count has been decremented to zero
+   ThreadPool * m_pThreadPool;
 
-      m_dataFrame.DestructDataSetInteraction(m_cFeatures);
-      free(m_aFeatures);
-      FreeObjectiveWrapperInternals(&m_objectiveCpu);
-      FreeObjectiveWrapperInternals(&m_objectiveSIMD);
-   };
+   ~InteractionCore();
 
    inline InteractionCore() noexcept :
       m_REFERENCE_COUNT(1), // we're not visible on any other thread yet, so no synchronization required
       m_cScores(0),
       m_bDisableApprox(EBM_FALSE),
       m_cFeatures(0),
-      m_aFeatures(nullptr)
+      m_aFeatures(nullptr),
+      m_pThreadPool(nullptr)
    {
       m_dataFrame.SafeInitDataSetInteraction();
       InitializeObjectiveWrapperUnfailing(&m_objectiveCpu);
@@ -91,6 +88,13 @@ public:
       return m_cFeatures;
    }
 
+   inline ThreadPool * GetThreadPool() {
+      // nullptr if we are single threaded
+      return m_pThreadPool;
+   }
+
+   size_t GetCountThreads() const;
+
    static void Free(InteractionCore * const pInteractionCore);
    static ErrorEbm Create(
       const unsigned char * const pDataSetShared,
@@ -124,8 +128,11 @@ public:
    }
 
    inline bool IsHessian() {
+      // The interaction gain divides by the hessians only for logitboost.  Otherwise it divides by the weights,
+      // and CalcInteractionFlags_EnableNewton only needs the objective's HessianConstant, so we do not compute, 
+      // store, or bin the per-sample hessians.
       EBM_ASSERT(nullptr != m_objectiveCpu.m_pObjective);
-      return EBM_FALSE != m_objectiveCpu.m_bObjectiveHasHessian;
+      return k_bUseLogitboost && EBM_FALSE != m_objectiveCpu.m_bObjectiveHasHessian;
    }
 
    inline BoolEbm IsDisableApprox() const {
@@ -27,12 +27,22 @@ extern void InitializeRmseGradientsAndHessiansInteraction(
    DataSetInteraction * const pDataSet
 );
 
+void InteractionShell::FreeAllocations() {
+   if(nullptr != m_aThreadShells) {
+      for(size_t iThreadShell = 0; iThreadShell < m_cThreadShells; ++iThreadShell) {
+         m_aThreadShells[iThreadShell].FreeAllocations();
+      }
+      free(m_aThreadShells);
+   }
+   AlignedFree(m_aInteractionFastBinsTemp);
+   AlignedFree(m_aInteractionMainBins);
+}
+
 void InteractionShell::Free(InteractionShell * const pInteractionShell) {
    LOG_0(Trace_Info, "Entered InteractionShell::Free");
 
    if(nullptr != pInteractionShell) {
-      AlignedFree(pInteractionShell->m_aInteractionFastBinsTemp);
-      AlignedFree(pInteractionShell->m_aInteractionMainBins);
+      pInteractionShell->FreeAllocations();
       InteractionCore::Free(pInteractionShell->m_pInteractionCore);
       
       // before we free our memory, indicate it was freed so if our higher level language attempts to use it we have
@@ -119,6 +129,37 @@ BinBase * InteractionShell::GetInteractionMainBins(const size_t cBytesPerMainBin
    return aBuffer;
 }
 
+ErrorEbm InteractionShell::AllocateThreadShells(const size_t cThreads) {
+   EBM_ASSERT(1 <= cThreads);
+
+   // the calling thread uses this shell, so we need one fewer thread shells than threads
+   const size_t cThreadShells = cThreads - size_t { 1 };
+   if(m_cThreadShells < cThreadShells) {
+      if(IsMultiplyError(sizeof(InteractionShell), cThreadShells)) {
+         LOG_0(Trace_Warning, "WARNING InteractionShell::AllocateThreadShells IsMultiplyError(sizeof(InteractionShell), cThreadShells)");
+         return Error_OutOfMemory;
+      }
+      InteractionShell * const aThreadShells = static_cast<InteractionShell *>(malloc(sizeof(InteractionShell) * cThreadShells));
+      if(nullptr == aThreadShells) {
+         LOG_0(Trace_Warning, "WARNING InteractionShell::AllocateThreadShells nullptr == aThreadShells");
+         return Error_OutOfMemory;
+      }
+      for(size_t iThreadShell = 0; iThreadShell < cThreadShells; ++iThreadShell) {
+         aThreadShells[iThreadShell].InitializeUnfailing(m_pInteractionCore);
+      }
+
+      if(nullptr != m_aThreadShells) {
+         for(size_t iThreadShell = 0; iThreadShell < m_cThreadShells; ++iThreadShell) {
+            m_aThreadShells[iThreadShell].FreeAllocations();
+         }
+         free(m_aThreadShells);
+      }
+      m_aThreadShells = aThreadShells;
+      m_cThreadShells = cThreadShells;
+   }
+   return Error_None;
+}
+
 EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION CreateInteractionDetector(
    const void * dataSet,
    const BagEbm * bag,
@@ -160,7 +201,9 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION CreateInteractionDetector(
    if(0 != (static_cast<UCreateInteractionFlags>(flags) & static_cast<UCreateInteractionFlags>(~(
       static_cast<UCreateInteractionFlags>(CreateInteractionFlags_DifferentialPrivacy) |
       static_cast<UCreateInteractionFlags>(CreateInteractionFlags_DisableApprox) |
-      static_cast<UCreateInteractionFlags>(CreateInteractionFlags_BinaryAsMulticlass)
+      static_cast<UCreateInteractionFlags>(CreateInteractionFlags_BinaryAsMulticlass) |
+      static_cast<UCreateInteractionFlags>(CreateInteractionFlags_Multithreaded) |
+      static_cast<UCreateInteractionFlags>(CreateInteractionFlags_EnableSIMD)
    )))) {
       LOG_0(Trace_Error, "ERROR CreateInteractionDetector flags contains unknown flags. Ignoring extras.");
    }
@@ -32,6 +32,11 @@ class InteractionShell final {
    BinBase * m_aInteractionMainBins;
    size_t m_cAllocatedMainBins;
 
+   // CalcInteractionStrengths gives each worker thread its own shell to hold its bins.  The thread shells share 
+   // our InteractionCore without holding a reference on it, and the calling thread uses this shell
+   size_t m_cThreadShells;
+   InteractionShell * m_aThreadShells;
+
    int m_cLogEnterMessages;
    int m_cLogExitMessages;
 
@@ -52,10 +57,14 @@ public:
       m_aInteractionMainBins = nullptr;
       m_cAllocatedMainBins = 0;
 
+      m_cThreadShells = 0;
+      m_aThreadShells = nullptr;
+
       m_cLogEnterMessages = 1000;
       m_cLogExitMessages = 1000;
    }
 
+   void FreeAllocations();
    static void Free(InteractionShell * const pInteractionShell);
    static InteractionShell * Create(InteractionCore * const pInteractionCore);
 
@@ -97,6 +106,16 @@ public:
    BinBase * GetInteractionFastBinsTemp(const size_t cBytes);
 
    BinBase * GetInteractionMainBins(const size_t cBytesPerMainBin, const size_t cMainBins);
+
+   ErrorEbm AllocateThreadShells(const size_t cThreads);
+
+   inline InteractionShell * GetThreadShell(const size_t iThread) {
+      if(size_t { 0 } == iThread) {
+         return this;
+      }
+      EBM_ASSERT(iThread <= m_cThreadShells);
+      return &m_aThreadShells[iThread - size_t { 1 }];
+   }
 };
 static_assert(std::is_standard_layout<InteractionShell>::value,
    "We use the struct hack in several places, so disallow non-standard_layout types in general");
@@ -475,8 +475,8 @@ extern double PartitionTwoDimensionalInteraction(
    EBM_ASSERT(1 <= cRuntimeScores);
    if(pInteractionCore->IsHessian()) {
       if(size_t { 1 } != cRuntimeScores) {
-         // muticlass
-         return PartitionTwoDimensionalInteractionTarget<true, k_cCompilerScoresStart>::Func(
+         // we only keep the hessians for logitboost, so do not optimize multiclass for it
+         return PartitionTwoDimensionalInteractionInternal<true, k_dynamicScores>::Func(
             pInteractionCore,
             cRealDimensions,
             acBins,
@@ -506,8 +506,8 @@ extern double PartitionTwoDimensionalInteraction(
       }
    } else {
       if(size_t { 1 } != cRuntimeScores) {
-         // Odd: gradient multiclass. Allow it, but do not optimize for it
-         return PartitionTwoDimensionalInteractionInternal<false, k_dynamicScores>::Func(
+         // muticlass
+         return PartitionTwoDimensionalInteractionTarget<false, k_cCompilerScoresStart>::Func(
             pInteractionCore,
             cRealDimensions,
             acBins,
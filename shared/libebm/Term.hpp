@@ -19,6 +19,11 @@ namespace DEFINED_ZONE_NAME {
 
 class FeatureBoosting;
 
+// how BinSumsBoosting bins a term.  CreateBoosterFlags_Autotune replaces the heuristic with the kernel it timed fastest
+static constexpr int k_binSumsPlanHeuristic = 0; // sort by bin range if the fast bins do not fit in the cache
+static constexpr int k_binSumsPlanDirect = 1;
+static constexpr int k_binSumsPlanSorted = 2;
+
 struct TermFeature {
    const FeatureBoosting * m_pFeature;
    size_t                  m_cStride;
@@ -31,6 +36,7 @@ class Term final {
    size_t m_cTensorBins;
    size_t m_cAuxillaryBins;
    int m_cBitsRequiredMin;
+   int m_binSumsPlan;
    int m_cLogEnterGenerateTermUpdateMessages;
    int m_cLogExitGenerateTermUpdateMessages;
    int m_cLogEnterApplyTermUpdateMessages;
@@ -56,6 +62,7 @@ public:
 
    inline void Initialize(const size_t cDimensions) noexcept {
       m_cDimensions = cDimensions;
+      m_binSumsPlan = k_binSumsPlanHeuristic;
       m_cLogEnterGenerateTermUpdateMessages = 2;
       m_cLogExitGenerateTermUpdateMessages = 2;
       m_cLogEnterApplyTermUpdateMessages = 2;
@@ -74,6 +81,14 @@ public:
       return m_cBitsRequiredMin;
    }
 
+   inline void SetBinSumsPlan(const int binSumsPlan) noexcept {
+      m_binSumsPlan = binSumsPlan;
+   }
+
+   inline int GetBinSumsPlan() const noexcept {
+      return m_binSumsPlan;
+   }
+
    inline size_t GetCountDimensions() const noexcept {
       EBM_ASSERT(m_cRealDimensions <= m_cDimensions);
       return m_cDimensions;
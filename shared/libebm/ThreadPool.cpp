@@ -0,0 +1,304 @@
+// Copyright (c) 2023 The InterpretML Contributors
+// Licensed under the MIT license.
+// Author: Paul Koch <code@koch.ninja>
+
+#include "pch.hpp"
+
+#include <stddef.h> // size_t, ptrdiff_t
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+
+#if defined(__linux__)
+#include <pthread.h> // pthread_setaffinity_np
+#include <sched.h> // sched_getaffinity, cpu_set_t
+#endif // __linux__
+
+#include "logging.h" // EBM_ASSERT
+
+#include "ThreadPool.hpp"
+
+namespace DEFINED_ZONE_NAME {
+#ifndef DEFINED_ZONE_NAME
+#error DEFINED_ZONE_NAME must be defined
+#endif // DEFINED_ZONE_NAME
+
+size_t ThreadPool::GetCountThreadsDefault() noexcept {
+   // hardware_concurrency is allowed to return 0 if the value is not computable
+   const unsigned int cThreads = std::thread::hardware_concurrency();
+   return 0 == cThreads ? size_t { 1 } : static_cast<size_t>(cThreads);
+}
+
+// Pin the worker to the iThread-th CPU that our process is allowed to run on, wrapping around if there are more
+// threads than CPUs.  The calling thread is thread 0 and belongs to our caller, so we never pin it.  Returns false
+// if the thread could not be pinned, in which case it keeps running wherever the OS schedules it.
+static bool PinThread(std::thread * const pThread, const size_t iThread) noexcept {
+#if defined(__linux__)
+   cpu_set_t allowed;
+   CPU_ZERO(&allowed);
+   if(0 != sched_getaffinity(0, sizeof(allowed), &allowed)) {
+      return false;
+   }
+   const int cCpus = CPU_COUNT(&allowed);
+   if(cCpus <= 0) {
+      return false;
+   }
+   size_t iAllowed = iThread % static_cast<size_t>(cCpus);
+   for(int iCpu = 0; iCpu < CPU_SETSIZE; ++iCpu) {
+      if(CPU_ISSET(iCpu, &allowed)) {
+         if(size_t { 0 } == iAllowed) {
+            cpu_set_t pinned;
+            CPU_ZERO(&pinned);
+            CPU_SET(iCpu, &pinned);
+            return 0 == pthread_setaffinity_np(pThread->native_handle(), sizeof(pinned), &pinned);
+         }
+         --iAllowed;
+      }
+   }
+   return false;
+#else // __linux__
+   UNUSED(pThread);
+   UNUSED(iThread);
+   return false;
+#endif // __linux__
+}
+
+void ThreadPool::RunTasks(const size_t iThread) noexcept {
+   if(m_bPinned) {
+      // the tasks are assigned to the workers round robin so that each task index always runs on the same CPU.
+      // The calling thread is not pinned, so it only waits for the workers
+      if(size_t { 0 } == iThread) {
+         return;
+      }
+      for(size_t iTask = iThread - size_t { 1 }; iTask < m_cTasks; iTask += m_cWorkers) {
+         const ErrorEbm error = (*m_pTask)(m_pContext, iThread, iTask);
+         if(Error_None != error) {
+            m_error.store(error, std::memory_order_relaxed);
+         }
+      }
+      return;
+   }
+   while(true) {
+      const size_t iTask = m_iTaskNext.fetch_add(1, std::memory_order_relaxed);
+      if(m_cTasks <= iTask) {
+         break;
+      }
+      const ErrorEbm error = (*m_pTask)(m_pContext, iThread, iTask);
+      if(Error_None != error) {
+         // if multiple tasks fail we return one of the errors, but we do not guarantee which one
+         m_error.store(error, std::memory_order_relaxed);
+      }
+   }
+}
+
+void ThreadPool::WorkerMain(const size_t iThread) noexcept {
+   // do not log from the workers.  Tasks are expected to leave their logging to the thread that called Execute
+   bool bCounted = false;
+   try {
+      size_t iGenerationPrev = 0;
+      std::unique_lock<std::mutex> lock(m_mutex);
+      while(true) {
+         m_conditionStart.wait(lock, [this, iGenerationPrev]() {
+            return m_bStop || iGenerationPrev != m_iGeneration;
+         });
+         if(m_bStop) {
+            return;
+         }
+         // Execute cannot start a new generation until all workers have finished the current one, so
+         // we cannot skip over a generation here
+         iGenerationPrev = m_iGeneration;
+         bCounted = true;
+         lock.unlock();
+
+         RunTasks(iThread);
+
+         lock.lock();
+         EBM_ASSERT(size_t { 1 } <= m_cWorkersRunning);
+         --m_cWorkersRunning;
+         bCounted = false;
+         if(size_t { 0 } == m_cWorkersRunning) {
+            m_conditionDone.notify_one();
+         }
+      }
+   } catch(...) {
+      // std::mutex and std::condition_variable only throw on system errors.  We cannot allow the exception
+      // to escape the thread since that would call std::terminate.  This worker is gone, so we take it out of
+      // the current generation, otherwise Execute would wait on m_conditionDone forever, and we record that it
+      // exited so that later calls to Execute run their tasks on the calling thread instead
+      m_error.store(Error_UnexpectedInternal, std::memory_order_relaxed);
+      try {
+         std::lock_guard<std::mutex> lock(m_mutex);
+         ++m_cWorkersExited;
+         if(bCounted) {
+            EBM_ASSERT(size_t { 1 } <= m_cWorkersRunning);
+            --m_cWorkersRunning;
+            if(size_t { 0 } == m_cWorkersRunning) {
+               m_conditionDone.notify_one();
+            }
+         }
+      } catch(...) {
+         // if we cannot even lock the mutex then there is nothing more that we can do
+      }
+   }
+}
+
+void ThreadPool::Free(ThreadPool * const pThreadPool) {
+   LOG_0(Trace_Info, "Entered ThreadPool::Free");
+
+   if(nullptr != pThreadPool) {
+      try {
+         {
+            std::lock_guard<std::mutex> lock(pThreadPool->m_mutex);
+            pThreadPool->m_bStop = true;
+         }
+         pThreadPool->m_conditionStart.notify_all();
+
+         for(size_t iWorker = 0; iWorker < pThreadPool->m_cWorkers; ++iWorker) {
+            std::thread * const pWorker = &pThreadPool->m_aWorkers[iWorker];
+            if(pWorker->joinable()) {
+               pWorker->join();
+            }
+         }
+      } catch(...) {
+         LOG_0(Trace_Error, "ERROR ThreadPool::Free exception while stopping the worker threads");
+      }
+      delete[] pThreadPool->m_aWorkers;
+      delete pThreadPool;
+   }
+
+   LOG_0(Trace_Info, "Exited ThreadPool::Free");
+}
+
+ErrorEbm ThreadPool::Create(const size_t cThreads, const bool bPinned, ThreadPool ** const ppThreadPoolOut) {
+   LOG_N(Trace_Info, "Entered ThreadPool::Create: cThreads=%zu, bPinned=%d", cThreads, bPinned ? 1 : 0);
+
+   EBM_ASSERT(size_t { 2 } <= cThreads);
+   EBM_ASSERT(nullptr != ppThreadPoolOut);
+   EBM_ASSERT(nullptr == *ppThreadPoolOut);
+
+   ThreadPool * pThreadPool;
+   try {
+      pThreadPool = new ThreadPool();
+   } catch(const std::bad_alloc &) {
+      LOG_0(Trace_Warning, "WARNING ThreadPool::Create Out of memory allocating ThreadPool");
+      return Error_OutOfMemory;
+   } catch(...) {
+      LOG_0(Trace_Warning, "WARNING ThreadPool::Create Unknown error");
+      return Error_UnexpectedInternal;
+   }
+   if(nullptr == pThreadPool) {
+      // this should be impossible since bad_alloc should have been thrown, but let's be untrusting
+      LOG_0(Trace_Warning, "WARNING ThreadPool::Create nullptr == pThreadPool");
+      return Error_OutOfMemory;
+   }
+   // give ownership of our object back to the caller, even if there is a failure
+   *ppThreadPoolOut = pThreadPool;
+
+   const size_t cWorkers = cThreads - size_t { 1 };
+   try {
+      pThreadPool->m_aWorkers = new std::thread[cWorkers];
+   } catch(const std::bad_alloc &) {
+      LOG_0(Trace_Warning, "WARNING ThreadPool::Create Out of memory allocating threads");
+      return Error_OutOfMemory;
+   } catch(...) {
+      LOG_0(Trace_Warning, "WARNING ThreadPool::Create Unknown error allocating threads");
+      return Error_UnexpectedInternal;
+   }
+   if(nullptr == pThreadPool->m_aWorkers) {
+      LOG_0(Trace_Warning, "WARNING ThreadPool::Create nullptr == m_aWorkers");
+      return Error_OutOfMemory;
+   }
+   pThreadPool->m_cWorkers = cWorkers;
+   // the workers read m_bPinned in RunTasks, so it needs to be set before they start
+   pThreadPool->m_bPinned = bPinned;
+
+   for(size_t iWorker = 0; iWorker < cWorkers; ++iWorker) {
+      try {
+         pThreadPool->m_aWorkers[iWorker] = std::thread(&ThreadPool::WorkerMain, pThreadPool, iWorker + size_t { 1 });
+      } catch(const std::bad_alloc &) {
+         LOG_0(Trace_Warning, "WARNING ThreadPool::Create thread start out of memory");
+         return Error_OutOfMemory;
+      } catch(...) {
+         // the C++ standard doesn't really seem to say what kind of exceptions we'd get for various errors, so
+         // about the best we can do is catch(...) since the exact exceptions seem to be implementation specific
+         LOG_0(Trace_Warning, "WARNING ThreadPool::Create thread start failed");
+         return Error_ThreadStartFailed;
+      }
+   }
+
+   if(bPinned) {
+      // failing to pin is not an error.  The task assignment stays the same, we just lose the memory locality
+      size_t cPinned = 0;
+      for(size_t iWorker = 0; iWorker < cWorkers; ++iWorker) {
+         if(PinThread(&pThreadPool->m_aWorkers[iWorker], iWorker + size_t { 1 })) {
+            ++cPinned;
+         }
+      }
+      LOG_N(Trace_Info, "INFO ThreadPool::Create pinned %zu of %zu workers", cPinned, cWorkers);
+   }
+
+   LOG_0(Trace_Info, "Exited ThreadPool::Create");
+   return Error_None;
+}
+
+ErrorEbm ThreadPool::Execute(
+   ThreadPool * const pThreadPool,
+   const size_t cTasks,
+   const THREAD_TASK pTask,
+   void * const pContext
+) noexcept {
+   EBM_ASSERT(nullptr != pTask);
+
+   // a pinned pool runs even a single task on its worker so that the task index stays on the same CPU
+   if(nullptr != pThreadPool && (size_t { 2 } <= cTasks || pThreadPool->m_bPinned && size_t { 1 } <= cTasks)) {
+      try {
+         // if another BoosterShell that shares our BoosterCore is already using the workers, or if a task is 
+         // calling us from a worker, then run our tasks on the calling thread instead of waiting for the workers 
+         // to become available.  Pinned pools lose their memory locality for these tasks
+         std::unique_lock<std::mutex> lockExecute(pThreadPool->m_mutexExecute, std::try_to_lock);
+         if(lockExecute.owns_lock()) {
+            {
+               std::lock_guard<std::mutex> lock(pThreadPool->m_mutex);
+               if(size_t { 0 } != pThreadPool->m_cWorkersExited) {
+                  // a worker died on a previous call.  Its share of the tasks would never run, so fall back
+                  // to running everything on the calling thread
+                  goto serial;
+               }
+               pThreadPool->m_pTask = pTask;
+               pThreadPool->m_pContext = pContext;
+               pThreadPool->m_cTasks = cTasks;
+               pThreadPool->m_iTaskNext.store(0, std::memory_order_relaxed);
+               pThreadPool->m_error.store(Error_None, std::memory_order_relaxed);
+               pThreadPool->m_cWorkersRunning = pThreadPool->m_cWorkers;
+               ++pThreadPool->m_iGeneration;
+            }
+            pThreadPool->m_conditionStart.notify_all();
+
+            pThreadPool->RunTasks(0);
+
+            {
+               std::unique_lock<std::mutex> lock(pThreadPool->m_mutex);
+               pThreadPool->m_conditionDone.wait(lock, [pThreadPool]() {
+                  return size_t { 0 } == pThreadPool->m_cWorkersRunning;
+               });
+            }
+            return pThreadPool->m_error.load(std::memory_order_relaxed);
+         }
+      } catch(...) {
+         LOG_0(Trace_Warning, "WARNING ThreadPool::Execute synchronization failure");
+         return Error_UnexpectedInternal;
+      }
+   }
+
+serial:;
+   for(size_t iTask = 0; iTask < cTasks; ++iTask) {
+      const ErrorEbm error = (*pTask)(pContext, 0, iTask);
+      if(Error_None != error) {
+         return error;
+      }
+   }
+   return Error_None;
+}
+
+} // DEFINED_ZONE_NAME
@@ -0,0 +1,108 @@
+// Copyright (c) 2023 The InterpretML Contributors
+// Licensed under the MIT license.
+// Author: Paul Koch <code@koch.ninja>
+
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+#include <stddef.h> // size_t, ptrdiff_t
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+
+#include "libebm.h" // ErrorEbm
+#include "logging.h" // EBM_ASSERT
+#include "unzoned.h"
+
+#include "zones.h"
+
+namespace DEFINED_ZONE_NAME {
+#ifndef DEFINED_ZONE_NAME
+#error DEFINED_ZONE_NAME must be defined
+#endif // DEFINED_ZONE_NAME
+
+// iThread is 0 for the calling thread and [1, cThreads) for the workers.  Tasks can use it to index into
+// per-thread scratch space.  iTask is the index of the task within the current call to Execute
+typedef ErrorEbm (* THREAD_TASK)(void * const pContext, const size_t iThread, const size_t iTask);
+
+class ThreadPool final {
+   // The workers are started once when the booster is created and then sleep on m_conditionStart between
+   // calls to Execute.  Each call to Execute hands out tasks through m_iTaskNext, so the order in which tasks
+   // run is non-deterministic.  Callers that need deterministic results should have each task write to its own
+   // memory and then combine the results in task order after Execute returns.
+   //
+   // A pinned pool instead pins each worker to its own CPU and always runs task iTask on worker thread
+   // 1 + iTask % (GetCountThreads() - 1).  The calling thread is not pinned, so it runs no tasks.  Callers that 
+   // use the same task index for the same data on every call then touch that data from the same CPU each time, 
+   // which keeps it in the memory of that CPU's NUMA node.  When the workers are busy with another call to 
+   // Execute the tasks run on the calling thread instead, and then they lose that locality.
+
+   std::mutex m_mutexExecute; // only one Execute at a time since BoosterCore can be shared between BoosterShells
+
+   std::mutex m_mutex;
+   std::condition_variable m_conditionStart;
+   std::condition_variable m_conditionDone;
+
+   size_t m_cWorkers;
+   std::thread * m_aWorkers;
+   bool m_bPinned;
+
+   size_t m_iGeneration;
+   bool m_bStop;
+   size_t m_cWorkersRunning;
+   size_t m_cWorkersExited; // workers that left WorkerMain through an exception and will not run any more tasks
+
+   THREAD_TASK m_pTask;
+   void * m_pContext;
+   size_t m_cTasks;
+   std::atomic_size_t m_iTaskNext;
+   std::atomic<ErrorEbm> m_error;
+
+   inline ThreadPool() noexcept :
+      m_cWorkers(0),
+      m_aWorkers(nullptr),
+      m_bPinned(false),
+      m_iGeneration(0),
+      m_bStop(false),
+      m_cWorkersRunning(0),
+      m_cWorkersExited(0),
+      m_pTask(nullptr),
+      m_pContext(nullptr),
+      m_cTasks(0),
+      m_iTaskNext(0),
+      m_error(Error_None) {
+   }
+
+   ~ThreadPool() = default;
+
+   void RunTasks(const size_t iThread) noexcept;
+   void WorkerMain(const size_t iThread) noexcept;
+
+public:
+
+   static size_t GetCountThreadsDefault() noexcept;
+
+   static void Free(ThreadPool * const pThreadPool);
+   static ErrorEbm Create(const size_t cThreads, const bool bPinned, ThreadPool ** const ppThreadPoolOut);
+
+   inline size_t GetCountThreads() const noexcept {
+      return m_cWorkers + size_t { 1 };
+   }
+
+   inline bool IsPinned() const noexcept {
+      return m_bPinned;
+   }
+
+   // pThreadPool can be nullptr, in which case the tasks are run in order on the calling thread
+   static ErrorEbm Execute(
+      ThreadPool * const pThreadPool,
+      const size_t cTasks,
+      const THREAD_TASK pTask,
+      void * const pContext
+   ) noexcept;
+};
+
+} // DEFINED_ZONE_NAME
+
+#endif // THREAD_POOL_HPP
@@ -23,22 +23,74 @@ namespace DEFINED_ZONE_NAME {
 #error DEFINED_ZONE_NAME must be defined
 #endif // DEFINED_ZONE_NAME
 
-template<typename TFloat, typename TUInt, bool bHessian, size_t cCompilerScores = 1>
+template<typename TFloat, typename TUInt, bool bHessian, size_t cCompilerScores = 1, bool bWeight = true>
 struct Bin;
 
+template<typename TFloat, typename TUInt, bool bWeight>
+struct BinTotals;
+
+template<typename TFloat, typename TUInt>
+struct BinTotals<TFloat, TUInt, true> final {
+   // the sample count and the sum of the sample weights of a Bin
+
+   BinTotals() = default; // preserve our POD status
+   ~BinTotals() = default; // preserve our POD status
+   void * operator new(std::size_t) = delete; // we only use malloc/free in this library
+   void operator delete (void *) = delete; // we only use malloc/free in this library
+
+   TUInt m_cSamples;
+   TFloat m_weight;
+
+   GPU_BOTH inline TFloat GetWeight() const {
+      return m_weight;
+   }
+   GPU_BOTH inline void SetWeight(const TFloat weight) {
+      m_weight = weight;
+   }
+
+   inline static ptrdiff_t GetOffsetWeight() {
+      return static_cast<ptrdiff_t>(offsetof(BinTotals, m_weight));
+   }
+};
+
+template<typename TFloat, typename TUInt>
+struct BinTotals<TFloat, TUInt, false> final {
+   // Without sample weights every sample has a weight of 1.0, so the weight is the sample count and we do not
+   // store it.  The counts stay exact as floats since the subsets are limited to k_cSubsetSamplesMax samples.
+
+   BinTotals() = default; // preserve our POD status
+   ~BinTotals() = default; // preserve our POD status
+   void * operator new(std::size_t) = delete; // we only use malloc/free in this library
+   void operator delete (void *) = delete; // we only use malloc/free in this library
+
+   TUInt m_cSamples;
+
+   GPU_BOTH inline TFloat GetWeight() const {
+      return static_cast<TFloat>(m_cSamples);
+   }
+   GPU_BOTH inline void SetWeight(const TFloat weight) {
+      // callers keep the weight in sync with the count, which is where we get it from
+      UNUSED(weight);
+   }
+
+   inline static ptrdiff_t GetOffsetWeight() {
+      return ptrdiff_t { -1 };
+   }
+};
+
 struct BinBase {
    BinBase() = default; // preserve our POD status
    ~BinBase() = default; // preserve our POD status
    void * operator new(std::size_t) = delete; // we only use malloc/free in this library
    void operator delete (void *) = delete; // we only use malloc/free in this library
 
-   template<typename TFloat, typename TUInt, bool bHessian, size_t cCompilerScores = 1>
-   GPU_BOTH inline Bin<TFloat, TUInt, bHessian, cCompilerScores> * Specialize() {
-      return static_cast<Bin<TFloat, TUInt, bHessian, cCompilerScores> *>(this);
+   template<typename TFloat, typename TUInt, bool bHessian, size_t cCompilerScores = 1, bool bWeight = true>
+   GPU_BOTH inline Bin<TFloat, TUInt, bHessian, cCompilerScores, bWeight> * Specialize() {
+      return static_cast<Bin<TFloat, TUInt, bHessian, cCompilerScores, bWeight> *>(this);
    }
-   template<typename TFloat, typename TUInt, bool bHessian, size_t cCompilerScores = 1>
-   GPU_BOTH inline const Bin<TFloat, TUInt, bHessian, cCompilerScores> * Specialize() const {
-      return static_cast<const Bin<TFloat, TUInt, bHessian, cCompilerScores> *>(this);
+   template<typename TFloat, typename TUInt, bool bHessian, size_t cCompilerScores = 1, bool bWeight = true>
+   GPU_BOTH inline const Bin<TFloat, TUInt, bHessian, cCompilerScores, bWeight> * Specialize() const {
+      return static_cast<const Bin<TFloat, TUInt, bHessian, cCompilerScores, bWeight> *>(this);
    }
 
    GPU_BOTH inline void ZeroMem(const size_t cBytesPerBin, const size_t cBins = 1, const size_t iBin = 0) {
@@ -65,26 +117,16 @@ static_assert(std::is_trivial<BinBase>::value,
 template<typename TFloat, typename TUInt>
 static bool IsOverflowBinSize(const bool bHessian, const size_t cScores);
 template<typename TFloat, typename TUInt>
-GPU_BOTH inline constexpr static size_t GetBinSize(const bool bHessian, const size_t cScores);
+GPU_BOTH inline constexpr static size_t GetBinSize(const bool bHessian, const size_t cScores, const bool bWeight = true);
 
-template<typename TFloat, typename TUInt, bool bHessian, size_t cCompilerScores>
+template<typename TFloat, typename TUInt, bool bHessian, size_t cCompilerScores, bool bWeight>
 struct Bin final : BinBase {
-   // TODO: Use the type std::nullptr_t for TUInt to indicate that the m_cSamples field should be dropped
-   //       and add a bool bWeight template parameter to indicate if weight should be kept
-
-   friend void ConvertAddBin(
-      const size_t,
-      const bool,
-      const size_t,
-      const bool,
-      const bool,
-      const void * const,
-      const bool,
-      const bool,
-      void * const
-   );
+   // bWeight is false for the bins that the compute zones fill when there are no sample weights, which drops
+   // the weight field.  The main bins always keep it.
+   // TODO: the split search uses the sample counts for cSamplesLeafMin, so we cannot drop m_cSamples yet
+
    template<typename, typename> friend bool IsOverflowBinSize(const bool, const size_t);
-   template<typename, typename> GPU_BOTH friend inline constexpr size_t GetBinSize(const bool, const size_t);
+   template<typename, typename> GPU_BOTH friend inline constexpr size_t GetBinSize(const bool, const size_t, const bool);
 
    
    static_assert(std::is_floating_point<TFloat>::value, "TFloat must be a float type");
@@ -93,8 +135,7 @@ struct Bin final : BinBase {
 
 private:
 
-   TUInt m_cSamples;
-   TFloat m_weight;
+   BinTotals<TFloat, TUInt, bWeight> m_totals;
 
    // IMPORTANT: m_aGradientPairs must be in the last position for the struct hack and this must be standard layout
    GradientPair<TFloat, bHessian> m_aGradientPairs[cCompilerScores];
@@ -107,17 +148,29 @@ public:
    void operator delete (void *) = delete; // we only use malloc/free in this library
 
    GPU_BOTH inline TUInt GetCountSamples() const {
-      return m_cSamples;
+      return m_totals.m_cSamples;
    }
    GPU_BOTH inline void SetCountSamples(const TUInt cSamples) {
-      m_cSamples = cSamples;
+      m_totals.m_cSamples = cSamples;
    }
 
    GPU_BOTH inline TFloat GetWeight() const {
-      return m_weight;
+      return m_totals.GetWeight();
    }
    GPU_BOTH inline void SetWeight(const TFloat weight) {
-      m_weight = weight;
+      m_totals.SetWeight(weight);
+   }
+
+   // the byte offsets of the fields, for code that handles bins whose types are only known at runtime
+   inline static ptrdiff_t GetOffsetCountSamples() {
+      return static_cast<ptrdiff_t>(offsetof(Bin, m_totals) + offsetof(decltype(m_totals), m_cSamples));
+   }
+   inline static ptrdiff_t GetOffsetWeight() {
+      const ptrdiff_t iWeight = decltype(m_totals)::GetOffsetWeight();
+      return iWeight < ptrdiff_t { 0 } ? iWeight : static_cast<ptrdiff_t>(offsetof(Bin, m_totals)) + iWeight;
+   }
+   inline static ptrdiff_t GetOffsetGradientPairs() {
+      return static_cast<ptrdiff_t>(offsetof(Bin, m_aGradientPairs));
    }
 
    GPU_BOTH inline const GradientPair<TFloat, bHessian> * GetGradientPairs() const {
@@ -127,11 +180,11 @@ public:
       return ArrayToPointer(m_aGradientPairs);
    }
 
-   GPU_BOTH inline const Bin<TFloat, TUInt, bHessian, 1> * Downgrade() const {
-      return reinterpret_cast<const Bin<TFloat, TUInt, bHessian, 1> *>(this);
+   GPU_BOTH inline const Bin<TFloat, TUInt, bHessian, 1, bWeight> * Downgrade() const {
+      return reinterpret_cast<const Bin<TFloat, TUInt, bHessian, 1, bWeight> *>(this);
    }
-   GPU_BOTH inline Bin<TFloat, TUInt, bHessian, 1> * Downgrade() {
-      return reinterpret_cast<Bin<TFloat, TUInt, bHessian, 1> *>(this);
+   GPU_BOTH inline Bin<TFloat, TUInt, bHessian, 1, bWeight> * Downgrade() {
+      return reinterpret_cast<Bin<TFloat, TUInt, bHessian, 1, bWeight> *>(this);
    }
 
    GPU_BOTH inline void Add(
@@ -146,8 +199,8 @@ public:
       EBM_ASSERT(cScores != cCompilerScores || aThisGradientPairs == GetGradientPairs());
       EBM_ASSERT(1 <= cScores);
 #endif // GPU_COMPILE
-      m_cSamples += other.m_cSamples;
-      m_weight += other.m_weight;
+      m_totals.m_cSamples += other.m_totals.m_cSamples;
+      m_totals.SetWeight(m_totals.GetWeight() + other.m_totals.GetWeight());
 
       size_t iScore = 0;
       do {
@@ -178,8 +231,8 @@ public:
       EBM_ASSERT(cScores != cCompilerScores || aThisGradientPairs == GetGradientPairs());
       EBM_ASSERT(1 <= cScores);
 #endif // GPU_COMPILE
-      m_cSamples -= other.m_cSamples;
-      m_weight -= other.m_weight;
+      m_totals.m_cSamples -= other.m_totals.m_cSamples;
+      m_totals.SetWeight(m_totals.GetWeight() - other.m_totals.GetWeight());
 
       size_t iScore = 0;
       do {
@@ -211,8 +264,7 @@ public:
       EBM_ASSERT(1 <= cScores);
 #endif // GPU_COMPILE
 
-      m_cSamples = other.m_cSamples;
-      m_weight = other.m_weight;
+      m_totals = other.m_totals;
 
       size_t iScore = 0;
       do {
@@ -240,8 +292,8 @@ public:
       EBM_ASSERT(cScores != cCompilerScores || aThisGradientPairs == GetGradientPairs());
 #endif // GPU_COMPILE
 
-      m_cSamples = 0;
-      m_weight = 0;
+      m_totals.m_cSamples = 0;
+      m_totals.SetWeight(0);
       ZeroGradientPairs(aThisGradientPairs, cScores);
    }
    GPU_BOTH inline void Zero(const size_t cScores) {
@@ -259,8 +311,8 @@ public:
       EBM_ASSERT(1 == cCompilerScores || cScores == cCompilerScores);
       EBM_ASSERT(cScores != cCompilerScores || aThisGradientPairs == GetGradientPairs());
 
-      EBM_ASSERT(0 == m_cSamples);
-      EBM_ASSERT(0 == m_weight);
+      EBM_ASSERT(0 == m_totals.m_cSamples);
+      EBM_ASSERT(0 == m_totals.GetWeight());
 
       EBM_ASSERT(1 <= cScores);
       size_t iScore = 0;
@@ -285,6 +337,11 @@ static_assert(std::is_standard_layout<Bin<double, uint64_t, false>>::value,
 static_assert(std::is_trivial<Bin<double, uint64_t, false>>::value,
    "We use memcpy in several places, so disallow non-trivial types in general");
 
+static_assert(std::is_standard_layout<Bin<float, uint32_t, true, 1, false>>::value,
+   "We use the struct hack in several places, so disallow non-standard_layout types in general");
+static_assert(std::is_trivial<Bin<float, uint32_t, true, 1, false>>::value,
+   "We use memcpy in several places, so disallow non-trivial types in general");
+
 template<typename TFloat, typename TUInt>
 inline static bool IsOverflowBinSize(const bool bHessian, const size_t cScores) {
    const size_t cBytesPerGradientPair = GetGradientPairSize<TFloat>(bHessian);
@@ -310,31 +367,36 @@ inline static bool IsOverflowBinSize(const bool bHessian, const size_t cScores)
 }
 
 template<typename TFloat, typename TUInt>
-GPU_BOTH inline constexpr static size_t GetBinSize(const bool bHessian, const size_t cScores) {
+GPU_BOTH inline constexpr static size_t GetBinSize(const bool bHessian, const size_t cScores, const bool bWeight) {
    typedef Bin<TFloat, TUInt, true> OffsetTypeHt;
    typedef Bin<TFloat, TUInt, false> OffsetTypeHf;
+   typedef Bin<TFloat, TUInt, true, 1, false> OffsetTypeHtWf;
+   typedef Bin<TFloat, TUInt, false, 1, false> OffsetTypeHfWf;
 
    // TODO: someday try out bin sizes that are a power of two.  This would allow us to use a shift when using bins
    //       instead of using multiplications.  In that version return the number of bits to shift here to make it easy
    //       to get either the shift required for indexing OR the number of bytes (shift 1 << num_bits)
 
-   return (bHessian ? offsetof(OffsetTypeHt, m_aGradientPairs) : offsetof(OffsetTypeHf, m_aGradientPairs)) + GetGradientPairSize<TFloat>(bHessian) * cScores;
+   return (bWeight ? 
+      (bHessian ? offsetof(OffsetTypeHt, m_aGradientPairs) : offsetof(OffsetTypeHf, m_aGradientPairs)) :
+      (bHessian ? offsetof(OffsetTypeHtWf, m_aGradientPairs) : offsetof(OffsetTypeHfWf, m_aGradientPairs))) + 
+      GetGradientPairSize<TFloat>(bHessian) * cScores;
 }
 
 
 
 
-template<typename TFloat, typename TUInt, bool bHessian, size_t cCompilerScores>
-GPU_BOTH inline static Bin<TFloat, TUInt, bHessian, cCompilerScores> * IndexBin(
-   Bin<TFloat, TUInt, bHessian, cCompilerScores> * const aBins,
+template<typename TFloat, typename TUInt, bool bHessian, size_t cCompilerScores, bool bWeight>
+GPU_BOTH inline static Bin<TFloat, TUInt, bHessian, cCompilerScores, bWeight> * IndexBin(
+   Bin<TFloat, TUInt, bHessian, cCompilerScores, bWeight> * const aBins,
    const size_t iByte
 ) {
    return IndexByte(aBins, iByte);
 }
 
-template<typename TFloat, typename TUInt, bool bHessian, size_t cCompilerScores>
-GPU_BOTH inline static const Bin<TFloat, TUInt, bHessian, cCompilerScores> * IndexBin(
-   const Bin<TFloat, TUInt, bHessian, cCompilerScores> * const aBins,
+template<typename TFloat, typename TUInt, bool bHessian, size_t cCompilerScores, bool bWeight>
+GPU_BOTH inline static const Bin<TFloat, TUInt, bHessian, cCompilerScores, bWeight> * IndexBin(
+   const Bin<TFloat, TUInt, bHessian, cCompilerScores, bWeight> * const aBins,
    const size_t iByte
 ) {
    return IndexByte(aBins, iByte);
@@ -28,16 +28,37 @@ typedef float FloatSmall;
 static_assert(sizeof(UIntSmall) < sizeof(UIntBig), "UIntBig must be able to contain UIntSmall");
 static_assert(sizeof(FloatSmall) < sizeof(FloatBig), "FloatBig must be able to contain FloatSmall");
 
+// how the gradients and hessians are stored in m_aGradientsAndHessians
+#define k_gradHessFloat             (0) // the float type of the zone
+#define k_gradHessBfloat16          (1)
+
+// the validation metrics that can be listed after the objective, eg: "log_loss,brier,auc"
+#define k_metricObjective           (0) // the objective's own metric, which is used if no metrics are listed
+#define k_metricAuc                 (1)
+#define k_metricBrier               (2)
+#define k_metricCalibrationError    (3)
+#define k_metricLogLoss             (4) // the objective's own metric, but only legal for the log_loss objectives
+
+// the most metrics that can be listed after the objective
+#define k_cMetricsMax               (STATIC_CAST(size_t, 8))
+
+// the number of equal width probability bins that the calibration_error metric uses
+#define k_cCalibrationBins          (STATIC_CAST(size_t, 10))
+
 struct ApplyUpdateBridge {
    size_t m_cScores;
    int m_cPack;
 
    BoolEbm m_bHessianNeeded;
+   int m_gradHessFormat; // k_gradHessFloat or k_gradHessBfloat16
 
    BoolEbm m_bValidation;
+   // if true then the binary log_loss validation pass also sums m_brierOut and m_aCalibrationOut
+   BoolEbm m_bProbabilityMetrics;
    BoolEbm m_bDisableApprox;
    void * m_aMulticlassMidwayTemp; // float or double
    const void * m_aUpdateTensorScores; // float or double
+   size_t m_cTensorBins; // the number of bins in m_aUpdateTensorScores for each score
    size_t m_cSamples;
    const void * m_aPacked; // uint64_t or uint32_t
    const void * m_aTargets; // uint64_t or uint32_t or float or double
@@ -46,27 +67,64 @@ struct ApplyUpdateBridge {
    void * m_aGradientsAndHessians; // float or double
 
    double m_metricOut;
+   double m_brierOut; // the weighted sum of (probability - target)^2
+   double m_aCalibrationOut[k_cCalibrationBins]; // the weighted sum of (probability - target) in each probability bin
 };
 
+// the most bin ranges that BinSumsBoosting will sort the samples into when given m_aSortScratch
+#define k_cBinSumsSortRangesMax      (STATIC_CAST(size_t, 256))
+
 struct BinSumsBoostingBridge {
    BoolEbm m_bHessian;
+   int m_gradHessFormat;
    size_t m_cScores;
 
    int m_cPack;
 
    size_t m_cSamples;
-   const void * m_aGradientsAndHessians; // float or double
+   const void * m_aGradientsAndHessians; // float or double, or as given by m_gradHessFormat
    const void * m_aWeights; // float or double
    const uint8_t * m_pCountOccurrences;
    const void * m_aPacked; // uint64_t or uint32_t
 
+   size_t m_cBins; // the number of bins in m_aFastBins
    void * m_aFastBins; // Bin<...> (can't use BinBase * since this is only C here)
 
+   // if not nullptr, space for 2 * m_cSamples uint64_t or uint32_t, and the samples are sorted into ranges of 
+   // (1 << m_cBinRangeShift) bins that are summed one at a time so that the bins being updated stay in the cache
+   void * m_aSortScratch;
+   int m_cBinRangeShift;
+
+   // filled in by the zone from ObjectiveWrapper::m_bConflictDetect, so callers do not need to set it
+   BoolEbm m_bConflictDetect;
+
 #ifndef NDEBUG
    const void * m_pDebugFastBinsEnd;
 #endif // NDEBUG
 };
 
+// the maximum number of terms that BinSumsBoostingMulti can bin in one pass.  Callers with more terms than this
+// need to split them into multiple calls
+#define k_cBinSumsMultiTermsMax      (STATIC_CAST(size_t, 16))
+
+struct BinSumsBoostingMultiBridge {
+   BoolEbm m_bHessian;
+   int m_gradHessFormat;
+   size_t m_cScores;
+
+   size_t m_cSamples;
+   const void * m_aGradientsAndHessians; // float or double
+   const void * m_aWeights; // float or double
+   const uint8_t * m_pCountOccurrences;
+
+   size_t m_cTerms;
+   int m_acPack[k_cBinSumsMultiTermsMax];
+   const void * m_aaPacked[k_cBinSumsMultiTermsMax]; // uint64_t or uint32_t
+   size_t m_acBins[k_cBinSumsMultiTermsMax]; // the number of bins in each of m_aaFastBins
+
+   void * m_aaFastBins[k_cBinSumsMultiTermsMax]; // Bin<...> (can't use BinBase * since this is only C here)
+};
+
 struct BinSumsInteractionBridge {
    BoolEbm m_bHessian;
    size_t m_cScores;
@@ -82,6 +140,9 @@ struct BinSumsInteractionBridge {
 
    void * m_aFastBins; // Bin<...> (can't use BinBase * since this is only C here)
 
+   // filled in by the zone from ObjectiveWrapper::m_bConflictDetect, so callers do not need to set it
+   BoolEbm m_bConflictDetect;
+
 #ifndef NDEBUG
    const void * m_pDebugFastBinsEnd;
 #endif // NDEBUG
@@ -95,11 +156,13 @@ typedef double (* FINISH_METRIC_C)(const ObjectiveWrapper * const pObjectiveWrap
 typedef BoolEbm (* CHECK_TARGETS_C)(const ObjectiveWrapper * const pObjectiveWrapper, const size_t c, const void * const aTargets);
 
 typedef ErrorEbm (* BIN_SUMS_BOOSTING_C)(const ObjectiveWrapper * const pObjectiveWrapper, BinSumsBoostingBridge * const pParams);
+typedef ErrorEbm (* BIN_SUMS_BOOSTING_MULTI_C)(const ObjectiveWrapper * const pObjectiveWrapper, BinSumsBoostingMultiBridge * const pParams);
 typedef ErrorEbm (* BIN_SUMS_INTERACTION_C)(const ObjectiveWrapper * const pObjectiveWrapper, BinSumsInteractionBridge * const pParams);
 
 struct ObjectiveWrapper {
    APPLY_UPDATE_C m_pApplyUpdateC;
    BIN_SUMS_BOOSTING_C m_pBinSumsBoostingC;
+   BIN_SUMS_BOOSTING_MULTI_C m_pBinSumsBoostingMultiC;
    BIN_SUMS_INTERACTION_C m_pBinSumsInteractionC;
    // everything below here the C++ *Objective specific class needs to fill out
 
@@ -132,6 +195,9 @@ struct ObjectiveWrapper {
 
    ComputeFlags m_zones;
 
+   // the CPU can detect colliding SIMD lanes (AVX-512CD), so the zone can update the bins with scatters
+   BoolEbm m_bConflictDetect;
+
    // these are C++ function pointer definitions that exist per-zone, and must remain hidden in the C interface
    void * m_pFunctionPointersCpp;
 };
@@ -153,6 +219,7 @@ inline static void InitializeObjectiveWrapperUnfailing(ObjectiveWrapper * const
    pObjectiveWrapper->m_cSIMDPack = 0;
    pObjectiveWrapper->m_cFloatBytes = 0;
    pObjectiveWrapper->m_cUIntBytes = 0;
+   pObjectiveWrapper->m_bConflictDetect = EBM_FALSE;
    pObjectiveWrapper->m_pFunctionPointersCpp = NULL;
 }
 
@@ -188,6 +255,13 @@ INTERNAL_IMPORT_EXPORT_INCLUDE ErrorEbm CreateObjective_Avx2_32(
    ObjectiveWrapper * const pObjectiveWrapperOut
 );
 
+INTERNAL_IMPORT_EXPORT_INCLUDE ErrorEbm CreateObjective_Avx2_64(
+   const Config * const pConfig,
+   const char * const sObjective,
+   const char * const sObjectiveEnd,
+   ObjectiveWrapper * const pObjectiveWrapperOut
+);
+
 INTERNAL_IMPORT_EXPORT_INCLUDE ErrorEbm CreateObjective_Cuda_32(
    const Config * const pConfig,
    const char * const sObjective,
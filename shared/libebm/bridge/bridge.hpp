@@ -74,6 +74,23 @@ inline constexpr static size_t GetArrayScores(const size_t cScores) noexcept {
 static constexpr int k_cItemsPerBitPackNone = -1; // this is for when there is only 1 bin
 static constexpr int k_cItemsPerBitPackDynamic = 0;
 
+// BinSumsBoosting gives each SIMD lane a private histogram if the histograms of all the lanes fit into this many 
+// bytes.  They are kept on the stack and we want them to stay in the L1 cache along with the bins
+static constexpr size_t k_cBytesLaneBinsMax = 16384;
+
+inline constexpr static bool IsLaneBins(
+   const size_t cSIMDPack, 
+   const size_t cFloatBytes, 
+   const bool bHessian, 
+   const size_t cScores, 
+   const size_t cBins
+) noexcept {
+   // each lane holds the count, weight, gradient and hessian of every bin, with the bins padded to a whole SIMD pack
+   return k_oneScore == cScores && size_t { 1 } != cSIMDPack && size_t { 1 } <= cBins &&
+      (cBins - size_t { 1 }) / cSIMDPack + size_t { 1 } <= 
+      k_cBytesLaneBinsMax / cFloatBytes / ((bHessian ? size_t { 4 } : size_t { 3 }) * cSIMDPack * cSIMDPack);
+}
+
 inline constexpr static bool IsRegressionOutput(const LinkEbm link) noexcept {
    return 
       Link_custom_regression == link ||
@@ -8,9 +8,12 @@
 #include <limits> // numeric_limits
 #include <type_traits> // std::is_integral, std::enable_if, std::is_signed
 #include <stddef.h> // size_t, ptrdiff_t
+#include <stdint.h> // uint16_t, uint32_t
+#include <string.h> // memcpy
 
 #include "logging.h"
 #include "unzoned.h"
+#include "bridge.h" // k_gradHessBfloat16
 
 #include "zones.h"
 
@@ -139,6 +142,56 @@ static_assert(EbmMax(3.75, 2.5, 1.25) == 3.75, "automated test with compiler");
 static_assert(EbmMax(2.5, 3.75, 1.25) == 3.75, "automated test with compiler");
 static_assert(EbmMax(1.25, 2.5, 3.75) == 3.75, "automated test with compiler");
 
+// bfloat16 keeps the sign, the exponent, and the top 7 bits of the mantissa of a float.  We use it to hold the
+// gradients and hessians when the booster is created with CreateBoosterFlags_Bfloat16Gradients.  It has the same 
+// range as a float, so unlike IEEE half precision the tiny hessians of confident predictions do not flush to zero,
+// and widening it back to a float is just a shift.
+struct Bfloat16 final {
+   uint16_t m_bits;
+};
+static_assert(sizeof(Bfloat16) == sizeof(uint16_t), "Bfloat16 must be packed since we index arrays of them");
+static_assert(std::is_standard_layout<Bfloat16>::value && std::is_trivially_copyable<Bfloat16>::value,
+   "This allows offsetof, memcpy, memset, inter-language, GPU and cross-machine use where needed");
+
+GPU_BOTH inline static float Bfloat16ToFloat(const Bfloat16 val) noexcept {
+   const uint32_t bits = static_cast<uint32_t>(val.m_bits) << 16;
+   float result;
+   memcpy(&result, &bits, sizeof(result));
+   return result;
+}
+
+GPU_BOTH inline static Bfloat16 FloatToBfloat16(const float val) noexcept {
+   uint32_t bits;
+   memcpy(&bits, &val, sizeof(bits));
+   if(uint32_t { 0x7F800000 } < (bits & uint32_t { 0x7FFFFFFF })) {
+      // keep NaN values NaN by setting the quiet bit, which survives the truncation below
+      bits |= uint32_t { 0x00400000 };
+   } else {
+      // round to nearest, ties to even
+      bits += uint32_t { 0x7FFF } + ((bits >> 16) & uint32_t { 1 });
+   }
+   Bfloat16 result;
+   result.m_bits = static_cast<uint16_t>(bits >> 16);
+   return result;
+}
+
+// the type that the gradients and hessians are stored as
+template<typename TFloat, int gradHessFormat>
+using GradHessStorage = typename std::conditional<k_gradHessBfloat16 == gradHessFormat, Bfloat16, typename TFloat::T>::type;
+
+inline static size_t GetCountBytesGradHessItem(const int gradHessFormat, const size_t cFloatBytes) noexcept {
+   return k_gradHessBfloat16 == gradHessFormat ? sizeof(Bfloat16) : cFloatBytes;
+}
+
+template<typename T>
+GPU_BOTH inline static T WidenGradHess(const T val) noexcept {
+   return val;
+}
+template<typename T>
+GPU_BOTH inline static T WidenGradHess(const Bfloat16 val) noexcept {
+   return static_cast<T>(Bfloat16ToFloat(val));
+}
+
 template<typename T>
 inline constexpr static T EbmAbs(T v) noexcept {
    return T { 0 } <= v ? v : -v;
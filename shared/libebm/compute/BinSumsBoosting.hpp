@@ -11,7 +11,8 @@
 #include "zones.h"
 
 #include "common.hpp" // Multiply
-#include "bridge.hpp" // BinSumsBoostingBridge
+#include "bridge.hpp" // BinSumsBoostingBridge, BinSumsBoostingMultiBridge
+#include "compute.hpp" // GetFirstBitPackBinSums, GetNextBitPackBinSums
 #include "GradientPair.hpp"
 #include "Bin.hpp"
 
@@ -23,21 +24,18 @@ namespace DEFINED_ZONE_NAME {
 template<
    typename TFloat, 
    bool bHessian, 
+   int gradHessFormat,
    bool bWeight,
    bool bReplication,
    size_t cCompilerScores,
    int cCompilerPack, 
-   typename std::enable_if<k_cItemsPerBitPackNone == cCompilerPack, int>::type = 0
+   typename std::enable_if<k_cItemsPerBitPackNone == cCompilerPack && k_dynamicScores != cCompilerScores, int>::type = 0
 >
 GPU_DEVICE NEVER_INLINE static void BinSumsBoostingInternal(BinSumsBoostingBridge * const pParams) {
    static_assert(bWeight || !bReplication, "bReplication cannot be true if bWeight is false");
 
-   // TODO: we can improve the zero dimensional scenario quite a bit because we know that all the scores added will
-   // eventually be added into the same bin.  Instead of adding the gradients & hessians & weights & counts from
-   // each sample to the bin in order, we can just add those values together for all samples in SIMD variables
-   // and then add the totals into the bins. We probably want to write a completely separate function for handling
-   // it this way though.
-   static constexpr size_t cArrayScores = GetArrayScores(cCompilerScores);
+   // All the samples go into the same bin, so instead of updating the bin for each sample we sum the counts, 
+   // weights, gradients and hessians in SIMD registers and add the horizontal sums into the bin at the end.
 
 #ifndef GPU_COMPILE
    EBM_ASSERT(nullptr != pParams);
@@ -45,17 +43,15 @@ GPU_DEVICE NEVER_INLINE static void BinSumsBoostingInternal(BinSumsBoostingBridg
    EBM_ASSERT(0 == pParams->m_cSamples % size_t { TFloat::k_cSIMDPack });
    EBM_ASSERT(nullptr != pParams->m_aGradientsAndHessians);
    EBM_ASSERT(nullptr != pParams->m_aFastBins);
-   EBM_ASSERT(k_dynamicScores == cCompilerScores || cCompilerScores == pParams->m_cScores);
+   EBM_ASSERT(cCompilerScores == pParams->m_cScores);
 #endif // GPU_COMPILE
 
-   const size_t cScores = GET_COUNT_SCORES(cCompilerScores, pParams->m_cScores);
-
-   auto * const aBins = reinterpret_cast<BinBase *>(pParams->m_aFastBins)->Specialize<typename TFloat::T, typename TFloat::TInt::T, bHessian, cArrayScores>();
+   auto * const pBin = reinterpret_cast<BinBase *>(pParams->m_aFastBins)->Specialize<typename TFloat::T, typename TFloat::TInt::T, bHessian, cCompilerScores, bWeight>();
 
    const size_t cSamples = pParams->m_cSamples;
 
-   const typename TFloat::T * pGradientAndHessian = reinterpret_cast<const typename TFloat::T *>(pParams->m_aGradientsAndHessians);
-   const typename TFloat::T * const pGradientsAndHessiansEnd = pGradientAndHessian + (bHessian ? size_t { 2 } : size_t { 1 }) * cScores * cSamples;
+   const GradHessStorage<TFloat, gradHessFormat> * pGradientAndHessian = reinterpret_cast<const GradHessStorage<TFloat, gradHessFormat> *>(pParams->m_aGradientsAndHessians);
+   const GradHessStorage<TFloat, gradHessFormat> * const pGradientsAndHessiansEnd = pGradientAndHessian + (bHessian ? size_t { 2 } : size_t { 1 }) * cCompilerScores * cSamples;
 
    const typename TFloat::T * pWeight;
    const uint8_t * pCountOccurrences;
@@ -72,51 +68,30 @@ GPU_DEVICE NEVER_INLINE static void BinSumsBoostingInternal(BinSumsBoostingBridg
       }
    }
 
-   do {
-      if(bReplication) {
-         const typename TFloat::TInt cOccurences = TFloat::TInt::LoadBytes(pCountOccurrences);
-         pCountOccurrences += TFloat::k_cSIMDPack;
-
-         TFloat::TInt::Execute([aBins](int, const typename TFloat::TInt::T x) {
-            auto * const pBin = aBins;
-            // TODO: In the future we'd like to eliminate this but we need the ability to change the Bin class
-            //       such that we can remove that field optionally
-            pBin->SetCountSamples(pBin->GetCountSamples() + x);
-         }, cOccurences);
-      } else {
-         TFloat::Execute([aBins](int) {
-            auto * const pBin = aBins;
-            // TODO: In the future we'd like to eliminate this but we need the ability to change the Bin class
-            //       such that we can remove that field optionally
-            pBin->SetCountSamples(pBin->GetCountSamples() + typename TFloat::TInt::T { 1 });
-         });
+   typename TFloat::TInt countSamples = typename TFloat::TInt::T { 0 };
+   TFloat sumWeights = 0.0;
+   TFloat aSumGradients[cCompilerScores];
+   TFloat aSumHessians[cCompilerScores];
+   for(size_t iScore = 0; iScore < cCompilerScores; ++iScore) {
+      aSumGradients[iScore] = 0.0;
+      if(bHessian) {
+         aSumHessians[iScore] = 0.0;
       }
+   }
 
+   do {
       TFloat weight;
       if(bWeight) {
          weight = TFloat::Load(pWeight);
          pWeight += TFloat::k_cSIMDPack;
-
-         TFloat::Execute([aBins](int, const typename TFloat::T x) {
-            auto * const pBin = aBins;
-            // TODO: In the future we'd like to eliminate this but we need the ability to change the Bin class
-            //       such that we can remove that field optionally
-            pBin->SetWeight(pBin->GetWeight() + x);
-         }, weight);
-      } else {
-         TFloat::Execute([aBins](int) {
-            auto * const pBin = aBins;
-            // TODO: In the future we'd like to eliminate this but we need the ability to change the Bin class
-            //       such that we can remove that field optionally
-            pBin->SetWeight(pBin->GetWeight() + typename TFloat::T { 1.0 });
-         });
+         sumWeights += weight;
+         if(bReplication) {
+            countSamples = countSamples + TFloat::TInt::LoadBytes(pCountOccurrences);
+            pCountOccurrences += TFloat::k_cSIMDPack;
+         }
       }
 
-      // TODO: we probably want a templated version of this function for Bins with only 1 cScore so that
-      //       we can pre-fetch the weight, count, gradient and hessian before writing them 
-
-      size_t iScore = 0;
-      do {
+      for(size_t iScore = 0; iScore < cCompilerScores; ++iScore) {
          if(bHessian) {
             TFloat gradient = TFloat::Load(&pGradientAndHessian[iScore << (TFloat::k_cSIMDShift + 1)]);
             TFloat hessian = TFloat::Load(&pGradientAndHessian[(iScore << (TFloat::k_cSIMDShift + 1)) + TFloat::k_cSIMDPack]);
@@ -124,39 +99,727 @@ GPU_DEVICE NEVER_INLINE static void BinSumsBoostingInternal(BinSumsBoostingBridg
                gradient *= weight;
                hessian *= weight;
             }
-            TFloat::Execute([aBins, iScore](int, const typename TFloat::T grad, const typename TFloat::T hess) {
-               auto * const pBin = aBins;
-               auto * const aGradientPair = pBin->GetGradientPairs();
-               auto * const pGradientPair = &aGradientPair[iScore];
-               typename TFloat::T binGrad = pGradientPair->m_sumGradients;
-               typename TFloat::T binHess = pGradientPair->GetHess();
-               binGrad += grad;
-               binHess += hess;
-               pGradientPair->m_sumGradients = binGrad;
-               pGradientPair->SetHess(binHess);
-            }, gradient, hessian);
+            aSumGradients[iScore] += gradient;
+            aSumHessians[iScore] += hessian;
          } else {
             TFloat gradient = TFloat::Load(&pGradientAndHessian[iScore << TFloat::k_cSIMDShift]);
             if(bWeight) {
                gradient *= weight;
             }
-            TFloat::Execute([aBins, iScore](int, const typename TFloat::T grad) {
-               auto * const pBin = aBins;
-               auto * const aGradientPair = pBin->GetGradientPairs();
-               auto * const pGradientPair = &aGradientPair[iScore];
-               pGradientPair->m_sumGradients += grad;
-            }, gradient);
+            aSumGradients[iScore] += gradient;
          }
-         ++iScore;
-      } while(cScores != iScore);
+      }
 
-      pGradientAndHessian += cScores << (bHessian ? (TFloat::k_cSIMDShift + 1) : TFloat::k_cSIMDShift);
+      pGradientAndHessian += cCompilerScores << (bHessian ? (TFloat::k_cSIMDShift + 1) : TFloat::k_cSIMDShift);
+   } while(pGradientsAndHessiansEnd != pGradientAndHessian);
+
+   // without replication each sample counts once.  Without weights the bin has no weight field to update
+   pBin->SetCountSamples(pBin->GetCountSamples() + 
+      (bReplication ? Sum(countSamples) : static_cast<typename TFloat::TInt::T>(cSamples)));
+   if(bWeight) {
+      pBin->SetWeight(pBin->GetWeight() + Sum(sumWeights));
+   }
+
+   auto * const aGradientPair = pBin->GetGradientPairs();
+   for(size_t iScore = 0; iScore < cCompilerScores; ++iScore) {
+      auto * const pGradientPair = &aGradientPair[iScore];
+      pGradientPair->m_sumGradients += Sum(aSumGradients[iScore]);
+      if(bHessian) {
+         pGradientPair->SetHess(pGradientPair->GetHess() + Sum(aSumHessians[iScore]));
+      }
+   }
+}
+
+template<
+   typename TFloat, 
+   bool bHessian, 
+   int gradHessFormat,
+   bool bWeight,
+   bool bReplication,
+   size_t cCompilerScores,
+   int cCompilerPack, 
+   typename std::enable_if<k_cItemsPerBitPackNone == cCompilerPack && k_dynamicScores == cCompilerScores, int>::type = 0
+>
+GPU_DEVICE NEVER_INLINE static void BinSumsBoostingInternal(BinSumsBoostingBridge * const pParams) {
+   static_assert(bWeight || !bReplication, "bReplication cannot be true if bWeight is false");
+
+   // All the samples go into the same bin, but with a runtime number of scores we cannot hold all the sums in 
+   // registers, so we make one pass over the samples for each block of k_cCompilerScoresMax scores and sum that
+   // block in SIMD registers.  The counts and weights are summed during the first pass.
+   static constexpr size_t cArrayScores = GetArrayScores(cCompilerScores);
+
+#ifndef GPU_COMPILE
+   EBM_ASSERT(nullptr != pParams);
+   EBM_ASSERT(1 <= pParams->m_cSamples);
+   EBM_ASSERT(0 == pParams->m_cSamples % size_t { TFloat::k_cSIMDPack });
+   EBM_ASSERT(nullptr != pParams->m_aGradientsAndHessians);
+   EBM_ASSERT(nullptr != pParams->m_aFastBins);
+   EBM_ASSERT(k_dynamicScores == cCompilerScores || cCompilerScores == pParams->m_cScores);
+#endif // GPU_COMPILE
+
+   const size_t cScores = GET_COUNT_SCORES(cCompilerScores, pParams->m_cScores);
+
+   auto * const pBin = reinterpret_cast<BinBase *>(pParams->m_aFastBins)->Specialize<typename TFloat::T, typename TFloat::TInt::T, bHessian, cArrayScores, bWeight>();
+   auto * const aGradientPair = pBin->GetGradientPairs();
+
+   const size_t cSamples = pParams->m_cSamples;
+   const size_t cPacks = cSamples >> TFloat::k_cSIMDShift;
+
+   const GradHessStorage<TFloat, gradHessFormat> * const aGradientsAndHessians = reinterpret_cast<const GradHessStorage<TFloat, gradHessFormat> *>(pParams->m_aGradientsAndHessians);
+
+   typename TFloat::TInt countSamples = typename TFloat::TInt::T { 0 };
+   TFloat sumWeights = 0.0;
+
+   size_t iScoreFirst = 0;
+   do {
+      const size_t cBlockScores = EbmMin(cScores - iScoreFirst, k_cCompilerScoresMax);
+
+      TFloat aSumGradients[k_cCompilerScoresMax];
+      TFloat aSumHessians[k_cCompilerScoresMax];
+      for(size_t iScore = 0; iScore < cBlockScores; ++iScore) {
+         aSumGradients[iScore] = 0.0;
+         if(bHessian) {
+            aSumHessians[iScore] = 0.0;
+         }
+      }
+
+      const GradHessStorage<TFloat, gradHessFormat> * pGradientAndHessian = 
+         aGradientsAndHessians + (iScoreFirst << (bHessian ? (TFloat::k_cSIMDShift + 1) : TFloat::k_cSIMDShift));
+
+      const typename TFloat::T * pWeight;
+      const uint8_t * pCountOccurrences;
+      if(bWeight) {
+         pWeight = reinterpret_cast<const typename TFloat::T *>(pParams->m_aWeights);
+#ifndef GPU_COMPILE
+         EBM_ASSERT(nullptr != pWeight);
+#endif // GPU_COMPILE
+         if(bReplication) {
+            pCountOccurrences = pParams->m_pCountOccurrences;
+#ifndef GPU_COMPILE
+            EBM_ASSERT(nullptr != pCountOccurrences);
+#endif // GPU_COMPILE
+         }
+      }
+
+      size_t iPack = 0;
+      do {
+         TFloat weight;
+         if(bWeight) {
+            weight = TFloat::Load(pWeight);
+            pWeight += TFloat::k_cSIMDPack;
+            if(0 == iScoreFirst) {
+               sumWeights += weight;
+               if(bReplication) {
+                  countSamples = countSamples + TFloat::TInt::LoadBytes(pCountOccurrences);
+                  pCountOccurrences += TFloat::k_cSIMDPack;
+               }
+            }
+         }
+
+         for(size_t iScore = 0; iScore < cBlockScores; ++iScore) {
+            if(bHessian) {
+               TFloat gradient = TFloat::Load(&pGradientAndHessian[iScore << (TFloat::k_cSIMDShift + 1)]);
+               TFloat hessian = TFloat::Load(&pGradientAndHessian[(iScore << (TFloat::k_cSIMDShift + 1)) + TFloat::k_cSIMDPack]);
+               if(bWeight) {
+                  gradient *= weight;
+                  hessian *= weight;
+               }
+               aSumGradients[iScore] += gradient;
+               aSumHessians[iScore] += hessian;
+            } else {
+               TFloat gradient = TFloat::Load(&pGradientAndHessian[iScore << TFloat::k_cSIMDShift]);
+               if(bWeight) {
+                  gradient *= weight;
+               }
+               aSumGradients[iScore] += gradient;
+            }
+         }
+
+         pGradientAndHessian += cScores << (bHessian ? (TFloat::k_cSIMDShift + 1) : TFloat::k_cSIMDShift);
+         ++iPack;
+      } while(cPacks != iPack);
+
+      for(size_t iScore = 0; iScore < cBlockScores; ++iScore) {
+         auto * const pGradientPair = &aGradientPair[iScoreFirst + iScore];
+         pGradientPair->m_sumGradients += Sum(aSumGradients[iScore]);
+         if(bHessian) {
+            pGradientPair->SetHess(pGradientPair->GetHess() + Sum(aSumHessians[iScore]));
+         }
+      }
+
+      iScoreFirst += cBlockScores;
+   } while(cScores != iScoreFirst);
+
+   // without replication each sample counts once.  Without weights the bin has no weight field to update
+   pBin->SetCountSamples(pBin->GetCountSamples() + 
+      (bReplication ? Sum(countSamples) : static_cast<typename TFloat::TInt::T>(cSamples)));
+   if(bWeight) {
+      pBin->SetWeight(pBin->GetWeight() + Sum(sumWeights));
+   }
+}
+
+template<
+   typename TFloat,
+   bool bHessian,
+   int gradHessFormat,
+   bool bWeight,
+   bool bReplication,
+   int cCompilerPack,
+   typename std::enable_if<1 == TFloat::k_cSIMDPack, int>::type = 0
+>
+GPU_DEVICE INLINE_ALWAYS static bool BinSumsBoostingLanes(BinSumsBoostingBridge * const pParams) {
+   // with only 1 lane there are no collisions within the SIMD pack to avoid
+   UNUSED(pParams);
+   return false;
+}
+
+template<
+   typename TFloat,
+   bool bHessian,
+   int gradHessFormat,
+   bool bWeight,
+   bool bReplication,
+   int cCompilerPack,
+   typename std::enable_if<1 != TFloat::k_cSIMDPack, int>::type = 0
+>
+GPU_DEVICE NEVER_INLINE static bool BinSumsBoostingLanes(BinSumsBoostingBridge * const pParams) {
+   static_assert(bWeight || !bReplication, "bReplication cannot be true if bWeight is false");
+   static_assert(sizeof(typename TFloat::T) == sizeof(typename TFloat::TInt::T), 
+      "the counts and the floats share the lane histogram memory");
+
+   // Samples in the same SIMD pack can land in the same bin, so the regular kernel serializes every bin update 
+   // through TFloat::Execute.  If the term has few enough bins we instead give each SIMD lane its own private 
+   // histogram.  The lanes then never collide, so each field is updated with one gather, add, and scatter for 
+   // the whole pack.  At the end we sum the lane histograms with SIMD adds and add the totals into the bins.
+   // Each lane histogram holds each field as an array of bins padded to a whole SIMD pack, which keeps the 
+   // counts separate from the floats and lets the final sums use aligned loads.
+   //
+   // Returns false without doing anything if the lane histograms do not fit into k_cBytesLaneBinsMax.  IsLaneBins 
+   // always reserves room for the weights so that callers can decide which terms we handle without knowing if 
+   // the bag has weights.  Without weights we simply leave the weight field out.
+
+   // count, weight, gradient, hessian
+   static constexpr size_t cFields = size_t { 2 } + (bWeight ? size_t { 1 } : size_t { 0 }) + (bHessian ? size_t { 1 } : size_t { 0 });
+   static constexpr size_t iSumGradient = bWeight ? size_t { 1 } : size_t { 0 }; // the index into the float fields
+   static constexpr size_t cItemsLaneBinsMax = k_cBytesLaneBinsMax / sizeof(typename TFloat::T);
+
+   const size_t cBins = pParams->m_cBins;
+#ifndef GPU_COMPILE
+   EBM_ASSERT(1 <= cBins);
+#endif // GPU_COMPILE
+   if(!IsLaneBins(size_t { TFloat::k_cSIMDPack }, sizeof(typename TFloat::T), bHessian, k_oneScore, cBins)) {
+      return false;
+   }
+   const size_t cBinsPadded = (cBins + size_t { TFloat::k_cSIMDPack - 1 }) & ~size_t { TFloat::k_cSIMDPack - 1 };
+   const size_t cItemsPerLane = cFields * cBinsPadded;
+   const size_t cItemsLaneBins = cItemsPerLane * size_t { TFloat::k_cSIMDPack };
+#ifndef GPU_COMPILE
+   EBM_ASSERT(cItemsLaneBins <= cItemsLaneBinsMax);
+#endif // GPU_COMPILE
+
+   alignas(alignof(TFloat)) typename TFloat::T aLaneBins[cItemsLaneBinsMax];
+   typename TFloat::TInt::T * const aLaneCounts = reinterpret_cast<typename TFloat::TInt::T *>(aLaneBins);
+
+   // the zero float is all zero bits, which is also the zero count
+   const TFloat zero = 0.0;
+   for(size_t iItem = 0; iItem < cItemsLaneBins; iItem += size_t { TFloat::k_cSIMDPack }) {
+      zero.Store(&aLaneBins[iItem]);
+   }
+
+   const size_t cSamples = pParams->m_cSamples;
+
+   const GradHessStorage<TFloat, gradHessFormat> * pGradientAndHessian = reinterpret_cast<const GradHessStorage<TFloat, gradHessFormat> *>(pParams->m_aGradientsAndHessians);
+   const GradHessStorage<TFloat, gradHessFormat> * const pGradientsAndHessiansEnd = pGradientAndHessian + (bHessian ? size_t { 2 } : size_t { 1 }) * cSamples;
+
+   const int cItemsPerBitPack = GET_ITEMS_PER_BIT_PACK(cCompilerPack, pParams->m_cPack);
+#ifndef GPU_COMPILE
+   EBM_ASSERT(k_cItemsPerBitPackNone != cItemsPerBitPack); // we require this condition to be templated
+   EBM_ASSERT(1 <= cItemsPerBitPack);
+   EBM_ASSERT(cItemsPerBitPack <= COUNT_BITS(typename TFloat::TInt::T));
+#endif // GPU_COMPILE
+
+   const int cBitsPerItemMax = GetCountBits<typename TFloat::TInt::T>(cItemsPerBitPack);
+#ifndef GPU_COMPILE
+   EBM_ASSERT(1 <= cBitsPerItemMax);
+   EBM_ASSERT(cBitsPerItemMax <= COUNT_BITS(typename TFloat::TInt::T));
+#endif // GPU_COMPILE
+
+   int cShift = static_cast<int>(((cSamples >> TFloat::k_cSIMDShift) - size_t { 1 }) % static_cast<size_t>(cItemsPerBitPack)) * cBitsPerItemMax;
+   const int cShiftReset = (cItemsPerBitPack - 1) * cBitsPerItemMax;
+
+   const typename TFloat::TInt maskBits = MakeLowMask<typename TFloat::TInt::T>(cBitsPerItemMax);
+
+   const typename TFloat::TInt::T * pInputData = reinterpret_cast<const typename TFloat::TInt::T *>(pParams->m_aPacked);
+#ifndef GPU_COMPILE
+   EBM_ASSERT(nullptr != pInputData);
+#endif // GPU_COMPILE
+
+   const typename TFloat::T * pWeight;
+   const uint8_t * pCountOccurrences;
+   if(bWeight) {
+      pWeight = reinterpret_cast<const typename TFloat::T *>(pParams->m_aWeights);
+#ifndef GPU_COMPILE
+      EBM_ASSERT(nullptr != pWeight);
+#endif // GPU_COMPILE
+      if(bReplication) {
+         pCountOccurrences = pParams->m_pCountOccurrences;
+#ifndef GPU_COMPILE
+         EBM_ASSERT(nullptr != pCountOccurrences);
+#endif // GPU_COMPILE
+      }
+   }
+
+   const typename TFloat::TInt laneOffsets = 
+      TFloat::TInt::MakeIndexes() * static_cast<typename TFloat::TInt::T>(cItemsPerLane);
+   const typename TFloat::TInt fieldOffset = static_cast<typename TFloat::TInt::T>(cBinsPadded);
+
+   do {
+      const typename TFloat::TInt iTensorBinCombined = TFloat::TInt::Load(pInputData);
+      pInputData += TFloat::TInt::k_cSIMDPack;
+      do {
+         TFloat weight;
+         typename TFloat::TInt cOccurences;
+         if(bWeight) {
+            weight = TFloat::Load(pWeight);
+            pWeight += TFloat::k_cSIMDPack;
+            if(bReplication) {
+               cOccurences = TFloat::TInt::LoadBytes(pCountOccurrences);
+               pCountOccurrences += TFloat::k_cSIMDPack;
+            }
+         }
+         if(!bReplication) {
+            cOccurences = typename TFloat::TInt::T { 1 };
+         }
+
+         TFloat gradient = TFloat::Load(pGradientAndHessian);
+         TFloat hessian;
+         if(bHessian) {
+            hessian = TFloat::Load(&pGradientAndHessian[TFloat::k_cSIMDPack]);
+         }
+         pGradientAndHessian += (bHessian ? size_t { 2 } : size_t { 1 }) * TFloat::k_cSIMDPack;
+
+         if(bWeight) {
+            gradient *= weight;
+            if(bHessian) {
+               hessian *= weight;
+            }
+         }
+
+         const typename TFloat::TInt iTensorBin = (iTensorBinCombined >> cShift) & maskBits;
+
+         const typename TFloat::TInt iCount = laneOffsets + iTensorBin;
+         const typename TFloat::TInt cBinSamples = TFloat::TInt::Load(aLaneCounts, iCount) + cOccurences;
+         cBinSamples.Store(aLaneCounts, iCount);
+
+         typename TFloat::TInt iGradient = iCount + fieldOffset;
+         if(bWeight) {
+            const TFloat binWeight = TFloat::Load(aLaneBins, iGradient) + weight;
+            binWeight.Store(aLaneBins, iGradient);
+            iGradient = iGradient + fieldOffset;
+         }
+
+         const TFloat binGrad = TFloat::Load(aLaneBins, iGradient) + gradient;
+         binGrad.Store(aLaneBins, iGradient);
+
+         if(bHessian) {
+            const typename TFloat::TInt iHessian = iGradient + fieldOffset;
+            const TFloat binHess = TFloat::Load(aLaneBins, iHessian) + hessian;
+            binHess.Store(aLaneBins, iHessian);
+         }
+
+         cShift -= cBitsPerItemMax;
+      } while(0 <= cShift);
+      cShift = cShiftReset;
+   } while(pGradientsAndHessiansEnd != pGradientAndHessian);
+
+   auto * const aBins = reinterpret_cast<BinBase *>(pParams->m_aFastBins)->Specialize<typename TFloat::T, typename TFloat::TInt::T, bHessian, size_t { 1 }, bWeight>();
+
+   size_t iBinStart = 0;
+   do {
+      alignas(alignof(TFloat)) typename TFloat::TInt::T aCounts[TFloat::k_cSIMDPack];
+      alignas(alignof(TFloat)) typename TFloat::T aSums[cFields - size_t { 1 }][TFloat::k_cSIMDPack];
+
+      typename TFloat::TInt counts = TFloat::TInt::Load(&aLaneCounts[iBinStart]);
+      TFloat sums[cFields - size_t { 1 }];
+      for(size_t iField = 1; iField < cFields; ++iField) {
+         sums[iField - size_t { 1 }] = TFloat::Load(&aLaneBins[iField * cBinsPadded + iBinStart]);
+      }
+      for(size_t iLane = 1; iLane < size_t { TFloat::k_cSIMDPack }; ++iLane) {
+         const size_t iLaneStart = iLane * cItemsPerLane + iBinStart;
+         counts = counts + TFloat::TInt::Load(&aLaneCounts[iLaneStart]);
+         for(size_t iField = 1; iField < cFields; ++iField) {
+            sums[iField - size_t { 1 }] += TFloat::Load(&aLaneBins[iField * cBinsPadded + iLaneStart]);
+         }
+      }
+      counts.Store(aCounts);
+      for(size_t iField = 1; iField < cFields; ++iField) {
+         sums[iField - size_t { 1 }].Store(aSums[iField - size_t { 1 }]);
+      }
+
+      const size_t cBinsPack = EbmMin(cBins - iBinStart, size_t { TFloat::k_cSIMDPack });
+      for(size_t iBinPack = 0; iBinPack < cBinsPack; ++iBinPack) {
+         auto * const pBin = &aBins[iBinStart + iBinPack];
+         auto * const pGradientPair = pBin->GetGradientPairs();
+         pBin->SetCountSamples(pBin->GetCountSamples() + aCounts[iBinPack]);
+         if(bWeight) {
+            pBin->SetWeight(pBin->GetWeight() + aSums[0][iBinPack]);
+         }
+         pGradientPair->m_sumGradients += aSums[iSumGradient][iBinPack];
+         if(bHessian) {
+            pGradientPair->SetHess(pGradientPair->GetHess() + aSums[cFields - size_t { 2 }][iBinPack]);
+         }
+      }
+      iBinStart += size_t { TFloat::k_cSIMDPack };
+   } while(iBinStart < cBins);
+
+   return true;
+}
+
+template<
+   typename TFloat,
+   bool bHessian,
+   int gradHessFormat,
+   bool bWeight,
+   bool bReplication,
+   int cCompilerPack,
+   typename std::enable_if<!TFloat::k_bConflictDetect, int>::type = 0
+>
+GPU_DEVICE INLINE_ALWAYS static bool BinSumsBoostingConflictFree(BinSumsBoostingBridge * const pParams) {
+   // this zone has no way to find the lanes that collide, so the caller serializes them through TFloat::Execute
+   UNUSED(pParams);
+   return false;
+}
+
+template<
+   typename TFloat,
+   bool bHessian,
+   int gradHessFormat,
+   bool bWeight,
+   bool bReplication,
+   int cCompilerPack,
+   typename std::enable_if<TFloat::k_bConflictDetect, int>::type = 0
+>
+GPU_DEVICE NEVER_INLINE static bool BinSumsBoostingConflictFree(BinSumsBoostingBridge * const pParams) {
+   static_assert(bWeight || !bReplication, "bReplication cannot be true if bWeight is false");
+   static_assert(sizeof(typename TFloat::T) == sizeof(typename TFloat::TInt::T), 
+      "we index the counts and the floats of the bins in the same units");
+
+   // For terms with too many bins for BinSumsBoostingLanes we update the shared bins with one gather, add, and 
+   // scatter per field for the whole SIMD pack.  TFloat::TInt::ExecuteConflictFree splits the pack into groups 
+   // of lanes that point to distinct bins, and only hands us a lane after all the earlier lanes that point to the 
+   // same bin, so each bin receives its additions in the same order as the TFloat::Execute path and the sums 
+   // are bit for bit identical.  Most packs have no collisions and need only one group.
+   //
+   // Returns false without doing anything if the CPU lacks conflict detection or if the bin indexes do not fit 
+   // into the signed 32 bit gather indexes.
+
+   if(EBM_FALSE == pParams->m_bConflictDetect) {
+      return false;
+   }
+
+   using TInt = typename TFloat::TInt;
+   using TMask = typename TInt::TMask;
+
+   static constexpr size_t cItemsPerBin = 
+      GetBinSize<typename TFloat::T, typename TInt::T>(bHessian, size_t { 1 }, bWeight) / sizeof(typename TFloat::T);
+
+   const size_t cBins = pParams->m_cBins;
+#ifndef GPU_COMPILE
+   EBM_ASSERT(1 <= cBins);
+#endif // GPU_COMPILE
+   if((size_t { 1 } << 31) / cItemsPerBin < cBins) {
+      return false;
+   }
+
+   using TBin = Bin<typename TFloat::T, typename TInt::T, bHessian, size_t { 1 }, bWeight>;
+
+   typename TInt::T * const aCounts = 
+      IndexByte(reinterpret_cast<typename TInt::T *>(pParams->m_aFastBins), static_cast<size_t>(TBin::GetOffsetCountSamples()));
+   typename TFloat::T * aWeights;
+   if(bWeight) {
+      aWeights = IndexByte(reinterpret_cast<typename TFloat::T *>(pParams->m_aFastBins), static_cast<size_t>(TBin::GetOffsetWeight()));
+   }
+   typename TFloat::T * const aGradients = 
+      IndexByte(reinterpret_cast<typename TFloat::T *>(pParams->m_aFastBins), static_cast<size_t>(TBin::GetOffsetGradientPairs()));
+   typename TFloat::T * aHessians;
+   if(bHessian) {
+      aHessians = aGradients + size_t { 1 };
+   }
+
+   const size_t cSamples = pParams->m_cSamples;
+
+   const GradHessStorage<TFloat, gradHessFormat> * pGradientAndHessian = reinterpret_cast<const GradHessStorage<TFloat, gradHessFormat> *>(pParams->m_aGradientsAndHessians);
+   const GradHessStorage<TFloat, gradHessFormat> * const pGradientsAndHessiansEnd = pGradientAndHessian + (bHessian ? size_t { 2 } : size_t { 1 }) * cSamples;
+
+   const int cItemsPerBitPack = GET_ITEMS_PER_BIT_PACK(cCompilerPack, pParams->m_cPack);
+#ifndef GPU_COMPILE
+   EBM_ASSERT(k_cItemsPerBitPackNone != cItemsPerBitPack); // we require this condition to be templated
+   EBM_ASSERT(1 <= cItemsPerBitPack);
+   EBM_ASSERT(cItemsPerBitPack <= COUNT_BITS(typename TInt::T));
+#endif // GPU_COMPILE
+
+   const int cBitsPerItemMax = GetCountBits<typename TInt::T>(cItemsPerBitPack);
+#ifndef GPU_COMPILE
+   EBM_ASSERT(1 <= cBitsPerItemMax);
+   EBM_ASSERT(cBitsPerItemMax <= COUNT_BITS(typename TInt::T));
+#endif // GPU_COMPILE
+
+   int cShift = static_cast<int>(((cSamples >> TFloat::k_cSIMDShift) - size_t { 1 }) % static_cast<size_t>(cItemsPerBitPack)) * cBitsPerItemMax;
+   const int cShiftReset = (cItemsPerBitPack - 1) * cBitsPerItemMax;
+
+   const TInt maskBits = MakeLowMask<typename TInt::T>(cBitsPerItemMax);
+
+   const typename TInt::T * pInputData = reinterpret_cast<const typename TInt::T *>(pParams->m_aPacked);
+#ifndef GPU_COMPILE
+   EBM_ASSERT(nullptr != pInputData);
+#endif // GPU_COMPILE
+
+   const typename TFloat::T * pWeight;
+   const uint8_t * pCountOccurrences;
+   if(bWeight) {
+      pWeight = reinterpret_cast<const typename TFloat::T *>(pParams->m_aWeights);
+#ifndef GPU_COMPILE
+      EBM_ASSERT(nullptr != pWeight);
+#endif // GPU_COMPILE
+      if(bReplication) {
+         pCountOccurrences = pParams->m_pCountOccurrences;
+#ifndef GPU_COMPILE
+         EBM_ASSERT(nullptr != pCountOccurrences);
+#endif // GPU_COMPILE
+      }
+   }
+
+   do {
+      const TInt iTensorBinCombined = TInt::Load(pInputData);
+      pInputData += TInt::k_cSIMDPack;
+      do {
+         TFloat weight;
+         TInt cOccurences;
+         if(bWeight) {
+            weight = TFloat::Load(pWeight);
+            pWeight += TFloat::k_cSIMDPack;
+            if(bReplication) {
+               cOccurences = TInt::LoadBytes(pCountOccurrences);
+               pCountOccurrences += TFloat::k_cSIMDPack;
+            }
+         }
+         if(!bReplication) {
+            cOccurences = typename TInt::T { 1 };
+         }
+
+         TFloat gradient = TFloat::Load(pGradientAndHessian);
+         TFloat hessian;
+         if(bHessian) {
+            hessian = TFloat::Load(&pGradientAndHessian[TFloat::k_cSIMDPack]);
+         }
+         pGradientAndHessian += (bHessian ? size_t { 2 } : size_t { 1 }) * TFloat::k_cSIMDPack;
+
+         if(bWeight) {
+            gradient *= weight;
+            if(bHessian) {
+               hessian *= weight;
+            }
+         }
+
+         const TInt iTensorBin = (iTensorBinCombined >> cShift) & maskBits;
+         const TInt iItem = iTensorBin * static_cast<typename TInt::T>(cItemsPerBin);
+
+         TInt::ExecuteConflictFree([aCounts, aWeights, aGradients, aHessians, &iItem, &cOccurences, &weight, &gradient, &hessian](const TMask lanes) {
+            const TInt cBinSamples = TInt::Load(aCounts, iItem, lanes) + cOccurences;
+            cBinSamples.Store(aCounts, iItem, lanes);
+            if(bWeight) {
+               const TFloat binWeight = TFloat::Load(aWeights, iItem, lanes) + weight;
+               binWeight.Store(aWeights, iItem, lanes);
+            }
+            const TFloat binGrad = TFloat::Load(aGradients, iItem, lanes) + gradient;
+            binGrad.Store(aGradients, iItem, lanes);
+            if(bHessian) {
+               const TFloat binHess = TFloat::Load(aHessians, iItem, lanes) + hessian;
+               binHess.Store(aHessians, iItem, lanes);
+            }
+         }, iTensorBin);
+
+         cShift -= cBitsPerItemMax;
+      } while(0 <= cShift);
+      cShift = cShiftReset;
    } while(pGradientsAndHessiansEnd != pGradientAndHessian);
+
+   return true;
+}
+
+template<
+   typename TFloat,
+   bool bHessian,
+   int gradHessFormat,
+   bool bWeight,
+   bool bReplication,
+   size_t cCompilerScores,
+   int cCompilerPack
+>
+GPU_DEVICE NEVER_INLINE static void BinSumsBoostingSorted(BinSumsBoostingBridge * const pParams) {
+   static_assert(bWeight || !bReplication, "bReplication cannot be true if bWeight is false");
+
+   // When the bins are much larger than the cache nearly every sample misses when we add it to its bin.  Instead
+   // we first decode the bin of each sample and counting sort the samples by which range of 
+   // (1 << m_cBinRangeShift) bins they fall into, and then we sum the samples one range at a time so that the bins
+   // of the range stay in the cache.  The counting sort is stable, so the samples of each bin are added in the same
+   // order as the other kernels add them and the sums are identical.
+
+   static constexpr size_t cArrayScores = GetArrayScores(cCompilerScores);
+
+#ifndef GPU_COMPILE
+   EBM_ASSERT(nullptr != pParams);
+   EBM_ASSERT(1 <= pParams->m_cSamples);
+   EBM_ASSERT(0 == pParams->m_cSamples % size_t { TFloat::k_cSIMDPack });
+   EBM_ASSERT(nullptr != pParams->m_aGradientsAndHessians);
+   EBM_ASSERT(nullptr != pParams->m_aFastBins);
+   EBM_ASSERT(nullptr != pParams->m_aSortScratch);
+   EBM_ASSERT(1 <= pParams->m_cBins);
+   EBM_ASSERT(0 <= pParams->m_cBinRangeShift);
+   EBM_ASSERT(k_dynamicScores == cCompilerScores || cCompilerScores == pParams->m_cScores);
+#endif // GPU_COMPILE
+
+   const size_t cScores = GET_COUNT_SCORES(cCompilerScores, pParams->m_cScores);
+
+   auto * const aBins = reinterpret_cast<BinBase *>(pParams->m_aFastBins)->Specialize<typename TFloat::T, typename TFloat::TInt::T, bHessian, cArrayScores, bWeight>();
+
+   const size_t cSamples = pParams->m_cSamples;
+
+   const size_t cBytesPerBin = GetBinSize<typename TFloat::T, typename TFloat::TInt::T>(bHessian, cScores, bWeight);
+
+   const int cBinRangeShift = pParams->m_cBinRangeShift;
+   const size_t cRanges = ((pParams->m_cBins - size_t { 1 }) >> cBinRangeShift) + size_t { 1 };
+#ifndef GPU_COMPILE
+   EBM_ASSERT(cRanges <= k_cBinSumsSortRangesMax);
+#endif // GPU_COMPILE
+
+   typename TFloat::TInt::T * const aiBins = reinterpret_cast<typename TFloat::TInt::T *>(pParams->m_aSortScratch);
+   typename TFloat::TInt::T * const aiSorted = aiBins + cSamples;
+
+   // after the scatter below each entry holds the end of its range within aiSorted
+   size_t aiRangeEnd[k_cBinSumsSortRangesMax];
+   for(size_t iRange = 0; iRange < cRanges; ++iRange) {
+      aiRangeEnd[iRange] = 0;
+   }
+
+   const int cItemsPerBitPack = GET_ITEMS_PER_BIT_PACK(cCompilerPack, pParams->m_cPack);
+#ifndef GPU_COMPILE
+   EBM_ASSERT(k_cItemsPerBitPackNone != cItemsPerBitPack); // we require this condition to be templated
+   EBM_ASSERT(1 <= cItemsPerBitPack);
+   EBM_ASSERT(cItemsPerBitPack <= COUNT_BITS(typename TFloat::TInt::T));
+#endif // GPU_COMPILE
+
+   const int cBitsPerItemMax = GetCountBits<typename TFloat::TInt::T>(cItemsPerBitPack);
+#ifndef GPU_COMPILE
+   EBM_ASSERT(1 <= cBitsPerItemMax);
+   EBM_ASSERT(cBitsPerItemMax <= COUNT_BITS(typename TFloat::TInt::T));
+#endif // GPU_COMPILE
+
+   int cShift = static_cast<int>(((cSamples >> TFloat::k_cSIMDShift) - size_t { 1 }) % static_cast<size_t>(cItemsPerBitPack)) * cBitsPerItemMax;
+   const int cShiftReset = (cItemsPerBitPack - 1) * cBitsPerItemMax;
+
+   const typename TFloat::TInt::T maskBits = MakeLowMask<typename TFloat::TInt::T>(cBitsPerItemMax);
+
+   const typename TFloat::TInt::T * pInputData = reinterpret_cast<const typename TFloat::TInt::T *>(pParams->m_aPacked);
+#ifndef GPU_COMPILE
+   EBM_ASSERT(nullptr != pInputData);
+#endif // GPU_COMPILE
+
+   // the sample held in SIMD lane iLane of the iPack-th SIMD pack is sample (iPack * k_cSIMDPack + iLane)
+   size_t iSample = 0;
+   do {
+      do {
+         for(size_t iLane = 0; iLane < size_t { TFloat::k_cSIMDPack }; ++iLane) {
+            const typename TFloat::TInt::T iTensorBin = (pInputData[iLane] >> cShift) & maskBits;
+            aiBins[iSample] = iTensorBin;
+            ++aiRangeEnd[static_cast<size_t>(iTensorBin) >> cBinRangeShift];
+            ++iSample;
+         }
+         cShift -= cBitsPerItemMax;
+      } while(0 <= cShift);
+      cShift = cShiftReset;
+      pInputData += TFloat::TInt::k_cSIMDPack;
+   } while(cSamples != iSample);
+
+   size_t iRangeStart = 0;
+   for(size_t iRange = 0; iRange < cRanges; ++iRange) {
+      const size_t cRangeSamples = aiRangeEnd[iRange];
+      aiRangeEnd[iRange] = iRangeStart;
+      iRangeStart += cRangeSamples;
+   }
+
+   for(iSample = 0; iSample < cSamples; ++iSample) {
+      const size_t iRange = static_cast<size_t>(aiBins[iSample]) >> cBinRangeShift;
+      aiSorted[aiRangeEnd[iRange]] = static_cast<typename TFloat::TInt::T>(iSample);
+      ++aiRangeEnd[iRange];
+   }
+
+   const GradHessStorage<TFloat, gradHessFormat> * const aGradientAndHessian = reinterpret_cast<const GradHessStorage<TFloat, gradHessFormat> *>(pParams->m_aGradientsAndHessians);
+   const size_t cFloatsPerScore = (bHessian ? size_t { 2 } : size_t { 1 }) * size_t { TFloat::k_cSIMDPack };
+
+   const typename TFloat::T * aWeight;
+   const uint8_t * aCountOccurrences;
+   if(bWeight) {
+      aWeight = reinterpret_cast<const typename TFloat::T *>(pParams->m_aWeights);
+#ifndef GPU_COMPILE
+      EBM_ASSERT(nullptr != aWeight);
+#endif // GPU_COMPILE
+      if(bReplication) {
+         aCountOccurrences = pParams->m_pCountOccurrences;
+#ifndef GPU_COMPILE
+         EBM_ASSERT(nullptr != aCountOccurrences);
+#endif // GPU_COMPILE
+      }
+   }
+
+   size_t iSorted = 0;
+   for(size_t iRange = 0; iRange < cRanges; ++iRange) {
+      const size_t iSortedEnd = aiRangeEnd[iRange];
+      for(; iSortedEnd != iSorted; ++iSorted) {
+         const size_t iSampleSorted = static_cast<size_t>(aiSorted[iSorted]);
+         auto * const pBin = IndexBin(aBins, static_cast<size_t>(aiBins[iSampleSorted]) * cBytesPerBin);
+
+         pBin->SetCountSamples(pBin->GetCountSamples() + (bReplication ? 
+            static_cast<typename TFloat::TInt::T>(aCountOccurrences[iSampleSorted]) : typename TFloat::TInt::T { 1 }));
+
+         typename TFloat::T weight;
+         if(bWeight) {
+            weight = aWeight[iSampleSorted];
+            pBin->SetWeight(pBin->GetWeight() + weight);
+         }
+
+         const GradHessStorage<TFloat, gradHessFormat> * const pGradientAndHessian = &aGradientAndHessian[
+            (iSampleSorted >> TFloat::k_cSIMDShift) * cScores * cFloatsPerScore + 
+            (iSampleSorted & (size_t { TFloat::k_cSIMDPack } - size_t { 1 }))];
+
+         // the other kernels multiply by the weight before adding, so keep these as separate statements to 
+         // prevent the compiler from contracting them into a fused multiply-add that would round differently
+         auto * const aGradientPair = pBin->GetGradientPairs();
+         size_t iScore = 0;
+         do {
+            auto * const pGradientPair = &aGradientPair[iScore];
+            typename TFloat::T gradient = WidenGradHess<typename TFloat::T>(pGradientAndHessian[iScore * cFloatsPerScore]);
+            if(bWeight) {
+               gradient *= weight;
+            }
+            pGradientPair->m_sumGradients += gradient;
+            if(bHessian) {
+               typename TFloat::T hessian = WidenGradHess<typename TFloat::T>(pGradientAndHessian[iScore * cFloatsPerScore + size_t { TFloat::k_cSIMDPack }]);
+               if(bWeight) {
+                  hessian *= weight;
+               }
+               pGradientPair->SetHess(pGradientPair->GetHess() + hessian);
+            }
+            ++iScore;
+         } while(cScores != iScore);
+      }
+   }
 }
 
 template<
    typename TFloat, 
    bool bHessian, 
+   int gradHessFormat,
    bool bWeight,
    bool bReplication,
    size_t cCompilerScores,
@@ -175,14 +838,29 @@ GPU_DEVICE NEVER_INLINE static void BinSumsBoostingInternal(BinSumsBoostingBridg
    EBM_ASSERT(size_t { 1 } == pParams->m_cScores);
 #endif // GPU_COMPILE
 
-   auto * const aBins = reinterpret_cast<BinBase *>(pParams->m_aFastBins)->Specialize<typename TFloat::T, typename TFloat::TInt::T, bHessian, size_t { 1 }>();
+#ifndef GPU_COMPILE
+   if(nullptr != pParams->m_aSortScratch) {
+      BinSumsBoostingSorted<TFloat, bHessian, gradHessFormat, bWeight, bReplication, cCompilerScores, cCompilerPack>(pParams);
+      return;
+   }
+#endif // GPU_COMPILE
+
+   if(BinSumsBoostingLanes<TFloat, bHessian, gradHessFormat, bWeight, bReplication, cCompilerPack>(pParams)) {
+      return;
+   }
+
+   if(BinSumsBoostingConflictFree<TFloat, bHessian, gradHessFormat, bWeight, bReplication, cCompilerPack>(pParams)) {
+      return;
+   }
+
+   auto * const aBins = reinterpret_cast<BinBase *>(pParams->m_aFastBins)->Specialize<typename TFloat::T, typename TFloat::TInt::T, bHessian, size_t { 1 }, bWeight>();
 
    const size_t cSamples = pParams->m_cSamples;
 
-   const typename TFloat::T * pGradientAndHessian = reinterpret_cast<const typename TFloat::T *>(pParams->m_aGradientsAndHessians);
-   const typename TFloat::T * const pGradientsAndHessiansEnd = pGradientAndHessian + (bHessian ? size_t { 2 } : size_t { 1 }) * cSamples;
+   const GradHessStorage<TFloat, gradHessFormat> * pGradientAndHessian = reinterpret_cast<const GradHessStorage<TFloat, gradHessFormat> *>(pParams->m_aGradientsAndHessians);
+   const GradHessStorage<TFloat, gradHessFormat> * const pGradientsAndHessiansEnd = pGradientAndHessian + (bHessian ? size_t { 2 } : size_t { 1 }) * cSamples;
 
-   const typename TFloat::TInt::T cBytesPerBin = static_cast<typename TFloat::TInt::T>(GetBinSize<typename TFloat::T, typename TFloat::TInt::T>(bHessian, size_t { 1 }));
+   const typename TFloat::TInt::T cBytesPerBin = static_cast<typename TFloat::TInt::T>(GetBinSize<typename TFloat::T, typename TFloat::TInt::T>(bHessian, size_t { 1 }, bWeight));
 
    const int cItemsPerBitPack = GET_ITEMS_PER_BIT_PACK(cCompilerPack, pParams->m_cPack);
 #ifndef GPU_COMPILE
@@ -258,20 +936,13 @@ GPU_DEVICE NEVER_INLINE static void BinSumsBoostingInternal(BinSumsBoostingBridg
          // there are low numbers of shifts, which should be the case for anything with a compile time constant here
          iTensorBin = Multiply<typename TFloat::TInt, typename TFloat::TInt::T, 
             1 != TFloat::k_cSIMDPack, 
-            static_cast<typename TFloat::TInt::T>(GetBinSize<typename TFloat::T, typename TFloat::TInt::T>(bHessian, size_t { 1 }))>(
+            static_cast<typename TFloat::TInt::T>(GetBinSize<typename TFloat::T, typename TFloat::TInt::T>(bHessian, size_t { 1 }, bWeight))>(
                iTensorBin, cBytesPerBin);
 
-         // TODO: the ultimate version of this algorithm would:
-         //   1) Write to k_cSIMDPack histograms simutaneously to avoid collisions of indexes
-         //   2) Sum up the final histograms using SIMD operations in parallel.  If we hvae k_cSIMDPack
-         //      histograms, then we're prefectly suited to sum them, and integers and float32 values shouldn't
-         //      have issues since we stay well away from 2^32 integers, and the float values don't have addition
-         //      issues anymore (where you can't add a 1 to more than 16 million floats)
-         //   3) Only do the above if there aren't too many bins. If we put each sample into it's own bin
-         //      for a feature, then we should prefer using this version that keeps only 1 histogram
-
-         // BEWARE: unless we generate a separate histogram for each SIMD stream and later merge them, pBin can 
-         // point to the same bin in multiple samples within the SIMD pack, so we need to serialize fetching sums
+         // BinSumsBoostingLanes handles terms with few enough bins by keeping a separate histogram for each 
+         // SIMD lane, and BinSumsBoostingConflictFree handles the rest when the zone can detect colliding lanes.
+         // We get here otherwise, where pBin can point to the same bin in multiple samples within the SIMD pack, 
+         // so we need to serialize fetching sums
          if(bWeight) {
             if(bReplication) {
                if(bHessian) {
@@ -380,15 +1051,12 @@ GPU_DEVICE NEVER_INLINE static void BinSumsBoostingInternal(BinSumsBoostingBridg
                   auto * const pBin = IndexBin(aBins, static_cast<size_t>(i));
                   auto * const pGradientPair = pBin->GetGradientPairs();
                   typename TFloat::TInt::T cBinSamples = pBin->GetCountSamples(); // TODO: eliminate this by eliminating the field in the future
-                  typename TFloat::T binWeight = pBin->GetWeight(); // TODO: eliminate this by eliminating the field in the future
                   typename TFloat::T binGrad = pGradientPair->m_sumGradients;
                   typename TFloat::T binHess = pGradientPair->GetHess();
                   cBinSamples += typename TFloat::TInt::T { 1 }; // TODO: eliminate this by eliminating the field in the future
-                  binWeight += typename TFloat::T { 1.0 }; // TODO: eliminate this by eliminating the field in the future
                   binGrad += grad;
                   binHess += hess;
                   pBin->SetCountSamples(cBinSamples); // TODO: eliminate this by eliminating the field in the future
-                  pBin->SetWeight(binWeight); // TODO: eliminate this by eliminating the field in the future
                   pGradientPair->m_sumGradients = binGrad;
                   pGradientPair->SetHess(binHess);
                }, iTensorBin, gradient, hessian);
@@ -402,13 +1070,10 @@ GPU_DEVICE NEVER_INLINE static void BinSumsBoostingInternal(BinSumsBoostingBridg
                   auto * const pBin = IndexBin(aBins, static_cast<size_t>(i));
                   auto * const pGradientPair = pBin->GetGradientPairs();
                   typename TFloat::TInt::T cBinSamples = pBin->GetCountSamples(); // TODO: eliminate this by eliminating the field in the future
-                  typename TFloat::T binWeight = pBin->GetWeight(); // TODO: eliminate this by eliminating the field in the future
                   typename TFloat::T binGrad = pGradientPair->m_sumGradients;
                   cBinSamples += typename TFloat::TInt::T { 1 }; // TODO: eliminate this by eliminating the field in the future
-                  binWeight += typename TFloat::T { 1.0 }; // TODO: eliminate this by eliminating the field in the future
                   binGrad += grad;
                   pBin->SetCountSamples(cBinSamples); // TODO: eliminate this by eliminating the field in the future
-                  pBin->SetWeight(binWeight); // TODO: eliminate this by eliminating the field in the future
                   pGradientPair->m_sumGradients = binGrad;
                }, iTensorBin, gradient);
             }
@@ -423,6 +1088,7 @@ GPU_DEVICE NEVER_INLINE static void BinSumsBoostingInternal(BinSumsBoostingBridg
 template<
    typename TFloat, 
    bool bHessian, 
+   int gradHessFormat,
    bool bWeight,
    bool bReplication,
    size_t cCompilerScores,
@@ -443,16 +1109,23 @@ GPU_DEVICE NEVER_INLINE static void BinSumsBoostingInternal(BinSumsBoostingBridg
    EBM_ASSERT(k_dynamicScores == cCompilerScores || cCompilerScores == pParams->m_cScores);
 #endif // GPU_COMPILE
 
+#ifndef GPU_COMPILE
+   if(nullptr != pParams->m_aSortScratch) {
+      BinSumsBoostingSorted<TFloat, bHessian, gradHessFormat, bWeight, bReplication, cCompilerScores, cCompilerPack>(pParams);
+      return;
+   }
+#endif // GPU_COMPILE
+
    const size_t cScores = GET_COUNT_SCORES(cCompilerScores, pParams->m_cScores);
 
-   auto * const aBins = reinterpret_cast<BinBase *>(pParams->m_aFastBins)->Specialize<typename TFloat::T, typename TFloat::TInt::T, bHessian, cArrayScores>();
+   auto * const aBins = reinterpret_cast<BinBase *>(pParams->m_aFastBins)->Specialize<typename TFloat::T, typename TFloat::TInt::T, bHessian, cArrayScores, bWeight>();
 
    const size_t cSamples = pParams->m_cSamples;
 
-   const typename TFloat::T * pGradientAndHessian = reinterpret_cast<const typename TFloat::T *>(pParams->m_aGradientsAndHessians);
-   const typename TFloat::T * const pGradientsAndHessiansEnd = pGradientAndHessian + (bHessian ? size_t { 2 } : size_t { 1 }) * cScores * cSamples;
+   const GradHessStorage<TFloat, gradHessFormat> * pGradientAndHessian = reinterpret_cast<const GradHessStorage<TFloat, gradHessFormat> *>(pParams->m_aGradientsAndHessians);
+   const GradHessStorage<TFloat, gradHessFormat> * const pGradientsAndHessiansEnd = pGradientAndHessian + (bHessian ? size_t { 2 } : size_t { 1 }) * cScores * cSamples;
 
-   const typename TFloat::TInt::T cBytesPerBin = static_cast<typename TFloat::TInt::T>(GetBinSize<typename TFloat::T, typename TFloat::TInt::T>(bHessian, cScores));
+   const typename TFloat::TInt::T cBytesPerBin = static_cast<typename TFloat::TInt::T>(GetBinSize<typename TFloat::T, typename TFloat::TInt::T>(bHessian, cScores, bWeight));
 
    const int cItemsPerBitPack = GET_ITEMS_PER_BIT_PACK(cCompilerPack, pParams->m_cPack);
 #ifndef GPU_COMPILE
@@ -496,7 +1169,7 @@ GPU_DEVICE NEVER_INLINE static void BinSumsBoostingInternal(BinSumsBoostingBridg
       const typename TFloat::TInt iTensorBinCombined = TFloat::TInt::Load(pInputData);
       pInputData += TFloat::TInt::k_cSIMDPack;
       do {
-         Bin<typename TFloat::T, typename TFloat::TInt::T, bHessian, cArrayScores> * apBins[TFloat::k_cSIMDPack];
+         Bin<typename TFloat::T, typename TFloat::TInt::T, bHessian, cArrayScores, bWeight> * apBins[TFloat::k_cSIMDPack];
          typename TFloat::TInt iTensorBin = (iTensorBinCombined >> cShift) & maskBits;
             
          // normally the compiler is better at optimimizing multiplications into shifs, but it isn't better
@@ -504,21 +1177,15 @@ GPU_DEVICE NEVER_INLINE static void BinSumsBoostingInternal(BinSumsBoostingBridg
          // there are low numbers of shifts, which should be the case for anything with a compile time constant here
          iTensorBin = Multiply<typename TFloat::TInt, typename TFloat::TInt::T, 
             k_dynamicScores != cCompilerScores && 1 != TFloat::k_cSIMDPack, 
-            static_cast<typename TFloat::TInt::T>(GetBinSize<typename TFloat::T, typename TFloat::TInt::T>(bHessian, cCompilerScores))>(
+            static_cast<typename TFloat::TInt::T>(GetBinSize<typename TFloat::T, typename TFloat::TInt::T>(bHessian, cCompilerScores, bWeight))>(
                iTensorBin, cBytesPerBin);
             
          TFloat::TInt::Execute([aBins, &apBins](const int i, const typename TFloat::TInt::T x) {
             apBins[i] = IndexBin(aBins, static_cast<size_t>(x));
          }, iTensorBin);
 
-         // TODO: the ultimate version of this algorithm would:
-         //   1) Write to k_cSIMDPack histograms simutaneously to avoid collisions of indexes
-         //   2) Sum up the final histograms using SIMD operations in parallel.  If we hvae k_cSIMDPack
-         //      histograms, then we're prefectly suited to sum them, and integers and float32 values shouldn't
-         //      have issues since we stay well away from 2^32 integers, and the float values don't have addition
-         //      issues anymore (where you can't add a 1 to more than 16 million floats)
-         //   3) Only do the above if there aren't too many bins. If we put each sample into it's own bin
-         //      for a feature, then we should prefer using this version that keeps only 1 histogram
+         // TODO: BinSumsBoostingLanes avoids serializing on collisions for 1 score by giving each SIMD lane its own
+         //       histogram.  We could do the same here, but multiclass bins are larger so fewer terms would fit
 
          if(bReplication) {
             const typename TFloat::TInt cOccurences = TFloat::TInt::LoadBytes(pCountOccurrences);
@@ -549,17 +1216,8 @@ GPU_DEVICE NEVER_INLINE static void BinSumsBoostingInternal(BinSumsBoostingBridg
 
             TFloat::Execute([apBins](const int i, const typename TFloat::T x) {
                auto * const pBin = apBins[i];
-               // TODO: In the future we'd like to eliminate this but we need the ability to change the Bin class
-               //       such that we can remove that field optionally
                pBin->SetWeight(pBin->GetWeight() + x);
             }, weight);
-         } else {
-            TFloat::Execute([apBins](const int i) {
-               auto * const pBin = apBins[i];
-               // TODO: In the future we'd like to eliminate this but we need the ability to change the Bin class
-               //       such that we can remove that field optionally
-               pBin->SetWeight(pBin->GetWeight() + typename TFloat::T { 1.0 });
-            });
          }
 
          size_t iScore = 0;
@@ -607,45 +1265,109 @@ GPU_DEVICE NEVER_INLINE static void BinSumsBoostingInternal(BinSumsBoostingBridg
    } while(pGradientsAndHessiansEnd != pGradientAndHessian);
 }
 
-template<typename TFloat, bool bHessian, bool bWeight, bool bReplication, size_t cCompilerScores, int cCompilerPack>
+template<typename TFloat, bool bHessian, int gradHessFormat, bool bWeight, bool bReplication, size_t cCompilerScores, int cCompilerPack>
 GPU_GLOBAL static void RemoteBinSumsBoosting(BinSumsBoostingBridge * const pParams) {
-   BinSumsBoostingInternal<TFloat, bHessian, bWeight, bReplication, cCompilerScores, cCompilerPack>(pParams);
+   BinSumsBoostingInternal<TFloat, bHessian, gradHessFormat, bWeight, bReplication, cCompilerScores, cCompilerPack>(pParams);
 }
 
-template<typename TFloat, bool bHessian, bool bWeight, bool bReplication, size_t cCompilerScores, int cCompilerPack>
+template<typename TFloat, bool bHessian, int gradHessFormat, bool bWeight, bool bReplication, size_t cCompilerScores, int cCompilerPack>
 INLINE_RELEASE_TEMPLATED ErrorEbm OperatorBinSumsBoosting(BinSumsBoostingBridge * const pParams) {
-   return TFloat::template OperatorBinSumsBoosting<bHessian, bWeight, bReplication, cCompilerScores, cCompilerPack>(pParams);
+   return TFloat::template OperatorBinSumsBoosting<bHessian, gradHessFormat, bWeight, bReplication, cCompilerScores, cCompilerPack>(pParams);
 }
 
-template<typename TFloat, bool bHessian, bool bWeight, bool bReplication, size_t cCompilerScores>
+template<typename TFloat, bool bHessian, int gradHessFormat, bool bWeight, bool bReplication, size_t cCompilerScores, int cCompilerPack>
+struct CompiledBitPackBoosting final {
+   INLINE_RELEASE_UNTEMPLATED static ErrorEbm Func(BinSumsBoostingBridge * const pParams) {
+      if(cCompilerPack == pParams->m_cPack) {
+         return OperatorBinSumsBoosting<TFloat, bHessian, gradHessFormat, bWeight, bReplication, cCompilerScores, cCompilerPack>(pParams);
+      } else {
+         return CompiledBitPackBoosting<TFloat, bHessian, gradHessFormat, bWeight, bReplication, cCompilerScores, GetNextBitPackBinSums<typename TFloat::TInt::T>(cCompilerPack)>::Func(pParams);
+      }
+   }
+};
+template<typename TFloat, bool bHessian, int gradHessFormat, bool bWeight, bool bReplication, size_t cCompilerScores>
+struct CompiledBitPackBoosting<TFloat, bHessian, gradHessFormat, bWeight, bReplication, cCompilerScores, k_cItemsPerBitPackDynamic> final {
+   INLINE_RELEASE_UNTEMPLATED static ErrorEbm Func(BinSumsBoostingBridge * const pParams) {
+      return OperatorBinSumsBoosting<TFloat, bHessian, gradHessFormat, bWeight, bReplication, cCompilerScores, k_cItemsPerBitPackDynamic>(pParams);
+   }
+};
+
+template<typename TFloat, bool bHessian, int gradHessFormat, bool bWeight, bool bReplication, size_t cCompilerScores>
 INLINE_RELEASE_TEMPLATED static ErrorEbm BitPackBoosting(BinSumsBoostingBridge * const pParams) {
    if(k_cItemsPerBitPackNone != pParams->m_cPack) {
-      return OperatorBinSumsBoosting<TFloat, bHessian, bWeight, bReplication, cCompilerScores, k_cItemsPerBitPackDynamic>(pParams);
+      // With a compile time bit pack the shifts and masks that unpack the bin indexes are constants and every
+      // packed word after the first one has a constant number of items.  Like ApplyUpdate, we only do this for 
+      // one score.  With multiple scores the compiler unrolls the loop over the scores instead, and compiling 
+      // the bit packs for each count of scores would multiply our kernels.  See GetNextBitPackBinSums for which 
+      // bit packs get their own kernel.
+      static constexpr int cCompilerPackFirst = k_oneScore == cCompilerScores ?
+         GetFirstBitPackBinSums<typename TFloat::TInt::T>() : k_cItemsPerBitPackDynamic;
+      return CompiledBitPackBoosting<TFloat, bHessian, gradHessFormat, bWeight, bReplication, cCompilerScores, cCompilerPackFirst>::Func(pParams);
    } else {
       // this needs to be special cased because otherwise we would inject comparisons into the dynamic version
-      return OperatorBinSumsBoosting<TFloat, bHessian, bWeight, bReplication, cCompilerScores, k_cItemsPerBitPackNone>(pParams);
+      return OperatorBinSumsBoosting<TFloat, bHessian, gradHessFormat, bWeight, bReplication, cCompilerScores, k_cItemsPerBitPackNone>(pParams);
    }
 }
 
 
-template<typename TFloat, bool bHessian, bool bWeight, bool bReplication, size_t cPossibleScores>
+template<typename TFloat, bool bHessian, int gradHessFormat, bool bWeight, bool bReplication, size_t cPossibleScores>
 struct CountClassesBoosting final {
    INLINE_RELEASE_UNTEMPLATED static ErrorEbm Func(BinSumsBoostingBridge * const pParams) {
       if(cPossibleScores == pParams->m_cScores) {
-         return BitPackBoosting<TFloat, bHessian, bWeight, bReplication, cPossibleScores>(pParams);
+         return BitPackBoosting<TFloat, bHessian, gradHessFormat, bWeight, bReplication, cPossibleScores>(pParams);
       } else {
-         return CountClassesBoosting<TFloat, bHessian, bWeight, bReplication, cPossibleScores + 1>::Func(pParams);
+         return CountClassesBoosting<TFloat, bHessian, gradHessFormat, bWeight, bReplication, cPossibleScores + 1>::Func(pParams);
       }
    }
 };
-template<typename TFloat, bool bHessian, bool bWeight, bool bReplication>
-struct CountClassesBoosting<TFloat, bHessian, bWeight, bReplication, k_cCompilerScoresMax + 1> final {
+template<typename TFloat, bool bHessian, int gradHessFormat, bool bWeight, bool bReplication>
+struct CountClassesBoosting<TFloat, bHessian, gradHessFormat, bWeight, bReplication, k_cCompilerScoresMax + 1> final {
    INLINE_RELEASE_UNTEMPLATED static ErrorEbm Func(BinSumsBoostingBridge * const pParams) {
-      return BitPackBoosting<TFloat, bHessian, bWeight, bReplication, k_dynamicScores>(pParams);
+      return BitPackBoosting<TFloat, bHessian, gradHessFormat, bWeight, bReplication, k_dynamicScores>(pParams);
    }
 };
 
 
+template<typename TFloat, int gradHessFormat>
+INLINE_RELEASE_TEMPLATED static ErrorEbm HessianBinSumsBoosting(BinSumsBoostingBridge * const pParams) {
+   static constexpr bool bHessian = true;
+   ErrorEbm error;
+   if(nullptr != pParams->m_aWeights) {
+      static constexpr bool bWeight = true;
+      if(nullptr != pParams->m_pCountOccurrences) {
+         static constexpr bool bReplication = true;
+         if(size_t { 1 } != pParams->m_cScores) {
+            // muticlass
+            error = CountClassesBoosting<TFloat, bHessian, gradHessFormat, bWeight, bReplication, k_cCompilerScoresStart>::Func(pParams);
+         } else {
+            error = BitPackBoosting<TFloat, bHessian, gradHessFormat, bWeight, bReplication, k_oneScore>(pParams);
+         }
+      } else {
+         static constexpr bool bReplication = false;
+         if(size_t { 1 } != pParams->m_cScores) {
+            // muticlass
+            error = CountClassesBoosting<TFloat, bHessian, gradHessFormat, bWeight, bReplication, k_cCompilerScoresStart>::Func(pParams);
+         } else {
+            error = BitPackBoosting<TFloat, bHessian, gradHessFormat, bWeight, bReplication, k_oneScore>(pParams);
+         }
+      }
+   } else {
+      static constexpr bool bWeight = false;
+
+      // we use the weights to hold both the weights and the inner bag counts if there are inner bags
+      EBM_ASSERT(nullptr == pParams->m_pCountOccurrences);
+      static constexpr bool bReplication = false;
+
+      if(size_t { 1 } != pParams->m_cScores) {
+         // muticlass
+         error = CountClassesBoosting<TFloat, bHessian, gradHessFormat, bWeight, bReplication, k_cCompilerScoresStart>::Func(pParams);
+      } else {
+         error = BitPackBoosting<TFloat, bHessian, gradHessFormat, bWeight, bReplication, k_oneScore>(pParams);
+      }
+   }
+   return error;
+}
+
 template<typename TFloat>
 INLINE_RELEASE_TEMPLATED static ErrorEbm BinSumsBoosting(BinSumsBoostingBridge * const pParams) {
    LOG_0(Trace_Verbose, "Entered BinSumsBoosting");
@@ -661,59 +1383,34 @@ INLINE_RELEASE_TEMPLATED static ErrorEbm BinSumsBoosting(BinSumsBoostingBridge *
 
    EBM_ASSERT(1 <= pParams->m_cScores);
    if(EBM_FALSE != pParams->m_bHessian) {
-      static constexpr bool bHessian = true;
-      if(nullptr != pParams->m_aWeights) {
-         static constexpr bool bWeight = true;
-         if(nullptr != pParams->m_pCountOccurrences) {
-            static constexpr bool bReplication = true;
-            if(size_t { 1 } != pParams->m_cScores) {
-               // muticlass
-               error = CountClassesBoosting<TFloat, bHessian, bWeight, bReplication, k_cCompilerScoresStart>::Func(pParams);
-            } else {
-               error = BitPackBoosting<TFloat, bHessian, bWeight, bReplication, k_oneScore>(pParams);
-            }
-         } else {
-            static constexpr bool bReplication = false;
-            if(size_t { 1 } != pParams->m_cScores) {
-               // muticlass
-               error = CountClassesBoosting<TFloat, bHessian, bWeight, bReplication, k_cCompilerScoresStart>::Func(pParams);
-            } else {
-               error = BitPackBoosting<TFloat, bHessian, bWeight, bReplication, k_oneScore>(pParams);
-            }
-         }
+      if(k_gradHessBfloat16 == pParams->m_gradHessFormat) {
+         error = HessianBinSumsBoosting<TFloat, k_gradHessBfloat16>(pParams);
       } else {
-         static constexpr bool bWeight = false;
-
-         // we use the weights to hold both the weights and the inner bag counts if there are inner bags
-         EBM_ASSERT(nullptr == pParams->m_pCountOccurrences);
-         static constexpr bool bReplication = false;
-
-         if(size_t { 1 } != pParams->m_cScores) {
-            // muticlass
-            error = CountClassesBoosting<TFloat, bHessian, bWeight, bReplication, k_cCompilerScoresStart>::Func(pParams);
-         } else {
-            error = BitPackBoosting<TFloat, bHessian, bWeight, bReplication, k_oneScore>(pParams);
-         }
+         EBM_ASSERT(k_gradHessFloat == pParams->m_gradHessFormat);
+         error = HessianBinSumsBoosting<TFloat, k_gradHessFloat>(pParams);
       }
    } else {
       static constexpr bool bHessian = false;
+      // only objectives with hessians store compact gradients
+      EBM_ASSERT(k_gradHessFloat == pParams->m_gradHessFormat);
+      static constexpr int gradHessFormat = k_gradHessFloat;
       if(nullptr != pParams->m_aWeights) {
          static constexpr bool bWeight = true;
          if(nullptr != pParams->m_pCountOccurrences) {
             static constexpr bool bReplication = true;
             if(size_t { 1 } != pParams->m_cScores) {
                // Odd: gradient multiclass. Allow it, but do not optimize for it
-               error = BitPackBoosting<TFloat, bHessian, bWeight, bReplication, k_dynamicScores>(pParams);
+               error = BitPackBoosting<TFloat, bHessian, gradHessFormat, bWeight, bReplication, k_dynamicScores>(pParams);
             } else {
-               error = BitPackBoosting<TFloat, bHessian, bWeight, bReplication, k_oneScore>(pParams);
+               error = BitPackBoosting<TFloat, bHessian, gradHessFormat, bWeight, bReplication, k_oneScore>(pParams);
             }
          } else {
             static constexpr bool bReplication = false;
             if(size_t { 1 } != pParams->m_cScores) {
                // Odd: gradient multiclass. Allow it, but do not optimize for it
-               error = BitPackBoosting<TFloat, bHessian, bWeight, bReplication, k_dynamicScores>(pParams);
+               error = BitPackBoosting<TFloat, bHessian, gradHessFormat, bWeight, bReplication, k_dynamicScores>(pParams);
             } else {
-               error = BitPackBoosting<TFloat, bHessian, bWeight, bReplication, k_oneScore>(pParams);
+               error = BitPackBoosting<TFloat, bHessian, gradHessFormat, bWeight, bReplication, k_oneScore>(pParams);
             }
          }
       } else {
@@ -725,9 +1422,9 @@ INLINE_RELEASE_TEMPLATED static ErrorEbm BinSumsBoosting(BinSumsBoostingBridge *
 
          if(size_t { 1 } != pParams->m_cScores) {
             // Odd: gradient multiclass. Allow it, but do not optimize for it
-            error = BitPackBoosting<TFloat, bHessian, bWeight, bReplication, k_dynamicScores>(pParams);
+            error = BitPackBoosting<TFloat, bHessian, gradHessFormat, bWeight, bReplication, k_dynamicScores>(pParams);
          } else {
-            error = BitPackBoosting<TFloat, bHessian, bWeight, bReplication, k_oneScore>(pParams);
+            error = BitPackBoosting<TFloat, bHessian, gradHessFormat, bWeight, bReplication, k_oneScore>(pParams);
          }
       }
    }
@@ -737,6 +1434,332 @@ INLINE_RELEASE_TEMPLATED static ErrorEbm BinSumsBoosting(BinSumsBoostingBridge *
    return error;
 }
 
+
+template<typename TFloat, bool bHessian, int gradHessFormat, bool bWeight, bool bReplication, size_t cCompilerScores>
+GPU_DEVICE NEVER_INLINE static void BinSumsBoostingMultiInternal(BinSumsBoostingMultiBridge * const pParams) {
+   static_assert(bWeight || !bReplication, "bReplication cannot be true if bWeight is false");
+
+   // This builds the histograms of several terms in a single pass over the gradients.  Each SIMD pack of
+   // gradients, hessians and weights is loaded once and then scattered into the bins of every term, which is
+   // only valid if the gradients do not change between the terms being binned.
+
+   static constexpr size_t cArrayScores = GetArrayScores(cCompilerScores);
+
+#ifndef GPU_COMPILE
+   EBM_ASSERT(nullptr != pParams);
+   EBM_ASSERT(1 <= pParams->m_cSamples);
+   EBM_ASSERT(0 == pParams->m_cSamples % size_t { TFloat::k_cSIMDPack });
+   EBM_ASSERT(nullptr != pParams->m_aGradientsAndHessians);
+   EBM_ASSERT(k_dynamicScores == cCompilerScores || cCompilerScores == pParams->m_cScores);
+   EBM_ASSERT(1 <= pParams->m_cTerms);
+   EBM_ASSERT(pParams->m_cTerms <= k_cBinSumsMultiTermsMax);
+#endif // GPU_COMPILE
+
+   const size_t cScores = GET_COUNT_SCORES(cCompilerScores, pParams->m_cScores);
+
+   const size_t cSamples = pParams->m_cSamples;
+
+   const GradHessStorage<TFloat, gradHessFormat> * pGradientAndHessian = reinterpret_cast<const GradHessStorage<TFloat, gradHessFormat> *>(pParams->m_aGradientsAndHessians);
+   const GradHessStorage<TFloat, gradHessFormat> * const pGradientsAndHessiansEnd = pGradientAndHessian + (bHessian ? size_t { 2 } : size_t { 1 }) * cScores * cSamples;
+
+   const typename TFloat::TInt::T cBytesPerBin = static_cast<typename TFloat::TInt::T>(GetBinSize<typename TFloat::T, typename TFloat::TInt::T>(bHessian, cScores, bWeight));
+
+   // each term has its own bit packing, so we keep separate unpacking state for each of them.  Terms with only
+   // 1 bin do not have packed data.  We give them a zero mask and zero bit width so that they always index bin 0
+   // and never need to load more packed data
+   Bin<typename TFloat::T, typename TFloat::TInt::T, bHessian, cArrayScores, bWeight> * aaBins[k_cBinSumsMultiTermsMax];
+   const typename TFloat::TInt::T * apInputData[k_cBinSumsMultiTermsMax];
+   typename TFloat::TInt aiTensorBinCombined[k_cBinSumsMultiTermsMax];
+   typename TFloat::TInt aMaskBits[k_cBinSumsMultiTermsMax];
+   int acBitsPerItemMax[k_cBinSumsMultiTermsMax];
+   int acShift[k_cBinSumsMultiTermsMax];
+   int acShiftReset[k_cBinSumsMultiTermsMax];
+
+   size_t cTerms = 0;
+   size_t iTermInit = 0;
+   do {
+#ifndef GPU_COMPILE
+      EBM_ASSERT(nullptr != pParams->m_aaFastBins[iTermInit]);
+#endif // GPU_COMPILE
+
+      const int cItemsPerBitPack = pParams->m_acPack[iTermInit];
+      if(k_oneScore == cCompilerScores && k_cItemsPerBitPackNone != cItemsPerBitPack) {
+         // BinSumsBoosting would sum this term with per-lane histograms if they fit, and the histograms we build 
+         // here need to be identical to the ones BinSumsBoosting builds, so we give those terms their own pass
+         BinSumsBoostingBridge paramsTerm;
+         paramsTerm.m_bHessian = pParams->m_bHessian;
+         paramsTerm.m_gradHessFormat = pParams->m_gradHessFormat;
+         paramsTerm.m_cScores = cScores;
+         paramsTerm.m_cPack = cItemsPerBitPack;
+         paramsTerm.m_cSamples = cSamples;
+         paramsTerm.m_aGradientsAndHessians = pParams->m_aGradientsAndHessians;
+         paramsTerm.m_aWeights = pParams->m_aWeights;
+         paramsTerm.m_pCountOccurrences = pParams->m_pCountOccurrences;
+         paramsTerm.m_aPacked = pParams->m_aaPacked[iTermInit];
+         paramsTerm.m_cBins = pParams->m_acBins[iTermInit];
+         paramsTerm.m_aFastBins = pParams->m_aaFastBins[iTermInit];
+         paramsTerm.m_aSortScratch = nullptr;
+         paramsTerm.m_cBinRangeShift = 0;
+         paramsTerm.m_bConflictDetect = EBM_FALSE;
+         if(BinSumsBoostingLanes<TFloat, bHessian, gradHessFormat, bWeight, bReplication, k_cItemsPerBitPackDynamic>(&paramsTerm)) {
+            ++iTermInit;
+            continue;
+         }
+      }
+
+      aaBins[cTerms] = reinterpret_cast<BinBase *>(pParams->m_aaFastBins[iTermInit])->Specialize<typename TFloat::T, typename TFloat::TInt::T, bHessian, cArrayScores, bWeight>();
+
+      if(k_cItemsPerBitPackNone == cItemsPerBitPack) {
+         apInputData[cTerms] = nullptr;
+         aiTensorBinCombined[cTerms] = typename TFloat::TInt::T { 0 };
+         aMaskBits[cTerms] = typename TFloat::TInt::T { 0 };
+         acBitsPerItemMax[cTerms] = 0;
+         acShift[cTerms] = 0;
+         acShiftReset[cTerms] = 0;
+      } else {
+#ifndef GPU_COMPILE
+         EBM_ASSERT(1 <= cItemsPerBitPack);
+         EBM_ASSERT(cItemsPerBitPack <= COUNT_BITS(typename TFloat::TInt::T));
+#endif // GPU_COMPILE
+
+         const int cBitsPerItemMax = GetCountBits<typename TFloat::TInt::T>(cItemsPerBitPack);
+#ifndef GPU_COMPILE
+         EBM_ASSERT(1 <= cBitsPerItemMax);
+         EBM_ASSERT(cBitsPerItemMax <= COUNT_BITS(typename TFloat::TInt::T));
+#endif // GPU_COMPILE
+
+         const typename TFloat::TInt::T * const pInputData = reinterpret_cast<const typename TFloat::TInt::T *>(pParams->m_aaPacked[iTermInit]);
+#ifndef GPU_COMPILE
+         EBM_ASSERT(nullptr != pInputData);
+#endif // GPU_COMPILE
+
+         aiTensorBinCombined[cTerms] = TFloat::TInt::Load(pInputData);
+         apInputData[cTerms] = pInputData + TFloat::TInt::k_cSIMDPack;
+         aMaskBits[cTerms] = MakeLowMask<typename TFloat::TInt::T>(cBitsPerItemMax);
+         acBitsPerItemMax[cTerms] = cBitsPerItemMax;
+         acShift[cTerms] = static_cast<int>(((cSamples >> TFloat::k_cSIMDShift) - size_t { 1 }) % static_cast<size_t>(cItemsPerBitPack)) * cBitsPerItemMax;
+         acShiftReset[cTerms] = (cItemsPerBitPack - 1) * cBitsPerItemMax;
+      }
+      ++cTerms;
+      ++iTermInit;
+   } while(pParams->m_cTerms != iTermInit);
+
+   if(size_t { 0 } == cTerms) {
+      return;
+   }
+
+   const typename TFloat::T * pWeight;
+   const uint8_t * pCountOccurrences;
+   if(bWeight) {
+      pWeight = reinterpret_cast<const typename TFloat::T *>(pParams->m_aWeights);
+#ifndef GPU_COMPILE
+      EBM_ASSERT(nullptr != pWeight);
+#endif // GPU_COMPILE
+      if(bReplication) {
+         pCountOccurrences = pParams->m_pCountOccurrences;
+#ifndef GPU_COMPILE
+         EBM_ASSERT(nullptr != pCountOccurrences);
+#endif // GPU_COMPILE
+      }
+   }
+
+   do {
+      TFloat weight;
+      typename TFloat::TInt cOccurences;
+      if(bWeight) {
+         weight = TFloat::Load(pWeight);
+         pWeight += TFloat::k_cSIMDPack;
+         if(bReplication) {
+            cOccurences = TFloat::TInt::LoadBytes(pCountOccurrences);
+            pCountOccurrences += TFloat::k_cSIMDPack;
+         }
+      }
+
+      // with a single score we can hold the weighted gradient and hessian in registers for all the terms.  With 
+      // multiple scores we re-load them for each term, but they will be in the L1 cache after the first term
+      TFloat gradientOne;
+      TFloat hessianOne;
+      if(k_oneScore == cCompilerScores) {
+         gradientOne = TFloat::Load(pGradientAndHessian);
+         if(bHessian) {
+            hessianOne = TFloat::Load(&pGradientAndHessian[TFloat::k_cSIMDPack]);
+         }
+         if(bWeight) {
+            gradientOne *= weight;
+            if(bHessian) {
+               hessianOne *= weight;
+            }
+         }
+      }
+
+      size_t iTerm = 0;
+      do {
+         if(acShift[iTerm] < 0) {
+            aiTensorBinCombined[iTerm] = TFloat::TInt::Load(apInputData[iTerm]);
+            apInputData[iTerm] += TFloat::TInt::k_cSIMDPack;
+            acShift[iTerm] = acShiftReset[iTerm];
+         }
+         typename TFloat::TInt iTensorBin = (aiTensorBinCombined[iTerm] >> acShift[iTerm]) & aMaskBits[iTerm];
+         acShift[iTerm] -= acBitsPerItemMax[iTerm];
+
+         iTensorBin = Multiply<typename TFloat::TInt, typename TFloat::TInt::T,
+            k_dynamicScores != cCompilerScores && 1 != TFloat::k_cSIMDPack,
+            static_cast<typename TFloat::TInt::T>(GetBinSize<typename TFloat::T, typename TFloat::TInt::T>(bHessian, cCompilerScores, bWeight))>(
+               iTensorBin, cBytesPerBin);
+
+         auto * const aBins = aaBins[iTerm];
+         Bin<typename TFloat::T, typename TFloat::TInt::T, bHessian, cArrayScores, bWeight> * apBins[TFloat::k_cSIMDPack];
+         TFloat::TInt::Execute([aBins, &apBins](const int i, const typename TFloat::TInt::T x) {
+            apBins[i] = IndexBin(aBins, static_cast<size_t>(x));
+         }, iTensorBin);
+
+         // BEWARE: pBin can point to the same bin in multiple samples within the SIMD pack, so we need to 
+         // serialize fetching sums
+         if(bReplication) {
+            TFloat::TInt::Execute([apBins](const int i, const typename TFloat::TInt::T x) {
+               auto * const pBin = apBins[i];
+               pBin->SetCountSamples(pBin->GetCountSamples() + x);
+            }, cOccurences);
+         } else {
+            TFloat::Execute([apBins](const int i) {
+               auto * const pBin = apBins[i];
+               pBin->SetCountSamples(pBin->GetCountSamples() + typename TFloat::TInt::T { 1 });
+            });
+         }
+
+         if(bWeight) {
+            TFloat::Execute([apBins](const int i, const typename TFloat::T x) {
+               auto * const pBin = apBins[i];
+               pBin->SetWeight(pBin->GetWeight() + x);
+            }, weight);
+         }
+
+         size_t iScore = 0;
+         do {
+            TFloat gradient;
+            TFloat hessian;
+            if(k_oneScore == cCompilerScores) {
+               gradient = gradientOne;
+               if(bHessian) {
+                  hessian = hessianOne;
+               }
+            } else {
+               if(bHessian) {
+                  gradient = TFloat::Load(&pGradientAndHessian[iScore << (TFloat::k_cSIMDShift + 1)]);
+                  hessian = TFloat::Load(&pGradientAndHessian[(iScore << (TFloat::k_cSIMDShift + 1)) + TFloat::k_cSIMDPack]);
+               } else {
+                  gradient = TFloat::Load(&pGradientAndHessian[iScore << TFloat::k_cSIMDShift]);
+               }
+               if(bWeight) {
+                  gradient *= weight;
+                  if(bHessian) {
+                     hessian *= weight;
+                  }
+               }
+            }
+
+            if(bHessian) {
+               TFloat::Execute([apBins, iScore](const int i, const typename TFloat::T grad, const typename TFloat::T hess) {
+                  auto * const pBin = apBins[i];
+                  auto * const aGradientPair = pBin->GetGradientPairs();
+                  auto * const pGradientPair = &aGradientPair[iScore];
+                  typename TFloat::T binGrad = pGradientPair->m_sumGradients;
+                  typename TFloat::T binHess = pGradientPair->GetHess();
+                  binGrad += grad;
+                  binHess += hess;
+                  pGradientPair->m_sumGradients = binGrad;
+                  pGradientPair->SetHess(binHess);
+               }, gradient, hessian);
+            } else {
+               TFloat::Execute([apBins, iScore](const int i, const typename TFloat::T grad) {
+                  auto * const pBin = apBins[i];
+                  auto * const aGradientPair = pBin->GetGradientPairs();
+                  auto * const pGradientPair = &aGradientPair[iScore];
+                  pGradientPair->m_sumGradients += grad;
+               }, gradient);
+            }
+            ++iScore;
+         } while(cScores != iScore);
+
+         ++iTerm;
+      } while(cTerms != iTerm);
+
+      pGradientAndHessian += cScores << (bHessian ? (TFloat::k_cSIMDShift + 1) : TFloat::k_cSIMDShift);
+   } while(pGradientsAndHessiansEnd != pGradientAndHessian);
+}
+
+template<typename TFloat, bool bHessian, int gradHessFormat, bool bWeight, bool bReplication, size_t cCompilerScores>
+GPU_GLOBAL static void RemoteBinSumsBoostingMulti(BinSumsBoostingMultiBridge * const pParams) {
+   BinSumsBoostingMultiInternal<TFloat, bHessian, gradHessFormat, bWeight, bReplication, cCompilerScores>(pParams);
+}
+
+template<typename TFloat, bool bHessian, int gradHessFormat, bool bWeight, bool bReplication, size_t cCompilerScores>
+INLINE_RELEASE_TEMPLATED ErrorEbm OperatorBinSumsBoostingMulti(BinSumsBoostingMultiBridge * const pParams) {
+   return TFloat::template OperatorBinSumsBoostingMulti<bHessian, gradHessFormat, bWeight, bReplication, cCompilerScores>(pParams);
+}
+
+template<typename TFloat, bool bHessian, int gradHessFormat, bool bWeight, bool bReplication>
+INLINE_RELEASE_TEMPLATED static ErrorEbm CountScoresBoostingMulti(BinSumsBoostingMultiBridge * const pParams) {
+   // the multi-term kernel is used far less often than the single term one, so we only special case 1 score
+   if(size_t { 1 } != pParams->m_cScores) {
+      return OperatorBinSumsBoostingMulti<TFloat, bHessian, gradHessFormat, bWeight, bReplication, k_dynamicScores>(pParams);
+   } else {
+      return OperatorBinSumsBoostingMulti<TFloat, bHessian, gradHessFormat, bWeight, bReplication, k_oneScore>(pParams);
+   }
+}
+
+template<typename TFloat, bool bHessian, int gradHessFormat>
+INLINE_RELEASE_TEMPLATED static ErrorEbm WeightBinSumsBoostingMulti(BinSumsBoostingMultiBridge * const pParams) {
+   if(nullptr != pParams->m_aWeights) {
+      static constexpr bool bWeight = true;
+      if(nullptr != pParams->m_pCountOccurrences) {
+         return CountScoresBoostingMulti<TFloat, bHessian, gradHessFormat, bWeight, true>(pParams);
+      } else {
+         return CountScoresBoostingMulti<TFloat, bHessian, gradHessFormat, bWeight, false>(pParams);
+      }
+   } else {
+      // we use the weights to hold both the weights and the inner bag counts if there are inner bags
+      EBM_ASSERT(nullptr == pParams->m_pCountOccurrences);
+      return CountScoresBoostingMulti<TFloat, bHessian, gradHessFormat, false, false>(pParams);
+   }
+}
+
+template<typename TFloat>
+INLINE_RELEASE_TEMPLATED static ErrorEbm BinSumsBoostingMulti(BinSumsBoostingMultiBridge * const pParams) {
+   LOG_0(Trace_Verbose, "Entered BinSumsBoostingMulti");
+
+#ifndef NDEBUG
+   // all our memory should be aligned. It is required by SIMD for correctness or performance
+   EBM_ASSERT(IsAligned(pParams->m_aGradientsAndHessians));
+   EBM_ASSERT(IsAligned(pParams->m_aWeights));
+   EBM_ASSERT(IsAligned(pParams->m_pCountOccurrences));
+   for(size_t iDebug = 0; iDebug < pParams->m_cTerms; ++iDebug) {
+      EBM_ASSERT(IsAligned(pParams->m_aaPacked[iDebug]));
+      EBM_ASSERT(IsAligned(pParams->m_aaFastBins[iDebug]));
+   }
+#endif // NDEBUG
+
+   ErrorEbm error;
+
+   EBM_ASSERT(1 <= pParams->m_cScores);
+   if(EBM_FALSE != pParams->m_bHessian) {
+      if(k_gradHessBfloat16 == pParams->m_gradHessFormat) {
+         error = WeightBinSumsBoostingMulti<TFloat, true, k_gradHessBfloat16>(pParams);
+      } else {
+         EBM_ASSERT(k_gradHessFloat == pParams->m_gradHessFormat);
+         error = WeightBinSumsBoostingMulti<TFloat, true, k_gradHessFloat>(pParams);
+      }
+   } else {
+      // only objectives with hessians store compact gradients
+      EBM_ASSERT(k_gradHessFloat == pParams->m_gradHessFormat);
+      error = WeightBinSumsBoostingMulti<TFloat, false, k_gradHessFloat>(pParams);
+   }
+
+   LOG_0(Trace_Verbose, "Exited BinSumsBoostingMulti");
+
+   return error;
+}
+
 } // DEFINED_ZONE_NAME
 
 #endif // BIN_SUMS_BOOSTING_HPP
\ No newline at end of file
@@ -20,6 +20,176 @@ namespace DEFINED_ZONE_NAME {
 #error DEFINED_ZONE_NAME must be defined
 #endif // DEFINED_ZONE_NAME
 
+template<typename TFloat, bool bHessian, bool bWeight, size_t cCompilerScores, size_t cCompilerDimensions, 
+   typename std::enable_if<!TFloat::k_bConflictDetect, int>::type = 0>
+GPU_DEVICE INLINE_ALWAYS static bool BinSumsInteractionConflictFree(BinSumsInteractionBridge * const pParams) {
+   // this zone has no way to find the lanes that collide, so the caller serializes them through TFloat::Execute
+   UNUSED(pParams);
+   return false;
+}
+
+WARNING_PUSH
+WARNING_DISABLE_UNINITIALIZED_MEMBER_VARIABLE
+template<typename TFloat, bool bHessian, bool bWeight, size_t cCompilerScores, size_t cCompilerDimensions, 
+   typename std::enable_if<TFloat::k_bConflictDetect, int>::type = 0>
+GPU_DEVICE NEVER_INLINE static bool BinSumsInteractionConflictFree(BinSumsInteractionBridge * const pParams) {
+   static_assert(sizeof(typename TFloat::T) == sizeof(typename TFloat::TInt::T), 
+      "we index the counts and the floats of the bins in the same units");
+
+   // Instead of building a pointer to the bin of each lane and updating the bins one lane at a time, we compute
+   // the index of each lane's bin with SIMD and update every field with one gather, add, and scatter per group
+   // of lanes from TFloat::TInt::ExecuteConflictFree.  The groups keep the additions into each bin in lane 
+   // order, so the sums are bit for bit identical to the TFloat::Execute path in BinSumsInteractionInternal.
+   //
+   // Returns false without doing anything if the CPU lacks conflict detection or if the tensor is too big to 
+   // index with the signed 32 bit gather indexes.
+
+   static constexpr size_t cArrayScores = GetArrayScores(cCompilerScores);
+
+   if(EBM_FALSE == pParams->m_bConflictDetect) {
+      return false;
+   }
+
+   using TInt = typename TFloat::TInt;
+   using TMask = typename TInt::TMask;
+   using TBin = Bin<typename TFloat::T, typename TInt::T, bHessian, cArrayScores>;
+
+   const size_t cScores = GET_COUNT_SCORES(cCompilerScores, pParams->m_cScores);
+   const size_t cRealDimensions = GET_COUNT_DIMENSIONS(cCompilerDimensions, pParams->m_cRuntimeRealDimensions);
+
+   static constexpr size_t cItemsPerGradientPair = bHessian ? size_t { 2 } : size_t { 1 };
+   const size_t cItemsPerBin = GetBinSize<typename TFloat::T, typename TInt::T>(bHessian, cScores) / sizeof(typename TFloat::T);
+
+   struct alignas(EbmMax(alignof(TInt), alignof(void *), alignof(int))) DimensionalData {
+      int m_cShift;
+      int m_cBitsPerItemMax;
+      int m_cShiftReset;
+      const typename TInt::T * m_pData;
+      typename TInt::T m_cItemsStride;
+
+      TInt iBinCombined;
+      TInt maskBits;
+   };
+
+   // this is on the stack and the compiler should be able to optimize these as if they were variables or registers
+   DimensionalData aDimensionalData[k_dynamicDimensions == cCompilerDimensions ? k_cDimensionsMax : cCompilerDimensions];
+
+   const size_t cSamples = pParams->m_cSamples;
+
+   size_t cItemsTensor = cItemsPerBin;
+   size_t iDimensionInit = 0;
+   do {
+      DimensionalData * const pDimensionalData = &aDimensionalData[iDimensionInit];
+
+      // the largest index is one less than the number of items, which needs to fit into a signed 32 bit index
+      if((size_t { 1 } << 31) / cItemsTensor < pParams->m_acBins[iDimensionInit]) {
+         return false;
+      }
+      pDimensionalData->m_cItemsStride = static_cast<typename TInt::T>(cItemsTensor);
+      cItemsTensor *= pParams->m_acBins[iDimensionInit];
+
+      const typename TInt::T * const pData = reinterpret_cast<const typename TInt::T *>(pParams->m_aaPacked[iDimensionInit]);
+      pDimensionalData->iBinCombined = TInt::Load(pData);
+      pDimensionalData->m_pData = pData + TInt::k_cSIMDPack;
+
+      const int cItemsPerBitPack = pParams->m_acItemsPerBitPack[iDimensionInit];
+#ifndef GPU_COMPILE
+      EBM_ASSERT(1 <= cItemsPerBitPack);
+      EBM_ASSERT(cItemsPerBitPack <= COUNT_BITS(typename TInt::T));
+#endif // GPU_COMPILE
+
+      const int cBitsPerItemMax = GetCountBits<typename TInt::T>(cItemsPerBitPack);
+#ifndef GPU_COMPILE
+      EBM_ASSERT(1 <= cBitsPerItemMax);
+      EBM_ASSERT(cBitsPerItemMax <= COUNT_BITS(typename TInt::T));
+#endif // GPU_COMPILE
+      pDimensionalData->m_cBitsPerItemMax = cBitsPerItemMax;
+
+      pDimensionalData->m_cShift = (static_cast<int>(((cSamples >> TFloat::k_cSIMDShift) - size_t { 1 }) % static_cast<size_t>(cItemsPerBitPack)) + 1) * cBitsPerItemMax;
+      pDimensionalData->m_cShiftReset = (cItemsPerBitPack - 1) * cBitsPerItemMax;
+
+      pDimensionalData->maskBits = MakeLowMask<typename TInt::T>(cBitsPerItemMax);
+
+      ++iDimensionInit;
+   } while(cRealDimensions != iDimensionInit);
+
+   typename TInt::T * const aCounts = 
+      IndexByte(reinterpret_cast<typename TInt::T *>(pParams->m_aFastBins), static_cast<size_t>(TBin::GetOffsetCountSamples()));
+   typename TFloat::T * const aWeights = 
+      IndexByte(reinterpret_cast<typename TFloat::T *>(pParams->m_aFastBins), static_cast<size_t>(TBin::GetOffsetWeight()));
+   typename TFloat::T * const aGradients = 
+      IndexByte(reinterpret_cast<typename TFloat::T *>(pParams->m_aFastBins), static_cast<size_t>(TBin::GetOffsetGradientPairs()));
+
+   const typename TFloat::T * pGradientAndHessian = reinterpret_cast<const typename TFloat::T *>(pParams->m_aGradientsAndHessians);
+   const typename TFloat::T * const pGradientsAndHessiansEnd = pGradientAndHessian + cItemsPerGradientPair * cScores * cSamples;
+
+   const typename TFloat::T * pWeight;
+   if(bWeight) {
+      pWeight = reinterpret_cast<const typename TFloat::T *>(pParams->m_aWeights);
+#ifndef GPU_COMPILE
+      EBM_ASSERT(nullptr != pWeight);
+#endif // GPU_COMPILE
+   }
+
+   do {
+      TInt iItem = typename TInt::T { 0 };
+      size_t iDimension = 0;
+      do {
+         DimensionalData * const pDimensionalData = &aDimensionalData[iDimension];
+
+         const int shift = pDimensionalData->m_cShift - pDimensionalData->m_cBitsPerItemMax;
+         pDimensionalData->m_cShift = shift;
+         if(shift < 0) {
+            const typename TInt::T * const pData = pDimensionalData->m_pData;
+            pDimensionalData->iBinCombined = TInt::Load(pData);
+            pDimensionalData->m_pData = pData + TInt::k_cSIMDPack;
+            pDimensionalData->m_cShift = pDimensionalData->m_cShiftReset;
+         }
+
+         const TInt iBin = (pDimensionalData->iBinCombined >> pDimensionalData->m_cShift) & pDimensionalData->maskBits;
+         iItem = iItem + iBin * pDimensionalData->m_cItemsStride;
+
+         ++iDimension;
+      } while(cRealDimensions != iDimension);
+
+      TFloat weight;
+      if(bWeight) {
+         weight = TFloat::Load(pWeight);
+         pWeight += TFloat::k_cSIMDPack;
+      } else {
+         weight = typename TFloat::T { 1.0 };
+      }
+
+      TInt::ExecuteConflictFree([aCounts, aWeights, aGradients, cScores, pGradientAndHessian, &iItem, &weight](const TMask lanes) {
+         const TInt cBinSamples = TInt::Load(aCounts, iItem, lanes) + typename TInt::T { 1 };
+         cBinSamples.Store(aCounts, iItem, lanes);
+
+         const TFloat binWeight = TFloat::Load(aWeights, iItem, lanes) + weight;
+         binWeight.Store(aWeights, iItem, lanes);
+
+         typename TFloat::T * pBinGradient = aGradients;
+         const typename TFloat::T * pGradient = pGradientAndHessian;
+         size_t iScore = 0;
+         do {
+            const TFloat binGrad = TFloat::Load(pBinGradient, iItem, lanes) + TFloat::Load(pGradient);
+            binGrad.Store(pBinGradient, iItem, lanes);
+            if(bHessian) {
+               const TFloat binHess = TFloat::Load(&pBinGradient[1], iItem, lanes) + TFloat::Load(&pGradient[TFloat::k_cSIMDPack]);
+               binHess.Store(&pBinGradient[1], iItem, lanes);
+            }
+            pBinGradient += cItemsPerGradientPair;
+            pGradient += cItemsPerGradientPair * size_t { TFloat::k_cSIMDPack };
+            ++iScore;
+         } while(cScores != iScore);
+      }, iItem);
+
+      pGradientAndHessian += cItemsPerGradientPair * cScores * size_t { TFloat::k_cSIMDPack };
+   } while(pGradientsAndHessiansEnd != pGradientAndHessian);
+
+   return true;
+}
+WARNING_POP
+
 WARNING_PUSH
 WARNING_DISABLE_UNINITIALIZED_MEMBER_VARIABLE
 template<typename TFloat, bool bHessian, bool bWeight, size_t cCompilerScores, size_t cCompilerDimensions>
@@ -38,6 +208,10 @@ GPU_DEVICE NEVER_INLINE static void BinSumsInteractionInternal(BinSumsInteractio
    EBM_ASSERT(1 == cCompilerDimensions || 1 != pParams->m_cRuntimeRealDimensions); // 1 dimension must be templated
 #endif // GPU_COMPILE
 
+   if(BinSumsInteractionConflictFree<TFloat, bHessian, bWeight, cCompilerScores, cCompilerDimensions>(pParams)) {
+      return;
+   }
+
    const size_t cScores = GET_COUNT_SCORES(cCompilerScores, pParams->m_cScores);
 
    auto * const aBins = reinterpret_cast<BinBase *>(pParams->m_aFastBins)->Specialize<typename TFloat::T, typename TFloat::TInt::T, bHessian, cArrayScores>();
@@ -336,16 +510,16 @@ INLINE_RELEASE_TEMPLATED static ErrorEbm BinSumsInteraction(BinSumsInteractionBr
       if(nullptr != pParams->m_aWeights) {
          static constexpr bool bWeights = true;
          if(size_t { 1 } != pParams->m_cScores) {
-            // muticlass
-            error = CountClassesInteraction<TFloat, bHessian, bWeights, k_cCompilerScoresStart>::Func(pParams);
+            // the interaction detector only bins hessians for logitboost, so do not optimize multiclass for it
+            error = OperatorBinSumsInteraction<TFloat, bHessian, bWeights, k_dynamicScores, k_dynamicDimensions>(pParams);
          } else {
             error = CountDimensionsInteraction<TFloat, bHessian, bWeights, k_oneScore, 1>::Func(pParams);
          }
       } else {
          static constexpr bool bWeights = false;
          if(size_t { 1 } != pParams->m_cScores) {
-            // muticlass
-            error = CountClassesInteraction<TFloat, bHessian, bWeights, k_cCompilerScoresStart>::Func(pParams);
+            // the interaction detector only bins hessians for logitboost, so do not optimize multiclass for it
+            error = OperatorBinSumsInteraction<TFloat, bHessian, bWeights, k_dynamicScores, k_dynamicDimensions>(pParams);
          } else {
             error = CountDimensionsInteraction<TFloat, bHessian, bWeights, k_oneScore, 1>::Func(pParams);
          }
@@ -355,16 +529,16 @@ INLINE_RELEASE_TEMPLATED static ErrorEbm BinSumsInteraction(BinSumsInteractionBr
       if(nullptr != pParams->m_aWeights) {
          static constexpr bool bWeights = true;
          if(size_t { 1 } != pParams->m_cScores) {
-            // Odd: gradient multiclass. Allow it, but do not optimize for it
-            error = OperatorBinSumsInteraction<TFloat, bHessian, bWeights, k_dynamicScores, k_dynamicDimensions>(pParams);
+            // muticlass
+            error = CountClassesInteraction<TFloat, bHessian, bWeights, k_cCompilerScoresStart>::Func(pParams);
          } else {
             error = CountDimensionsInteraction<TFloat, bHessian, bWeights, k_oneScore, 1>::Func(pParams);
          }
       } else {
          static constexpr bool bWeights = false;
          if(size_t { 1 } != pParams->m_cScores) {
-            // Odd: gradient multiclass. Allow it, but do not optimize for it
-            error = OperatorBinSumsInteraction<TFloat, bHessian, bWeights, k_dynamicScores, k_dynamicDimensions>(pParams);
+            // muticlass
+            error = CountClassesInteraction<TFloat, bHessian, bWeights, k_cCompilerScoresStart>::Func(pParams);
          } else {
             error = CountDimensionsInteraction<TFloat, bHessian, bWeights, k_oneScore, 1>::Func(pParams);
          }
@@ -78,10 +78,58 @@ GPU_DEVICE inline GradientHessian<TFloat> MakeGradientHessian(const double gradi
 }
 
 
-template<typename TObjective, bool bValidation, bool bWeight, bool bHessian, bool bDisableApprox, size_t cCompilerScores, int cCompilerPack>
+// Fetches the update score for each SIMD lane's tensor bin.  Most terms have small update tensors (booleans,
+// low cardinality categoricals, pairs of those) and if the zone can hold the entire update tensor in a single
+// register then we look up the scores with an in-register permute instead of issuing a gather to memory.
+template<typename TFloat, bool bTable = size_t { 0 } != TFloat::k_cTableItemsMax>
+class UpdateTensorLookup;
+
+template<typename TFloat>
+class UpdateTensorLookup<TFloat, false> final {
+   const typename TFloat::T * m_aUpdateTensorScores;
+
+public:
+   GPU_DEVICE inline UpdateTensorLookup(const typename TFloat::T * const aUpdateTensorScores, const size_t) noexcept :
+      m_aUpdateTensorScores(aUpdateTensorScores) {
+   }
+
+   GPU_DEVICE inline TFloat Load(const typename TFloat::TInt & iTensorBin) const noexcept {
+      return TFloat::Load(m_aUpdateTensorScores, iTensorBin);
+   }
+};
+
+template<typename TFloat>
+class alignas(alignof(TFloat)) UpdateTensorLookup<TFloat, true> final {
+   TFloat m_table;
+   const typename TFloat::T * m_aUpdateTensorScores;
+   bool m_bTable;
+
+public:
+   inline UpdateTensorLookup(const typename TFloat::T * const aUpdateTensorScores, const size_t cTensorBins) noexcept :
+      // the table is unused when the tensor does not fit, but we zero it so the compiler can see it is initialized
+      m_table(cTensorBins <= TFloat::k_cTableItemsMax ? TFloat::LoadTable(aUpdateTensorScores, cTensorBins) : TFloat(0.0)),
+      m_aUpdateTensorScores(aUpdateTensorScores),
+      m_bTable(cTensorBins <= TFloat::k_cTableItemsMax) {
+      EBM_ASSERT(1 <= cTensorBins);
+   }
+
+   inline TFloat Load(const typename TFloat::TInt & iTensorBin) const noexcept {
+      // the branch goes the same way for the entire update, so it is predicted perfectly
+      return m_bTable ? m_table.Lookup(iTensorBin) : TFloat::Load(m_aUpdateTensorScores, iTensorBin);
+   }
+};
+
+
+// The training pass only has weights when the validation set is an alias of the training set.  It then also 
+// calculates the metric using the validation weights, which are zero for the samples that we train on.
+inline constexpr static bool IsFusedMetric(const bool bValidation, const bool bWeight) noexcept {
+   return !bValidation && bWeight;
+}
+
+template<typename TObjective, bool bValidation, bool bWeight, bool bHessian, int gradHessFormat, bool bDisableApprox, size_t cCompilerScores, int cCompilerPack>
 GPU_GLOBAL static void RemoteApplyUpdate(const Objective * const pObjective, ApplyUpdateBridge * const pData) {
    const TObjective * const pObjectiveSpecific = static_cast<const TObjective *>(pObjective);
-   pObjectiveSpecific->template InjectedApplyUpdate<bValidation, bWeight, bHessian, bDisableApprox, cCompilerScores, cCompilerPack>(pData);
+   pObjectiveSpecific->template InjectedApplyUpdate<bValidation, bWeight, bHessian, gradHessFormat, bDisableApprox, cCompilerScores, cCompilerPack>(pData);
 }
 
 
@@ -142,22 +190,26 @@ private:
 
          if(nullptr != pData->m_aWeights) {
             static constexpr bool bWeight = true;
-            return ApproxApplyUpdate<TObjective, bValidation, bWeight, bHessian>(pData);
+            return ApproxApplyUpdate<TObjective, bValidation, bWeight, bHessian, k_gradHessFloat>(pData);
          } else {
             static constexpr bool bWeight = false;
-            return ApproxApplyUpdate<TObjective, bValidation, bWeight, bHessian>(pData);
+            return ApproxApplyUpdate<TObjective, bValidation, bWeight, bHessian, k_gradHessFloat>(pData);
          }
       } else {
          static constexpr bool bValidation = false;
 
          EBM_ASSERT(nullptr != pData->m_aGradientsAndHessians);
 
-         // we only use weights for calculating the metric. Weights get applied 
-         // in BinSumsBoosting or during initialization for interactions
-         EBM_ASSERT(nullptr == pData->m_aWeights);
-         static constexpr bool bWeight = false;
-
-         return HessianApplyUpdate<TObjective, bValidation, bWeight>(pData);
+         // we only use weights for calculating the metric. Weights get applied in BinSumsBoosting or during 
+         // initialization for interactions, so training only has weights when the validation set is an alias 
+         // of the training set and the metric is calculated with the validation weights in the same pass
+         if(nullptr != pData->m_aWeights) {
+            static constexpr bool bWeight = true;
+            return HessianApplyUpdate<TObjective, bValidation, bWeight>(pData);
+         } else {
+            static constexpr bool bWeight = false;
+            return HessianApplyUpdate<TObjective, bValidation, bWeight>(pData);
+         }
       }
    }
    template<typename TObjective, typename std::enable_if<TObjective::k_bRmse, int>::type = 0>
@@ -172,20 +224,23 @@ private:
 
          if(nullptr != pData->m_aWeights) {
             static constexpr bool bWeight = true;
-            return ApproxApplyUpdate<TObjective, bValidation, bWeight, bHessian>(pData);
+            return ApproxApplyUpdate<TObjective, bValidation, bWeight, bHessian, k_gradHessFloat>(pData);
          } else {
             static constexpr bool bWeight = false;
-            return ApproxApplyUpdate<TObjective, bValidation, bWeight, bHessian>(pData);
+            return ApproxApplyUpdate<TObjective, bValidation, bWeight, bHessian, k_gradHessFloat>(pData);
          }
       } else {
          static constexpr bool bValidation = false;
 
-         // we only use weights for calculating the metric. Weights get applied 
-         // in BinSumsBoosting or during initialization for interactions
-         EBM_ASSERT(nullptr == pData->m_aWeights);
-         static constexpr bool bWeight = false; // if we are not calculating the metric then we never need the weights
-
-         return ApproxApplyUpdate<TObjective, bValidation, bWeight, bHessian>(pData);
+         // we only use weights for calculating the metric. Weights get applied in BinSumsBoosting or during 
+         // initialization for interactions, so training only has weights when the validation set is an alias
+         if(nullptr != pData->m_aWeights) {
+            static constexpr bool bWeight = true;
+            return ApproxApplyUpdate<TObjective, bValidation, bWeight, bHessian, k_gradHessFloat>(pData);
+         } else {
+            static constexpr bool bWeight = false;
+            return ApproxApplyUpdate<TObjective, bValidation, bWeight, bHessian, k_gradHessFloat>(pData);
+         }
       }
    }
 
@@ -193,29 +248,38 @@ private:
    template<typename TObjective, bool bValidation, bool bWeight, typename std::enable_if<HasHessian<TObjective>(), int>::type = 0>
    INLINE_RELEASE_TEMPLATED ErrorEbm HessianApplyUpdate(ApplyUpdateBridge * const pData) const {
       if(pData->m_bHessianNeeded) {
-         return ApproxApplyUpdate<TObjective, bValidation, bWeight, true>(pData);
+         // we only store compact gradients for objectives with hessians since they overwrite the gradients 
+         // each time instead of accumulating residuals in them like RMSE
+         if(k_gradHessBfloat16 == pData->m_gradHessFormat) {
+            return ApproxApplyUpdate<TObjective, bValidation, bWeight, true, k_gradHessBfloat16>(pData);
+         } else {
+            EBM_ASSERT(k_gradHessFloat == pData->m_gradHessFormat);
+            return ApproxApplyUpdate<TObjective, bValidation, bWeight, true, k_gradHessFloat>(pData);
+         }
       } else {
-         return ApproxApplyUpdate<TObjective, bValidation, bWeight, false>(pData);
+         EBM_ASSERT(k_gradHessFloat == pData->m_gradHessFormat);
+         return ApproxApplyUpdate<TObjective, bValidation, bWeight, false, k_gradHessFloat>(pData);
       }
    }
    template<typename TObjective, bool bValidation, bool bWeight, typename std::enable_if<!HasHessian<TObjective>(), int>::type = 0>
    INLINE_RELEASE_TEMPLATED ErrorEbm HessianApplyUpdate(ApplyUpdateBridge * const pData) const {
       EBM_ASSERT(!pData->m_bHessianNeeded);
-      return ApproxApplyUpdate<TObjective, bValidation, bWeight, false>(pData);
+      EBM_ASSERT(k_gradHessFloat == pData->m_gradHessFormat);
+      return ApproxApplyUpdate<TObjective, bValidation, bWeight, false, k_gradHessFloat>(pData);
    }
 
 
-   template<typename TObjective, bool bValidation, bool bWeight, bool bHessian, typename std::enable_if<TObjective::k_bApprox, int>::type = 0>
+   template<typename TObjective, bool bValidation, bool bWeight, bool bHessian, int gradHessFormat, typename std::enable_if<TObjective::k_bApprox, int>::type = 0>
    INLINE_RELEASE_TEMPLATED ErrorEbm ApproxApplyUpdate(ApplyUpdateBridge * const pData) const {
       if(EBM_FALSE != pData->m_bDisableApprox) {
-         return CountApplyUpdate<TObjective, bValidation, bWeight, bHessian, true>(pData);
+         return CountApplyUpdate<TObjective, bValidation, bWeight, bHessian, gradHessFormat, true>(pData);
       } else {
-         return CountApplyUpdate<TObjective, bValidation, bWeight, bHessian, false>(pData);
+         return CountApplyUpdate<TObjective, bValidation, bWeight, bHessian, gradHessFormat, false>(pData);
       }
    }
-   template<typename TObjective, bool bValidation, bool bWeight, bool bHessian, typename std::enable_if<!TObjective::k_bApprox, int>::type = 0>
+   template<typename TObjective, bool bValidation, bool bWeight, bool bHessian, int gradHessFormat, typename std::enable_if<!TObjective::k_bApprox, int>::type = 0>
    INLINE_RELEASE_TEMPLATED ErrorEbm ApproxApplyUpdate(ApplyUpdateBridge * const pData) const {
-      return CountApplyUpdate<TObjective, bValidation, bWeight, bHessian, false>(pData);
+      return CountApplyUpdate<TObjective, bValidation, bWeight, bHessian, gradHessFormat, false>(pData);
    }
 
 
@@ -226,61 +290,63 @@ private:
    // part of our template blowup issue of having N * M starting point templates where N is the number
    // of scores and M is the number of bit packs.  If we use 8 * 16 that's already 128 copies of the
    // templated function at this point and more later.  Reducing this to just 16 is very very helpful.
-   template<typename TObjective, bool bValidation, bool bWeight, bool bHessian, bool bDisableApprox, typename std::enable_if<!TObjective::IsMultiScore, int>::type = 0>
+   template<typename TObjective, bool bValidation, bool bWeight, bool bHessian, int gradHessFormat, bool bDisableApprox, typename std::enable_if<!TObjective::IsMultiScore, int>::type = 0>
    INLINE_RELEASE_TEMPLATED ErrorEbm CountApplyUpdate(ApplyUpdateBridge * const pData) const {
-      return PackApplyUpdate<TObjective, bValidation, bWeight, bHessian, bDisableApprox, k_oneScore>(pData);
+      return PackApplyUpdate<TObjective, bValidation, bWeight, bHessian, gradHessFormat, bDisableApprox, k_oneScore>(pData);
    }
-   template<typename TObjective, bool bValidation, bool bWeight, bool bHessian, bool bDisableApprox, typename std::enable_if<TObjective::IsMultiScore && (std::is_base_of<MulticlassMultitaskObjective, TObjective>::value || !bHessian || bDisableApprox), int>::type = 0>
+   template<typename TObjective, bool bValidation, bool bWeight, bool bHessian, int gradHessFormat, bool bDisableApprox, typename std::enable_if<TObjective::IsMultiScore && (std::is_base_of<MulticlassMultitaskObjective, TObjective>::value || !bHessian || bDisableApprox || IsFusedMetric(bValidation, bWeight)), int>::type = 0>
    INLINE_RELEASE_TEMPLATED ErrorEbm CountApplyUpdate(ApplyUpdateBridge * const pData) const {
       // multiclass multitask is going to need some really special handling, so use dynamic scores, and skip the bit packing too
+      // the training pass that also calculates the metric is only used with aliased validation sets, so it 
+      // does not get its own compiled count of scores either
       if(k_cItemsPerBitPackNone == pData->m_cPack) {
          // don't blow up our complexity if we have only 1 bin or during init. Just use dynamic for the count of scores
-         return OperatorApplyUpdate<TObjective, bValidation, bWeight, bHessian, bDisableApprox, k_dynamicScores, k_cItemsPerBitPackNone>(pData);
+         return OperatorApplyUpdate<TObjective, bValidation, bWeight, bHessian, gradHessFormat, bDisableApprox, k_dynamicScores, k_cItemsPerBitPackNone>(pData);
       } else {
-         return OperatorApplyUpdate<TObjective, bValidation, bWeight, bHessian, bDisableApprox, k_dynamicScores, k_cItemsPerBitPackDynamic>(pData);
+         return OperatorApplyUpdate<TObjective, bValidation, bWeight, bHessian, gradHessFormat, bDisableApprox, k_dynamicScores, k_cItemsPerBitPackDynamic>(pData);
       }
    }
-   template<typename TObjective, bool bValidation, bool bWeight, bool bHessian, bool bDisableApprox, typename std::enable_if<TObjective::IsMultiScore && !(std::is_base_of<MulticlassMultitaskObjective, TObjective>::value || !bHessian || bDisableApprox), int>::type = 0>
+   template<typename TObjective, bool bValidation, bool bWeight, bool bHessian, int gradHessFormat, bool bDisableApprox, typename std::enable_if<TObjective::IsMultiScore && !(std::is_base_of<MulticlassMultitaskObjective, TObjective>::value || !bHessian || bDisableApprox || IsFusedMetric(bValidation, bWeight)), int>::type = 0>
    INLINE_RELEASE_TEMPLATED ErrorEbm CountApplyUpdate(ApplyUpdateBridge * const pData) const {
       if(k_cItemsPerBitPackNone == pData->m_cPack) {
          // don't blow up our complexity if we have only 1 bin or during init. Just use dynamic for the count of scores
-         return OperatorApplyUpdate<TObjective, bValidation, bWeight, bHessian, bDisableApprox, k_dynamicScores, k_cItemsPerBitPackNone>(pData);
+         return OperatorApplyUpdate<TObjective, bValidation, bWeight, bHessian, gradHessFormat, bDisableApprox, k_dynamicScores, k_cItemsPerBitPackNone>(pData);
       } else {
-         return CountScores<TObjective, bValidation, bWeight, bHessian, bDisableApprox, (k_cCompilerScoresMax < k_cCompilerScoresStart ? k_dynamicScores : k_cCompilerScoresStart)>::Func(this, pData);
+         return CountScores<TObjective, bValidation, bWeight, bHessian, gradHessFormat, bDisableApprox, (k_cCompilerScoresMax < k_cCompilerScoresStart ? k_dynamicScores : k_cCompilerScoresStart)>::Func(this, pData);
       }
    }
 
 
-   template<typename TObjective, bool bValidation, bool bWeight, bool bHessian, bool bDisableApprox, size_t cCompilerScores>
+   template<typename TObjective, bool bValidation, bool bWeight, bool bHessian, int gradHessFormat, bool bDisableApprox, size_t cCompilerScores>
    struct CountScores final {
       INLINE_ALWAYS static ErrorEbm Func(const Objective * const pObjective, ApplyUpdateBridge * const pData) {
          if(cCompilerScores == pData->m_cScores) {
             if(k_cItemsPerBitPackNone == pData->m_cPack) {
-               return pObjective->OperatorApplyUpdate<TObjective, bValidation, bWeight, bHessian, bDisableApprox, cCompilerScores, k_cItemsPerBitPackNone>(pData);
+               return pObjective->OperatorApplyUpdate<TObjective, bValidation, bWeight, bHessian, gradHessFormat, bDisableApprox, cCompilerScores, k_cItemsPerBitPackNone>(pData);
             } else {
-               return pObjective->OperatorApplyUpdate<TObjective, bValidation, bWeight, bHessian, bDisableApprox, cCompilerScores, k_cItemsPerBitPackDynamic>(pData);
+               return pObjective->OperatorApplyUpdate<TObjective, bValidation, bWeight, bHessian, gradHessFormat, bDisableApprox, cCompilerScores, k_cItemsPerBitPackDynamic>(pData);
             }
          } else {
-            return CountScores<TObjective, bValidation, bWeight, bHessian, bDisableApprox, k_cCompilerScoresMax == cCompilerScores ? k_dynamicScores : cCompilerScores + 1>::Func(pObjective, pData);
+            return CountScores<TObjective, bValidation, bWeight, bHessian, gradHessFormat, bDisableApprox, k_cCompilerScoresMax == cCompilerScores ? k_dynamicScores : cCompilerScores + 1>::Func(pObjective, pData);
          }
       }
    };
-   template<typename TObjective, bool bValidation, bool bWeight, bool bHessian, bool bDisableApprox>
-   struct CountScores<TObjective, bValidation, bWeight, bHessian, bDisableApprox, k_dynamicScores> final {
+   template<typename TObjective, bool bValidation, bool bWeight, bool bHessian, int gradHessFormat, bool bDisableApprox>
+   struct CountScores<TObjective, bValidation, bWeight, bHessian, gradHessFormat, bDisableApprox, k_dynamicScores> final {
       INLINE_ALWAYS static ErrorEbm Func(const Objective * const pObjective, ApplyUpdateBridge * const pData) {
          if(k_cItemsPerBitPackNone == pData->m_cPack) {
-            return pObjective->OperatorApplyUpdate<TObjective, bValidation, bWeight, bHessian, bDisableApprox, k_dynamicScores, k_cItemsPerBitPackNone>(pData);
+            return pObjective->OperatorApplyUpdate<TObjective, bValidation, bWeight, bHessian, gradHessFormat, bDisableApprox, k_dynamicScores, k_cItemsPerBitPackNone>(pData);
          } else {
-            return pObjective->OperatorApplyUpdate<TObjective, bValidation, bWeight, bHessian, bDisableApprox, k_dynamicScores, k_cItemsPerBitPackDynamic>(pData);
+            return pObjective->OperatorApplyUpdate<TObjective, bValidation, bWeight, bHessian, gradHessFormat, bDisableApprox, k_dynamicScores, k_cItemsPerBitPackDynamic>(pData);
          }
       }
    };
             
 
-   template<typename TObjective, bool bValidation, bool bWeight, bool bHessian, bool bDisableApprox, size_t cCompilerScores, typename std::enable_if<!(bDisableApprox || ComputeFlags_Cpu == TObjective::TFloatInternal::k_zone), int>::type = 0>
+   template<typename TObjective, bool bValidation, bool bWeight, bool bHessian, int gradHessFormat, bool bDisableApprox, size_t cCompilerScores, typename std::enable_if<!(bDisableApprox || ComputeFlags_Cpu == TObjective::TFloatInternal::k_zone || IsFusedMetric(bValidation, bWeight)), int>::type = 0>
    INLINE_RELEASE_TEMPLATED ErrorEbm PackApplyUpdate(ApplyUpdateBridge * const pData) const {
       if(k_cItemsPerBitPackNone == pData->m_cPack) {
-         return OperatorApplyUpdate<TObjective, bValidation, bWeight, bHessian, bDisableApprox, cCompilerScores, k_cItemsPerBitPackNone>(pData);
+         return OperatorApplyUpdate<TObjective, bValidation, bWeight, bHessian, gradHessFormat, bDisableApprox, cCompilerScores, k_cItemsPerBitPackNone>(pData);
       } else {
          // TODO: we're not currently getting much benefit from having a compile sized bitpack.  We benefit a little
          //       from having compile time constants as this frees registers.  The big win that we want is to
@@ -296,49 +362,51 @@ private:
          //       number of samples was divisible by the bitpack.  The we can change the code such that the compiler
          //       can optimize away the loop
 
-         return BitPack<TObjective, bValidation, bWeight, bHessian, bDisableApprox, cCompilerScores, GetFirstBitPack<typename TObjective::TFloatInternal::TInt::T>(TObjective::k_cItemsPerBitPackMax, TObjective::k_cItemsPerBitPackMin)>::Func(this, pData);
+         return BitPack<TObjective, bValidation, bWeight, bHessian, gradHessFormat, bDisableApprox, cCompilerScores, GetFirstBitPack<typename TObjective::TFloatInternal::TInt::T>(TObjective::k_cItemsPerBitPackMax, TObjective::k_cItemsPerBitPackMin)>::Func(this, pData);
       }
    }
-   template<typename TObjective, bool bValidation, bool bWeight, bool bHessian, bool bDisableApprox, size_t cCompilerScores, typename std::enable_if<bDisableApprox || ComputeFlags_Cpu == TObjective::TFloatInternal::k_zone, int>::type = 0>
+   template<typename TObjective, bool bValidation, bool bWeight, bool bHessian, int gradHessFormat, bool bDisableApprox, size_t cCompilerScores, typename std::enable_if<bDisableApprox || ComputeFlags_Cpu == TObjective::TFloatInternal::k_zone || IsFusedMetric(bValidation, bWeight), int>::type = 0>
    INLINE_RELEASE_TEMPLATED ErrorEbm PackApplyUpdate(ApplyUpdateBridge * const pData) const {
+      // the training pass that also calculates the metric is only used with aliased validation sets, so 
+      // we use the dynamic bit pack for it instead of doubling the number of compiled bit packs
       if(k_cItemsPerBitPackNone == pData->m_cPack) {
-         return OperatorApplyUpdate<TObjective, bValidation, bWeight, bHessian, bDisableApprox, cCompilerScores, k_cItemsPerBitPackNone>(pData);
+         return OperatorApplyUpdate<TObjective, bValidation, bWeight, bHessian, gradHessFormat, bDisableApprox, cCompilerScores, k_cItemsPerBitPackNone>(pData);
       } else {
-         return OperatorApplyUpdate<TObjective, bValidation, bWeight, bHessian, bDisableApprox, cCompilerScores, k_cItemsPerBitPackDynamic>(pData);
+         return OperatorApplyUpdate<TObjective, bValidation, bWeight, bHessian, gradHessFormat, bDisableApprox, cCompilerScores, k_cItemsPerBitPackDynamic>(pData);
       }
    }
 
 
    // in our current format cCompilerScores will always be 1, but just in case we change our code to allow
    // for special casing multiclass with compile time unrolling of the compiler pack, leave cCompilerScores here
-   template<typename TObjective, bool bValidation, bool bWeight, bool bHessian, bool bDisableApprox, size_t cCompilerScores, int cCompilerPack>
+   template<typename TObjective, bool bValidation, bool bWeight, bool bHessian, int gradHessFormat, bool bDisableApprox, size_t cCompilerScores, int cCompilerPack>
    struct BitPack final {
       INLINE_ALWAYS static ErrorEbm Func(const Objective * const pObjective, ApplyUpdateBridge * const pData) {
          if(cCompilerPack == pData->m_cPack) {
-            return pObjective->OperatorApplyUpdate<TObjective, bValidation, bWeight, bHessian, bDisableApprox, cCompilerScores, cCompilerPack>(pData);
+            return pObjective->OperatorApplyUpdate<TObjective, bValidation, bWeight, bHessian, gradHessFormat, bDisableApprox, cCompilerScores, cCompilerPack>(pData);
          } else {
-            return BitPack<TObjective, bValidation, bWeight, bHessian, bDisableApprox, cCompilerScores, GetNextBitPack<typename TObjective::TFloatInternal::TInt::T>(cCompilerPack, TObjective::k_cItemsPerBitPackMin)>::Func(pObjective, pData);
+            return BitPack<TObjective, bValidation, bWeight, bHessian, gradHessFormat, bDisableApprox, cCompilerScores, GetNextBitPack<typename TObjective::TFloatInternal::TInt::T>(cCompilerPack, TObjective::k_cItemsPerBitPackMin)>::Func(pObjective, pData);
          }
       }
    };
-   template<typename TObjective, bool bValidation, bool bWeight, bool bHessian, bool bDisableApprox, size_t cCompilerScores>
-   struct BitPack<TObjective, bValidation, bWeight, bHessian, bDisableApprox, cCompilerScores, k_cItemsPerBitPackDynamic> final {
+   template<typename TObjective, bool bValidation, bool bWeight, bool bHessian, int gradHessFormat, bool bDisableApprox, size_t cCompilerScores>
+   struct BitPack<TObjective, bValidation, bWeight, bHessian, gradHessFormat, bDisableApprox, cCompilerScores, k_cItemsPerBitPackDynamic> final {
       INLINE_ALWAYS static ErrorEbm Func(const Objective * const pObjective, ApplyUpdateBridge * const pData) {
-         return pObjective->OperatorApplyUpdate<TObjective, bValidation, bWeight, bHessian, bDisableApprox, cCompilerScores, k_cItemsPerBitPackDynamic>(pData);
+         return pObjective->OperatorApplyUpdate<TObjective, bValidation, bWeight, bHessian, gradHessFormat, bDisableApprox, cCompilerScores, k_cItemsPerBitPackDynamic>(pData);
       }
    };
 
 
-   template<typename TObjective, bool bValidation, bool bWeight, bool bHessian, bool bDisableApprox, size_t cCompilerScores, int cCompilerPack>
+   template<typename TObjective, bool bValidation, bool bWeight, bool bHessian, int gradHessFormat, bool bDisableApprox, size_t cCompilerScores, int cCompilerPack>
    INLINE_RELEASE_TEMPLATED ErrorEbm OperatorApplyUpdate(ApplyUpdateBridge * const pData) const {
-      return TObjective::TFloatInternal::template OperatorApplyUpdate<TObjective, bValidation, bWeight, bHessian, bDisableApprox, cCompilerScores, cCompilerPack>(this, pData);
+      return TObjective::TFloatInternal::template OperatorApplyUpdate<TObjective, bValidation, bWeight, bHessian, gradHessFormat, bDisableApprox, cCompilerScores, cCompilerPack>(this, pData);
    }
 
 protected:
 
-   template<typename TObjective, typename TFloat, bool bHessian, typename std::enable_if<bHessian, int>::type = 0>
-   GPU_DEVICE INLINE_ALWAYS typename TFloat::T * HandleGradHess(
-      typename TFloat::T * const pGradientAndHessian,
+   template<typename TObjective, typename TFloat, bool bHessian, int gradHessFormat, typename std::enable_if<bHessian, int>::type = 0>
+   GPU_DEVICE INLINE_ALWAYS GradHessStorage<TFloat, gradHessFormat> * HandleGradHess(
+      GradHessStorage<TFloat, gradHessFormat> * const pGradientAndHessian,
       const TFloat & sampleScore,
       const TFloat & target
    ) const noexcept {
@@ -350,9 +418,9 @@ protected:
       hessian.Store(pGradientAndHessian + TFloat::k_cSIMDPack);
       return pGradientAndHessian + (TFloat::k_cSIMDPack + TFloat::k_cSIMDPack);
    }
-   template<typename TObjective, typename TFloat, bool bHessian, typename std::enable_if<!bHessian, int>::type = 0>
-   GPU_DEVICE INLINE_ALWAYS typename TFloat::T * HandleGradHess(
-      typename TFloat::T * const pGradientAndHessian, 
+   template<typename TObjective, typename TFloat, bool bHessian, int gradHessFormat, typename std::enable_if<!bHessian, int>::type = 0>
+   GPU_DEVICE INLINE_ALWAYS GradHessStorage<TFloat, gradHessFormat> * HandleGradHess(
+      GradHessStorage<TFloat, gradHessFormat> * const pGradientAndHessian, 
       const TFloat & sampleScore, 
       const TFloat & target
    ) const noexcept {
@@ -362,20 +430,23 @@ protected:
       return pGradientAndHessian + TFloat::k_cSIMDPack;
    }
 
-   template<typename TObjective, bool bValidation, bool bWeight, bool bHessian, bool bDisableApprox, size_t cCompilerScores, int cCompilerPack>
+   template<typename TObjective, bool bValidation, bool bWeight, bool bHessian, int gradHessFormat, bool bDisableApprox, size_t cCompilerScores, int cCompilerPack>
    GPU_DEVICE NEVER_INLINE void ChildApplyUpdate(ApplyUpdateBridge * const pData) const {
       using TFloat = typename TObjective::TFloatInternal;
       const TObjective * const pObjective = static_cast<const TObjective *>(this);
 
       static_assert(k_oneScore == cCompilerScores, "We special case the classifiers so do not need to handle them");
       static_assert(!bValidation || !bHessian, "bHessian can only be true if bValidation is false");
-      static_assert(bValidation || !bWeight, "bWeight can only be true if bValidation is true");
+      static_assert(bHessian || k_gradHessFloat == gradHessFormat, "compact gradients require bHessian");
 
+      // see IsFusedMetric for when training calculates the metric
+      static constexpr bool bMetric = bValidation || bWeight;
       static constexpr bool bCompilerZeroDimensional = k_cItemsPerBitPackNone == cCompilerPack;
 
 #ifndef GPU_COMPILE
       EBM_ASSERT(nullptr != pData);
       EBM_ASSERT(nullptr != pData->m_aUpdateTensorScores);
+      EBM_ASSERT(1 <= pData->m_cTensorBins);
       EBM_ASSERT(1 <= pData->m_cSamples);
       EBM_ASSERT(0 == pData->m_cSamples % size_t { TFloat::k_cSIMDPack });
       EBM_ASSERT(nullptr != pData->m_aSampleScores);
@@ -384,6 +455,7 @@ protected:
 #endif // GPU_COMPILE
 
       const typename TFloat::T * const aUpdateTensorScores = reinterpret_cast<const typename TFloat::T *>(pData->m_aUpdateTensorScores);
+      const UpdateTensorLookup<TFloat> updateTensor(aUpdateTensorScores, pData->m_cTensorBins);
 
       const size_t cSamples = pData->m_cSamples;
 
@@ -427,10 +499,10 @@ protected:
 
       const typename TFloat::T * pTargetData = reinterpret_cast<const typename TFloat::T *>(pData->m_aTargets);
 
-      typename TFloat::T * pGradientAndHessian;
+      GradHessStorage<TFloat, gradHessFormat> * pGradientAndHessian;
       const typename TFloat::T * pWeight;
       TFloat metricSum;
-      if(bValidation) {
+      if(bMetric) {
          if(bWeight) {
             pWeight = reinterpret_cast<const typename TFloat::T *>(pData->m_aWeights);
 #ifndef GPU_COMPILE
@@ -438,8 +510,9 @@ protected:
 #endif // GPU_COMPILE
          }
          metricSum = 0.0;
-      } else {
-         pGradientAndHessian = reinterpret_cast<typename TFloat::T *>(pData->m_aGradientsAndHessians);
+      }
+      if(!bValidation) {
+         pGradientAndHessian = reinterpret_cast<GradHessStorage<TFloat, gradHessFormat> *>(pData->m_aGradientsAndHessians);
 #ifndef GPU_COMPILE
          EBM_ASSERT(nullptr != pGradientAndHessian);
 #endif // GPU_COMPILE
@@ -462,7 +535,7 @@ protected:
          while(true) {
             if(!bCompilerZeroDimensional) {
                const typename TFloat::TInt iTensorBin = (iTensorBinCombined >> cShift) & maskBits;
-               updateScore = TFloat::Load(aUpdateTensorScores, iTensorBin);
+               updateScore = updateTensor.Load(iTensorBin);
             }
 
             const TFloat target = TFloat::Load(pTargetData);
@@ -473,7 +546,7 @@ protected:
             sampleScore.Store(pSampleScore);
             pSampleScore += TFloat::k_cSIMDPack;
 
-            if(bValidation) {
+            if(bMetric) {
                TFloat metric = pObjective->CalcMetric(sampleScore, target);
                if(bWeight) {
                   const TFloat weight = TFloat::Load(pWeight);
@@ -482,8 +555,9 @@ protected:
                } else {
                   metricSum += metric;
                }
-            } else {
-               pGradientAndHessian = HandleGradHess<TObjective, TFloat, bHessian>(pGradientAndHessian, sampleScore, target);
+            }
+            if(!bValidation) {
+               pGradientAndHessian = HandleGradHess<TObjective, TFloat, bHessian, gradHessFormat>(pGradientAndHessian, sampleScore, target);
             }
 
             if(bCompilerZeroDimensional) {
@@ -503,7 +577,7 @@ protected:
          cShift = cShiftReset;
       } while(pSampleScoresEnd != pSampleScore);
 
-      if(bValidation) {
+      if(bMetric) {
          pData->m_metricOut = static_cast<double>(Sum(metricSum));
       }
    }
@@ -654,7 +728,7 @@ public:
       EBM_ASSERT(sObjective < sObjectiveEnd); // empty string not allowed
       EBM_ASSERT('\0' != *sObjective);
       EBM_ASSERT(!(0x20 == *sObjective || (0x9 <= *sObjective && *sObjective <= 0xd)));
-      EBM_ASSERT('\0' == *sObjectiveEnd);
+      EBM_ASSERT('\0' == *sObjectiveEnd || k_registrationSeparator == *sObjectiveEnd); // metrics can follow
       EBM_ASSERT(nullptr != pObjectiveWrapperOut);
       EBM_ASSERT(nullptr == pObjectiveWrapperOut->m_pObjective);
       EBM_ASSERT(nullptr != pObjectiveWrapperOut->m_pFunctionPointersCpp);
@@ -846,10 +920,10 @@ protected:
 
 #define OBJECTIVE_TEMPLATE_BOILERPLATE \
    public: \
-      template<bool bValidation, bool bWeight, bool bHessian, bool bDisableApprox, size_t cCompilerScores, int cCompilerPack> \
+      template<bool bValidation, bool bWeight, bool bHessian, int gradHessFormat, bool bDisableApprox, size_t cCompilerScores, int cCompilerPack> \
       GPU_DEVICE void InjectedApplyUpdate(ApplyUpdateBridge * const pData) const { \
          Objective::ChildApplyUpdate<typename std::remove_pointer<decltype(this)>::type, \
-            bValidation, bWeight, bHessian, bDisableApprox, cCompilerScores, cCompilerPack>(pData); \
+            bValidation, bWeight, bHessian, gradHessFormat, bDisableApprox, cCompilerScores, cCompilerPack>(pData); \
       }
 
 #define OBJECTIVE_BOILERPLATE(__EBM_TYPE, __MAXIMIZE_METRIC, __LINK_FUNCTION) \
@@ -68,6 +68,29 @@ struct alignas(k_cAlignment) Avx2_32_Int final {
       return Avx2_32_Int(_mm256_cvtepu8_epi32(_mm_loadu_si64(a)));
    }
 
+   inline static Avx2_32_Int Load(const T * const a, const Avx2_32_Int & i) noexcept {
+      // i is treated as signed, so we should only use the lower 31 bits otherwise we'll read from memory before a
+      return Avx2_32_Int(_mm256_i32gather_epi32(reinterpret_cast<const int *>(a), i.m_data, sizeof(a[0])));
+   }
+
+   inline void Store(T * const a, const Avx2_32_Int & i) const noexcept {
+      // AVX2 has no scatter instruction
+      alignas(k_cAlignment) T ints[k_cSIMDPack];
+      alignas(k_cAlignment) T vals[k_cSIMDPack];
+
+      i.Store(ints);
+      Store(vals);
+
+      a[ints[0]] = vals[0];
+      a[ints[1]] = vals[1];
+      a[ints[2]] = vals[2];
+      a[ints[3]] = vals[3];
+      a[ints[4]] = vals[4];
+      a[ints[5]] = vals[5];
+      a[ints[6]] = vals[6];
+      a[ints[7]] = vals[7];
+   }
+
    template<typename TFunc>
    static inline void Execute(const TFunc & func, const Avx2_32_Int & val0) noexcept {
       alignas(k_cAlignment) T a0[k_cSIMDPack];
@@ -108,6 +131,15 @@ struct alignas(k_cAlignment) Avx2_32_Int final {
       return Avx2_32_Int(_mm256_and_si256(m_data, other.m_data));
    }
 
+   friend inline T Sum(const Avx2_32_Int & val) noexcept {
+      const __m128i vlow = _mm256_castsi256_si128(val.m_data);
+      const __m128i vhigh = _mm256_extracti128_si256(val.m_data, 1);
+      const __m128i sum = _mm_add_epi32(vlow, vhigh);
+      const __m128i sum1 = _mm_hadd_epi32(sum, sum);
+      const __m128i sum2 = _mm_hadd_epi32(sum1, sum1);
+      return static_cast<T>(_mm_cvtsi128_si32(sum2));
+   }
+
 private:
    inline Avx2_32_Int(const TPack & data) noexcept : m_data(data) {
    }
@@ -127,6 +159,8 @@ struct alignas(k_cAlignment) Avx2_32_Float final {
    static constexpr ComputeFlags k_zone = TInt::k_zone;
    static constexpr int k_cSIMDShift = TInt::k_cSIMDShift;
    static constexpr int k_cSIMDPack = TInt::k_cSIMDPack;
+   static constexpr bool k_bConflictDetect = false;
+   static constexpr size_t k_cTableItemsMax = 8; // one register can hold a lookup table of this many items
 
    ATTRIBUTE_WARNING_DISABLE_UNINITIALIZED_MEMBER
    inline Avx2_32_Float() noexcept {
@@ -234,6 +268,18 @@ struct alignas(k_cAlignment) Avx2_32_Float final {
       return Avx2_32_Float(_mm256_i32gather_ps(a, i.m_data, sizeof(a[0])));
    }
 
+   inline static Avx2_32_Float LoadTable(const T * const a, const size_t c) noexcept {
+      // loads the c items of a into the lower lanes without reading past the end of a
+      EBM_ASSERT(1 <= c && c <= k_cTableItemsMax);
+      const __m256i mask = _mm256_cmpgt_epi32(_mm256_set1_epi32(static_cast<int>(c)), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+      return Avx2_32_Float(_mm256_maskload_ps(a, mask));
+   }
+
+   inline Avx2_32_Float Lookup(const TInt & i) const noexcept {
+      // the same result as Load(a, i) when this was made by LoadTable(a, c), but without going to memory
+      return Avx2_32_Float(_mm256_permutevar8x32_ps(m_data, i.m_data));
+   }
+
    inline void Store(T * const a, const TInt & i) const noexcept {
       alignas(k_cAlignment) TInt::T ints[k_cSIMDPack];
       alignas(k_cAlignment) T floats[k_cSIMDPack];
@@ -251,6 +297,47 @@ struct alignas(k_cAlignment) Avx2_32_Float final {
       a[ints[7]] = floats[7];
    }
 
+   inline static Avx2_32_Float Load(const Bfloat16 * const a) noexcept {
+      // widening a bfloat16 is a shift into the upper half of the float
+      const __m256i bits = _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(a)));
+      return Avx2_32_Float(_mm256_castsi256_ps(_mm256_slli_epi32(bits, 16)));
+   }
+
+   inline void Store(Bfloat16 * const a) const noexcept {
+      // round to nearest even like FloatToBfloat16, and set the quiet bit of NaN values so they stay NaN
+      const __m256i bits = _mm256_castps_si256(m_data);
+      const __m256i lowest = _mm256_and_si256(_mm256_srli_epi32(bits, 16), _mm256_set1_epi32(1));
+      const __m256i rounded = _mm256_add_epi32(bits, _mm256_add_epi32(_mm256_set1_epi32(0x7FFF), lowest));
+      const __m256i quiet = _mm256_or_si256(bits, _mm256_set1_epi32(0x00400000));
+      const __m256i isNaN = _mm256_castps_si256(_mm256_cmp_ps(m_data, m_data, _CMP_UNORD_Q));
+      const __m256i high = _mm256_srli_epi32(_mm256_blendv_epi8(rounded, quiet, isNaN), 16);
+      // packus works within each 128 bit lane, so gather the two lower 64 bit halves together afterwards
+      const __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi32(high, high), 0x08);
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(a), _mm256_castsi256_si128(packed));
+   }
+
+   inline static Avx2_32_Float Load(const Bfloat16 * const a, const TInt & i) noexcept {
+      alignas(k_cAlignment) TInt::T ints[k_cSIMDPack];
+      alignas(k_cAlignment) T floats[k_cSIMDPack];
+
+      i.Store(ints);
+      for(int iLane = 0; iLane < k_cSIMDPack; ++iLane) {
+         floats[iLane] = Bfloat16ToFloat(a[ints[iLane]]);
+      }
+      return Load(floats);
+   }
+
+   inline void Store(Bfloat16 * const a, const TInt & i) const noexcept {
+      alignas(k_cAlignment) TInt::T ints[k_cSIMDPack];
+      alignas(k_cAlignment) T floats[k_cSIMDPack];
+
+      i.Store(ints);
+      Store(floats);
+      for(int iLane = 0; iLane < k_cSIMDPack; ++iLane) {
+         a[ints[iLane]] = FloatToBfloat16(floats[iLane]);
+      }
+   }
+
    template<typename TFunc>
    friend inline Avx2_32_Float ApplyFunc(const TFunc & func, const Avx2_32_Float & val) noexcept {
       alignas(k_cAlignment) T aTemp[k_cSIMDPack];
@@ -618,16 +705,23 @@ struct alignas(k_cAlignment) Avx2_32_Float final {
    }
 
 
-   template<typename TObjective, bool bValidation, bool bWeight, bool bHessian, bool bDisableApprox, size_t cCompilerScores, int cCompilerPack>
+   template<typename TObjective, bool bValidation, bool bWeight, bool bHessian, int gradHessFormat, bool bDisableApprox, size_t cCompilerScores, int cCompilerPack>
    INLINE_RELEASE_TEMPLATED static ErrorEbm OperatorApplyUpdate(const Objective * const pObjective, ApplyUpdateBridge * const pData) noexcept {
-      RemoteApplyUpdate<TObjective, bValidation, bWeight, bHessian, bDisableApprox, cCompilerScores, cCompilerPack>(pObjective, pData);
+      RemoteApplyUpdate<TObjective, bValidation, bWeight, bHessian, gradHessFormat, bDisableApprox, cCompilerScores, cCompilerPack>(pObjective, pData);
       return Error_None;
    }
 
 
-   template<bool bHessian, bool bWeight, bool bReplication, size_t cCompilerScores, int cCompilerPack>
+   template<bool bHessian, int gradHessFormat, bool bWeight, bool bReplication, size_t cCompilerScores, int cCompilerPack>
    INLINE_RELEASE_TEMPLATED static ErrorEbm OperatorBinSumsBoosting(BinSumsBoostingBridge * const pParams) noexcept {
-      RemoteBinSumsBoosting<Avx2_32_Float, bHessian, bWeight, bReplication, cCompilerScores, cCompilerPack>(pParams);
+      RemoteBinSumsBoosting<Avx2_32_Float, bHessian, gradHessFormat, bWeight, bReplication, cCompilerScores, cCompilerPack>(pParams);
+      return Error_None;
+   }
+
+
+   template<bool bHessian, int gradHessFormat, bool bWeight, bool bReplication, size_t cCompilerScores>
+   INLINE_RELEASE_TEMPLATED static ErrorEbm OperatorBinSumsBoostingMulti(BinSumsBoostingMultiBridge * const pParams) noexcept {
+      RemoteBinSumsBoostingMulti<Avx2_32_Float, bHessian, gradHessFormat, bWeight, bReplication, cCompilerScores>(pParams);
       return Error_None;
    }
 
@@ -686,6 +780,27 @@ INTERNAL_IMPORT_EXPORT_BODY ErrorEbm BinSumsBoosting_Avx2_32(
    return (*pBinSumsBoostingCpp)(pParams);
 }
 
+INTERNAL_IMPORT_EXPORT_BODY ErrorEbm BinSumsBoostingMulti_Avx2_32(
+   const ObjectiveWrapper * const pObjectiveWrapper,
+   BinSumsBoostingMultiBridge * const pParams
+) {
+   const BIN_SUMS_BOOSTING_MULTI_CPP pBinSumsBoostingMultiCpp =
+      (static_cast<FunctionPointersCpp *>(pObjectiveWrapper->m_pFunctionPointersCpp))->m_pBinSumsBoostingMultiCpp;
+
+#ifndef NDEBUG
+   // all our memory should be aligned. It is required by SIMD for correctness or performance
+   EBM_ASSERT(IsAligned(pParams->m_aGradientsAndHessians));
+   EBM_ASSERT(IsAligned(pParams->m_aWeights));
+   EBM_ASSERT(IsAligned(pParams->m_pCountOccurrences));
+   for(size_t iDebug = 0; iDebug < pParams->m_cTerms; ++iDebug) {
+      EBM_ASSERT(IsAligned(pParams->m_aaPacked[iDebug]));
+      EBM_ASSERT(IsAligned(pParams->m_aaFastBins[iDebug]));
+   }
+#endif // NDEBUG
+
+   return (*pBinSumsBoostingMultiCpp)(pParams);
+}
+
 INTERNAL_IMPORT_EXPORT_BODY ErrorEbm BinSumsInteraction_Avx2_32(
    const ObjectiveWrapper * const pObjectiveWrapper,
    BinSumsInteractionBridge * const pParams
@@ -714,6 +829,7 @@ INTERNAL_IMPORT_EXPORT_BODY ErrorEbm CreateObjective_Avx2_32(
 ) {
    pObjectiveWrapperOut->m_pApplyUpdateC = ApplyUpdate_Avx2_32;
    pObjectiveWrapperOut->m_pBinSumsBoostingC = BinSumsBoosting_Avx2_32;
+   pObjectiveWrapperOut->m_pBinSumsBoostingMultiC = BinSumsBoostingMulti_Avx2_32;
    pObjectiveWrapperOut->m_pBinSumsInteractionC = BinSumsInteraction_Avx2_32;
    ErrorEbm error = ComputeWrapper<Avx2_32_Float>::FillWrapper(pObjectiveWrapperOut);
    if(Error_None != error) {
@@ -0,0 +1,777 @@
+// Copyright (c) 2023 The InterpretML Contributors
+// Licensed under the MIT license.
+// Author: Paul Koch <code@koch.ninja>
+
+#define _CRT_SECURE_NO_DEPRECATE
+
+#include <string.h> // memcpy
+#include <cmath> // exp, log
+#include <limits> // numeric_limits
+#include <type_traits> // is_unsigned
+#include <immintrin.h> // SIMD.  Do not include in pch.hpp!
+
+#include "libebm.h"
+#include "logging.h"
+#include "unzoned.h"
+
+#include "zones.h"
+#include "bridge.h"
+#include "common.hpp"
+#include "bridge.hpp"
+
+#include "Registration.hpp"
+#include "Objective.hpp"
+
+#include "approximate_math.hpp"
+#include "compute_wrapper.hpp"
+
+namespace DEFINED_ZONE_NAME {
+#ifndef DEFINED_ZONE_NAME
+#error DEFINED_ZONE_NAME must be defined
+#endif // DEFINED_ZONE_NAME
+
+// this is super-special and included inside the zone namespace
+#include "objective_registrations.hpp"
+
+
+static constexpr size_t k_cAlignment = 32;
+
+struct alignas(k_cAlignment) Avx2_64_Float;
+
+struct alignas(k_cAlignment) Avx2_64_Int final {
+   friend Avx2_64_Float;
+   friend inline Avx2_64_Float IfEqual(const Avx2_64_Int & cmp1, const Avx2_64_Int & cmp2, const Avx2_64_Float & trueVal, const Avx2_64_Float & falseVal) noexcept;
+
+   using T = uint64_t;
+   using TPack = __m256i;
+   static_assert(std::is_unsigned<T>::value, "T must be an unsigned integer type");
+   static_assert(std::is_same<UIntBig, T>::value || std::is_same<UIntSmall, T>::value, 
+      "T must be either UIntBig or UIntSmall");
+   static constexpr ComputeFlags k_zone = ComputeFlags_AVX2_64;
+   static constexpr int k_cSIMDShift = 2;
+   static constexpr int k_cSIMDPack = 1 << k_cSIMDShift;
+
+   ATTRIBUTE_WARNING_DISABLE_UNINITIALIZED_MEMBER
+   inline Avx2_64_Int() noexcept {
+   }
+
+   inline Avx2_64_Int(const T & val) noexcept : m_data(_mm256_set1_epi64x(static_cast<long long>(val))) {
+   }
+
+   inline static Avx2_64_Int Load(const T * const a) noexcept {
+      return Avx2_64_Int(_mm256_load_si256(reinterpret_cast<const TPack *>(a)));
+   }
+
+   inline void Store(T * const a) const noexcept {
+      _mm256_store_si256(reinterpret_cast<TPack *>(a), m_data);
+   }
+
+   inline static Avx2_64_Int LoadBytes(const uint8_t * const a) noexcept {
+      int32_t bytes;
+      memcpy(&bytes, a, sizeof(bytes));
+      return Avx2_64_Int(_mm256_cvtepu8_epi64(_mm_cvtsi32_si128(bytes)));
+   }
+
+   inline static Avx2_64_Int Load(const T * const a, const Avx2_64_Int & i) noexcept {
+      // i is treated as signed, so we should only use the lower 63 bits otherwise we'll read from memory before a
+      return Avx2_64_Int(_mm256_i64gather_epi64(reinterpret_cast<const long long *>(a), i.m_data, sizeof(a[0])));
+   }
+
+   inline void Store(T * const a, const Avx2_64_Int & i) const noexcept {
+      // AVX2 has no scatter instruction
+      alignas(k_cAlignment) T ints[k_cSIMDPack];
+      alignas(k_cAlignment) T vals[k_cSIMDPack];
+
+      i.Store(ints);
+      Store(vals);
+
+      a[ints[0]] = vals[0];
+      a[ints[1]] = vals[1];
+      a[ints[2]] = vals[2];
+      a[ints[3]] = vals[3];
+   }
+
+   template<typename TFunc>
+   static inline void Execute(const TFunc & func, const Avx2_64_Int & val0) noexcept {
+      alignas(k_cAlignment) T a0[k_cSIMDPack];
+      val0.Store(a0);
+
+      // no loops because this will disable optimizations for loops in the caller
+      func(0, a0[0]);
+      func(1, a0[1]);
+      func(2, a0[2]);
+      func(3, a0[3]);
+   }
+
+   inline static Avx2_64_Int MakeIndexes() noexcept {
+      return Avx2_64_Int(_mm256_set_epi64x(3, 2, 1, 0));
+   }
+
+   inline Avx2_64_Int operator+ (const Avx2_64_Int & other) const noexcept {
+      return Avx2_64_Int(_mm256_add_epi64(m_data, other.m_data));
+   }
+
+   inline Avx2_64_Int operator* (const T & other) const noexcept {
+      // AVX2 has no 64 bit multiply, so build it from 32x32->64 bit multiplies.  The high*high product only
+      // contributes to bits above 64, so we can drop it
+      const __m256i mul = _mm256_set1_epi64x(static_cast<long long>(other));
+      const __m256i lowLow = _mm256_mul_epu32(m_data, mul);
+      const __m256i highLow = _mm256_mul_epu32(_mm256_srli_epi64(m_data, 32), mul);
+      const __m256i lowHigh = _mm256_mul_epu32(m_data, _mm256_srli_epi64(mul, 32));
+      return Avx2_64_Int(_mm256_add_epi64(lowLow, _mm256_slli_epi64(_mm256_add_epi64(highLow, lowHigh), 32)));
+   }
+
+   inline Avx2_64_Int operator>> (int shift) const noexcept {
+      return Avx2_64_Int(_mm256_srli_epi64(m_data, shift));
+   }
+
+   inline Avx2_64_Int operator<< (int shift) const noexcept {
+      return Avx2_64_Int(_mm256_slli_epi64(m_data, shift));
+   }
+
+   inline Avx2_64_Int operator& (const Avx2_64_Int & other) const noexcept {
+      return Avx2_64_Int(_mm256_and_si256(m_data, other.m_data));
+   }
+
+   friend inline T Sum(const Avx2_64_Int & val) noexcept {
+      // _mm_cvtsi128_si64 is not available in 32 bit builds, so sum the lanes from memory
+      alignas(k_cAlignment) T a[k_cSIMDPack];
+      val.Store(a);
+      return a[0] + a[1] + a[2] + a[3];
+   }
+
+private:
+   inline Avx2_64_Int(const TPack & data) noexcept : m_data(data) {
+   }
+
+   TPack m_data;
+};
+static_assert(std::is_standard_layout<Avx2_64_Int>::value && std::is_trivially_copyable<Avx2_64_Int>::value,
+   "This allows offsetof, memcpy, memset, inter-language, GPU and cross-machine use where needed");
+
+
+struct alignas(k_cAlignment) Avx2_64_Float final {
+   using T = double;
+   using TPack = __m256d;
+   using TInt = Avx2_64_Int;
+   static_assert(std::is_same<FloatBig, T>::value || std::is_same<FloatSmall, T>::value,
+      "T must be either FloatBig or FloatSmall");
+   static constexpr ComputeFlags k_zone = TInt::k_zone;
+   static constexpr int k_cSIMDShift = TInt::k_cSIMDShift;
+   static constexpr int k_cSIMDPack = TInt::k_cSIMDPack;
+   static constexpr bool k_bConflictDetect = false;
+   static constexpr size_t k_cTableItemsMax = 0;
+
+   ATTRIBUTE_WARNING_DISABLE_UNINITIALIZED_MEMBER
+   inline Avx2_64_Float() noexcept {
+   }
+
+   inline Avx2_64_Float(const double val) noexcept : m_data(_mm256_set1_pd(static_cast<T>(val))) {
+   }
+   inline Avx2_64_Float(const float val) noexcept : m_data(_mm256_set1_pd(static_cast<T>(val))) {
+   }
+   inline Avx2_64_Float(const int val) noexcept : m_data(_mm256_set1_pd(static_cast<T>(val))) {
+   }
+
+
+   inline Avx2_64_Float operator+() const noexcept {
+      return *this;
+   }
+
+   inline Avx2_64_Float operator-() const noexcept {
+      return Avx2_64_Float(_mm256_xor_pd(m_data, _mm256_set1_pd(-0.0)));
+   }
+
+
+   inline Avx2_64_Float operator+ (const Avx2_64_Float & other) const noexcept {
+      return Avx2_64_Float(_mm256_add_pd(m_data, other.m_data));
+   }
+
+   inline Avx2_64_Float operator- (const Avx2_64_Float & other) const noexcept {
+      return Avx2_64_Float(_mm256_sub_pd(m_data, other.m_data));
+   }
+
+   inline Avx2_64_Float operator* (const Avx2_64_Float & other) const noexcept {
+      return Avx2_64_Float(_mm256_mul_pd(m_data, other.m_data));
+   }
+
+   inline Avx2_64_Float operator/ (const Avx2_64_Float & other) const noexcept {
+      return Avx2_64_Float(_mm256_div_pd(m_data, other.m_data));
+   }
+
+
+   inline Avx2_64_Float & operator+= (const Avx2_64_Float & other) noexcept {
+      *this = (*this) + other;
+      return *this;
+   }
+
+   inline Avx2_64_Float & operator-= (const Avx2_64_Float & other) noexcept {
+      *this = (*this) - other;
+      return *this;
+   }
+
+   inline Avx2_64_Float & operator*= (const Avx2_64_Float & other) noexcept {
+      *this = (*this) * other;
+      return *this;
+   }
+
+   inline Avx2_64_Float & operator/= (const Avx2_64_Float & other) noexcept {
+      *this = (*this) / other;
+      return *this;
+   }
+
+
+   friend inline Avx2_64_Float operator+ (const double val, const Avx2_64_Float & other) noexcept {
+      return Avx2_64_Float(val) + other;
+   }
+
+   friend inline Avx2_64_Float operator- (const double val, const Avx2_64_Float & other) noexcept {
+      return Avx2_64_Float(val) - other;
+   }
+
+   friend inline Avx2_64_Float operator* (const double val, const Avx2_64_Float & other) noexcept {
+      return Avx2_64_Float(val) * other;
+   }
+
+   friend inline Avx2_64_Float operator/ (const double val, const Avx2_64_Float & other) noexcept {
+      return Avx2_64_Float(val) / other;
+   }
+
+
+   friend inline Avx2_64_Float operator+ (const float val, const Avx2_64_Float & other) noexcept {
+      return Avx2_64_Float(val) + other;
+   }
+
+   friend inline Avx2_64_Float operator- (const float val, const Avx2_64_Float & other) noexcept {
+      return Avx2_64_Float(val) - other;
+   }
+
+   friend inline Avx2_64_Float operator* (const float val, const Avx2_64_Float & other) noexcept {
+      return Avx2_64_Float(val) * other;
+   }
+
+   friend inline Avx2_64_Float operator/ (const float val, const Avx2_64_Float & other) noexcept {
+      return Avx2_64_Float(val) / other;
+   }
+
+
+   inline static Avx2_64_Float Load(const T * const a) noexcept {
+      return Avx2_64_Float(_mm256_load_pd(a));
+   }
+
+   inline void Store(T * const a) const noexcept {
+      _mm256_store_pd(a, m_data);
+   }
+
+   inline static Avx2_64_Float Load(const T * const a, const TInt & i) noexcept {
+      // i is treated as signed, so we should only use the lower 63 bits otherwise we'll read from memory before a
+      return Avx2_64_Float(_mm256_i64gather_pd(a, i.m_data, sizeof(a[0])));
+   }
+
+   inline void Store(T * const a, const TInt & i) const noexcept {
+      alignas(k_cAlignment) TInt::T ints[k_cSIMDPack];
+      alignas(k_cAlignment) T floats[k_cSIMDPack];
+
+      i.Store(ints);
+      Store(floats);
+
+      a[ints[0]] = floats[0];
+      a[ints[1]] = floats[1];
+      a[ints[2]] = floats[2];
+      a[ints[3]] = floats[3];
+   }
+
+   inline static Avx2_64_Float Load(const Bfloat16 * const a) noexcept {
+      // widening a bfloat16 is a shift into the upper half of a float, which then widens exactly to a double
+      const __m128i bits = _mm_cvtepu16_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(a)));
+      return Avx2_64_Float(_mm256_cvtps_pd(_mm_castsi128_ps(_mm_slli_epi32(bits, 16))));
+   }
+
+   inline void Store(Bfloat16 * const a) const noexcept {
+      // narrow to float first like the Cpu_64 zone does, then round to nearest even like FloatToBfloat16 and 
+      // set the quiet bit of NaN values so they stay NaN
+      const __m128 narrowed = _mm256_cvtpd_ps(m_data);
+      const __m128i bits = _mm_castps_si128(narrowed);
+      const __m128i lowest = _mm_and_si128(_mm_srli_epi32(bits, 16), _mm_set1_epi32(1));
+      const __m128i rounded = _mm_add_epi32(bits, _mm_add_epi32(_mm_set1_epi32(0x7FFF), lowest));
+      const __m128i quiet = _mm_or_si128(bits, _mm_set1_epi32(0x00400000));
+      const __m128i isNaN = _mm_castps_si128(_mm_cmpunord_ps(narrowed, narrowed));
+      const __m128i high = _mm_srli_epi32(_mm_blendv_epi8(rounded, quiet, isNaN), 16);
+      _mm_storel_epi64(reinterpret_cast<__m128i *>(a), _mm_packus_epi32(high, high));
+   }
+
+   inline static Avx2_64_Float Load(const Bfloat16 * const a, const TInt & i) noexcept {
+      alignas(k_cAlignment) TInt::T ints[k_cSIMDPack];
+      alignas(k_cAlignment) T floats[k_cSIMDPack];
+
+      i.Store(ints);
+      for(int iLane = 0; iLane < k_cSIMDPack; ++iLane) {
+         floats[iLane] = static_cast<T>(Bfloat16ToFloat(a[ints[iLane]]));
+      }
+      return Load(floats);
+   }
+
+   inline void Store(Bfloat16 * const a, const TInt & i) const noexcept {
+      alignas(k_cAlignment) TInt::T ints[k_cSIMDPack];
+      alignas(k_cAlignment) T floats[k_cSIMDPack];
+
+      i.Store(ints);
+      Store(floats);
+      for(int iLane = 0; iLane < k_cSIMDPack; ++iLane) {
+         a[ints[iLane]] = FloatToBfloat16(static_cast<float>(floats[iLane]));
+      }
+   }
+
+   template<typename TFunc>
+   friend inline Avx2_64_Float ApplyFunc(const TFunc & func, const Avx2_64_Float & val) noexcept {
+      alignas(k_cAlignment) T aTemp[k_cSIMDPack];
+      val.Store(aTemp);
+
+      aTemp[0] = func(aTemp[0]);
+      aTemp[1] = func(aTemp[1]);
+      aTemp[2] = func(aTemp[2]);
+      aTemp[3] = func(aTemp[3]);
+
+      return Load(aTemp);
+   }
+
+   template<typename TFunc>
+   static inline void Execute(const TFunc & func) noexcept {
+      func(0);
+      func(1);
+      func(2);
+      func(3);
+   }
+
+   template<typename TFunc>
+   static inline void Execute(const TFunc & func, const Avx2_64_Float & val0) noexcept {
+      alignas(k_cAlignment) T a0[k_cSIMDPack];
+      val0.Store(a0);
+
+      func(0, a0[0]);
+      func(1, a0[1]);
+      func(2, a0[2]);
+      func(3, a0[3]);
+   }
+
+   template<typename TFunc>
+   static inline void Execute(const TFunc & func, const Avx2_64_Float & val0, const Avx2_64_Float & val1) noexcept {
+      alignas(k_cAlignment) T a0[k_cSIMDPack];
+      val0.Store(a0);
+      alignas(k_cAlignment) T a1[k_cSIMDPack];
+      val1.Store(a1);
+
+      func(0, a0[0], a1[0]);
+      func(1, a0[1], a1[1]);
+      func(2, a0[2], a1[2]);
+      func(3, a0[3], a1[3]);
+   }
+
+   template<typename TFunc>
+   static inline void Execute(const TFunc & func, const Avx2_64_Int & val0, const Avx2_64_Float & val1) noexcept {
+      alignas(k_cAlignment) TInt::T a0[k_cSIMDPack];
+      val0.Store(a0);
+      alignas(k_cAlignment) T a1[k_cSIMDPack];
+      val1.Store(a1);
+
+      func(0, a0[0], a1[0]);
+      func(1, a0[1], a1[1]);
+      func(2, a0[2], a1[2]);
+      func(3, a0[3], a1[3]);
+   }
+
+   template<typename TFunc>
+   static inline void Execute(const TFunc & func, const Avx2_64_Int & val0, const Avx2_64_Float & val1, const Avx2_64_Float & val2) noexcept {
+      alignas(k_cAlignment) TInt::T a0[k_cSIMDPack];
+      val0.Store(a0);
+      alignas(k_cAlignment) T a1[k_cSIMDPack];
+      val1.Store(a1);
+      alignas(k_cAlignment) T a2[k_cSIMDPack];
+      val2.Store(a2);
+
+      func(0, a0[0], a1[0], a2[0]);
+      func(1, a0[1], a1[1], a2[1]);
+      func(2, a0[2], a1[2], a2[2]);
+      func(3, a0[3], a1[3], a2[3]);
+   }
+
+   template<typename TFunc>
+   static inline void Execute(const TFunc & func, const Avx2_64_Int & val0, const Avx2_64_Float & val1, const Avx2_64_Float & val2, const Avx2_64_Float & val3) noexcept {
+      alignas(k_cAlignment) TInt::T a0[k_cSIMDPack];
+      val0.Store(a0);
+      alignas(k_cAlignment) T a1[k_cSIMDPack];
+      val1.Store(a1);
+      alignas(k_cAlignment) T a2[k_cSIMDPack];
+      val2.Store(a2);
+      alignas(k_cAlignment) T a3[k_cSIMDPack];
+      val3.Store(a3);
+
+      func(0, a0[0], a1[0], a2[0], a3[0]);
+      func(1, a0[1], a1[1], a2[1], a3[1]);
+      func(2, a0[2], a1[2], a2[2], a3[2]);
+      func(3, a0[3], a1[3], a2[3], a3[3]);
+   }
+
+   template<typename TFunc>
+   static inline void Execute(const TFunc & func, const Avx2_64_Int & val0, const Avx2_64_Int & val1, const Avx2_64_Float & val2, const Avx2_64_Float & val3) noexcept {
+      alignas(k_cAlignment) TInt::T a0[k_cSIMDPack];
+      val0.Store(a0);
+      alignas(k_cAlignment) TInt::T a1[k_cSIMDPack];
+      val1.Store(a1);
+      alignas(k_cAlignment) T a2[k_cSIMDPack];
+      val2.Store(a2);
+      alignas(k_cAlignment) T a3[k_cSIMDPack];
+      val3.Store(a3);
+
+      func(0, a0[0], a1[0], a2[0], a3[0]);
+      func(1, a0[1], a1[1], a2[1], a3[1]);
+      func(2, a0[2], a1[2], a2[2], a3[2]);
+      func(3, a0[3], a1[3], a2[3], a3[3]);
+   }
+
+   template<typename TFunc>
+   static inline void Execute(const TFunc & func, const Avx2_64_Int & val0, const Avx2_64_Int & val1, const Avx2_64_Float & val2, const Avx2_64_Float & val3, const Avx2_64_Float & val4) noexcept {
+      alignas(k_cAlignment) TInt::T a0[k_cSIMDPack];
+      val0.Store(a0);
+      alignas(k_cAlignment) TInt::T a1[k_cSIMDPack];
+      val1.Store(a1);
+      alignas(k_cAlignment) T a2[k_cSIMDPack];
+      val2.Store(a2);
+      alignas(k_cAlignment) T a3[k_cSIMDPack];
+      val3.Store(a3);
+      alignas(k_cAlignment) T a4[k_cSIMDPack];
+      val4.Store(a4);
+
+      func(0, a0[0], a1[0], a2[0], a3[0], a4[0]);
+      func(1, a0[1], a1[1], a2[1], a3[1], a4[1]);
+      func(2, a0[2], a1[2], a2[2], a3[2], a4[2]);
+      func(3, a0[3], a1[3], a2[3], a3[3], a4[3]);
+   }
+
+   friend inline Avx2_64_Float IfLess(const Avx2_64_Float & cmp1, const Avx2_64_Float & cmp2, const Avx2_64_Float & trueVal, const Avx2_64_Float & falseVal) noexcept {
+      const __m256d mask = _mm256_cmp_pd(cmp1.m_data, cmp2.m_data, _CMP_LT_OQ);
+      return Avx2_64_Float(_mm256_blendv_pd(falseVal.m_data, trueVal.m_data, mask));
+   }
+
+   friend inline Avx2_64_Float IfEqual(const Avx2_64_Float & cmp1, const Avx2_64_Float & cmp2, const Avx2_64_Float & trueVal, const Avx2_64_Float & falseVal) noexcept {
+      const __m256d mask = _mm256_cmp_pd(cmp1.m_data, cmp2.m_data, _CMP_EQ_OQ);
+      return Avx2_64_Float(_mm256_blendv_pd(falseVal.m_data, trueVal.m_data, mask));
+   }
+
+   friend inline Avx2_64_Float IfNaN(const Avx2_64_Float & cmp, const Avx2_64_Float & trueVal, const Avx2_64_Float & falseVal) noexcept {
+      // rely on the fact that a == a can only be false if a is a NaN
+      return IfEqual(cmp, cmp, falseVal, trueVal);
+   }
+
+   friend inline Avx2_64_Float IfEqual(const Avx2_64_Int & cmp1, const Avx2_64_Int & cmp2, const Avx2_64_Float & trueVal, const Avx2_64_Float & falseVal) noexcept {
+      const __m256i mask = _mm256_cmpeq_epi64(cmp1.m_data, cmp2.m_data);
+      return Avx2_64_Float(_mm256_blendv_pd(falseVal.m_data, trueVal.m_data, _mm256_castsi256_pd(mask)));
+   }
+
+   friend inline Avx2_64_Float Abs(const Avx2_64_Float & val) noexcept {
+      return Avx2_64_Float(_mm256_andnot_pd(_mm256_set1_pd(-0.0), val.m_data));
+   }
+
+   friend inline Avx2_64_Float FastApproxReciprocal(const Avx2_64_Float & val) noexcept {
+      // there is no double precision reciprocal approximation in AVX2
+      return Avx2_64_Float(1.0) / val;
+   }
+
+   friend inline Avx2_64_Float FastApproxDivide(const Avx2_64_Float & dividend, const Avx2_64_Float & divisor) noexcept {
+      return dividend / divisor;
+   }
+
+   friend inline Avx2_64_Float FusedMultiplyAdd(const Avx2_64_Float & mul1, const Avx2_64_Float & mul2, const Avx2_64_Float & add) noexcept {
+      // we check the cpuid for FMA3 during init, see Avx2_32_Float
+      return Avx2_64_Float(_mm256_fmadd_pd(mul1.m_data, mul2.m_data, add.m_data));
+   }
+
+   friend inline Avx2_64_Float FusedNegateMultiplyAdd(const Avx2_64_Float & mul1, const Avx2_64_Float & mul2, const Avx2_64_Float & add) noexcept {
+      // equivalent to: -(mul1 * mul2) + add
+      return Avx2_64_Float(_mm256_fnmadd_pd(mul1.m_data, mul2.m_data, add.m_data));
+   }
+
+   friend inline Avx2_64_Float Sqrt(const Avx2_64_Float & val) noexcept {
+      return Avx2_64_Float(_mm256_sqrt_pd(val.m_data));
+   }
+
+   friend inline Avx2_64_Float Exp(const Avx2_64_Float & val) noexcept {
+      return ApplyFunc([](T x) { return std::exp(x); }, val);
+   }
+
+   friend inline Avx2_64_Float Log(const Avx2_64_Float & val) noexcept {
+      return ApplyFunc([](T x) { return std::log(x); }, val);
+   }
+
+   template<
+      bool bDisableApprox,
+      bool bNegateInput = false,
+      bool bNaNPossible = true,
+      bool bUnderflowPossible = true,
+      bool bOverflowPossible = true,
+      bool bSpecialCaseZero = false,
+      typename std::enable_if<bDisableApprox, int>::type = 0
+   >
+   static inline Avx2_64_Float ApproxExp(
+      const Avx2_64_Float & val, 
+      const int32_t addExpSchraudolphTerm = k_expTermZeroMeanErrorForSoftmaxWithZeroedLogit
+   ) noexcept {
+      UNUSED(addExpSchraudolphTerm);
+      return Exp(bNegateInput ? -val : val);
+   }
+
+   template<
+      bool bDisableApprox,
+      bool bNegateInput = false,
+      bool bNaNPossible = true,
+      bool bUnderflowPossible = true,
+      bool bOverflowPossible = true,
+      bool bSpecialCaseZero = false,
+      typename std::enable_if<!bDisableApprox, int>::type = 0
+   >
+   static inline Avx2_64_Float ApproxExp(
+      const Avx2_64_Float & val, 
+      const int32_t addExpSchraudolphTerm = k_expTermZeroMeanErrorForSoftmaxWithZeroedLogit
+   ) noexcept {
+      // This code will make no sense until you read the Nicol N. Schraudolph paper:
+      // https://citeseerx.ist.psu.edu/viewdoc/download?doi=10.1.1.9.4508&rep=rep1&type=pdf
+      // and also see approximate_math.hpp
+      //
+      // Like ExpApproxSchraudolph for doubles, the approximation is computed on floats.  Values outside of the 
+      // float range convert to infinity, but those are replaced by the overflow and underflow checks below.
+      static constexpr float signedExpMultiple = bNegateInput ? -k_expMultiple : k_expMultiple;
+      const __m128 valFloat = _mm256_cvtpd_ps(val.m_data);
+#ifdef EXP_INT_SIMD
+      const __m128 product = _mm_mul_ps(valFloat, _mm_set1_ps(signedExpMultiple));
+      const __m128i retInt = _mm_add_epi32(_mm_cvttps_epi32(product), _mm_set1_epi32(addExpSchraudolphTerm));
+#else // EXP_INT_SIMD
+      const __m128 retFloat = _mm_fmadd_ps(valFloat, _mm_set1_ps(signedExpMultiple), _mm_set1_ps(static_cast<float>(addExpSchraudolphTerm)));
+      const __m128i retInt = _mm_cvttps_epi32(retFloat);
+#endif // EXP_INT_SIMD
+      Avx2_64_Float result = Avx2_64_Float(_mm256_cvtps_pd(_mm_castsi128_ps(retInt)));
+      if(bSpecialCaseZero) {
+         result = IfEqual(0.0, val, 1.0, result);
+      }
+      if(bOverflowPossible) {
+         if(bNegateInput) {
+            result = IfLess(val, static_cast<T>(-k_expOverflowPoint), std::numeric_limits<T>::infinity(), result);
+         } else {
+            result = IfLess(static_cast<T>(k_expOverflowPoint), val, std::numeric_limits<T>::infinity(), result);
+         }
+      }
+      if(bUnderflowPossible) {
+         if(bNegateInput) {
+            result = IfLess(static_cast<T>(-k_expUnderflowPoint), val, 0.0, result);
+         } else {
+            result = IfLess(val, static_cast<T>(k_expUnderflowPoint), 0.0, result);
+         }
+      }
+      if(bNaNPossible) {
+         result = IfNaN(val, val, result);
+      }
+      return result;
+   }
+
+
+   template<
+      bool bDisableApprox,
+      bool bNegateOutput = false,
+      bool bNaNPossible = true,
+      bool bNegativePossible = false,
+      bool bZeroPossible = false, // if false, positive zero returns a big negative number, negative zero returns a big positive number
+      bool bPositiveInfinityPossible = false, // if false, +inf returns a big positive number.  If val can be a double that is above the largest representable float, then setting this is necessary to avoid undefined behavior
+      typename std::enable_if<bDisableApprox, int>::type = 0
+   >
+   static inline Avx2_64_Float ApproxLog(
+      const Avx2_64_Float & val, 
+      const float addLogSchraudolphTerm = k_logTermLowerBoundInputCloseToOne
+   ) noexcept {
+      UNUSED(addLogSchraudolphTerm);
+      Avx2_64_Float ret = Log(val);
+      return bNegateOutput ? -ret : ret;
+   }
+
+   template<
+      bool bDisableApprox,
+      bool bNegateOutput = false,
+      bool bNaNPossible = true,
+      bool bNegativePossible = false,
+      bool bZeroPossible = false, // if false, positive zero returns a big negative number, negative zero returns a big positive number
+      bool bPositiveInfinityPossible = false, // if false, +inf returns a big positive number.  If val can be a double that is above the largest representable float, then setting this is necessary to avoid undefined behavior
+      typename std::enable_if<!bDisableApprox, int>::type = 0
+   >
+   static inline Avx2_64_Float ApproxLog(
+      const Avx2_64_Float & val, 
+      const float addLogSchraudolphTerm = k_logTermLowerBoundInputCloseToOne
+   ) noexcept {
+      // This code will make no sense until you read the Nicol N. Schraudolph paper:
+      // https://citeseerx.ist.psu.edu/viewdoc/download?doi=10.1.1.9.4508&rep=rep1&type=pdf
+      // and also see approximate_math.hpp
+      //
+      // Like LogApproxSchraudolph for doubles, we take the bits of the value narrowed to a float.  Every int32 
+      // converts exactly to a double, so the rest can be done in double precision.
+      const __m128i retInt = _mm_castps_si128(_mm256_cvtpd_ps(val.m_data));
+      Avx2_64_Float result = Avx2_64_Float(_mm256_cvtepi32_pd(retInt));
+      if(bNegateOutput) {
+         result = FusedMultiplyAdd(result, static_cast<T>(-k_logMultiple), static_cast<T>(-addLogSchraudolphTerm));
+      } else {
+         result = FusedMultiplyAdd(result, static_cast<T>(k_logMultiple), static_cast<T>(addLogSchraudolphTerm));
+      }
+      // doubles above the float range narrow to infinity, so handle them like LogApproxSchraudolph does.  This
+      // also covers bPositiveInfinityPossible
+      result = IfLess(static_cast<T>(std::numeric_limits<float>::max()), val, 
+         bNegateOutput ? -std::numeric_limits<T>::infinity() : std::numeric_limits<T>::infinity(), result);
+      if(bZeroPossible) {
+         result = IfEqual(0.0, val, bNegateOutput ? std::numeric_limits<T>::infinity() : -std::numeric_limits<T>::infinity(), result);
+      }
+      if(bNegativePossible) {
+         result = IfLess(val, 0.0, std::numeric_limits<T>::quiet_NaN(), result);
+      }
+      if(bNaNPossible) {
+         result = IfNaN(val, val, result);
+      }
+      return result;
+   }
+
+   friend inline T Sum(const Avx2_64_Float & val) noexcept {
+      const __m128d vlow = _mm256_castpd256_pd128(val.m_data);
+      const __m128d vhigh = _mm256_extractf128_pd(val.m_data, 1);
+      const __m128d sum = _mm_add_pd(vlow, vhigh);
+      return _mm_cvtsd_f64(_mm_add_sd(sum, _mm_unpackhi_pd(sum, sum)));
+   }
+
+
+   template<typename TObjective, bool bValidation, bool bWeight, bool bHessian, int gradHessFormat, bool bDisableApprox, size_t cCompilerScores, int cCompilerPack>
+   INLINE_RELEASE_TEMPLATED static ErrorEbm OperatorApplyUpdate(const Objective * const pObjective, ApplyUpdateBridge * const pData) noexcept {
+      RemoteApplyUpdate<TObjective, bValidation, bWeight, bHessian, gradHessFormat, bDisableApprox, cCompilerScores, cCompilerPack>(pObjective, pData);
+      return Error_None;
+   }
+
+
+   template<bool bHessian, int gradHessFormat, bool bWeight, bool bReplication, size_t cCompilerScores, int cCompilerPack>
+   INLINE_RELEASE_TEMPLATED static ErrorEbm OperatorBinSumsBoosting(BinSumsBoostingBridge * const pParams) noexcept {
+      RemoteBinSumsBoosting<Avx2_64_Float, bHessian, gradHessFormat, bWeight, bReplication, cCompilerScores, cCompilerPack>(pParams);
+      return Error_None;
+   }
+
+
+   template<bool bHessian, int gradHessFormat, bool bWeight, bool bReplication, size_t cCompilerScores>
+   INLINE_RELEASE_TEMPLATED static ErrorEbm OperatorBinSumsBoostingMulti(BinSumsBoostingMultiBridge * const pParams) noexcept {
+      RemoteBinSumsBoostingMulti<Avx2_64_Float, bHessian, gradHessFormat, bWeight, bReplication, cCompilerScores>(pParams);
+      return Error_None;
+   }
+
+
+   template<bool bHessian, bool bWeight, size_t cCompilerScores, size_t cCompilerDimensions>
+   INLINE_RELEASE_TEMPLATED static ErrorEbm OperatorBinSumsInteraction(BinSumsInteractionBridge * const pParams) noexcept {
+      RemoteBinSumsInteraction<Avx2_64_Float, bHessian, bWeight, cCompilerScores, cCompilerDimensions>(pParams);
+      return Error_None;
+   }
+
+
+private:
+
+   inline Avx2_64_Float(const TPack & data) noexcept : m_data(data) {
+   }
+
+   TPack m_data;
+};
+static_assert(std::is_standard_layout<Avx2_64_Float>::value && std::is_trivially_copyable<Avx2_64_Float>::value,
+   "This allows offsetof, memcpy, memset, inter-language, GPU and cross-machine use where needed");
+
+INTERNAL_IMPORT_EXPORT_BODY ErrorEbm ApplyUpdate_Avx2_64(
+   const ObjectiveWrapper * const pObjectiveWrapper,
+   ApplyUpdateBridge * const pData
+) {
+   const Objective * const pObjective = static_cast<const Objective *>(pObjectiveWrapper->m_pObjective);
+   const APPLY_UPDATE_CPP pApplyUpdateCpp =
+      (static_cast<FunctionPointersCpp*>(pObjectiveWrapper->m_pFunctionPointersCpp))->m_pApplyUpdateCpp;
+
+   // all our memory should be aligned. It is required by SIMD for correctness or performance
+   EBM_ASSERT(IsAligned(pData->m_aMulticlassMidwayTemp));
+   EBM_ASSERT(IsAligned(pData->m_aUpdateTensorScores));
+   EBM_ASSERT(IsAligned(pData->m_aPacked));
+   EBM_ASSERT(IsAligned(pData->m_aTargets));
+   EBM_ASSERT(IsAligned(pData->m_aWeights));
+   EBM_ASSERT(IsAligned(pData->m_aSampleScores));
+   EBM_ASSERT(IsAligned(pData->m_aGradientsAndHessians));
+
+   return (*pApplyUpdateCpp)(pObjective, pData);
+}
+
+INTERNAL_IMPORT_EXPORT_BODY ErrorEbm BinSumsBoosting_Avx2_64(
+   const ObjectiveWrapper * const pObjectiveWrapper,
+   BinSumsBoostingBridge * const pParams
+) {
+   const BIN_SUMS_BOOSTING_CPP pBinSumsBoostingCpp =
+      (static_cast<FunctionPointersCpp *>(pObjectiveWrapper->m_pFunctionPointersCpp))->m_pBinSumsBoostingCpp;
+
+   // all our memory should be aligned. It is required by SIMD for correctness or performance
+   EBM_ASSERT(IsAligned(pParams->m_aGradientsAndHessians));
+   EBM_ASSERT(IsAligned(pParams->m_aWeights));
+   EBM_ASSERT(IsAligned(pParams->m_pCountOccurrences));
+   EBM_ASSERT(IsAligned(pParams->m_aPacked));
+   EBM_ASSERT(IsAligned(pParams->m_aFastBins));
+
+   return (*pBinSumsBoostingCpp)(pParams);
+}
+
+INTERNAL_IMPORT_EXPORT_BODY ErrorEbm BinSumsBoostingMulti_Avx2_64(
+   const ObjectiveWrapper * const pObjectiveWrapper,
+   BinSumsBoostingMultiBridge * const pParams
+) {
+   const BIN_SUMS_BOOSTING_MULTI_CPP pBinSumsBoostingMultiCpp =
+      (static_cast<FunctionPointersCpp *>(pObjectiveWrapper->m_pFunctionPointersCpp))->m_pBinSumsBoostingMultiCpp;
+
+#ifndef NDEBUG
+   // all our memory should be aligned. It is required by SIMD for correctness or performance
+   EBM_ASSERT(IsAligned(pParams->m_aGradientsAndHessians));
+   EBM_ASSERT(IsAligned(pParams->m_aWeights));
+   EBM_ASSERT(IsAligned(pParams->m_pCountOccurrences));
+   for(size_t iDebug = 0; iDebug < pParams->m_cTerms; ++iDebug) {
+      EBM_ASSERT(IsAligned(pParams->m_aaPacked[iDebug]));
+      EBM_ASSERT(IsAligned(pParams->m_aaFastBins[iDebug]));
+   }
+#endif // NDEBUG
+
+   return (*pBinSumsBoostingMultiCpp)(pParams);
+}
+
+INTERNAL_IMPORT_EXPORT_BODY ErrorEbm BinSumsInteraction_Avx2_64(
+   const ObjectiveWrapper * const pObjectiveWrapper,
+   BinSumsInteractionBridge * const pParams
+) {
+   const BIN_SUMS_INTERACTION_CPP pBinSumsInteractionCpp =
+      (static_cast<FunctionPointersCpp *>(pObjectiveWrapper->m_pFunctionPointersCpp))->m_pBinSumsInteractionCpp;
+
+#ifndef NDEBUG
+   // all our memory should be aligned. It is required by SIMD for correctness or performance
+   EBM_ASSERT(IsAligned(pParams->m_aGradientsAndHessians));
+   EBM_ASSERT(IsAligned(pParams->m_aWeights));
+   EBM_ASSERT(IsAligned(pParams->m_aFastBins));
+   for(size_t iDebug = 0; iDebug < pParams->m_cRuntimeRealDimensions; ++iDebug) {
+      EBM_ASSERT(IsAligned(pParams->m_aaPacked[iDebug]));
+   }
+#endif // NDEBUG
+
+   return (*pBinSumsInteractionCpp)(pParams);
+}
+
+INTERNAL_IMPORT_EXPORT_BODY ErrorEbm CreateObjective_Avx2_64(
+   const Config * const pConfig,
+   const char * const sObjective,
+   const char * const sObjectiveEnd,
+   ObjectiveWrapper * const pObjectiveWrapperOut
+) {
+   pObjectiveWrapperOut->m_pApplyUpdateC = ApplyUpdate_Avx2_64;
+   pObjectiveWrapperOut->m_pBinSumsBoostingC = BinSumsBoosting_Avx2_64;
+   pObjectiveWrapperOut->m_pBinSumsBoostingMultiC = BinSumsBoostingMulti_Avx2_64;
+   pObjectiveWrapperOut->m_pBinSumsInteractionC = BinSumsInteraction_Avx2_64;
+   ErrorEbm error = ComputeWrapper<Avx2_64_Float>::FillWrapper(pObjectiveWrapperOut);
+   if(Error_None != error) {
+      return error;
+   }
+   return Objective::CreateObjective<Avx2_64_Float>(pConfig, sObjective, sObjectiveEnd, pObjectiveWrapperOut);
+}
+
+} // DEFINED_ZONE_NAME
@@ -34,6 +34,19 @@ namespace DEFINED_ZONE_NAME {
 
 static constexpr size_t k_cAlignment = 64;
 
+// The zone is compiled for AVX512F only, so the AVX512CD instruction needs to be enabled for the one function that 
+// uses it.  GetObjective checks CPUID before letting us call it.  MSVC allows the intrinsic without this.
+#if defined(__GNUC__) || defined(__clang__)
+#define ATTRIBUTE_TARGET_AVX512CD __attribute__((target("avx512cd")))
+#else // defined(__GNUC__) || defined(__clang__)
+#define ATTRIBUTE_TARGET_AVX512CD
+#endif // defined(__GNUC__) || defined(__clang__)
+
+ATTRIBUTE_TARGET_AVX512CD static __m512i ConflictEarlierLanes(const __m512i i) noexcept {
+   // each lane gets a bit for every lower lane that holds the same value
+   return _mm512_conflict_epi32(i);
+}
+
 struct alignas(k_cAlignment) Avx512f_32_Float;
 
 struct alignas(k_cAlignment) Avx512f_32_Int final {
@@ -42,6 +55,7 @@ struct alignas(k_cAlignment) Avx512f_32_Int final {
 
    using T = uint32_t;
    using TPack = __m512i;
+   using TMask = __mmask16;
    static_assert(std::is_unsigned<T>::value, "T must be an unsigned integer type");
    static_assert(std::is_same<UIntBig, T>::value || std::is_same<UIntSmall, T>::value,
       "T must be either UIntBig or UIntSmall");
@@ -68,6 +82,41 @@ struct alignas(k_cAlignment) Avx512f_32_Int final {
       return Avx512f_32_Int(_mm512_cvtepu8_epi32(_mm_load_si128(reinterpret_cast<const __m128i *>(a))));
    }
 
+   inline static Avx512f_32_Int Load(const T * const a, const Avx512f_32_Int & i) noexcept {
+      // i is treated as signed, so we should only use the lower 31 bits otherwise we'll read from memory before a
+      return Avx512f_32_Int(_mm512_i32gather_epi32(i.m_data, a, sizeof(a[0])));
+   }
+
+   inline void Store(T * const a, const Avx512f_32_Int & i) const noexcept {
+      // i is treated as signed, so we should only use the lower 31 bits otherwise we'll read from memory before a
+      _mm512_i32scatter_epi32(a, i.m_data, m_data, sizeof(a[0]));
+   }
+
+   inline static Avx512f_32_Int Load(const T * const a, const Avx512f_32_Int & i, const TMask mask) noexcept {
+      // only the lanes in mask are loaded, and the rest are zero
+      return Avx512f_32_Int(_mm512_mask_i32gather_epi32(_mm512_setzero_si512(), mask, i.m_data, a, sizeof(a[0])));
+   }
+
+   inline void Store(T * const a, const Avx512f_32_Int & i, const TMask mask) const noexcept {
+      _mm512_mask_i32scatter_epi32(a, mask, i.m_data, m_data, sizeof(a[0]));
+   }
+
+   template<typename TFunc>
+   static inline void ExecuteConflictFree(const TFunc & func, const Avx512f_32_Int & i) noexcept {
+      // Calls func with groups of lanes that have distinct values in i until every lane has been passed once.
+      // A lane is only passed after all the lower lanes with the same value, so if func gathers, adds, and 
+      // scatters then equal values accumulate in lane order, just like Execute would.
+      // Only call this if ObjectiveWrapper::m_bConflictDetect is set
+      const __m512i conflicts = ConflictEarlierLanes(i.m_data);
+      TMask remaining = TMask { 0xFFFF };
+      do {
+         // the lanes that have no remaining lower lanes with the same value
+         const TMask ready = _mm512_mask_testn_epi32_mask(remaining, conflicts, _mm512_set1_epi32(static_cast<int>(remaining)));
+         func(ready);
+         remaining = static_cast<TMask>(remaining & ~ready);
+      } while(TMask { 0 } != remaining);
+   }
+
    template<typename TFunc>
    static inline void Execute(const TFunc & func, const Avx512f_32_Int & val0) noexcept {
       alignas(k_cAlignment) T a0[k_cSIMDPack];
@@ -116,6 +165,10 @@ struct alignas(k_cAlignment) Avx512f_32_Int final {
       return Avx512f_32_Int(_mm512_and_si512(m_data, other.m_data));
    }
 
+   friend inline T Sum(const Avx512f_32_Int & val) noexcept {
+      return static_cast<T>(_mm512_reduce_add_epi32(val.m_data));
+   }
+
 private:
    inline Avx512f_32_Int(const TPack & data) noexcept : m_data(data) {
    }
@@ -135,6 +188,8 @@ struct alignas(k_cAlignment) Avx512f_32_Float final {
    static constexpr ComputeFlags k_zone = TInt::k_zone;
    static constexpr int k_cSIMDShift = TInt::k_cSIMDShift;
    static constexpr int k_cSIMDPack = TInt::k_cSIMDPack;
+   static constexpr bool k_bConflictDetect = true; // when ObjectiveWrapper::m_bConflictDetect says the CPU has AVX512CD
+   static constexpr size_t k_cTableItemsMax = 16; // one register can hold a lookup table of this many items
 
    ATTRIBUTE_WARNING_DISABLE_UNINITIALIZED_MEMBER
    inline Avx512f_32_Float() noexcept {
@@ -239,7 +294,21 @@ struct alignas(k_cAlignment) Avx512f_32_Float final {
 
    inline static Avx512f_32_Float Load(const T * const a, const TInt & i) noexcept {
       // i is treated as signed, so we should only use the lower 31 bits otherwise we'll read from memory before a
-      return Avx512f_32_Float(_mm512_i32gather_ps(i.m_data, a, sizeof(a[0])));
+      // the masked form with a zeroed source avoids GCC's _mm512_undefined_ps, which -Wmaybe-uninitialized flags
+      return Avx512f_32_Float(
+            _mm512_mask_i32gather_ps(_mm512_setzero_ps(), static_cast<__mmask16>(0xFFFF), i.m_data, a, sizeof(a[0])));
+   }
+
+   inline static Avx512f_32_Float LoadTable(const T * const a, const size_t c) noexcept {
+      // loads the c items of a into the lower lanes without reading past the end of a
+      EBM_ASSERT(1 <= c && c <= k_cTableItemsMax);
+      const __mmask16 mask = static_cast<__mmask16>((uint32_t { 1 } << c) - uint32_t { 1 });
+      return Avx512f_32_Float(_mm512_maskz_loadu_ps(mask, a));
+   }
+
+   inline Avx512f_32_Float Lookup(const TInt & i) const noexcept {
+      // the same result as Load(a, i) when this was made by LoadTable(a, c), but without going to memory
+      return Avx512f_32_Float(_mm512_mask_permutexvar_ps(m_data, static_cast<__mmask16>(0xFFFF), i.m_data, m_data));
    }
 
    inline void Store(T * const a, const TInt & i) const noexcept {
@@ -247,6 +316,53 @@ struct alignas(k_cAlignment) Avx512f_32_Float final {
       _mm512_i32scatter_ps(a, i.m_data, m_data, sizeof(a[0]));
    }
 
+   inline static Avx512f_32_Float Load(const T * const a, const TInt & i, const TInt::TMask mask) noexcept {
+      // only the lanes in mask are loaded, and the rest are zero
+      return Avx512f_32_Float(_mm512_mask_i32gather_ps(_mm512_setzero_ps(), mask, i.m_data, a, sizeof(a[0])));
+   }
+
+   inline void Store(T * const a, const TInt & i, const TInt::TMask mask) const noexcept {
+      _mm512_mask_i32scatter_ps(a, mask, i.m_data, m_data, sizeof(a[0]));
+   }
+
+   inline static Avx512f_32_Float Load(const Bfloat16 * const a) noexcept {
+      // widening a bfloat16 is a shift into the upper half of the float
+      const __m512i bits = _mm512_cvtepu16_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(a)));
+      return Avx512f_32_Float(_mm512_castsi512_ps(_mm512_slli_epi32(bits, 16)));
+   }
+
+   inline void Store(Bfloat16 * const a) const noexcept {
+      // round to nearest even like FloatToBfloat16, and set the quiet bit of NaN values so they stay NaN
+      const __m512i bits = _mm512_castps_si512(m_data);
+      const __m512i lowest = _mm512_and_si512(_mm512_srli_epi32(bits, 16), _mm512_set1_epi32(1));
+      __m512i rounded = _mm512_add_epi32(bits, _mm512_add_epi32(_mm512_set1_epi32(0x7FFF), lowest));
+      const __mmask16 isNaN = _mm512_cmp_ps_mask(m_data, m_data, _CMP_UNORD_Q);
+      rounded = _mm512_mask_or_epi32(rounded, isNaN, bits, _mm512_set1_epi32(0x00400000));
+      _mm256_storeu_si256(reinterpret_cast<__m256i *>(a), _mm512_cvtepi32_epi16(_mm512_srli_epi32(rounded, 16)));
+   }
+
+   inline static Avx512f_32_Float Load(const Bfloat16 * const a, const TInt & i) noexcept {
+      alignas(k_cAlignment) TInt::T ints[k_cSIMDPack];
+      alignas(k_cAlignment) T floats[k_cSIMDPack];
+
+      i.Store(ints);
+      for(int iLane = 0; iLane < k_cSIMDPack; ++iLane) {
+         floats[iLane] = Bfloat16ToFloat(a[ints[iLane]]);
+      }
+      return Load(floats);
+   }
+
+   inline void Store(Bfloat16 * const a, const TInt & i) const noexcept {
+      alignas(k_cAlignment) TInt::T ints[k_cSIMDPack];
+      alignas(k_cAlignment) T floats[k_cSIMDPack];
+
+      i.Store(ints);
+      Store(floats);
+      for(int iLane = 0; iLane < k_cSIMDPack; ++iLane) {
+         a[ints[iLane]] = FloatToBfloat16(floats[iLane]);
+      }
+   }
+
    template<typename TFunc>
    friend inline Avx512f_32_Float ApplyFunc(const TFunc & func, const Avx512f_32_Float & val) noexcept {
       alignas(k_cAlignment) T aTemp[k_cSIMDPack];
@@ -674,16 +790,23 @@ struct alignas(k_cAlignment) Avx512f_32_Float final {
    }
 
 
-   template<typename TObjective, bool bValidation, bool bWeight, bool bHessian, bool bDisableApprox, size_t cCompilerScores, int cCompilerPack>
+   template<typename TObjective, bool bValidation, bool bWeight, bool bHessian, int gradHessFormat, bool bDisableApprox, size_t cCompilerScores, int cCompilerPack>
    INLINE_RELEASE_TEMPLATED static ErrorEbm OperatorApplyUpdate(const Objective * const pObjective, ApplyUpdateBridge * const pData) noexcept {
-      RemoteApplyUpdate<TObjective, bValidation, bWeight, bHessian, bDisableApprox, cCompilerScores, cCompilerPack>(pObjective, pData);
+      RemoteApplyUpdate<TObjective, bValidation, bWeight, bHessian, gradHessFormat, bDisableApprox, cCompilerScores, cCompilerPack>(pObjective, pData);
       return Error_None;
    }
 
 
-   template<bool bHessian, bool bWeight, bool bReplication, size_t cCompilerScores, int cCompilerPack>
+   template<bool bHessian, int gradHessFormat, bool bWeight, bool bReplication, size_t cCompilerScores, int cCompilerPack>
    INLINE_RELEASE_TEMPLATED static ErrorEbm OperatorBinSumsBoosting(BinSumsBoostingBridge * const pParams) noexcept {
-      RemoteBinSumsBoosting<Avx512f_32_Float, bHessian, bWeight, bReplication, cCompilerScores, cCompilerPack>(pParams);
+      RemoteBinSumsBoosting<Avx512f_32_Float, bHessian, gradHessFormat, bWeight, bReplication, cCompilerScores, cCompilerPack>(pParams);
+      return Error_None;
+   }
+
+
+   template<bool bHessian, int gradHessFormat, bool bWeight, bool bReplication, size_t cCompilerScores>
+   INLINE_RELEASE_TEMPLATED static ErrorEbm OperatorBinSumsBoostingMulti(BinSumsBoostingMultiBridge * const pParams) noexcept {
+      RemoteBinSumsBoostingMulti<Avx512f_32_Float, bHessian, gradHessFormat, bWeight, bReplication, cCompilerScores>(pParams);
       return Error_None;
    }
 
@@ -732,6 +855,8 @@ INTERNAL_IMPORT_EXPORT_BODY ErrorEbm BinSumsBoosting_Avx512f_32(
    const BIN_SUMS_BOOSTING_CPP pBinSumsBoostingCpp =
       (static_cast<FunctionPointersCpp *>(pObjectiveWrapper->m_pFunctionPointersCpp))->m_pBinSumsBoostingCpp;
 
+   pParams->m_bConflictDetect = pObjectiveWrapper->m_bConflictDetect;
+
    // all our memory should be aligned. It is required by SIMD for correctness or performance
    EBM_ASSERT(IsAligned(pParams->m_aGradientsAndHessians));
    EBM_ASSERT(IsAligned(pParams->m_aWeights));
@@ -742,6 +867,27 @@ INTERNAL_IMPORT_EXPORT_BODY ErrorEbm BinSumsBoosting_Avx512f_32(
    return (*pBinSumsBoostingCpp)(pParams);
 }
 
+INTERNAL_IMPORT_EXPORT_BODY ErrorEbm BinSumsBoostingMulti_Avx512f_32(
+   const ObjectiveWrapper * const pObjectiveWrapper,
+   BinSumsBoostingMultiBridge * const pParams
+) {
+   const BIN_SUMS_BOOSTING_MULTI_CPP pBinSumsBoostingMultiCpp =
+      (static_cast<FunctionPointersCpp *>(pObjectiveWrapper->m_pFunctionPointersCpp))->m_pBinSumsBoostingMultiCpp;
+
+#ifndef NDEBUG
+   // all our memory should be aligned. It is required by SIMD for correctness or performance
+   EBM_ASSERT(IsAligned(pParams->m_aGradientsAndHessians));
+   EBM_ASSERT(IsAligned(pParams->m_aWeights));
+   EBM_ASSERT(IsAligned(pParams->m_pCountOccurrences));
+   for(size_t iDebug = 0; iDebug < pParams->m_cTerms; ++iDebug) {
+      EBM_ASSERT(IsAligned(pParams->m_aaPacked[iDebug]));
+      EBM_ASSERT(IsAligned(pParams->m_aaFastBins[iDebug]));
+   }
+#endif // NDEBUG
+
+   return (*pBinSumsBoostingMultiCpp)(pParams);
+}
+
 INTERNAL_IMPORT_EXPORT_BODY ErrorEbm BinSumsInteraction_Avx512f_32(
    const ObjectiveWrapper * const pObjectiveWrapper,
    BinSumsInteractionBridge * const pParams
@@ -749,6 +895,8 @@ INTERNAL_IMPORT_EXPORT_BODY ErrorEbm BinSumsInteraction_Avx512f_32(
    const BIN_SUMS_INTERACTION_CPP pBinSumsInteractionCpp =
       (static_cast<FunctionPointersCpp *>(pObjectiveWrapper->m_pFunctionPointersCpp))->m_pBinSumsInteractionCpp;
 
+   pParams->m_bConflictDetect = pObjectiveWrapper->m_bConflictDetect;
+
 #ifndef NDEBUG
    // all our memory should be aligned. It is required by SIMD for correctness or performance
    EBM_ASSERT(IsAligned(pParams->m_aGradientsAndHessians));
@@ -770,6 +918,7 @@ INTERNAL_IMPORT_EXPORT_BODY ErrorEbm CreateObjective_Avx512f_32(
 ) {
    pObjectiveWrapperOut->m_pApplyUpdateC = ApplyUpdate_Avx512f_32;
    pObjectiveWrapperOut->m_pBinSumsBoostingC = BinSumsBoosting_Avx512f_32;
+   pObjectiveWrapperOut->m_pBinSumsBoostingMultiC = BinSumsBoostingMulti_Avx512f_32;
    pObjectiveWrapperOut->m_pBinSumsInteractionC = BinSumsInteraction_Avx512f_32;
    ErrorEbm error = ComputeWrapper<Avx512f_32_Float>::FillWrapper(pObjectiveWrapperOut);
    if(Error_None != error) {
@@ -27,11 +27,41 @@ inline constexpr static int GetNextBitPack(const int cItemsBitPackedPrev, const
       COUNT_BITS(T) / ((COUNT_BITS(T) / cItemsBitPackedPrev) + 1);
 }
 
+template<typename T>
+inline constexpr static int GetNextBitPackBinSums(const int cItemsBitPackedPrev) noexcept {
+   // BinSums has many more kernel variations than ApplyUpdate (hessian, weights, replication, gradient formats), 
+   // so instead of the full progression we only compile the bit packs that the tensors we usually see produce.
+   // Every feature has a missing and an unseen bin in addition to its regular bins, so a continuous feature has 
+   // len(cuts) + 3 bins.  The ones we see most often are:
+   //   binary and low cardinality features with 3-4 bins (2 bits), 5-8 bins (3 bits) and 9-16 bins (4 bits)
+   //   continuous features at the default max_bins of 256: 258 bins (9 bits)
+   //   pairs at the default max_interaction_bins of 32: 34 * 34 = 1156 bins (11 bits)
+   // for 64 bits, the progression is: 32,21,16,7,5,0 (dynamic)
+   // for 32 bits, the progression is: 16,10,8,3,2,0 (dynamic)
+   // this function should never see the dynamic value 0 because we should terminate the chain at that point
+   return 64 == COUNT_BITS(T) ?
+      (32 < cItemsBitPackedPrev ? 32 :
+      21 < cItemsBitPackedPrev ? 21 :
+      16 < cItemsBitPackedPrev ? 16 :
+      7 < cItemsBitPackedPrev ? 7 :
+      5 < cItemsBitPackedPrev ? 5 : k_cItemsPerBitPackDynamic) :
+      (16 < cItemsBitPackedPrev ? 16 :
+      10 < cItemsBitPackedPrev ? 10 :
+      8 < cItemsBitPackedPrev ? 8 :
+      3 < cItemsBitPackedPrev ? 3 :
+      2 < cItemsBitPackedPrev ? 2 : k_cItemsPerBitPackDynamic);
+}
+
 template<typename T>
 inline constexpr static int GetFirstBitPack(int cItemsPerBitPackMax, const int cItemsPerBitPackMin) noexcept {
    return GetNextBitPack<T>(cItemsPerBitPackMax + 1, cItemsPerBitPackMin);
 }
 
+template<typename T>
+inline constexpr static int GetFirstBitPackBinSums() noexcept {
+   return GetNextBitPackBinSums<T>(COUNT_BITS(T) + 1);
+}
+
 template<typename T, typename U, U multiplicator, int shiftEnd, int shift>
 struct MultiplierInternal final {
    GPU_DEVICE inline constexpr static T Func(const T val) {
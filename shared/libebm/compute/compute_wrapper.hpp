@@ -22,6 +22,10 @@ struct ComputeWrapper final {
       return BinSumsBoosting<TFloat>(pParams);
    }
 
+   static ErrorEbm StaticBinSumsBoostingMulti(BinSumsBoostingMultiBridge * const pParams) {
+      return BinSumsBoostingMulti<TFloat>(pParams);
+   }
+
    static ErrorEbm StaticBinSumsInteraction(BinSumsInteractionBridge * const pParams) {
       return BinSumsInteraction<TFloat>(pParams);
    }
@@ -37,6 +41,7 @@ struct ComputeWrapper final {
       pObjectiveWrapperOut->m_pFunctionPointersCpp = pFunctionPointersCpp;
 
       pFunctionPointersCpp->m_pBinSumsBoostingCpp = StaticBinSumsBoosting;
+      pFunctionPointersCpp->m_pBinSumsBoostingMultiCpp = StaticBinSumsBoostingMulti;
       pFunctionPointersCpp->m_pBinSumsInteractionCpp = StaticBinSumsInteraction;
 
       pObjectiveWrapperOut->m_cSIMDPack = static_cast<size_t>(TFloat::k_cSIMDPack);
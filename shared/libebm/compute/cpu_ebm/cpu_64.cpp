@@ -94,6 +94,10 @@ struct Cpu_64_Int final {
       return Cpu_64_Int(m_data & other.m_data);
    }
 
+   friend inline T Sum(const Cpu_64_Int & val) noexcept {
+      return val.m_data;
+   }
+
 private:
    TPack m_data;
 };
@@ -110,6 +114,8 @@ struct Cpu_64_Float final {
    static constexpr ComputeFlags k_zone = TInt::k_zone;
    static constexpr int k_cSIMDShift = TInt::k_cSIMDShift;
    static constexpr int k_cSIMDPack = TInt::k_cSIMDPack;
+   static constexpr bool k_bConflictDetect = false;
+   static constexpr size_t k_cTableItemsMax = 0;
 
    ATTRIBUTE_WARNING_DISABLE_UNINITIALIZED_MEMBER
    inline Cpu_64_Float() noexcept {
@@ -220,6 +226,22 @@ struct Cpu_64_Float final {
       a[i.m_data] = m_data;
    }
 
+   inline static Cpu_64_Float Load(const Bfloat16 * const a) noexcept {
+      return Cpu_64_Float(static_cast<T>(Bfloat16ToFloat(*a)));
+   }
+
+   inline void Store(Bfloat16 * const a) const noexcept {
+      *a = FloatToBfloat16(static_cast<float>(m_data));
+   }
+
+   inline static Cpu_64_Float Load(const Bfloat16 * const a, const TInt & i) noexcept {
+      return Cpu_64_Float(static_cast<T>(Bfloat16ToFloat(a[i.m_data])));
+   }
+
+   inline void Store(Bfloat16 * const a, const TInt & i) const noexcept {
+      a[i.m_data] = FloatToBfloat16(static_cast<float>(m_data));
+   }
+
    template<typename TFunc>
    friend inline Cpu_64_Float ApplyFunc(const TFunc & func, const Cpu_64_Float & val) noexcept {
       return Cpu_64_Float(func(val.m_data));
@@ -359,16 +381,23 @@ struct Cpu_64_Float final {
    }
 
 
-   template<typename TObjective, bool bValidation, bool bWeight, bool bHessian, bool bDisableApprox, size_t cCompilerScores, int cCompilerPack>
+   template<typename TObjective, bool bValidation, bool bWeight, bool bHessian, int gradHessFormat, bool bDisableApprox, size_t cCompilerScores, int cCompilerPack>
    INLINE_RELEASE_TEMPLATED static ErrorEbm OperatorApplyUpdate(const Objective * const pObjective, ApplyUpdateBridge * const pData) noexcept {
-      RemoteApplyUpdate<TObjective, bValidation, bWeight, bHessian, bDisableApprox, cCompilerScores, cCompilerPack>(pObjective, pData);
+      RemoteApplyUpdate<TObjective, bValidation, bWeight, bHessian, gradHessFormat, bDisableApprox, cCompilerScores, cCompilerPack>(pObjective, pData);
       return Error_None;
    }
 
 
-   template<bool bHessian, bool bWeight, bool bReplication, size_t cCompilerScores, int cCompilerPack>
+   template<bool bHessian, int gradHessFormat, bool bWeight, bool bReplication, size_t cCompilerScores, int cCompilerPack>
    INLINE_RELEASE_TEMPLATED static ErrorEbm OperatorBinSumsBoosting(BinSumsBoostingBridge * const pParams) noexcept {
-      RemoteBinSumsBoosting<Cpu_64_Float, bHessian, bWeight, bReplication, cCompilerScores, cCompilerPack>(pParams);
+      RemoteBinSumsBoosting<Cpu_64_Float, bHessian, gradHessFormat, bWeight, bReplication, cCompilerScores, cCompilerPack>(pParams);
+      return Error_None;
+   }
+
+
+   template<bool bHessian, int gradHessFormat, bool bWeight, bool bReplication, size_t cCompilerScores>
+   INLINE_RELEASE_TEMPLATED static ErrorEbm OperatorBinSumsBoostingMulti(BinSumsBoostingMultiBridge * const pParams) noexcept {
+      RemoteBinSumsBoostingMulti<Cpu_64_Float, bHessian, gradHessFormat, bWeight, bReplication, cCompilerScores>(pParams);
       return Error_None;
    }
 
@@ -424,6 +453,27 @@ INTERNAL_IMPORT_EXPORT_BODY ErrorEbm BinSumsBoosting_Cpu_64(
    return (*pBinSumsBoostingCpp)(pParams);
 }
 
+INTERNAL_IMPORT_EXPORT_BODY ErrorEbm BinSumsBoostingMulti_Cpu_64(
+   const ObjectiveWrapper * const pObjectiveWrapper,
+   BinSumsBoostingMultiBridge * const pParams
+) {
+   const BIN_SUMS_BOOSTING_MULTI_CPP pBinSumsBoostingMultiCpp =
+      (static_cast<FunctionPointersCpp *>(pObjectiveWrapper->m_pFunctionPointersCpp))->m_pBinSumsBoostingMultiCpp;
+
+#ifndef NDEBUG
+   // all our memory should be aligned. It is required by SIMD for correctness or performance
+   EBM_ASSERT(IsAligned(pParams->m_aGradientsAndHessians));
+   EBM_ASSERT(IsAligned(pParams->m_aWeights));
+   EBM_ASSERT(IsAligned(pParams->m_pCountOccurrences));
+   for(size_t iDebug = 0; iDebug < pParams->m_cTerms; ++iDebug) {
+      EBM_ASSERT(IsAligned(pParams->m_aaPacked[iDebug]));
+      EBM_ASSERT(IsAligned(pParams->m_aaFastBins[iDebug]));
+   }
+#endif // NDEBUG
+
+   return (*pBinSumsBoostingMultiCpp)(pParams);
+}
+
 INTERNAL_IMPORT_EXPORT_BODY ErrorEbm BinSumsInteraction_Cpu_64(
    const ObjectiveWrapper * const pObjectiveWrapper,
    BinSumsInteractionBridge * const pParams
@@ -477,6 +527,7 @@ INTERNAL_IMPORT_EXPORT_BODY ErrorEbm CreateObjective_Cpu_64(
 ) {
    pObjectiveWrapperOut->m_pApplyUpdateC = ApplyUpdate_Cpu_64;
    pObjectiveWrapperOut->m_pBinSumsBoostingC = BinSumsBoosting_Cpu_64;
+   pObjectiveWrapperOut->m_pBinSumsBoostingMultiC = BinSumsBoostingMulti_Cpu_64;
    pObjectiveWrapperOut->m_pBinSumsInteractionC = BinSumsInteraction_Cpu_64;
    ErrorEbm error = ComputeWrapper<Cpu_64_Float>::FillWrapper(pObjectiveWrapperOut);
    if(Error_None != error) {
@@ -101,6 +101,10 @@ struct Cuda_32_Int final {
       return Cuda_32_Int(m_data & other.m_data);
    }
 
+   GPU_BOTH friend inline T Sum(const Cuda_32_Int & val) noexcept {
+      return val.m_data;
+   }
+
 private:
    TPack m_data;
 };
@@ -120,6 +124,8 @@ struct Cuda_32_Float final {
    static constexpr bool k_bCpu = TInt::k_bCpu;
    static constexpr int k_cSIMDShift = TInt::k_cSIMDShift;
    static constexpr int k_cSIMDPack = TInt::k_cSIMDPack;
+   static constexpr bool k_bConflictDetect = false;
+   static constexpr size_t k_cTableItemsMax = 0;
 
    ATTRIBUTE_WARNING_DISABLE_UNINITIALIZED_MEMBER
    GPU_BOTH inline Cuda_32_Float() noexcept {
@@ -476,6 +482,15 @@ struct Cuda_32_Float final {
    }
 
 
+   template<bool bHessian, bool bWeight, bool bReplication, size_t cCompilerScores>
+   INLINE_RELEASE_TEMPLATED static ErrorEbm OperatorBinSumsBoostingMulti(BinSumsBoostingMultiBridge * const pParams) noexcept {
+      // TODO: move memory to the GPU and return errors
+      static constexpr size_t k_cItems = 5;
+      RemoteBinSumsBoostingMulti<Cuda_32_Float, bHessian, bWeight, bReplication, cCompilerScores><<<1, k_cItems>>>(pParams);
+      return Error_None;
+   }
+
+
    template<bool bHessian, size_t cCompilerScores, size_t cCompilerDimensions, bool bWeight>
    INLINE_RELEASE_TEMPLATED static ErrorEbm OperatorBinSumsInteraction(BinSumsInteractionBridge * const pParams) noexcept {
       // TODO: move memory to the GPU and return errors
@@ -502,6 +517,7 @@ INTERNAL_IMPORT_EXPORT_BODY ErrorEbm CreateObjective_Cuda_32(
 ) {
    pObjectiveWrapperOut->m_pApplyUpdateC = ApplyUpdate_Cuda_32;
    pObjectiveWrapperOut->m_pBinSumsBoostingC = BinSumsBoosting_Cuda_32;
+   pObjectiveWrapperOut->m_pBinSumsBoostingMultiC = BinSumsBoostingMulti_Cuda_32;
    pObjectiveWrapperOut->m_pBinSumsInteractionC = BinSumsInteraction_Cuda_32;
    ErrorEbm error = ComputeWrapper<Cuda_32_Float>::FillWrapper(pObjectiveWrapperOut);
    if(Error_None != error) {
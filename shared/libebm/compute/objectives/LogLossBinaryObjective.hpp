@@ -73,17 +73,37 @@ struct LogLossBinaryObjective : BinaryObjective {
       return GradientHessian<TFloat>(0.0, 0.0);
    }
 
-   template<bool bValidation, bool bWeight, bool bHessian, bool bDisableApprox, size_t cCompilerScores, int cCompilerPack>
-   GPU_DEVICE NEVER_INLINE void InjectedApplyUpdate(ApplyUpdateBridge * const pData) const {
+   template<bool bValidation, bool bWeight, bool bHessian, int gradHessFormat, bool bDisableApprox, size_t cCompilerScores, int cCompilerPack>
+   GPU_DEVICE inline void InjectedApplyUpdate(ApplyUpdateBridge * const pData) const {
+      // the probability metrics only exist when we calculate the metric, so training without the metric 
+      // only instantiates the version without
+      static constexpr bool bMetric = bValidation || bWeight;
+      if(bMetric && EBM_FALSE != pData->m_bProbabilityMetrics) {
+         ApplyUpdateInternal<bMetric, bValidation, bWeight, bHessian, gradHessFormat, bDisableApprox, cCompilerScores, cCompilerPack>(pData);
+      } else {
+         ApplyUpdateInternal<false, bValidation, bWeight, bHessian, gradHessFormat, bDisableApprox, cCompilerScores, cCompilerPack>(pData);
+      }
+   }
+
+private:
+
+   template<bool bProbabilityMetrics, bool bValidation, bool bWeight, bool bHessian, int gradHessFormat, bool bDisableApprox, size_t cCompilerScores, int cCompilerPack>
+   GPU_DEVICE NEVER_INLINE void ApplyUpdateInternal(ApplyUpdateBridge * const pData) const {
       static_assert(k_oneScore == cCompilerScores, "We special case the classifiers so do not need to handle them");
       static_assert(!bValidation || !bHessian, "bHessian can only be true if bValidation is false");
-      static_assert(bValidation || !bWeight, "bWeight can only be true if bValidation is true");
+      // see IsFusedMetric for when training calculates the metric
+      static constexpr bool bMetric = bValidation || bWeight;
+      static_assert(bMetric || !bProbabilityMetrics, "bProbabilityMetrics requires the metric");
+
+      // the calibration bins are summed as cumulative sums below each interior bin boundary
+      static constexpr size_t cCalibrationBoundaries = k_cCalibrationBins - size_t { 1 };
 
       static constexpr bool bCompilerZeroDimensional = k_cItemsPerBitPackNone == cCompilerPack;
 
 #ifndef GPU_COMPILE
       EBM_ASSERT(nullptr != pData);
       EBM_ASSERT(nullptr != pData->m_aUpdateTensorScores);
+      EBM_ASSERT(1 <= pData->m_cTensorBins);
       EBM_ASSERT(1 <= pData->m_cSamples);
       EBM_ASSERT(0 == pData->m_cSamples % size_t { TFloat::k_cSIMDPack });
       EBM_ASSERT(nullptr != pData->m_aSampleScores);
@@ -92,6 +112,7 @@ struct LogLossBinaryObjective : BinaryObjective {
 #endif // GPU_COMPILE
 
       const typename TFloat::T * const aUpdateTensorScores = reinterpret_cast<const typename TFloat::T *>(pData->m_aUpdateTensorScores);
+      const UpdateTensorLookup<TFloat> updateTensor(aUpdateTensorScores, pData->m_cTensorBins);
 
       const size_t cSamples = pData->m_cSamples;
 
@@ -137,8 +158,11 @@ struct LogLossBinaryObjective : BinaryObjective {
 
       const typename TFloat::T * pWeight;
       TFloat metricSum;
-      typename TFloat::T * pGradientAndHessian;
-      if(bValidation) {
+      TFloat brierSum;
+      TFloat calibrationSum;
+      TFloat aCalibrationBelow[cCalibrationBoundaries];
+      GradHessStorage<TFloat, gradHessFormat> * pGradientAndHessian;
+      if(bMetric) {
          if(bWeight) {
             pWeight = reinterpret_cast<const typename TFloat::T *>(pData->m_aWeights);
 #ifndef GPU_COMPILE
@@ -146,8 +170,16 @@ struct LogLossBinaryObjective : BinaryObjective {
 #endif // GPU_COMPILE
          }
          metricSum = 0.0;
-      } else {
-         pGradientAndHessian = reinterpret_cast<typename TFloat::T *>(pData->m_aGradientsAndHessians);
+         if(bProbabilityMetrics) {
+            brierSum = 0.0;
+            calibrationSum = 0.0;
+            for(size_t iBoundary = 0; iBoundary < cCalibrationBoundaries; ++iBoundary) {
+               aCalibrationBelow[iBoundary] = 0.0;
+            }
+         }
+      }
+      if(!bValidation) {
+         pGradientAndHessian = reinterpret_cast<GradHessStorage<TFloat, gradHessFormat> *>(pData->m_aGradientsAndHessians);
 #ifndef GPU_COMPILE
          EBM_ASSERT(nullptr != pGradientAndHessian);
 #endif // GPU_COMPILE
@@ -171,7 +203,7 @@ struct LogLossBinaryObjective : BinaryObjective {
 
             if(!bCompilerZeroDimensional) {
                const typename TFloat::TInt iTensorBin = (iTensorBinCombined >> cShift) & maskBits;
-               updateScore = TFloat::Load(aUpdateTensorScores, iTensorBin);
+               updateScore = updateTensor.Load(iTensorBin);
             }
 
             const typename TFloat::TInt target = TFloat::TInt::Load(pTargetData);
@@ -182,7 +214,7 @@ struct LogLossBinaryObjective : BinaryObjective {
             sampleScore.Store(pSampleScore);
             pSampleScore += TFloat::k_cSIMDPack;
 
-            if(bValidation) {
+            if(bMetric) {
                // TODO: similar to the gradient calculation above, once we sort our data by the target values we
                //       will be able to pass all the targets==0 and target==1 in to a single call to this function
                //       and we can therefore template the target value.  We can then call ExpForBinaryClassification
@@ -192,16 +224,43 @@ struct LogLossBinaryObjective : BinaryObjective {
                TFloat metric = IfEqual(typename TFloat::TInt(0), target, sampleScore, -sampleScore);
                metric = TFloat::template ApproxExp<bDisableApprox, false>(metric);
                metric += 1.0;
+
+               TFloat error;
+               TFloat probability;
+               if(bProbabilityMetrics) {
+                  // metric holds 1 + exp(+-sampleScore) with the sign chosen by the target, so 1 - 1 / metric is the
+                  // distance between the probability of class 1 and the target.  This reuses the exp of the log loss
+                  // and reaches 1.0 instead of NaN when the exp overflows
+                  const TFloat distance = 1.0 - 1.0 / metric;
+                  error = IfEqual(typename TFloat::TInt(0), target, distance, -distance);
+                  probability = IfEqual(typename TFloat::TInt(0), target, distance, 1.0 - distance);
+               }
+
                metric = TFloat::template ApproxLog<bDisableApprox, false>(metric);
 
                if(bWeight) {
                   const TFloat weight = TFloat::Load(pWeight);
                   pWeight += TFloat::k_cSIMDPack;
                   metricSum = FusedMultiplyAdd(metric, weight, metricSum);
+                  if(bProbabilityMetrics) {
+                     brierSum = FusedMultiplyAdd(error * error, weight, brierSum);
+                     error *= weight;
+                  }
                } else {
                   metricSum += metric;
+                  if(bProbabilityMetrics) {
+                     brierSum = FusedMultiplyAdd(error, error, brierSum);
+                  }
                }
-            } else {
+               if(bProbabilityMetrics) {
+                  calibrationSum += error;
+                  for(size_t iBoundary = 0; iBoundary < cCalibrationBoundaries; ++iBoundary) {
+                     const TFloat boundary = static_cast<double>(iBoundary + size_t { 1 }) / static_cast<double>(k_cCalibrationBins);
+                     aCalibrationBelow[iBoundary] += IfLess(probability, boundary, error, 0.0);
+                  }
+               }
+            }
+            if(!bValidation) {
                // gradient will be 0.0 if we perfectly predict the target with 100% certainty.  
                //    To do so, sampleScore would need to be either +infinity or -infinity
                // gradient will be +1.0 if actual value was 1 but we incorrectly predicted with 
@@ -336,8 +395,18 @@ struct LogLossBinaryObjective : BinaryObjective {
          cShift = cShiftReset;
       } while(pSampleScoresEnd != pSampleScore);
 
-      if(bValidation) {
+      if(bMetric) {
          pData->m_metricOut = static_cast<double>(Sum(metricSum));
+         if(bProbabilityMetrics) {
+            pData->m_brierOut = static_cast<double>(Sum(brierSum));
+            double below = 0.0;
+            for(size_t iBoundary = 0; iBoundary < cCalibrationBoundaries; ++iBoundary) {
+               const double belowNext = static_cast<double>(Sum(aCalibrationBelow[iBoundary]));
+               pData->m_aCalibrationOut[iBoundary] = belowNext - below;
+               below = belowNext;
+            }
+            pData->m_aCalibrationOut[cCalibrationBoundaries] = static_cast<double>(Sum(calibrationSum)) - below;
+         }
       }
    }
 };
@@ -81,11 +81,13 @@ struct LogLossMulticlassObjective : MulticlassObjective {
       return GradientHessian<TFloat>(0.0, 0.0);
    }
 
-   template<bool bValidation, bool bWeight, bool bHessian, bool bDisableApprox, size_t cCompilerScores, int cCompilerPack>
+   template<bool bValidation, bool bWeight, bool bHessian, int gradHessFormat, bool bDisableApprox, size_t cCompilerScores, int cCompilerPack>
    GPU_DEVICE NEVER_INLINE void InjectedApplyUpdate(ApplyUpdateBridge * const pData) const {
       static_assert(k_dynamicScores == cCompilerScores || 2 <= cCompilerScores, "Multiclass needs more than 1 score");
       static_assert(!bValidation || !bHessian, "bHessian can only be true if bValidation is false");
-      static_assert(bValidation || !bWeight, "bWeight can only be true if bValidation is true");
+
+      // see IsFusedMetric for when training calculates the metric
+      static constexpr bool bMetric = bValidation || bWeight;
 
       static constexpr bool bCompilerZeroDimensional = k_cItemsPerBitPackNone == cCompilerPack;
       static constexpr bool bDynamic = k_dynamicScores == cCompilerScores;
@@ -156,8 +158,8 @@ struct LogLossMulticlassObjective : MulticlassObjective {
 
       const typename TFloat::T * pWeight;
       TFloat metricSum;
-      typename TFloat::T * pGradientAndHessian;
-      if(bValidation) {
+      GradHessStorage<TFloat, gradHessFormat> * pGradientAndHessian;
+      if(bMetric) {
          if(bWeight) {
             pWeight = reinterpret_cast<const typename TFloat::T *>(pData->m_aWeights);
 #ifndef GPU_COMPILE
@@ -165,8 +167,9 @@ struct LogLossMulticlassObjective : MulticlassObjective {
 #endif // GPU_COMPILE
          }
          metricSum = 0.0;
-      } else {
-         pGradientAndHessian = reinterpret_cast<typename TFloat::T *>(pData->m_aGradientsAndHessians);
+      }
+      if(!bValidation) {
+         pGradientAndHessian = reinterpret_cast<GradHessStorage<TFloat, gradHessFormat> *>(pData->m_aGradientsAndHessians);
 #ifndef GPU_COMPILE
          EBM_ASSERT(nullptr != pGradientAndHessian);
 #endif // GPU_COMPILE
@@ -234,18 +237,18 @@ struct LogLossMulticlassObjective : MulticlassObjective {
             typename TFloat::TInt target = TFloat::TInt::Load(pTargetData);
             pTargetData += TFloat::TInt::k_cSIMDPack;
 
-            if(bValidation) {
+            if(bMetric) {
                // TODO: instead of writing the exp values to memory, since we just need 1 and the sum, 
                // we could use an if selector to keep only the one that matches our target and we don't need
                // to store (or re-load) from memory.  This also saves us a gathering load, which will be expensive
                // in latency
 
-               target = target << TFloat::k_cSIMDShift;
-               target = target + TFloat::TInt::MakeIndexes();
+               // the gradients below still need the unshifted target
+               const typename TFloat::TInt iExp = (target << TFloat::k_cSIMDShift) + TFloat::TInt::MakeIndexes();
 
                // TODO: after we finish sorting our dataset, all the target values in this datasubset will be
                // identical, so instead of calling LoadScattered we'll be able to call LoadAligned
-               const TFloat itemExp = TFloat::Load(aExps, target);
+               const TFloat itemExp = TFloat::Load(aExps, iExp);
                const TFloat invertedProbability = FastApproxDivide(sumExp, itemExp);
                TFloat metric = TFloat::template ApproxLog<bDisableApprox, false>(invertedProbability);
 
@@ -256,7 +259,8 @@ struct LogLossMulticlassObjective : MulticlassObjective {
                } else {
                   metricSum += metric;
                }
-            } else {
+            }
+            if(!bValidation) {
                // this Reciprocal is fast and is more SIMD-able, but it does create some complications.
                // When sumExp gets somewhat large, arround +4.5 or above, then the sumExp can get to be something
                // in the order of +100.  The inverse of that is around 0.01. We can then later multiply a number
@@ -320,7 +324,7 @@ struct LogLossMulticlassObjective : MulticlassObjective {
          cShift = cShiftReset;
       } while(pSampleScoresEnd != pSampleScore);
 
-      if(bValidation) {
+      if(bMetric) {
          pData->m_metricOut = static_cast<double>(Sum(metricSum));
       }
    }
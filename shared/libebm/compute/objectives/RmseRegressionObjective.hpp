@@ -110,18 +110,22 @@ struct RmseRegressionObjective : RegressionObjective {
    }
 
 
-   template<bool bValidation, bool bWeight, bool bHessian, bool bDisableApprox, size_t cCompilerScores, int cCompilerPack>
+   template<bool bValidation, bool bWeight, bool bHessian, int gradHessFormat, bool bDisableApprox, size_t cCompilerScores, int cCompilerPack>
    GPU_DEVICE NEVER_INLINE void InjectedApplyUpdate(ApplyUpdateBridge * const pData) const {
       static_assert(k_oneScore == cCompilerScores, "for RMSE regression there should always be one score");
       static_assert(!bHessian, "for RMSE regression we should never need the hessians");
-      static_assert(bValidation || !bWeight, "bWeight can only be true if bValidation is true");
+      static_assert(k_gradHessFloat == gradHessFormat, "RMSE accumulates residuals in the gradients, so keep them in full precision");
       static_assert(!bDisableApprox, "Approximations cannot be disabled on RMSE since there are none on RMSE");
 
+      // the residuals are the same for training and validation, so the only difference is that validation always 
+      // calculates the metric and training only calculates it when the validation set is an alias
+      static constexpr bool bMetric = bValidation || bWeight;
       static constexpr bool bCompilerZeroDimensional = k_cItemsPerBitPackNone == cCompilerPack;
 
 #ifndef GPU_COMPILE
       EBM_ASSERT(nullptr != pData);
       EBM_ASSERT(nullptr != pData->m_aUpdateTensorScores);
+      EBM_ASSERT(1 <= pData->m_cTensorBins);
       EBM_ASSERT(1 <= pData->m_cSamples);
       EBM_ASSERT(0 == pData->m_cSamples % size_t { TFloat::k_cSIMDPack });
       EBM_ASSERT(nullptr == pData->m_aSampleScores);
@@ -130,6 +134,7 @@ struct RmseRegressionObjective : RegressionObjective {
 #endif // GPU_COMPILE
 
       const typename TFloat::T * const aUpdateTensorScores = reinterpret_cast<const typename TFloat::T *>(pData->m_aUpdateTensorScores);
+      const UpdateTensorLookup<TFloat> updateTensor(aUpdateTensorScores, pData->m_cTensorBins);
 
       const size_t cSamples = pData->m_cSamples;
 
@@ -173,7 +178,7 @@ struct RmseRegressionObjective : RegressionObjective {
 
       const typename TFloat::T * pWeight;
       TFloat metricSum;
-      if(bValidation) {
+      if(bMetric) {
          if(bWeight) {
             pWeight = reinterpret_cast<const typename TFloat::T *>(pData->m_aWeights);
 #ifndef GPU_COMPILE
@@ -200,7 +205,7 @@ struct RmseRegressionObjective : RegressionObjective {
          while(true) {
             if(!bCompilerZeroDimensional) {
                const typename TFloat::TInt iTensorBin = (iTensorBinCombined >> cShift) & maskBits;
-               updateScore = TFloat::Load(aUpdateTensorScores, iTensorBin);
+               updateScore = updateTensor.Load(iTensorBin);
             }
 
             TFloat gradient = TFloat::Load(pGradient);
@@ -208,7 +213,7 @@ struct RmseRegressionObjective : RegressionObjective {
             gradient.Store(pGradient);
             pGradient += TFloat::k_cSIMDPack;
 
-            if(bValidation) {
+            if(bMetric) {
                // we use RMSE so get the squared error part here
                if(bWeight) {
                   const TFloat weight = TFloat::Load(pWeight);
@@ -236,7 +241,7 @@ struct RmseRegressionObjective : RegressionObjective {
          cShift = cShiftReset;
       } while(pGradientsEnd != pGradient);
 
-      if(bValidation) {
+      if(bMetric) {
          pData->m_metricOut = static_cast<double>(Sum(metricSum));
       }
    }
@@ -10,6 +10,7 @@
 
 struct ApplyUpdateBridge;
 struct BinSumsBoostingBridge;
+struct BinSumsBoostingMultiBridge;
 struct BinSumsInteractionBridge;
 
 namespace DEFINED_ZONE_NAME {
@@ -25,6 +26,7 @@ typedef ErrorEbm (* APPLY_UPDATE_CPP)(const Objective * const pObjective, ApplyU
 typedef double (* FINISH_METRIC_CPP)(const Objective * const pObjective, const double metricSum);
 typedef BoolEbm (* CHECK_TARGETS_CPP)(const Objective * const pObjective, const size_t c, const void * const aTargets);
 typedef ErrorEbm (* BIN_SUMS_BOOSTING_CPP)(BinSumsBoostingBridge * const pParams);
+typedef ErrorEbm (* BIN_SUMS_BOOSTING_MULTI_CPP)(BinSumsBoostingMultiBridge * const pParams);
 typedef ErrorEbm (* BIN_SUMS_INTERACTION_CPP)(BinSumsInteractionBridge * const pParams);
 
 struct FunctionPointersCpp {
@@ -37,6 +39,7 @@ struct FunctionPointersCpp {
    CHECK_TARGETS_CPP m_pCheckTargetsCpp;
 
    BIN_SUMS_BOOSTING_CPP m_pBinSumsBoostingCpp;
+   BIN_SUMS_BOOSTING_MULTI_CPP m_pBinSumsBoostingMultiCpp;
    BIN_SUMS_INTERACTION_CPP m_pBinSumsInteractionCpp;
 };
 
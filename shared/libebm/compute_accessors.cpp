@@ -6,7 +6,7 @@
 
 #include <stddef.h> // size_t, ptrdiff_t
 
-#if defined(BRIDGE_AVX512F_32) || defined(BRIDGE_AVX2_32)
+#if defined(BRIDGE_AVX512F_32) || defined(BRIDGE_AVX2_32) || defined(BRIDGE_AVX2_64)
 #define INTEL_SIMD
 #endif
 
@@ -136,6 +136,17 @@ static bool IsFMA3() {
    return 0 != (abcd[2] & (1 << 12));
 }
 
+#ifdef BRIDGE_AVX512F_32
+static bool IsAVX512CD() {
+   // only call this if 9 <= DetectInstructionset(), which stands for AVX512F
+   // Every CPU with AVX512F that we know of also has AVX512CD, but the zone only uses the conflict detection 
+   // instructions when we say it can, so check anyways
+   int abcd[4];
+   cpuid(abcd, 7);
+   return 0 != (abcd[1] & (1 << 28));
+}
+#endif // BRIDGE_AVX512F_32
+
 #endif // INTEL_SIMD
 
 extern ErrorEbm GetObjective(
@@ -161,7 +172,13 @@ extern ErrorEbm GetObjective(
       return Error_ObjectiveUnknown;
    }
 
-   const char * const sObjectiveEnd = sObjective + strlen(sObjective);
+   // any validation metrics listed after the objective are handled by GetMetrics
+   const char * sObjectiveEnd = strchr(sObjective, k_registrationSeparator);
+   if(nullptr == sObjectiveEnd) {
+      sObjectiveEnd = sObjective + strlen(sObjective);
+   } else if(sObjectiveEnd == sObjective) {
+      return Error_ObjectiveUnknown;
+   }
 
    ErrorEbm error;
 
@@ -187,6 +204,10 @@ extern ErrorEbm GetObjective(
             if(Error_None != error) {
                return error;
             }
+            if(IsAVX512CD()) {
+               LOG_0(Trace_Info, "INFO GetObjective AVX512CD conflict detection available");
+               pSIMDObjectiveWrapperOut->m_bConflictDetect = EBM_TRUE;
+            }
             break;
          }
       }
@@ -207,30 +228,52 @@ extern ErrorEbm GetObjective(
       }
 #endif // BRIDGE_AVX2_32
 
+#ifdef BRIDGE_AVX2_64
+      // the double precision zone is slower than the float zones above, so we only get here if the caller
+      // disabled those, which is how callers that need double precision scores ask for SIMD
+      if(0 != (ComputeFlags_AVX2_64 & zones)) {
+         LOG_0(Trace_Info, "INFO GetObjective checking for AVX2 double precision compatibility");
+         EBM_ASSERT(nullptr != pSIMDObjectiveWrapperOut);
+         if(8 <= DetectInstructionset() && IsFMA3()) {
+            LOG_0(Trace_Info, "INFO GetObjective creating AVX2 double precision SIMD Objective");
+            error = CreateObjective_Avx2_64(pConfig, sObjective, sObjectiveEnd, pSIMDObjectiveWrapperOut);
+            if(Error_None != error) {
+               return error;
+            }
+            break;
+         }
+      }
+#endif // BRIDGE_AVX2_64
+
       LOG_0(Trace_Info, "INFO GetObjective no SIMD option found");
    } while(false);
 
    return Error_None;
 }
 
-#ifdef NEVER
-// TODO: eventually enable metrics
-INLINE_RELEASE_UNTEMPLATED static ErrorEbm GetMetrics(
-   const Config * const pConfig,
-   const char * sMetric
-//   MetricWrapper * const aMetricWrapperOut
-) noexcept {
-   EBM_ASSERT(nullptr != pConfig);
-   //EBM_ASSERT(nullptr != pMetricWrapperOut);
-   //aMetricWrapperOut->m_pMetric = nullptr;
-   //aMetricWrapperOut->m_pFunctionPointersCpp = nullptr;
-
+extern ErrorEbm GetMetrics(const char * sObjective, size_t * const pcMetricsOut, int * const aMetricsOut) noexcept {
+   // The objective string can list validation metrics after the objective, eg: "log_loss,brier,auc".  Without any
+   // the validation metric is the objective's own metric.  All the listed metrics are computed in the same pass
+   // over the validation set and the first one drives the best model tracking.  AUC is a rank statistic over the
+   // entire validation set so it is not registered per zone like the objectives.  BoosterCore computes it in the 
+   // main zone instead.  The brier and calibration_error metrics are fused into the log_loss validation pass.
+   EBM_ASSERT(nullptr != pcMetricsOut);
+   EBM_ASSERT(nullptr != aMetricsOut);
+
+   *pcMetricsOut = 1;
+   aMetricsOut[0] = k_metricObjective;
+   if(nullptr == sObjective) {
+      return Error_None;
+   }
+   const char * sMetric = strchr(sObjective, k_registrationSeparator);
    if(nullptr == sMetric) {
       // it's legal to have no metrics
       return Error_None;
    }
+   size_t cMetrics = 0;
    while(true) {
-      sMetric = SkipWhitespace(sMetric);
+      EBM_ASSERT(k_registrationSeparator == *sMetric);
+      sMetric = SkipWhitespace(sMetric + 1);
       const char * sMetricEnd = strchr(sMetric, k_registrationSeparator);
       if(nullptr == sMetricEnd) {
          // find the null terminator then
@@ -238,25 +281,32 @@ INLINE_RELEASE_UNTEMPLATED static ErrorEbm GetMetrics(
       }
       if(sMetricEnd != sMetric) {
          // we allow empty registrations like ",,,something_legal,,,  something_else  , " since the intent is clear
-         ErrorEbm error;
-
-         error = CreateMetric_Cpu_64(pConfig, sMetric, sMetricEnd);
-         if(Error_None != error) {
-            return error;
+         int metric;
+         if(sMetricEnd == IsStringEqualsCaseInsensitive(sMetric, "auc")) {
+            metric = k_metricAuc;
+         } else if(sMetricEnd == IsStringEqualsCaseInsensitive(sMetric, "brier")) {
+            metric = k_metricBrier;
+         } else if(sMetricEnd == IsStringEqualsCaseInsensitive(sMetric, "calibration_error")) {
+            metric = k_metricCalibrationError;
+         } else if(sMetricEnd == IsStringEqualsCaseInsensitive(sMetric, "log_loss")) {
+            metric = k_metricLogLoss;
+         } else {
+            LOG_0(Trace_Error, "ERROR GetMetrics unknown metric");
+            return Error_ObjectiveUnknown;
          }
-
-         // TODO: for now let's return after we find the first metric, but in the future we'll want to return
-         //       some kind of list of them
-         return error;
+         if(k_cMetricsMax == cMetrics) {
+            LOG_0(Trace_Error, "ERROR GetMetrics too many metrics");
+            return Error_IllegalParamVal;
+         }
+         aMetricsOut[cMetrics] = metric;
+         ++cMetrics;
+         *pcMetricsOut = cMetrics;
       }
       if('\0' == *sMetricEnd) {
          return Error_None;
       }
-      EBM_ASSERT(k_registrationSeparator == *sMetricEnd);
-
-      sMetric = sMetricEnd + 1;
+      sMetric = sMetricEnd;
    }
 }
-#endif // NEVER
 
 } // DEFINED_ZONE_NAME
@@ -53,6 +53,10 @@ static constexpr FloatCalc k_epsilonNegativeGainAllowed = FloatCalc { -1e-7 };
 
 static constexpr bool k_bUseLogitboost = false;
 
+// the cache size we assume when the OS cannot tell us how much L2 cache we have.  Terms with fast bins larger than 
+// the cache are binned by sorting the samples into ranges of bins first
+static constexpr size_t k_cBytesHistogramCacheDefault = size_t { 1 } << 20;
+
 extern double FloatTickIncrementInternal(double deprecisioned[1]) noexcept;
 extern double FloatTickDecrementInternal(double deprecisioned[1]) noexcept;
 
@@ -197,6 +197,29 @@ typedef struct _InteractionHandle {
 #define CreateBoosterFlags_DifferentialPrivacy     (CREATE_BOOSTER_FLAGS_CAST(0x00000001))
 #define CreateBoosterFlags_DisableApprox           (CREATE_BOOSTER_FLAGS_CAST(0x00000002))
 #define CreateBoosterFlags_BinaryAsMulticlass      (CREATE_BOOSTER_FLAGS_CAST(0x00000004))
+// experimentalParams[0] holds the thread count if experimentalParams is not NULL, otherwise use all cores.
+// The models are identical for any thread count.  With or without this flag, 2 or more inner bags are each boosted 
+// with their own random number stream seeded from the rng passed to GenerateTermUpdate in bag order, so the flag 
+// does not change the random numbers.  It does split the training set into subsets that are summed separately, so on 
+// datasets with more than about 131k samples the sums can round differently than without the flag
+#define CreateBoosterFlags_Multithreaded           (CREATE_BOOSTER_FLAGS_CAST(0x00000008))
+// pin the worker threads to CPUs and have each thread first touch the data subsets it processes, which places them
+// in the memory of that thread's NUMA node.  Only used with CreateBoosterFlags_Multithreaded.  Pinning is Linux only.
+// The calling thread is not pinned and only waits, so the subsets are processed by one thread less than the thread 
+// count.  Boosters that share their data through CreateBoosterBags and boost at the same time process their subsets 
+// on the calling thread while another booster has the workers, which loses the locality for those calls
+#define CreateBoosterFlags_PinThreads              (CREATE_BOOSTER_FLAGS_CAST(0x00000010))
+// store the training gradients and hessians as bfloat16, which halves their memory traffic.  Only used by objectives 
+// that have hessians.  The gradients are still calculated and summed in full precision
+#define CreateBoosterFlags_Bfloat16Gradients       (CREATE_BOOSTER_FLAGS_CAST(0x00000020))
+// time the compute zones and BinSums kernels on a sample of the training data when the booster is created and keep 
+// the fastest.  The zones differ in floating point precision, so the models can vary slightly between machines and runs.
+// The SIMD zones are candidates even without CreateBoosterFlags_EnableSIMD
+#define CreateBoosterFlags_Autotune                (CREATE_BOOSTER_FLAGS_CAST(0x00000080))
+// allow the objective to run in the SIMD zones that disableCompute leaves enabled.  The SIMD zones compute in float32
+// with approximate exp and log, so the models differ slightly from the float64 CPU zone, which is used otherwise.
+// CreateBoosterFlags_Autotune also allows the SIMD zones since it already accepts differences in precision
+#define CreateBoosterFlags_EnableSIMD              (CREATE_BOOSTER_FLAGS_CAST(0x00000100))
 
 #define TermBoostFlags_Default                     (TERM_BOOST_FLAGS_CAST(0x00000000))
 #define TermBoostFlags_DisableNewtonGain           (TERM_BOOST_FLAGS_CAST(0x00000001))
@@ -208,6 +231,10 @@ typedef struct _InteractionHandle {
 #define CreateInteractionFlags_DifferentialPrivacy (CREATE_INTERACTION_FLAGS_CAST(0x00000001))
 #define CreateInteractionFlags_DisableApprox       (CREATE_INTERACTION_FLAGS_CAST(0x00000002))
 #define CreateInteractionFlags_BinaryAsMulticlass  (CREATE_INTERACTION_FLAGS_CAST(0x00000004))
+// experimentalParams[0] holds the thread count if experimentalParams is not NULL, otherwise use all cores
+#define CreateInteractionFlags_Multithreaded       (CREATE_INTERACTION_FLAGS_CAST(0x00000008))
+// same as CreateBoosterFlags_EnableSIMD
+#define CreateInteractionFlags_EnableSIMD          (CREATE_INTERACTION_FLAGS_CAST(0x00000010))
 
 #define CalcInteractionFlags_Default               (CALC_INTERACTION_FLAGS_CAST(0x00000000))
 #define CalcInteractionFlags_Pure                  (CALC_INTERACTION_FLAGS_CAST(0x00000001))
@@ -218,7 +245,8 @@ typedef struct _InteractionHandle {
 #define ComputeFlags_Nvidia                        (COMPUTE_CAST(0x00000002))
 #define ComputeFlags_AVX2                          (COMPUTE_CAST(0x00000004))
 #define ComputeFlags_AVX512F                       (COMPUTE_CAST(0x00000008))
-#define ComputeFlags_IntelSIMD                     (ComputeFlags_AVX2 | ComputeFlags_AVX512F)
+#define ComputeFlags_AVX2_64                       (COMPUTE_CAST(0x00000010))
+#define ComputeFlags_IntelSIMD                     (ComputeFlags_AVX2 | ComputeFlags_AVX512F | ComputeFlags_AVX2_64)
 #define ComputeFlags_SIMD                          (ComputeFlags_IntelSIMD)
 #define ComputeFlags_GPU                           (ComputeFlags_Nvidia)
 #define ComputeFlags_ALL                           (COMPUTE_CAST(~COMPUTE_CAST(0)))
@@ -464,6 +492,26 @@ EBM_API_INCLUDE ErrorEbm EBM_CALLING_CONVENTION CreateBooster(
    const double * experimentalParams,
    BoosterHandle * boosterHandleOut
 );
+// CreateBoosterBags creates one booster per outer bag. The bags array holds countBags bag arrays, each with one 
+// entry per sample in the dataSet. Each booster holds one copy of the samples that its bag includes, which its
+// validation set shares, so the metric is computed over all the included samples with zero weight on the 
+// training samples. Boosters whose bags include the same samples also share the packed term data, and all the
+// boosters share the thread pool. initScores, if not NULL, holds the scores for every sample in the dataSet. 
+// Inner bags are not supported. Each returned handle is independent and must be freed with FreeBooster.
+EBM_API_INCLUDE ErrorEbm EBM_CALLING_CONVENTION CreateBoosterBags(
+   const void * dataSet,
+   IntEbm countBags,
+   const BagEbm * bags,
+   const double * initScores,
+   IntEbm countTerms,
+   const IntEbm * dimensionCounts,
+   const IntEbm * featureIndexes,
+   CreateBoosterFlags flags,
+   ComputeFlags disableCompute,
+   const char * objective,
+   const double * experimentalParams,
+   BoosterHandle * boosterHandlesOut
+);
 EBM_API_INCLUDE ErrorEbm EBM_CALLING_CONVENTION CreateBoosterView(
    BoosterHandle boosterHandle,
    BoosterHandle * boosterHandleViewOut
@@ -501,6 +549,39 @@ EBM_API_INCLUDE ErrorEbm EBM_CALLING_CONVENTION ApplyTermUpdate(
    BoosterHandle boosterHandle,
    double * avgValidationMetricOut
 );
+// GetValidationMetrics returns the validation metrics calculated by the latest ApplyTermUpdate in the order that they
+// were listed after the objective, eg: "log_loss,brier,calibration_error,auc".  The first metric is the one returned
+// from ApplyTermUpdate and used to select the best model.  countMetrics is 1 if no metrics were listed, and the metric
+// is then the objective's own metric.  Like ApplyTermUpdate, metrics that are better when higher are negated
+EBM_API_INCLUDE ErrorEbm EBM_CALLING_CONVENTION GetValidationMetrics(
+   BoosterHandle boosterHandle,
+   IntEbm countMetrics,
+   double * validationMetricsOut
+);
+// PrefetchTerm hints that the next GenerateTermUpdate will boost indexTerm, which lets the next ApplyTermUpdate bin 
+// that term while it updates the gradients.  The results are identical with or without the hint.  Only main terms 
+// are prefetched, and the hint is cleared by ApplyTermUpdate.  Pass -1 to cancel the hint
+EBM_API_INCLUDE ErrorEbm EBM_CALLING_CONVENTION PrefetchTerm(
+   BoosterHandle boosterHandle,
+   IntEbm indexTerm
+);
+// BoostRounds runs whole cyclic/greedy boosting rounds by calling GenerateTermUpdate and ApplyTermUpdate internally.
+// leavesMax applies to every dimension of every term.  countRoundsOut is the number of rounds completed
+EBM_API_INCLUDE ErrorEbm EBM_CALLING_CONVENTION BoostRounds(
+   void * rng,
+   BoosterHandle boosterHandle,
+   TermBoostFlags flags,
+   double learningRate,
+   IntEbm minSamplesLeaf,
+   IntEbm leavesMax,
+   double greediness,
+   IntEbm smoothingRounds,
+   IntEbm maxRounds,
+   IntEbm earlyStoppingRounds,
+   double earlyStoppingTolerance,
+   IntEbm * countRoundsOut,
+   double * bestMetricOut
+);
 EBM_API_INCLUDE ErrorEbm EBM_CALLING_CONVENTION GetBestTermScores(
    BoosterHandle boosterHandle, 
    IntEbm indexTerm,
@@ -535,6 +616,24 @@ EBM_API_INCLUDE ErrorEbm EBM_CALLING_CONVENTION CalcInteractionStrength(
    IntEbm minSamplesLeaf,
    double * avgInteractionStrengthOut
 );
+// CalcInteractionStrengths calculates the strengths of countTerms terms in one call. Term i has dimensionCounts[i]
+// features, and the feature indexes of all the terms are concatenated in featureIndexes. Each strength is 
+// identical to what CalcInteractionStrength would return for the term. The terms are spread over the threads of 
+// an InteractionHandle created with CreateInteractionFlags_Multithreaded. If topTermIndexesOut is not NULL, it
+// receives the indexes of the min(countTopTerms, countTerms) strongest terms in decreasing order of strength, 
+// with ties ordered by decreasing term index.
+EBM_API_INCLUDE ErrorEbm EBM_CALLING_CONVENTION CalcInteractionStrengths(
+   InteractionHandle interactionHandle,
+   IntEbm countTerms,
+   const IntEbm * dimensionCounts,
+   const IntEbm * featureIndexes,
+   CalcInteractionFlags flags,
+   IntEbm maxCardinality,
+   IntEbm minSamplesLeaf,
+   double * avgInteractionStrengthsOut,
+   IntEbm countTopTerms,
+   IntEbm * topTermIndexesOut
+);
 
 #ifdef __cplusplus
 } // extern "C"
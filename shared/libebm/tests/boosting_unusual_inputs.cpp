@@ -1912,3 +1912,1682 @@ TEST_CASE("tweedie, boosting") {
    termScore = test.GetCurrentTermScore(0, {0}, 0);
    CHECK_APPROX(termScore, 2.3025076860047466);
 }
+
+TEST_CASE("multithreaded, boosting, binary") {
+   // enough samples to require multiple data subsets, which are the unit of work handed to each thread
+   std::vector<TestSample> train;
+   std::vector<TestSample> validation;
+   for(IntEbm i = 0; i < 300000; ++i) {
+      const IntEbm bin0 = i % 7;
+      const IntEbm bin1 = (i / 7) % 5;
+      const double target = (bin0 + bin1 + i % 3) % 2;
+      train.push_back(TestSample({ bin0, bin1 }, target));
+      if(0 == i % 100) {
+         validation.push_back(TestSample({ bin0, bin1 }, target));
+      }
+   }
+
+   TestBoost test1 = TestBoost(
+      OutputType_BinaryClassification,
+      { FeatureTest(7), FeatureTest(5) },
+      { { 0 }, { 1 }, { 0, 1 } },
+      train,
+      validation
+   );
+
+   TestBoost test2 = TestBoost(
+      OutputType_BinaryClassification,
+      { FeatureTest(7), FeatureTest(5) },
+      { { 0 }, { 1 }, { 0, 1 } },
+      train,
+      validation,
+      k_countInnerBagsDefault,
+      k_testCreateBoosterFlags_Default | CreateBoosterFlags_Multithreaded,
+      k_testComputeFlags_Default,
+      nullptr,
+      k_iZeroClassificationLogitDefault,
+      { 4.0 } // the thread count
+   );
+
+   for(int iEpoch = 0; iEpoch < 10; ++iEpoch) {
+      for(size_t iTerm = 0; iTerm < test1.GetCountTerms(); ++iTerm) {
+         const BoostRet ret1 = test1.Boost(iTerm);
+         const BoostRet ret2 = test2.Boost(iTerm);
+         CHECK_APPROX(ret1.gainAvg, ret2.gainAvg);
+         CHECK_APPROX(ret1.validationMetric, ret2.validationMetric);
+      }
+   }
+
+   for(IntEbm bin0 = 0; bin0 < 7; ++bin0) {
+      CHECK_APPROX(test1.GetCurrentTermScore(0, { static_cast<size_t>(bin0) }, 0), 
+         test2.GetCurrentTermScore(0, { static_cast<size_t>(bin0) }, 0));
+   }
+}
+
+TEST_CASE("multithreaded, boosting, multiclass") {
+   // multiple validation subsets so that the validation metric is reduced across subsets
+   std::vector<TestSample> train;
+   std::vector<TestSample> validation;
+   for(IntEbm i = 0; i < 200000; ++i) {
+      const IntEbm bin0 = i % 7;
+      const IntEbm bin1 = (i / 7) % 5;
+      train.push_back(TestSample({ bin0, bin1 }, static_cast<double>((bin0 + bin1 + i % 4) % 3)));
+      validation.push_back(TestSample({ bin1, bin0 % 5 }, static_cast<double>((bin0 * bin1 + i % 5) % 3)));
+   }
+
+   TestBoost test1 = TestBoost(
+      3,
+      { FeatureTest(7), FeatureTest(5) },
+      { { 0 }, { 1 }, { 0, 1 } },
+      train,
+      validation
+   );
+
+   TestBoost test2 = TestBoost(
+      3,
+      { FeatureTest(7), FeatureTest(5) },
+      { { 0 }, { 1 }, { 0, 1 } },
+      train,
+      validation,
+      k_countInnerBagsDefault,
+      k_testCreateBoosterFlags_Default | CreateBoosterFlags_Multithreaded,
+      k_testComputeFlags_Default,
+      nullptr,
+      k_iZeroClassificationLogitDefault,
+      { 2.0 } // the thread count
+   );
+
+   TestBoost test3 = TestBoost(
+      3,
+      { FeatureTest(7), FeatureTest(5) },
+      { { 0 }, { 1 }, { 0, 1 } },
+      train,
+      validation,
+      k_countInnerBagsDefault,
+      k_testCreateBoosterFlags_Default | CreateBoosterFlags_Multithreaded,
+      k_testComputeFlags_Default,
+      nullptr,
+      k_iZeroClassificationLogitDefault,
+      { 5.0 } // the thread count
+   );
+
+   for(int iEpoch = 0; iEpoch < 5; ++iEpoch) {
+      for(size_t iTerm = 0; iTerm < test1.GetCountTerms(); ++iTerm) {
+         const BoostRet ret1 = test1.Boost(iTerm);
+         const BoostRet ret2 = test2.Boost(iTerm);
+         const BoostRet ret3 = test3.Boost(iTerm);
+         CHECK_APPROX(ret1.gainAvg, ret2.gainAvg);
+         CHECK_APPROX(ret1.validationMetric, ret2.validationMetric);
+         // the results should be identical regardless of the number of threads
+         CHECK(ret2.gainAvg == ret3.gainAvg);
+         CHECK(ret2.validationMetric == ret3.validationMetric);
+      }
+   }
+
+   for(IntEbm bin0 = 0; bin0 < 7; ++bin0) {
+      for(size_t iClass = 0; iClass < 3; ++iClass) {
+         CHECK_APPROX(test1.GetCurrentTermScore(0, { static_cast<size_t>(bin0) }, iClass),
+            test2.GetCurrentTermScore(0, { static_cast<size_t>(bin0) }, iClass));
+         CHECK(test2.GetCurrentTermScore(0, { static_cast<size_t>(bin0) }, iClass) ==
+            test3.GetCurrentTermScore(0, { static_cast<size_t>(bin0) }, iClass));
+      }
+   }
+}
+
+TEST_CASE("multithreaded, boosting, pinned threads") {
+   // multiple training and validation subsets so that each pinned worker owns several of them
+   std::vector<TestSample> train;
+   std::vector<TestSample> validation;
+   for(IntEbm i = 0; i < 300000; ++i) {
+      const IntEbm bin0 = i % 7;
+      const IntEbm bin1 = (i / 7) % 5;
+      train.push_back(TestSample({ bin0, bin1 }, static_cast<double>((bin0 + bin1 + i % 4) % 2)));
+      if(0 == i % 2) {
+         validation.push_back(TestSample({ bin1, bin0 % 5 }, static_cast<double>((bin0 * bin1 + i % 5) % 2)));
+      }
+   }
+
+   TestBoost test1 = TestBoost(
+      OutputType_BinaryClassification,
+      { FeatureTest(7), FeatureTest(5) },
+      { { 0 }, { 1 }, { 0, 1 } },
+      train,
+      validation,
+      2,
+      k_testCreateBoosterFlags_Default | CreateBoosterFlags_Multithreaded,
+      k_testComputeFlags_Default,
+      nullptr,
+      k_iZeroClassificationLogitDefault,
+      { 3.0 } // the thread count
+   );
+
+   TestBoost test2 = TestBoost(
+      OutputType_BinaryClassification,
+      { FeatureTest(7), FeatureTest(5) },
+      { { 0 }, { 1 }, { 0, 1 } },
+      train,
+      validation,
+      2,
+      k_testCreateBoosterFlags_Default | CreateBoosterFlags_Multithreaded | CreateBoosterFlags_PinThreads,
+      k_testComputeFlags_Default,
+      nullptr,
+      k_iZeroClassificationLogitDefault,
+      { 3.0 } // the thread count
+   );
+
+   for(int iEpoch = 0; iEpoch < 3; ++iEpoch) {
+      for(size_t iTerm = 0; iTerm < test1.GetCountTerms(); ++iTerm) {
+         const BoostRet ret1 = test1.Boost(iTerm);
+         const BoostRet ret2 = test2.Boost(iTerm);
+         // moving the subsets and pinning the threads does not change the results
+         CHECK(ret1.gainAvg == ret2.gainAvg);
+         CHECK(ret1.validationMetric == ret2.validationMetric);
+      }
+   }
+
+   for(IntEbm bin0 = 0; bin0 < 7; ++bin0) {
+      CHECK(test1.GetCurrentTermScore(0, { static_cast<size_t>(bin0) }, 0) ==
+         test2.GetCurrentTermScore(0, { static_cast<size_t>(bin0) }, 0));
+   }
+}
+
+TEST_CASE("multithreaded, boosting, inner bags") {
+   std::vector<TestSample> train;
+   std::vector<TestSample> validation;
+   for(IntEbm i = 0; i < 20000; ++i) {
+      const IntEbm bin0 = i % 7;
+      const IntEbm bin1 = (i / 7) % 5;
+      train.push_back(TestSample({ bin0, bin1 }, static_cast<double>(bin0 * bin1 + i % 3)));
+      if(0 == i % 10) {
+         validation.push_back(TestSample({ bin0, bin1 }, static_cast<double>(bin0 + bin1)));
+      }
+   }
+
+   // the inner bags are boosted concurrently on the 3 thread booster, but the results should be identical to the 
+   // single threaded boosters with or without CreateBoosterFlags_Multithreaded
+   TestBoost test0 = TestBoost(
+      OutputType_Regression,
+      { FeatureTest(7), FeatureTest(5) },
+      { { 0 }, { 1 }, { 0, 1 } },
+      train,
+      validation,
+      5
+   );
+
+   TestBoost test1 = TestBoost(
+      OutputType_Regression,
+      { FeatureTest(7), FeatureTest(5) },
+      { { 0 }, { 1 }, { 0, 1 } },
+      train,
+      validation,
+      5,
+      k_testCreateBoosterFlags_Default | CreateBoosterFlags_Multithreaded,
+      k_testComputeFlags_Default,
+      nullptr,
+      k_iZeroClassificationLogitDefault,
+      { 1.0 } // the thread count
+   );
+
+   TestBoost test2 = TestBoost(
+      OutputType_Regression,
+      { FeatureTest(7), FeatureTest(5) },
+      { { 0 }, { 1 }, { 0, 1 } },
+      train,
+      validation,
+      5,
+      k_testCreateBoosterFlags_Default | CreateBoosterFlags_Multithreaded,
+      k_testComputeFlags_Default,
+      nullptr,
+      k_iZeroClassificationLogitDefault,
+      { 3.0 } // the thread count
+   );
+
+   for(int iEpoch = 0; iEpoch < 5; ++iEpoch) {
+      for(size_t iTerm = 0; iTerm < test1.GetCountTerms(); ++iTerm) {
+         // alternate with random splits, which consume the random numbers of each inner bag
+         const TermBoostFlags flags = 0 == iEpoch % 2 ? TermBoostFlags_Default : TermBoostFlags_RandomSplits;
+         const BoostRet ret0 = test0.Boost(iTerm, flags);
+         const BoostRet ret1 = test1.Boost(iTerm, flags);
+         const BoostRet ret2 = test2.Boost(iTerm, flags);
+         CHECK(ret0.gainAvg == ret1.gainAvg);
+         CHECK(ret0.validationMetric == ret1.validationMetric);
+         CHECK(ret1.gainAvg == ret2.gainAvg);
+         CHECK(ret1.validationMetric == ret2.validationMetric);
+      }
+   }
+
+   for(IntEbm bin0 = 0; bin0 < 7; ++bin0) {
+      for(IntEbm bin1 = 0; bin1 < 5; ++bin1) {
+         CHECK(test1.GetCurrentTermScore(2, { static_cast<size_t>(bin0), static_cast<size_t>(bin1) }, 0) ==
+            test2.GetCurrentTermScore(2, { static_cast<size_t>(bin0), static_cast<size_t>(bin1) }, 0));
+      }
+   }
+}
+
+TEST_CASE("boosting, inner bags advance the caller rng once per bag") {
+   std::vector<TestSample> train;
+   for(IntEbm i = 0; i < 1000; ++i) {
+      train.push_back(TestSample({ i % 7 }, static_cast<double>(i % 3)));
+   }
+
+   static constexpr IntEbm cInnerBags = 5;
+
+   for(const CreateBoosterFlags flags : 
+      { k_testCreateBoosterFlags_Default, k_testCreateBoosterFlags_Default | CreateBoosterFlags_Multithreaded }) 
+   {
+      // the intercept term does not draw any random numbers, so only the inner bag seeding touches the caller rng
+      TestBoost test = TestBoost(
+         OutputType_Regression,
+         { FeatureTest(7) },
+         { {} },
+         train,
+         {},
+         cInnerBags,
+         flags,
+         k_testComputeFlags_Default,
+         nullptr,
+         k_iZeroClassificationLogitDefault,
+         { 2.0 } // the thread count
+      );
+
+      std::vector<unsigned char> rng1(static_cast<size_t>(MeasureRNG()));
+      InitRNG(k_seed, &rng1[0]);
+      std::vector<unsigned char> rng2(static_cast<size_t>(MeasureRNG()));
+      InitRNG(k_seed, &rng2[0]);
+      std::vector<unsigned char> rngBranch(static_cast<size_t>(MeasureRNG()));
+
+      for(int iRound = 0; iRound < 3; ++iRound) {
+         double gain;
+         const ErrorEbm error = GenerateTermUpdate(
+            &rng1[0],
+            test.GetBoosterHandle(),
+            0,
+            TermBoostFlags_Default,
+            k_learningRateDefault,
+            k_minSamplesLeafDefault,
+            nullptr,
+            &gain
+         );
+         CHECK(Error_None == error);
+
+         // BranchRNG draws one 64 bit seed, which is what each inner bag takes from the caller rng
+         for(IntEbm iBag = 0; iBag < cInnerBags; ++iBag) {
+            BranchRNG(&rng2[0], &rngBranch[0]);
+         }
+
+         SeedEbm seed1;
+         CHECK(Error_None == GenerateSeed(&rng1[0], &seed1));
+         SeedEbm seed2;
+         CHECK(Error_None == GenerateSeed(&rng2[0], &seed2));
+         CHECK(seed1 == seed2);
+      }
+   }
+}
+
+TEST_CASE("BoostRounds, matches individual boosting steps") {
+   std::vector<TestSample> train;
+   std::vector<TestSample> validation;
+   for(IntEbm i = 0; i < 1000; ++i) {
+      const IntEbm bin0 = i % 7;
+      const IntEbm bin1 = (i / 7) % 5;
+      const IntEbm bin2 = (i / 35) % 3;
+      train.push_back(TestSample({ bin0, bin1, bin2 }, static_cast<double>(bin0 * bin1 + bin2 + i % 3)));
+      if(0 == i % 4) {
+         validation.push_back(TestSample({ bin0, bin1, bin2 }, static_cast<double>(bin0 * bin1 + bin2)));
+      }
+   }
+
+   const std::vector<FeatureTest> features = { FeatureTest(7), FeatureTest(5), FeatureTest(3) };
+   const std::vector<std::vector<IntEbm>> terms = { { 0 }, { 1 }, { 2 }, { 0, 1 } };
+
+   static constexpr double learningRate = 0.1;
+   static constexpr IntEbm leavesMax = 3;
+   static constexpr double greediness = 0.5;
+   static constexpr IntEbm smoothingRounds = 2;
+   static constexpr IntEbm maxRounds = 8;
+
+   TestBoost test1 = TestBoost(OutputType_Regression, features, terms, train, validation);
+   TestBoost test2 = TestBoost(OutputType_Regression, features, terms, train, validation);
+
+   std::vector<unsigned char> rng1(static_cast<size_t>(MeasureRNG()));
+   InitRNG(k_seed, &rng1[0]);
+   std::vector<unsigned char> rng2(static_cast<size_t>(MeasureRNG()));
+   InitRNG(k_seed, &rng2[0]);
+
+   IntEbm countRounds = 0;
+   double bestMetric = 0.0;
+   ErrorEbm error = BoostRounds(
+      &rng1[0],
+      test1.GetBoosterHandle(),
+      TermBoostFlags_Default,
+      learningRate,
+      k_minSamplesLeafDefault,
+      leavesMax,
+      greediness,
+      smoothingRounds,
+      maxRounds,
+      0,
+      0.0,
+      &countRounds,
+      &bestMetric
+   );
+   CHECK(Error_None == error);
+   CHECK(maxRounds == countRounds);
+
+   // the same schedule as BoostRounds using the individual boosting steps
+   const std::vector<IntEbm> aLeavesMax(terms.size(), leavesMax);
+   std::vector<double> gains(terms.size(), 0.0);
+   double greedyPortion = 0.0;
+   double minMetric = std::numeric_limits<double>::infinity();
+   IntEbm cSmoothingRounds = smoothingRounds;
+   for(IntEbm iRound = 0; iRound < maxRounds; ++iRound) {
+      const TermBoostFlags flags = IntEbm { 0 } < cSmoothingRounds ?
+         TermBoostFlags_DisableNewtonGain | TermBoostFlags_DisableNewtonUpdate | TermBoostFlags_RandomSplits :
+         TermBoostFlags_Default;
+      const bool bGreedy = 1.0 <= greedyPortion;
+      for(size_t iStep = 0; iStep < terms.size(); ++iStep) {
+         size_t iTerm = iStep;
+         if(bGreedy) {
+            iTerm = 0;
+            for(size_t iTermCompare = 1; iTermCompare < terms.size(); ++iTermCompare) {
+               if(gains[iTerm] < gains[iTermCompare]) {
+                  iTerm = iTermCompare;
+               }
+            }
+         }
+         error = GenerateTermUpdate(
+            &rng2[0],
+            test2.GetBoosterHandle(),
+            static_cast<IntEbm>(iTerm),
+            flags,
+            learningRate,
+            k_minSamplesLeafDefault,
+            &aLeavesMax[0],
+            &gains[iTerm]
+         );
+         CHECK(Error_None == error);
+         double metric;
+         error = ApplyTermUpdate(test2.GetBoosterHandle(), &metric);
+         CHECK(Error_None == error);
+         minMetric = minMetric < metric ? minMetric : metric;
+      }
+      if(bGreedy) {
+         greedyPortion -= 1.0;
+      }
+      if(IntEbm { 0 } < cSmoothingRounds) {
+         --cSmoothingRounds;
+      } else {
+         greedyPortion += greediness;
+      }
+   }
+
+   CHECK(minMetric == bestMetric);
+   for(size_t iTerm = 0; iTerm < 3; ++iTerm) {
+      CHECK(test1.GetCurrentTermScore(iTerm, { 1 }, 0) == test2.GetCurrentTermScore(iTerm, { 1 }, 0));
+   }
+   CHECK(test1.GetCurrentTermScore(3, { 1, 2 }, 0) == test2.GetCurrentTermScore(3, { 1, 2 }, 0));
+}
+
+TEST_CASE("BoostRounds, early stopping") {
+   TestBoost test = TestBoost(
+      OutputType_Regression,
+      { FeatureTest(2) },
+      { { 0 } },
+      { TestSample({ 0 }, 10), TestSample({ 1 }, 20) },
+      { TestSample({ 0 }, 10), TestSample({ 1 }, 20) }
+   );
+
+   IntEbm countRounds = 0;
+   double bestMetric = 0.0;
+   const ErrorEbm error = BoostRounds(
+      nullptr,
+      test.GetBoosterHandle(),
+      TermBoostFlags_Default,
+      k_learningRateDefault,
+      k_minSamplesLeafDefault,
+      3,
+      0.0,
+      0,
+      1000000,
+      5,
+      1000.0, // no round can improve by this much, so we stop after the early stopping rounds
+      &countRounds,
+      &bestMetric
+   );
+   CHECK(Error_None == error);
+   CHECK(5 == countRounds);
+   CHECK(bestMetric < std::numeric_limits<double>::infinity());
+}
+
+TEST_CASE("boosting, main terms on unchanged gradients") {
+   // multithreaded boosters split the training set into subsets that they bin concurrently
+   for(const bool bMultithreaded : { false, true }) {
+      const IntEbm cSamples = bMultithreaded ? IntEbm { 300000 } : IntEbm { 3000 };
+      std::vector<TestSample> train;
+      std::vector<TestSample> validation;
+      for(IntEbm i = 0; i < cSamples; ++i) {
+         const IntEbm bin0 = i % 7;
+         const IntEbm bin1 = (i / 7) % 5;
+         const IntEbm bin2 = (i / 35) % 3;
+         const IntEbm bin3 = (i / 105) % 4;
+         const double target = static_cast<double>((bin0 + bin1 * bin2 + bin3 + i % 2) % 3);
+         const double weight = 0.5 + static_cast<double>(i % 5) * 0.25;
+         train.push_back(TestSample({ bin0, bin1, bin2, bin3 }, target, weight));
+         if(0 == i % 6) {
+            validation.push_back(TestSample({ bin0, bin1, bin2, bin3 }, target, weight));
+         }
+      }
+
+      const std::vector<FeatureTest> features = { FeatureTest(7), FeatureTest(5), FeatureTest(3), FeatureTest(4) };
+      const std::vector<std::vector<IntEbm>> terms = { { 0 }, { 1 }, { 0, 1 }, { 2 }, { 3 } };
+
+      // test1 ranks all the terms on the same gradients, which bins the main terms together.  test2 applies an
+      // all zero update after each term, which leaves the gradients the same but prevents binning them together
+      const CreateBoosterFlags flags = 
+         k_testCreateBoosterFlags_Default | (bMultithreaded ? CreateBoosterFlags_Multithreaded : CreateBoosterFlags_Default);
+      TestBoost test1 = TestBoost(3, features, terms, train, validation, k_countInnerBagsDefault, flags,
+         k_testComputeFlags_Default, nullptr, k_iZeroClassificationLogitDefault, { 2.0 });
+      TestBoost test2 = TestBoost(3, features, terms, train, validation, k_countInnerBagsDefault, flags,
+         k_testComputeFlags_Default, nullptr, k_iZeroClassificationLogitDefault, { 2.0 });
+
+      std::vector<unsigned char> rng1(static_cast<size_t>(MeasureRNG()));
+      InitRNG(k_seed, &rng1[0]);
+      std::vector<unsigned char> rng2(static_cast<size_t>(MeasureRNG()));
+      InitRNG(k_seed, &rng2[0]);
+
+      const std::vector<IntEbm> leavesMax(2, 3);
+      ErrorEbm error;
+      for(int iRound = 0; iRound < 4; ++iRound) {
+         size_t iTermBest = 0;
+         double gainBest = -std::numeric_limits<double>::infinity();
+         for(size_t iTerm = 0; iTerm < terms.size(); ++iTerm) {
+            double gain1;
+            error = GenerateTermUpdate(&rng1[0], test1.GetBoosterHandle(), static_cast<IntEbm>(iTerm), 
+               TermBoostFlags_Default, k_learningRateDefault, k_minSamplesLeafDefault, &leavesMax[0], &gain1);
+            CHECK(Error_None == error);
+
+            double gain2;
+            error = GenerateTermUpdate(&rng2[0], test2.GetBoosterHandle(), static_cast<IntEbm>(iTerm),
+               TermBoostFlags_Default, k_learningRateDefault, k_minSamplesLeafDefault, &leavesMax[0], &gain2);
+            CHECK(Error_None == error);
+            size_t cUpdateScores = 3;
+            for(const IntEbm iFeature : terms[iTerm]) {
+               cUpdateScores *= static_cast<size_t>(features[static_cast<size_t>(iFeature)].m_countBins);
+            }
+            const std::vector<double> zeros(cUpdateScores, 0.0);
+            error = SetTermUpdate(test2.GetBoosterHandle(), static_cast<IntEbm>(iTerm), &zeros[0]);
+            CHECK(Error_None == error);
+            error = ApplyTermUpdate(test2.GetBoosterHandle(), nullptr);
+            CHECK(Error_None == error);
+
+            CHECK(gain1 == gain2);
+            if(gainBest < gain1) {
+               gainBest = gain1;
+               iTermBest = iTerm;
+            }
+         }
+
+         double gain1;
+         error = GenerateTermUpdate(&rng1[0], test1.GetBoosterHandle(), static_cast<IntEbm>(iTermBest),
+            TermBoostFlags_Default, k_learningRateDefault, k_minSamplesLeafDefault, &leavesMax[0], &gain1);
+         CHECK(Error_None == error);
+         double metric1;
+         error = ApplyTermUpdate(test1.GetBoosterHandle(), &metric1);
+         CHECK(Error_None == error);
+
+         double gain2;
+         error = GenerateTermUpdate(&rng2[0], test2.GetBoosterHandle(), static_cast<IntEbm>(iTermBest),
+            TermBoostFlags_Default, k_learningRateDefault, k_minSamplesLeafDefault, &leavesMax[0], &gain2);
+         CHECK(Error_None == error);
+         double metric2;
+         error = ApplyTermUpdate(test2.GetBoosterHandle(), &metric2);
+         CHECK(Error_None == error);
+
+         CHECK(gain1 == gain2);
+         CHECK(metric1 == metric2);
+      }
+
+      for(size_t iScore = 0; iScore < 3; ++iScore) {
+         CHECK(test1.GetCurrentTermScore(0, { 4 }, iScore) == test2.GetCurrentTermScore(0, { 4 }, iScore));
+         CHECK(test1.GetCurrentTermScore(4, { 2 }, iScore) == test2.GetCurrentTermScore(4, { 2 }, iScore));
+      }
+   }
+}
+
+TEST_CASE("PrefetchTerm, matches boosting without the hint") {
+   // enough samples that ApplyTermUpdate processes the prefetch in multiple blocks
+   std::vector<TestSample> train;
+   std::vector<TestSample> validation;
+   for(IntEbm i = 0; i < 10007; ++i) {
+      const IntEbm bin0 = i % 7;
+      const IntEbm bin1 = (i / 7) % 5;
+      const IntEbm bin2 = (i * 31) % 300;
+      const double target = static_cast<double>((bin0 + bin1 * bin2 + i % 2) % 3);
+      const double weight = 0.5 + static_cast<double>(i % 5) * 0.25;
+      train.push_back(TestSample({ bin0, bin1, bin2 }, target, weight));
+      if(0 == i % 6) {
+         validation.push_back(TestSample({ bin0, bin1, bin2 }, target, weight));
+      }
+   }
+
+   const std::vector<FeatureTest> features = { FeatureTest(7), FeatureTest(5), FeatureTest(300) };
+   const std::vector<std::vector<IntEbm>> terms = { { 0 }, { 1 }, { 0, 1 }, { 2 } };
+
+   TestBoost test1 = TestBoost(3, features, terms, train, validation);
+   TestBoost test2 = TestBoost(3, features, terms, train, validation);
+
+   std::vector<unsigned char> rng1(static_cast<size_t>(MeasureRNG()));
+   InitRNG(k_seed, &rng1[0]);
+   std::vector<unsigned char> rng2(static_cast<size_t>(MeasureRNG()));
+   InitRNG(k_seed, &rng2[0]);
+
+   const std::vector<IntEbm> leavesMax(2, 3);
+   ErrorEbm error;
+   for(int iRound = 0; iRound < 3; ++iRound) {
+      for(size_t iTerm = 0; iTerm < terms.size(); ++iTerm) {
+         double gain1;
+         error = GenerateTermUpdate(&rng1[0], test1.GetBoosterHandle(), static_cast<IntEbm>(iTerm),
+            TermBoostFlags_Default, k_learningRateDefault, k_minSamplesLeafDefault, &leavesMax[0], &gain1);
+         CHECK(Error_None == error);
+         // the hint for the pair term is ignored
+         error = PrefetchTerm(test1.GetBoosterHandle(), static_cast<IntEbm>((iTerm + 1) % terms.size()));
+         CHECK(Error_None == error);
+         double metric1;
+         error = ApplyTermUpdate(test1.GetBoosterHandle(), &metric1);
+         CHECK(Error_None == error);
+
+         double gain2;
+         error = GenerateTermUpdate(&rng2[0], test2.GetBoosterHandle(), static_cast<IntEbm>(iTerm),
+            TermBoostFlags_Default, k_learningRateDefault, k_minSamplesLeafDefault, &leavesMax[0], &gain2);
+         CHECK(Error_None == error);
+         double metric2;
+         error = ApplyTermUpdate(test2.GetBoosterHandle(), &metric2);
+         CHECK(Error_None == error);
+
+         CHECK(gain1 == gain2);
+         CHECK(metric1 == metric2);
+      }
+   }
+
+   for(size_t iScore = 0; iScore < 3; ++iScore) {
+      CHECK(test1.GetCurrentTermScore(0, { 4 }, iScore) == test2.GetCurrentTermScore(0, { 4 }, iScore));
+      CHECK(test1.GetCurrentTermScore(3, { 123 }, iScore) == test2.GetCurrentTermScore(3, { 123 }, iScore));
+   }
+
+   CHECK(Error_IllegalParamVal == PrefetchTerm(test1.GetBoosterHandle(), static_cast<IntEbm>(terms.size())));
+   CHECK(Error_None == PrefetchTerm(test1.GetBoosterHandle(), -1));
+}
+
+TEST_CASE("SIMD lane histograms, match the CPU zone") {
+   // the 7 and 60 bin terms fit into the per-lane histograms of both SIMD zones, but the 300 bin term does not
+   const std::vector<FeatureTest> features = { FeatureTest(7), FeatureTest(60), FeatureTest(300) };
+   const std::vector<std::vector<IntEbm>> terms = { { 0 }, { 1 }, { 2 } };
+
+   std::vector<TestSample> train;
+   std::vector<TestSample> validation;
+   MakeStridedSamples(5003, features, { 1, 13, 31 }, 2, train, validation);
+
+   for(const OutputType outputType : { OutputType_BinaryClassification, OutputType_Regression }) {
+      TestBoost testCpu = TestBoost(outputType, features, terms, train, validation, 2, 
+         k_testCreateBoosterFlags_SIMD, ComputeFlags_SIMD);
+      TestBoost testAvx2 = TestBoost(outputType, features, terms, train, validation, 2, 
+         k_testCreateBoosterFlags_SIMD, ComputeFlags_AVX512F);
+      TestBoost testDefault = TestBoost(outputType, features, terms, train, validation, 2,
+         k_testCreateBoosterFlags_SIMD);
+
+      for(int iEpoch = 0; iEpoch < 3; ++iEpoch) {
+         for(size_t iTerm = 0; iTerm < terms.size(); ++iTerm) {
+            const BoostRet retCpu = testCpu.Boost(iTerm);
+            const BoostRet retAvx2 = testAvx2.Boost(iTerm);
+            const BoostRet retDefault = testDefault.Boost(iTerm);
+            // the gains are small differences of large float sums, and the SIMD zones use approximate exp and log
+            CHECK_APPROX_TOLERANCE(retCpu.gainAvg, retAvx2.gainAvg, 2e-3);
+            CHECK_APPROX(retCpu.validationMetric, retAvx2.validationMetric);
+            CHECK_APPROX_TOLERANCE(retCpu.gainAvg, retDefault.gainAvg, 2e-3);
+            CHECK_APPROX(retCpu.validationMetric, retDefault.validationMetric);
+         }
+      }
+
+      for(size_t iBin = 0; iBin < 60; ++iBin) {
+         CHECK_APPROX(testCpu.GetCurrentTermScore(1, { iBin }, 0), testAvx2.GetCurrentTermScore(1, { iBin }, 0));
+         CHECK_APPROX(testCpu.GetCurrentTermScore(1, { iBin }, 0), testDefault.GetCurrentTermScore(1, { iBin }, 0));
+      }
+   }
+}
+
+TEST_CASE("SIMD update tensor lookup, match the CPU zone") {
+   // AVX2 holds update tensors of up to 8 bins in a register and AVX512F up to 16, so straddle both limits
+   std::vector<TestSample> train;
+   std::vector<TestSample> validation;
+   for(IntEbm i = 0; i < 3001; ++i) {
+      const IntEbm bin0 = i % 2;
+      const IntEbm bin1 = (i * 3) % 8;
+      const IntEbm bin2 = (i * 5) % 9;
+      const IntEbm bin3 = (i * 7) % 16;
+      const IntEbm bin4 = (i * 11) % 17;
+      const double target = static_cast<double>((bin0 + bin1 + bin2 + bin3 + bin4 + i % 3) % 2);
+      train.push_back(TestSample({ bin0, bin1, bin2, bin3, bin4 }, target));
+      if(0 == i % 4) {
+         validation.push_back(TestSample({ bin0, bin1, bin2, bin3, bin4 }, target));
+      }
+   }
+
+   const std::vector<FeatureTest> features = { FeatureTest(2), FeatureTest(8), FeatureTest(9), FeatureTest(16), FeatureTest(17) };
+   const std::vector<std::vector<IntEbm>> terms = { { 0 }, { 1 }, { 2 }, { 3 }, { 4 }, { 0, 1 }, { 0, 2 } };
+
+   for(const OutputType outputType : { OutputType_BinaryClassification, OutputType_Regression }) {
+      TestBoost testCpu = TestBoost(outputType, features, terms, train, validation, 2,
+         k_testCreateBoosterFlags_SIMD, ComputeFlags_SIMD);
+      TestBoost testAvx2 = TestBoost(outputType, features, terms, train, validation, 2,
+         k_testCreateBoosterFlags_SIMD, ComputeFlags_AVX512F);
+      TestBoost testDefault = TestBoost(outputType, features, terms, train, validation, 2,
+         k_testCreateBoosterFlags_SIMD);
+
+      for(int iEpoch = 0; iEpoch < 3; ++iEpoch) {
+         for(size_t iTerm = 0; iTerm < terms.size(); ++iTerm) {
+            const BoostRet retCpu = testCpu.Boost(iTerm);
+            const BoostRet retAvx2 = testAvx2.Boost(iTerm);
+            const BoostRet retDefault = testDefault.Boost(iTerm);
+            CHECK_APPROX(retCpu.validationMetric, retAvx2.validationMetric);
+            CHECK_APPROX(retCpu.validationMetric, retDefault.validationMetric);
+         }
+      }
+
+      for(size_t iBin = 0; iBin < 17; ++iBin) {
+         CHECK_APPROX(testCpu.GetCurrentTermScore(4, { iBin }, 0), testAvx2.GetCurrentTermScore(4, { iBin }, 0));
+         CHECK_APPROX(testCpu.GetCurrentTermScore(4, { iBin }, 0), testDefault.GetCurrentTermScore(4, { iBin }, 0));
+      }
+   }
+}
+
+TEST_CASE("SIMD single bin sums, match the binned kernel in the same zone") {
+   // every sample is in the first bin of the feature, so the term on it gets the same update as the intercept.  The
+   // intercept is summed by the single bin kernel and the other term by the regular kernel of the same zone, so the
+   // only difference is the order that the float sums are added in
+   const std::vector<FeatureTest> features = { FeatureTest(2) };
+   const std::vector<std::vector<IntEbm>> terms = { {}, { 0 } };
+   const std::vector<IntEbm> leavesMax = { 2 };
+
+   // 11 classes exceeds the compiled score counts, so the scores are summed in blocks at runtime
+   for(const OutputType outputType : { OutputType_Regression, OutputType { 3 }, OutputType { 11 } }) {
+      const IntEbm cTargets = OutputType_Regression == outputType ? IntEbm { 3 } : static_cast<IntEbm>(outputType);
+      const size_t cScores = OutputType_Regression == outputType ? size_t { 1 } : static_cast<size_t>(cTargets);
+
+      std::vector<TestSample> train;
+      std::vector<TestSample> validation;
+      MakeStridedSamples(1001, features, { 0 }, cTargets, train, validation);
+
+      for(const ComputeFlags computeFlags : { k_testComputeFlags_Default, ComputeFlags_AVX512F, ComputeFlags_SIMD }) {
+         TestBoost test = TestBoost(outputType, features, terms, train, validation, 2, k_testCreateBoosterFlags_SIMD, 
+            computeFlags);
+
+         std::vector<double> updateBinned(cScores * 2);
+         std::vector<double> updateSingle(cScores);
+         for(int iRound = 0; iRound < 3; ++iRound) {
+            double gain;
+            CHECK(Error_None == GenerateTermUpdate(nullptr, test.GetBoosterHandle(), 1, TermBoostFlags_Default, 
+               k_learningRateDefault, k_minSamplesLeafDefault, &leavesMax[0], &gain));
+            CHECK(Error_None == GetTermUpdate(test.GetBoosterHandle(), &updateBinned[0]));
+
+            CHECK(Error_None == GenerateTermUpdate(nullptr, test.GetBoosterHandle(), 0, TermBoostFlags_Default, 
+               k_learningRateDefault, k_minSamplesLeafDefault, nullptr, &gain));
+            CHECK(Error_None == GetTermUpdate(test.GetBoosterHandle(), &updateSingle[0]));
+
+            for(size_t iScore = 0; iScore < cScores; ++iScore) {
+               CHECK(0.0 != updateSingle[iScore]);
+               CHECK_APPROX(updateSingle[iScore], updateBinned[iScore]);
+            }
+
+            // move the scores so that the next round sums different gradients
+            double metric;
+            CHECK(Error_None == ApplyTermUpdate(test.GetBoosterHandle(), &metric));
+         }
+      }
+   }
+}
+
+TEST_CASE("AVX2 double precision zone, match the CPU zone") {
+   // disabling the float SIMD zones leaves the double precision AVX2 zone, or the CPU zone on older machines
+   const std::vector<FeatureTest> features = { FeatureTest(7), FeatureTest(60) };
+   const std::vector<std::vector<IntEbm>> terms = { { 0 }, { 1 }, { 0, 1 } };
+
+   std::vector<TestSample> train;
+   std::vector<TestSample> validation;
+   MakeStridedSamples(2003, features, { 1, 13 }, 3, train, validation);
+
+   for(const OutputType outputType : { OutputType_Regression, OutputType { 3 } }) {
+      TestBoost testCpu = TestBoost(outputType, features, terms, train, validation, 2,
+         k_testCreateBoosterFlags_SIMD, ComputeFlags_SIMD);
+      TestBoost testAvx2Double = TestBoost(outputType, features, terms, train, validation, 2,
+         k_testCreateBoosterFlags_SIMD, ComputeFlags_AVX2 | ComputeFlags_AVX512F);
+
+      for(int iEpoch = 0; iEpoch < 3; ++iEpoch) {
+         for(size_t iTerm = 0; iTerm < terms.size(); ++iTerm) {
+            const BoostRet retCpu = testCpu.Boost(iTerm);
+            const BoostRet retAvx2Double = testAvx2Double.Boost(iTerm);
+            CHECK_APPROX(retCpu.gainAvg, retAvx2Double.gainAvg);
+            CHECK_APPROX(retCpu.validationMetric, retAvx2Double.validationMetric);
+         }
+      }
+
+      const size_t cScores = OutputType_Regression == outputType ? size_t { 1 } : size_t { 3 };
+      for(size_t iBin = 0; iBin < 60; ++iBin) {
+         for(size_t iScore = 0; iScore < cScores; ++iScore) {
+            CHECK_APPROX(testCpu.GetCurrentTermScore(1, { iBin }, iScore), testAvx2Double.GetCurrentTermScore(1, { iBin }, iScore));
+         }
+      }
+   }
+}
+
+TEST_CASE("autotune, match the default zone") {
+   const std::vector<FeatureTest> features = { FeatureTest(7), FeatureTest(60) };
+   const std::vector<std::vector<IntEbm>> terms = { {}, { 0 }, { 1 }, { 0, 1 } };
+
+   std::vector<TestSample> train;
+   std::vector<TestSample> validation;
+   MakeStridedSamples(2003, features, { 1, 13 }, 3, train, validation);
+
+   for(const OutputType outputType : { OutputType_Regression, OutputType { 3 } }) {
+      const size_t cScores = OutputType_Regression == outputType ? size_t { 1 } : size_t { 3 };
+
+      // with only the CPU zone the autotuner can only change the BinSums kernel, which sums in the same order
+      TestBoost testCpu = TestBoost(outputType, features, terms, train, validation, 2,
+         k_testCreateBoosterFlags_SIMD, ComputeFlags_SIMD);
+      TestBoost testCpuAutotune = TestBoost(outputType, features, terms, train, validation, 2,
+         k_testCreateBoosterFlags_SIMD | CreateBoosterFlags_Autotune, ComputeFlags_SIMD);
+
+      // the autotuner can pick a zone with different precision, so we only expect approximately the same results.
+      // The autotuner considers the SIMD zones without CreateBoosterFlags_EnableSIMD
+      TestBoost test = TestBoost(outputType, features, terms, train, validation, 2,
+         k_testCreateBoosterFlags_SIMD);
+      TestBoost testAutotune = TestBoost(outputType, features, terms, train, validation, 2,
+         k_testCreateBoosterFlags_Default | CreateBoosterFlags_Autotune);
+
+      for(int iEpoch = 0; iEpoch < 3; ++iEpoch) {
+         for(size_t iTerm = 0; iTerm < terms.size(); ++iTerm) {
+            const BoostRet retCpu = testCpu.Boost(iTerm);
+            const BoostRet retCpuAutotune = testCpuAutotune.Boost(iTerm);
+            CHECK(retCpu.gainAvg == retCpuAutotune.gainAvg);
+            CHECK(retCpu.validationMetric == retCpuAutotune.validationMetric);
+
+            const BoostRet ret = test.Boost(iTerm);
+            const BoostRet retAutotune = testAutotune.Boost(iTerm);
+            CHECK_APPROX(ret.gainAvg, retAutotune.gainAvg);
+            CHECK_APPROX(ret.validationMetric, retAutotune.validationMetric);
+         }
+      }
+
+      for(size_t iBin = 0; iBin < 60; ++iBin) {
+         for(size_t iScore = 0; iScore < cScores; ++iScore) {
+            CHECK(testCpu.GetCurrentTermScore(2, { iBin }, iScore) == 
+               testCpuAutotune.GetCurrentTermScore(2, { iBin }, iScore));
+            if(size_t { 1 } == cScores) {
+               // the multiclass scores sum to zero, so some are too close to zero for a relative comparison
+               CHECK_APPROX(test.GetCurrentTermScore(2, { iBin }, iScore),
+                  testAutotune.GetCurrentTermScore(2, { iBin }, iScore));
+            }
+         }
+      }
+   }
+}
+
+TEST_CASE("AVX512F conflict detection, match the AVX2 zone") {
+   // terms with too many bins for the lane histograms are summed with scatters in the AVX512F zone, which add 
+   // into each bin in sample order just like the AVX2 zone does, so the float bins are identical.  The zones 
+   // update the gradients differently after the first boost, so we only compare the first boost of each term.
+   // On CPUs without AVX512F both use the AVX2 zone and this passes trivially
+   const std::vector<FeatureTest> features = { FeatureTest(500), FeatureTest(40) };
+   const std::vector<std::vector<IntEbm>> terms = { { 0 }, { 1 }, { 0, 1 } };
+
+   // the first feature only uses every 100th bin, so every SIMD pack has samples that collide
+   std::vector<TestSample> train;
+   std::vector<TestSample> validation;
+   MakeStridedSamples(4001, features, { 100, 13 }, 17, train, validation);
+
+   for(size_t iTerm = 0; iTerm < terms.size(); ++iTerm) {
+      TestBoost test = TestBoost(OutputType_Regression, features, terms, train, validation, 2,
+         k_testCreateBoosterFlags_SIMD);
+      TestBoost testAvx2 = TestBoost(OutputType_Regression, features, terms, train, validation, 2,
+         k_testCreateBoosterFlags_SIMD, ComputeFlags_AVX512F);
+
+      const BoostRet ret = test.Boost(iTerm);
+      const BoostRet retAvx2 = testAvx2.Boost(iTerm);
+      CHECK(ret.gainAvg == retAvx2.gainAvg);
+      if(size_t { 0 } == iTerm) {
+         for(size_t iBin = 0; iBin < 500; ++iBin) {
+            CHECK(test.GetCurrentTermScore(0, { iBin }, 0) == testAvx2.GetCurrentTermScore(0, { iBin }, 0));
+         }
+      }
+   }
+
+   TestInteraction testInteraction = TestInteraction(OutputType_Regression, features, train,
+      k_testCreateInteractionFlags_SIMD);
+   TestInteraction testInteractionAvx2 = TestInteraction(OutputType_Regression, features, train,
+      k_testCreateInteractionFlags_SIMD, ComputeFlags_AVX512F);
+   CHECK(testInteraction.TestCalcInteractionStrength({ 0, 1 }) == 
+      testInteractionAvx2.TestCalcInteractionStrength({ 0, 1 }));
+}
+
+TEST_CASE("boosting, unit weights match no weights") {
+   // without weights the compute zones fill bins that have no weight field, so this compares the two bin layouts
+   std::vector<TestSample> trainWeighted;
+   std::vector<TestSample> validationWeighted;
+   std::vector<TestSample> train;
+   std::vector<TestSample> validation;
+   for(IntEbm i = 0; i < 3001; ++i) {
+      const IntEbm bin0 = i % 7;
+      const IntEbm bin1 = (i * 13) % 60;
+      const IntEbm bin2 = (i * 31) % 300;
+      const double target = static_cast<double>((bin0 + bin1 + bin2 / 10 + i % 3) % 3);
+      trainWeighted.push_back(TestSample({ bin0, bin1, bin2 }, target, 1.0));
+      train.push_back(TestSample({ bin0, bin1, bin2 }, target));
+      if(0 == i % 4) {
+         validationWeighted.push_back(TestSample({ bin0, bin1, bin2 }, target, 1.0));
+         validation.push_back(TestSample({ bin0, bin1, bin2 }, target));
+      }
+   }
+
+   const std::vector<FeatureTest> features = { FeatureTest(7), FeatureTest(60), FeatureTest(300) };
+   const std::vector<std::vector<IntEbm>> terms = { {}, { 0 }, { 1 }, { 2 } };
+
+   for(const OutputType outputType : { OutputType_Regression, OutputType { 3 } }) {
+      TestBoost testWeighted = TestBoost(outputType, features, terms, trainWeighted, validationWeighted, 0);
+      TestBoost test = TestBoost(outputType, features, terms, train, validation, 0);
+
+      for(int iEpoch = 0; iEpoch < 3; ++iEpoch) {
+         for(size_t iTerm = 0; iTerm < terms.size(); ++iTerm) {
+            const BoostRet retWeighted = testWeighted.Boost(iTerm);
+            const BoostRet ret = test.Boost(iTerm);
+            CHECK(retWeighted.gainAvg == ret.gainAvg);
+            // the validation metric is accumulated differently when there are weights
+            CHECK_APPROX(retWeighted.validationMetric, ret.validationMetric);
+         }
+      }
+
+      const size_t cScores = OutputType_Regression == outputType ? size_t { 1 } : size_t { 3 };
+      for(size_t iScore = 0; iScore < cScores; ++iScore) {
+         for(size_t iBin = 0; iBin < 60; ++iBin) {
+            CHECK(testWeighted.GetCurrentTermScore(2, { iBin }, iScore) == test.GetCurrentTermScore(2, { iBin }, iScore));
+         }
+      }
+   }
+}
+
+TEST_CASE("boosting, pair larger than the cache matches the same pair with fewer bins") {
+   // the fast bins of the 600x600 pair do not fit in the cache, so they are summed by sorting the samples by bin 
+   // range first.  The samples only use the first 10 bins of each feature, so the sums should match.  The small
+   // pair can be summed with per-lane histograms which changes the order of the floating point additions.
+   std::vector<TestSample> trainLarge;
+   std::vector<TestSample> validationLarge;
+   std::vector<TestSample> trainSmall;
+   std::vector<TestSample> validationSmall;
+   for(IntEbm i = 0; i < 2003; ++i) {
+      const IntEbm bin0 = i % 10;
+      const IntEbm bin1 = (i * 7 / 3) % 10;
+      const double target = static_cast<double>((bin0 + bin1 + i % 5) % 3);
+      const double weight = 0.5 + static_cast<double>(i % 4) * 0.25;
+      trainLarge.push_back(TestSample({ bin0, bin1 }, target, weight));
+      trainSmall.push_back(TestSample({ bin0, bin1 }, target, weight));
+      if(0 == i % 3) {
+         validationLarge.push_back(TestSample({ bin0, bin1 }, target, weight));
+         validationSmall.push_back(TestSample({ bin0, bin1 }, target, weight));
+      }
+   }
+
+   const std::vector<std::vector<IntEbm>> terms = { { 0, 1 } };
+
+   for(const OutputType outputType : { OutputType_Regression, OutputType { 3 } }) {
+      TestBoost testLarge = TestBoost(
+         outputType, { FeatureTest(600), FeatureTest(600) }, terms, trainLarge, validationLarge, 0);
+      TestBoost testSmall = TestBoost(
+         outputType, { FeatureTest(10), FeatureTest(10) }, terms, trainSmall, validationSmall, 0);
+
+      for(int iEpoch = 0; iEpoch < 3; ++iEpoch) {
+         const BoostRet retLarge = testLarge.Boost(0);
+         const BoostRet retSmall = testSmall.Boost(0);
+         CHECK_APPROX(retLarge.gainAvg, retSmall.gainAvg);
+         CHECK_APPROX(retLarge.validationMetric, retSmall.validationMetric);
+      }
+
+      const size_t cScores = OutputType_Regression == outputType ? size_t { 1 } : size_t { 3 };
+      for(size_t iScore = 0; iScore < cScores; ++iScore) {
+         for(size_t iBin0 = 0; iBin0 < 10; ++iBin0) {
+            for(size_t iBin1 = 0; iBin1 < 10; ++iBin1) {
+               CHECK_APPROX(testLarge.GetCurrentTermScore(0, { iBin0, iBin1 }, iScore), 
+                  testSmall.GetCurrentTermScore(0, { iBin0, iBin1 }, iScore));
+            }
+         }
+      }
+   }
+}
+
+TEST_CASE("CreateBoosterBags, matches separately created boosters") {
+   static constexpr size_t cSamples = 300;
+   static constexpr IntEbm cClasses = 3;
+   static constexpr size_t cBags = 3;
+
+   std::vector<IntEbm> binIndexes0;
+   std::vector<IntEbm> binIndexes1;
+   std::vector<IntEbm> targets;
+   std::vector<double> weights;
+   for(size_t i = 0; i < cSamples; ++i) {
+      const IntEbm bin0 = static_cast<IntEbm>(i % 7);
+      const IntEbm bin1 = static_cast<IntEbm>((i / 7) % 5);
+      binIndexes0.push_back(bin0);
+      binIndexes1.push_back(bin1);
+      targets.push_back((bin0 + bin1 * 2 + static_cast<IntEbm>(i % 2)) % cClasses);
+      weights.push_back(0.5 + static_cast<double>(i % 5) * 0.25);
+   }
+
+   // each bag has its own training and validation samples, and excludes some samples entirely
+   std::vector<BagEbm> bags;
+   for(size_t iBag = 0; iBag < cBags; ++iBag) {
+      for(size_t i = 0; i < cSamples; ++i) {
+         BagEbm bag = 1;
+         if(iBag == i % 4) {
+            bag = -1;
+         } else if(iBag + 1 == i % 5) {
+            bag = 0;
+         }
+         bags.push_back(bag);
+      }
+   }
+
+   IntEbm size = MeasureDataSetHeader(2, 1, 1);
+   size += MeasureFeature(7, EBM_TRUE, EBM_TRUE, EBM_FALSE, cSamples, &binIndexes0[0]);
+   size += MeasureFeature(5, EBM_TRUE, EBM_TRUE, EBM_FALSE, cSamples, &binIndexes1[0]);
+   size += MeasureWeight(cSamples, &weights[0]);
+   size += MeasureClassificationTarget(cClasses, cSamples, &targets[0]);
+   std::vector<unsigned char> dataSet(static_cast<size_t>(size));
+   CHECK(Error_None == FillDataSetHeader(2, 1, 1, size, &dataSet[0]));
+   CHECK(Error_None == FillFeature(7, EBM_TRUE, EBM_TRUE, EBM_FALSE, cSamples, &binIndexes0[0], size, &dataSet[0]));
+   CHECK(Error_None == FillFeature(5, EBM_TRUE, EBM_TRUE, EBM_FALSE, cSamples, &binIndexes1[0], size, &dataSet[0]));
+   CHECK(Error_None == FillWeight(cSamples, &weights[0], size, &dataSet[0]));
+   CHECK(Error_None == FillClassificationTarget(cClasses, cSamples, &targets[0], size, &dataSet[0]));
+
+   const std::vector<IntEbm> dimensionCounts = { 1, 1, 2 };
+   const std::vector<IntEbm> featureIndexes = { 0, 1, 0, 1 };
+
+   // the shared boosters include extra zero weighted samples, so keep to the CPU zone where the sums are
+   // computed in the same order
+   BoosterHandle aBoostersShared[cBags];
+   ErrorEbm error = CreateBoosterBags(
+      &dataSet[0],
+      cBags,
+      &bags[0],
+      nullptr,
+      dimensionCounts.size(),
+      &dimensionCounts[0],
+      &featureIndexes[0],
+      CreateBoosterFlags_Default,
+      ComputeFlags_SIMD,
+      "log_loss",
+      nullptr,
+      aBoostersShared
+   );
+   CHECK(Error_None == error);
+
+   const std::vector<IntEbm> leavesMax(2, 3);
+   for(size_t iBag = 0; iBag < cBags; ++iBag) {
+      BoosterHandle boosterSeparate = nullptr;
+      error = CreateBooster(
+         nullptr,
+         &dataSet[0],
+         &bags[iBag * cSamples],
+         nullptr,
+         dimensionCounts.size(),
+         &dimensionCounts[0],
+         &featureIndexes[0],
+         0,
+         CreateBoosterFlags_Default,
+         ComputeFlags_SIMD,
+         "log_loss",
+         nullptr,
+         &boosterSeparate
+      );
+      CHECK(Error_None == error);
+
+      std::vector<unsigned char> rng1(static_cast<size_t>(MeasureRNG()));
+      InitRNG(k_seed, &rng1[0]);
+      std::vector<unsigned char> rng2(static_cast<size_t>(MeasureRNG()));
+      InitRNG(k_seed, &rng2[0]);
+
+      for(int iRound = 0; iRound < 5; ++iRound) {
+         for(size_t iTerm = 0; iTerm < dimensionCounts.size(); ++iTerm) {
+            double gain1;
+            error = GenerateTermUpdate(&rng1[0], aBoostersShared[iBag], iTerm, TermBoostFlags_Default, 0.1, 1, &leavesMax[0], &gain1);
+            CHECK(Error_None == error);
+            double gain2;
+            error = GenerateTermUpdate(&rng2[0], boosterSeparate, iTerm, TermBoostFlags_Default, 0.1, 1, &leavesMax[0], &gain2);
+            CHECK(Error_None == error);
+            CHECK(gain1 == gain2);
+
+            double metric1;
+            error = ApplyTermUpdate(aBoostersShared[iBag], &metric1);
+            CHECK(Error_None == error);
+            double metric2;
+            error = ApplyTermUpdate(boosterSeparate, &metric2);
+            CHECK(Error_None == error);
+            CHECK(metric1 == metric2);
+         }
+      }
+
+      double scores1[7 * 5 * cClasses];
+      double scores2[7 * 5 * cClasses];
+      error = GetCurrentTermScores(aBoostersShared[iBag], 2, scores1);
+      CHECK(Error_None == error);
+      error = GetCurrentTermScores(boosterSeparate, 2, scores2);
+      CHECK(Error_None == error);
+      for(size_t iScore = 0; iScore < 7 * 5 * cClasses; ++iScore) {
+         CHECK(scores1[iScore] == scores2[iScore]);
+      }
+
+      FreeBooster(boosterSeparate);
+   }
+
+   // free the booster that owns the shared data first to check that the others keep it alive
+   for(size_t iBag = 0; iBag < cBags; ++iBag) {
+      FreeBooster(aBoostersShared[iBag]);
+   }
+}
+
+TEST_CASE("CreateBoosterBags, replicated bags, close to separately created boosters") {
+   static constexpr size_t cSamples = 509; // not a multiple of the SIMD width, so a CPU subset holds the remainder
+   static constexpr size_t cBags = 3;
+
+   std::vector<IntEbm> binIndexes0;
+   std::vector<IntEbm> binIndexes1;
+   std::vector<IntEbm> targetsClassification;
+   std::vector<double> targetsRegression;
+   std::vector<double> weights;
+   for(size_t i = 0; i < cSamples; ++i) {
+      const IntEbm bin0 = static_cast<IntEbm>(i % 7);
+      const IntEbm bin1 = static_cast<IntEbm>((i / 7) % 5);
+      binIndexes0.push_back(bin0);
+      binIndexes1.push_back(bin1);
+      targetsClassification.push_back((bin0 + bin1 * 2 + static_cast<IntEbm>(i % 2)) % 3);
+      targetsRegression.push_back(static_cast<double>(bin0) - 0.5 * static_cast<double>(bin1) + 
+         static_cast<double>(i % 3) * 0.25);
+      weights.push_back(0.5 + static_cast<double>(i % 5) * 0.25);
+   }
+
+   // like the python bags, every bag includes every sample, some of them replicated in either direction
+   std::vector<BagEbm> bags;
+   for(size_t iBag = 0; iBag < cBags; ++iBag) {
+      for(size_t i = 0; i < cSamples; ++i) {
+         BagEbm bag = static_cast<BagEbm>(1 + (i + iBag) % 3);
+         if(iBag == i % 4) {
+            bag = -1;
+         } else if(iBag + 1 == i % 11) {
+            bag = -2;
+         }
+         bags.push_back(bag);
+      }
+   }
+
+   const std::vector<IntEbm> dimensionCounts = { 1, 1, 2 };
+   const std::vector<IntEbm> featureIndexes = { 0, 1, 0, 1 };
+   const std::vector<IntEbm> leavesMax(2, 3);
+
+   for(const bool bClassification : { true, false }) {
+      IntEbm size = MeasureDataSetHeader(2, 1, 1);
+      size += MeasureFeature(7, EBM_TRUE, EBM_TRUE, EBM_FALSE, cSamples, &binIndexes0[0]);
+      size += MeasureFeature(5, EBM_TRUE, EBM_TRUE, EBM_FALSE, cSamples, &binIndexes1[0]);
+      size += MeasureWeight(cSamples, &weights[0]);
+      size += bClassification ? MeasureClassificationTarget(3, cSamples, &targetsClassification[0]) :
+         MeasureRegressionTarget(cSamples, &targetsRegression[0]);
+      std::vector<unsigned char> dataSet(static_cast<size_t>(size));
+      CHECK(Error_None == FillDataSetHeader(2, 1, 1, size, &dataSet[0]));
+      CHECK(Error_None == FillFeature(7, EBM_TRUE, EBM_TRUE, EBM_FALSE, cSamples, &binIndexes0[0], size, &dataSet[0]));
+      CHECK(Error_None == FillFeature(5, EBM_TRUE, EBM_TRUE, EBM_FALSE, cSamples, &binIndexes1[0], size, &dataSet[0]));
+      CHECK(Error_None == FillWeight(cSamples, &weights[0], size, &dataSet[0]));
+      if(bClassification) {
+         CHECK(Error_None == FillClassificationTarget(3, cSamples, &targetsClassification[0], size, &dataSet[0]));
+      } else {
+         CHECK(Error_None == FillRegressionTarget(cSamples, &targetsRegression[0], size, &dataSet[0]));
+      }
+      const char * const objective = bClassification ? "log_loss" : "rmse";
+      const size_t cScores = bClassification ? size_t { 3 } : size_t { 1 };
+
+      // the boosters created together hold the validation samples with zero training weight, so the sums
+      // are grouped differently in the SIMD zones
+      for(const ComputeFlags computeFlags : { ComputeFlags_SIMD, ComputeFlags_AVX512F, k_testComputeFlags_Default }) {
+         for(const CreateBoosterFlags flags :
+            { CreateBoosterFlags_EnableSIMD, CreateBoosterFlags_EnableSIMD | CreateBoosterFlags_Multithreaded })
+         {
+            BoosterHandle aBoostersShared[cBags];
+            ErrorEbm error = CreateBoosterBags(
+               &dataSet[0],
+               cBags,
+               &bags[0],
+               nullptr,
+               dimensionCounts.size(),
+               &dimensionCounts[0],
+               &featureIndexes[0],
+               flags,
+               computeFlags,
+               objective,
+               nullptr,
+               aBoostersShared
+            );
+            CHECK(Error_None == error);
+
+            for(size_t iBag = 0; iBag < cBags; ++iBag) {
+               BoosterHandle boosterSeparate = nullptr;
+               error = CreateBooster(
+                  nullptr,
+                  &dataSet[0],
+                  &bags[iBag * cSamples],
+                  nullptr,
+                  dimensionCounts.size(),
+                  &dimensionCounts[0],
+                  &featureIndexes[0],
+                  0,
+                  flags,
+                  computeFlags,
+                  objective,
+                  nullptr,
+                  &boosterSeparate
+               );
+               CHECK(Error_None == error);
+
+               std::vector<unsigned char> rng1(static_cast<size_t>(MeasureRNG()));
+               InitRNG(k_seed, &rng1[0]);
+               std::vector<unsigned char> rng2(static_cast<size_t>(MeasureRNG()));
+               InitRNG(k_seed, &rng2[0]);
+
+               for(int iRound = 0; iRound < 5; ++iRound) {
+                  for(size_t iTerm = 0; iTerm < dimensionCounts.size(); ++iTerm) {
+                     double gain1;
+                     error = GenerateTermUpdate(&rng1[0], aBoostersShared[iBag], iTerm, TermBoostFlags_Default, 0.1, 1, &leavesMax[0], &gain1);
+                     CHECK(Error_None == error);
+                     double gain2;
+                     error = GenerateTermUpdate(&rng2[0], boosterSeparate, iTerm, TermBoostFlags_Default, 0.1, 1, &leavesMax[0], &gain2);
+                     CHECK(Error_None == error);
+                     CHECK_APPROX_TOLERANCE(gain1, gain2, 1e-3);
+
+                     double metric1;
+                     error = ApplyTermUpdate(aBoostersShared[iBag], &metric1);
+                     CHECK(Error_None == error);
+                     double metric2;
+                     error = ApplyTermUpdate(boosterSeparate, &metric2);
+                     CHECK(Error_None == error);
+                     CHECK_APPROX_TOLERANCE(metric1, metric2, 1e-3);
+                  }
+               }
+
+               std::vector<double> scores1(7 * 5 * cScores);
+               std::vector<double> scores2(7 * 5 * cScores);
+               error = GetCurrentTermScores(aBoostersShared[iBag], 2, &scores1[0]);
+               CHECK(Error_None == error);
+               error = GetCurrentTermScores(boosterSeparate, 2, &scores2[0]);
+               CHECK(Error_None == error);
+               for(size_t iScore = 0; iScore < scores1.size(); ++iScore) {
+                  CHECK_APPROX_TOLERANCE(scores1[iScore], scores2[iScore], 1e-3);
+               }
+
+               FreeBooster(boosterSeparate);
+            }
+
+            for(size_t iBag = 0; iBag < cBags; ++iBag) {
+               FreeBooster(aBoostersShared[iBag]);
+            }
+         }
+      }
+   }
+}
+
+static size_t g_cSamplesApplied = 0;
+
+static void CountSamplesApplied(const TraceEbm traceLevel, const char * const message) {
+   UNUSED(traceLevel);
+   // ApplyTermUpdate logs the number of samples it updated when it exits
+   static const char sSamplesApplied[] = "cSamplesApplied=";
+   const char * const sFound = strstr(message, sSamplesApplied);
+   if(nullptr != sFound) {
+      g_cSamplesApplied += static_cast<size_t>(strtoull(sFound + sizeof(sSamplesApplied) - 1, nullptr, 10));
+   }
+}
+
+TEST_CASE("CreateBoosterBags, applies no more updates than separately created boosters") {
+   static constexpr size_t cSamples = 509;
+   static constexpr size_t cBags = 3;
+
+   std::vector<IntEbm> binIndexes0;
+   std::vector<IntEbm> binIndexes1;
+   std::vector<IntEbm> targets;
+   for(size_t i = 0; i < cSamples; ++i) {
+      const IntEbm bin0 = static_cast<IntEbm>(i % 7);
+      const IntEbm bin1 = static_cast<IntEbm>((i / 7) % 5);
+      binIndexes0.push_back(bin0);
+      binIndexes1.push_back(bin1);
+      targets.push_back((bin0 + bin1 * 2 + static_cast<IntEbm>(i % 2)) % 2);
+   }
+
+   // like the python bags, every bag includes every sample, some of them replicated
+   std::vector<BagEbm> bags;
+   for(size_t iBag = 0; iBag < cBags; ++iBag) {
+      for(size_t i = 0; i < cSamples; ++i) {
+         BagEbm bag = static_cast<BagEbm>(1 + (i + iBag) % 2);
+         if(iBag == i % 4) {
+            bag = -1;
+         }
+         bags.push_back(bag);
+      }
+   }
+
+   IntEbm size = MeasureDataSetHeader(2, 0, 1);
+   size += MeasureFeature(7, EBM_TRUE, EBM_TRUE, EBM_FALSE, cSamples, &binIndexes0[0]);
+   size += MeasureFeature(5, EBM_TRUE, EBM_TRUE, EBM_FALSE, cSamples, &binIndexes1[0]);
+   size += MeasureClassificationTarget(2, cSamples, &targets[0]);
+   std::vector<unsigned char> dataSet(static_cast<size_t>(size));
+   CHECK(Error_None == FillDataSetHeader(2, 0, 1, size, &dataSet[0]));
+   CHECK(Error_None == FillFeature(7, EBM_TRUE, EBM_TRUE, EBM_FALSE, cSamples, &binIndexes0[0], size, &dataSet[0]));
+   CHECK(Error_None == FillFeature(5, EBM_TRUE, EBM_TRUE, EBM_FALSE, cSamples, &binIndexes1[0], size, &dataSet[0]));
+   CHECK(Error_None == FillClassificationTarget(2, cSamples, &targets[0], size, &dataSet[0]));
+
+   const std::vector<IntEbm> dimensionCounts = { 1, 1, 2 };
+   const std::vector<IntEbm> featureIndexes = { 0, 1, 0, 1 };
+   const std::vector<IntEbm> leavesMax(2, 3);
+
+   g_pLogMessageHook = &CountSamplesApplied;
+   // the prefetch hint calculates the metric of the aliased validation set in blocks between the binning
+   for(const bool bPrefetch : { false, true }) {
+      for(const CreateBoosterFlags flags : { CreateBoosterFlags_Default, CreateBoosterFlags_Multithreaded }) {
+         BoosterHandle aBoostersShared[cBags];
+         ErrorEbm error = CreateBoosterBags(
+            &dataSet[0],
+            cBags,
+            &bags[0],
+            nullptr,
+            dimensionCounts.size(),
+            &dimensionCounts[0],
+            &featureIndexes[0],
+            flags,
+            k_testComputeFlags_Default,
+            "log_loss",
+            nullptr,
+            aBoostersShared
+         );
+         CHECK(Error_None == error);
+
+         size_t cSamplesAppliedShared = 0;
+         size_t cSamplesAppliedSeparate = 0;
+         for(size_t iBag = 0; iBag < cBags; ++iBag) {
+            BoosterHandle boosterSeparate = nullptr;
+            error = CreateBooster(
+               nullptr,
+               &dataSet[0],
+               &bags[iBag * cSamples],
+               nullptr,
+               dimensionCounts.size(),
+               &dimensionCounts[0],
+               &featureIndexes[0],
+               0,
+               flags,
+               k_testComputeFlags_Default,
+               "log_loss",
+               nullptr,
+               &boosterSeparate
+            );
+            CHECK(Error_None == error);
+
+            std::vector<unsigned char> rng1(static_cast<size_t>(MeasureRNG()));
+            InitRNG(k_seed, &rng1[0]);
+            std::vector<unsigned char> rng2(static_cast<size_t>(MeasureRNG()));
+            InitRNG(k_seed, &rng2[0]);
+
+            for(int iRound = 0; iRound < 3; ++iRound) {
+               for(size_t iTerm = 0; iTerm < dimensionCounts.size(); ++iTerm) {
+                  double gain;
+                  error = GenerateTermUpdate(&rng1[0], aBoostersShared[iBag], iTerm, TermBoostFlags_Default, 0.1, 1, &leavesMax[0], &gain);
+                  CHECK(Error_None == error);
+                  error = GenerateTermUpdate(&rng2[0], boosterSeparate, iTerm, TermBoostFlags_Default, 0.1, 1, &leavesMax[0], &gain);
+                  CHECK(Error_None == error);
+                  if(bPrefetch) {
+                     const IntEbm iTermNext = static_cast<IntEbm>((iTerm + 1) % dimensionCounts.size());
+                     CHECK(Error_None == PrefetchTerm(aBoostersShared[iBag], iTermNext));
+                     CHECK(Error_None == PrefetchTerm(boosterSeparate, iTermNext));
+                  }
+
+                  double metric1;
+                  g_cSamplesApplied = 0;
+                  error = ApplyTermUpdate(aBoostersShared[iBag], &metric1);
+                  CHECK(Error_None == error);
+                  cSamplesAppliedShared += g_cSamplesApplied;
+
+                  double metric2;
+                  g_cSamplesApplied = 0;
+                  error = ApplyTermUpdate(boosterSeparate, &metric2);
+                  CHECK(Error_None == error);
+                  cSamplesAppliedSeparate += g_cSamplesApplied;
+
+                  CHECK_APPROX_TOLERANCE(metric1, metric2, 1e-3);
+               }
+            }
+
+            FreeBooster(boosterSeparate);
+         }
+
+         // the validation samples are held by the training set with zero training weight, so they are updated 
+         // once by the training pass, which also calculates the metric
+         CHECK(size_t { 0 } != cSamplesAppliedSeparate);
+         CHECK(cSamplesAppliedShared <= cSamplesAppliedSeparate);
+
+         for(size_t iBag = 0; iBag < cBags; ++iBag) {
+            FreeBooster(aBoostersShared[iBag]);
+         }
+      }
+   }
+   g_pLogMessageHook = nullptr;
+}
+
+TEST_CASE("bfloat16 gradients, boosting, close to full precision gradients") {
+   const std::vector<FeatureTest> features = { FeatureTest(7), FeatureTest(60) };
+   const std::vector<std::vector<IntEbm>> terms = { { 0 }, { 1 }, { 0, 1 } };
+
+   for(const ComputeFlags computeFlags :
+      { ComputeFlags_SIMD, ComputeFlags_AVX512F, ComputeFlags_AVX2 | ComputeFlags_AVX512F, k_testComputeFlags_Default }) {
+      for(const OutputType outputType : { OutputType_BinaryClassification, OutputType { 3 }, OutputType_Regression }) {
+         const IntEbm cTargets = OutputType_BinaryClassification == outputType ? IntEbm { 2 } : IntEbm { 3 };
+         std::vector<TestSample> train;
+         std::vector<TestSample> validation;
+         MakeStridedSamples(2003, features, { 1, 13 }, cTargets, train, validation);
+
+         TestBoost testFull = TestBoost(outputType, features, terms, train, validation, 2, 
+            k_testCreateBoosterFlags_SIMD, computeFlags);
+         TestBoost testBfloat16 = TestBoost(outputType, features, terms, train, validation, 2, 
+            k_testCreateBoosterFlags_SIMD | CreateBoosterFlags_Bfloat16Gradients, computeFlags);
+
+         for(int iEpoch = 0; iEpoch < 5; ++iEpoch) {
+            for(size_t iTerm = 0; iTerm < terms.size(); ++iTerm) {
+               const BoostRet retFull = testFull.Boost(iTerm);
+               const BoostRet retBfloat16 = testBfloat16.Boost(iTerm);
+               if(OutputType_Regression == outputType) {
+                  // RMSE has no hessians, so it keeps its gradients in full precision
+                  CHECK(retFull.gainAvg == retBfloat16.gainAvg);
+                  CHECK(retFull.validationMetric == retBfloat16.validationMetric);
+               } else {
+                  // bfloat16 keeps 8 bits of mantissa, so each gradient is within 0.4% of the full precision value, 
+                  // but the gains are small differences of large sums and move further
+                  CHECK_APPROX_TOLERANCE(retBfloat16.gainAvg, retFull.gainAvg, 5e-2);
+                  CHECK_APPROX_TOLERANCE(retBfloat16.validationMetric, retFull.validationMetric, 1e-3);
+               }
+            }
+         }
+      }
+   }
+}
+
+TEST_CASE("auc validation metric, matches the pairwise definition") {
+   const std::vector<FeatureTest> features = { FeatureTest(6), FeatureTest(4) };
+   const std::vector<std::vector<IntEbm>> terms = { { 0 }, { 1 } };
+
+   // the small validation set has buckets that are insertion sorted, and the large one has buckets that need
+   // std::sort since there are only 24 distinct scores
+   // samples with tied term bins only keep their tied scores if they all land in the same zone, so use counts that
+   // divide evenly into the SIMD packs instead of leaving a remainder for the CPU zone
+   for(const IntEbm cValidation : { IntEbm { 48 }, IntEbm { 1024 } }) {
+      for(const ComputeFlags computeFlags : { ComputeFlags_SIMD, k_testComputeFlags_Default }) {
+         std::vector<TestSample> train;
+         std::vector<TestSample> validation;
+         for(IntEbm i = 0; i < 997; ++i) {
+            const IntEbm bin0 = i % 6;
+            const IntEbm bin1 = (i * 7) % 4;
+            // irregular targets so that no two bins get exactly the same update, which float zones would untie
+            train.push_back(TestSample({ bin0, bin1 }, static_cast<double>((i * i * 7 + bin0 * 3 + bin1) % 5 < 2)));
+         }
+         for(IntEbm i = 0; i < cValidation; ++i) {
+            const IntEbm bin0 = (i * 5) % 6;
+            const IntEbm bin1 = i % 4;
+            const double weight = 0.5 + static_cast<double>(i % 3) * 0.5;
+            validation.push_back(TestSample({ bin0, bin1 }, static_cast<double>((bin0 + bin1 + i % 5) / 4 % 2), weight));
+         }
+
+         TestBoost test = TestBoost(OutputType_BinaryClassification, features, terms, train, validation,
+            k_countInnerBagsDefault, k_testCreateBoosterFlags_SIMD, computeFlags, "log_loss,auc");
+
+         for(int iEpoch = 0; iEpoch < 5; ++iEpoch) {
+            for(size_t iTerm = 0; iTerm < terms.size(); ++iTerm) {
+               const BoostRet ret = test.Boost(iTerm);
+
+               std::vector<double> scores;
+               for(const TestSample & sample : validation) {
+                  scores.push_back(
+                     test.GetCurrentTermScore(0, { static_cast<size_t>(sample.m_sampleBinIndexes[0]) }, 1) +
+                     test.GetCurrentTermScore(1, { static_cast<size_t>(sample.m_sampleBinIndexes[1]) }, 1));
+               }
+               double sum = 0.0;
+               double weightPairs = 0.0;
+               for(size_t iPositive = 0; iPositive < validation.size(); ++iPositive) {
+                  if(0.0 != validation[iPositive].m_target) {
+                     for(size_t iNegative = 0; iNegative < validation.size(); ++iNegative) {
+                        if(0.0 == validation[iNegative].m_target) {
+                           const double weight = validation[iPositive].m_weight * validation[iNegative].m_weight;
+                           weightPairs += weight;
+                           if(scores[iNegative] < scores[iPositive]) {
+                              sum += weight;
+                           } else if(scores[iNegative] == scores[iPositive]) {
+                              sum += 0.5 * weight;
+                           }
+                        }
+                     }
+                  }
+               }
+               // we return the negated AUC so that lower is better, like the other metrics
+               CHECK_APPROX(-sum / weightPairs, ret.validationMetric);
+            }
+         }
+      }
+   }
+}
+
+TEST_CASE("auc validation metric, rejected for regression and unknown metrics") {
+   const std::vector<FeatureTest> features = { FeatureTest(3) };
+   const std::vector<std::vector<IntEbm>> terms = { { 0 } };
+   const std::vector<TestSample> train = { TestSample({ 0 }, 0.0), TestSample({ 1 }, 1.0), TestSample({ 2 }, 1.0) };
+   const std::vector<TestSample> validation = { TestSample({ 0 }, 1.0), TestSample({ 2 }, 0.0) };
+
+   ErrorEbm error = Error_None;
+   try {
+      TestBoost test = TestBoost(OutputType_Regression, features, terms, train, validation,
+         k_countInnerBagsDefault, k_testCreateBoosterFlags_Default, k_testComputeFlags_Default, "rmse,auc");
+   } catch(const TestException & except) {
+      error = except.GetError();
+   }
+   CHECK(Error_ObjectiveParamMismatchWithConfig == error);
+
+   error = Error_None;
+   try {
+      TestBoost test = TestBoost(OutputType_BinaryClassification, features, terms, train, validation,
+         k_countInnerBagsDefault, k_testCreateBoosterFlags_Default, k_testComputeFlags_Default, "log_loss,not_a_metric");
+   } catch(const TestException & except) {
+      error = except.GetError();
+   }
+   CHECK(Error_ObjectiveUnknown == error);
+
+   // empty metrics are allowed, and leave the objective's metric in place
+   TestBoost test = TestBoost(OutputType_BinaryClassification, features, terms, train, validation,
+      k_countInnerBagsDefault, k_testCreateBoosterFlags_Default, k_testComputeFlags_Default, "log_loss, ,");
+   CHECK(0.0 < test.Boost(0).validationMetric);
+}
+
+TEST_CASE("validation metrics, fused probability metrics match their definitions") {
+   const std::vector<FeatureTest> features = { FeatureTest(6), FeatureTest(4) };
+   const std::vector<std::vector<IntEbm>> terms = { { 0 }, { 1 } };
+
+   for(const IntEbm cValidation : { IntEbm { 48 }, IntEbm { 1024 } }) {
+      for(const ComputeFlags computeFlags : { ComputeFlags_SIMD, k_testComputeFlags_Default }) {
+         std::vector<TestSample> train;
+         std::vector<TestSample> validation;
+         for(IntEbm i = 0; i < 997; ++i) {
+            const IntEbm bin0 = i % 6;
+            const IntEbm bin1 = (i * 7) % 4;
+            train.push_back(TestSample({ bin0, bin1 }, static_cast<double>((i * i * 7 + bin0 * 3 + bin1) % 5 < 2)));
+         }
+         for(IntEbm i = 0; i < cValidation; ++i) {
+            const IntEbm bin0 = (i * 5) % 6;
+            const IntEbm bin1 = i % 4;
+            const double weight = 0.5 + static_cast<double>(i % 3) * 0.5;
+            validation.push_back(TestSample({ bin0, bin1 }, static_cast<double>((i * 3 + bin0) % 5 < 2), weight));
+         }
+
+         // the approximate exp would move probabilities near 0.5 across the calibration bin boundary
+         TestBoost test = TestBoost(OutputType_BinaryClassification, features, terms, train, validation,
+            k_countInnerBagsDefault, k_testCreateBoosterFlags_SIMD | CreateBoosterFlags_DisableApprox, computeFlags, 
+            "log_loss,log_loss,brier,calibration_error,auc");
+
+         for(int iEpoch = 0; iEpoch < 50; ++iEpoch) {
+            for(size_t iTerm = 0; iTerm < terms.size(); ++iTerm) {
+               const BoostRet ret = test.Boost(iTerm);
+
+               double metrics[4];
+               CHECK(Error_None == GetValidationMetrics(test.GetBoosterHandle(), 4, metrics));
+
+               double weightTotal = 0.0;
+               double logLoss = 0.0;
+               double brier = 0.0;
+               double calibrationBins[10] = {};
+               for(const TestSample & sample : validation) {
+                  const double score =
+                     test.GetCurrentTermScore(0, { static_cast<size_t>(sample.m_sampleBinIndexes[0]) }, 1) +
+                     test.GetCurrentTermScore(1, { static_cast<size_t>(sample.m_sampleBinIndexes[1]) }, 1);
+                  const double probability = 1.0 / (1.0 + std::exp(-score));
+                  const double error = probability - sample.m_target;
+                  weightTotal += sample.m_weight;
+                  logLoss += sample.m_weight * std::log(1.0 + std::exp(0.0 == sample.m_target ? score : -score));
+                  brier += sample.m_weight * error * error;
+                  calibrationBins[std::min(static_cast<size_t>(probability * 10.0), size_t { 9 })] += 
+                     sample.m_weight * error;
+               }
+               double calibrationError = 0.0;
+               for(const double calibrationBin : calibrationBins) {
+                  calibrationError += std::abs(calibrationBin);
+               }
+
+               CHECK(ret.validationMetric == metrics[0]);
+               CHECK_APPROX(metrics[0], logLoss / weightTotal);
+               CHECK_APPROX(metrics[1], brier / weightTotal);
+               CHECK_APPROX(metrics[2], calibrationError / weightTotal);
+               CHECK(-1.0 <= metrics[3] && metrics[3] <= 0.0);
+            }
+         }
+
+         double metricsWrongCount[5];
+         CHECK(Error_IllegalParamVal == GetValidationMetrics(test.GetBoosterHandle(), 5, metricsWrongCount));
+      }
+   }
+}
+
+TEST_CASE("validation metrics, the first metric listed selects the best model") {
+   const std::vector<FeatureTest> features = { FeatureTest(3) };
+   const std::vector<std::vector<IntEbm>> terms = { { 0 } };
+   const std::vector<TestSample> train = { TestSample({ 0 }, 0.0), TestSample({ 1 }, 1.0), TestSample({ 2 }, 1.0) };
+   const std::vector<TestSample> validation = { TestSample({ 0 }, 1.0), TestSample({ 2 }, 0.0) };
+
+   TestBoost testPlain = TestBoost(OutputType_BinaryClassification, features, terms, train, validation);
+   TestBoost testBrier = TestBoost(OutputType_BinaryClassification, features, terms, train, validation,
+      k_countInnerBagsDefault, k_testCreateBoosterFlags_Default, k_testComputeFlags_Default, "log_loss,brier,log_loss");
+
+   const BoostRet retPlain = testPlain.Boost(0);
+   const BoostRet retBrier = testBrier.Boost(0);
+
+   double metricsPlain[1];
+   CHECK(Error_None == GetValidationMetrics(testPlain.GetBoosterHandle(), 1, metricsPlain));
+   CHECK(retPlain.validationMetric == metricsPlain[0]);
+
+   // the objective comes first, so brier is the first metric
+   double metricsBrier[2];
+   CHECK(Error_None == GetValidationMetrics(testBrier.GetBoosterHandle(), 2, metricsBrier));
+   CHECK(retBrier.validationMetric == metricsBrier[0]);
+   CHECK(retPlain.validationMetric == metricsBrier[1]);
+   CHECK(metricsBrier[0] != metricsBrier[1]);
+
+   ErrorEbm error = Error_None;
+   try {
+      TestBoost test = TestBoost(OutputType_Regression, features, terms, train, validation,
+         k_countInnerBagsDefault, k_testCreateBoosterFlags_Default, k_testComputeFlags_Default, "rmse,brier");
+   } catch(const TestException & except) {
+      error = except.GetError();
+   }
+   CHECK(Error_ObjectiveParamMismatchWithConfig == error);
+
+   error = Error_None;
+   try {
+      TestBoost test = TestBoost(OutputType_Regression, features, terms, train, validation,
+         k_countInnerBagsDefault, k_testCreateBoosterFlags_Default, k_testComputeFlags_Default, "rmse,log_loss");
+   } catch(const TestException & except) {
+      error = except.GetError();
+   }
+   CHECK(Error_ObjectiveParamMismatchWithConfig == error);
+
+   error = Error_None;
+   try {
+      TestBoost test = TestBoost(OutputType_BinaryClassification, features, terms, train, validation,
+         k_countInnerBagsDefault, k_testCreateBoosterFlags_Default, k_testComputeFlags_Default, 
+         "log_loss,auc,auc,auc,auc,auc,auc,auc,auc,auc");
+   } catch(const TestException & except) {
+      error = except.GetError();
+   }
+   CHECK(Error_IllegalParamVal == error);
+}
+
+TEST_CASE("best model, only terms boosted since the last improvement are copied") {
+   const std::vector<FeatureTest> features = { FeatureTest(5), FeatureTest(4), FeatureTest(4, false, false) };
+   const std::vector<std::vector<IntEbm>> terms = { { 0 }, { 1 }, { 0, 1 }, { 2 } };
+   const size_t aTermPattern[] = { 0, 1, 1, 2, 0, 0, 1, 2, 2 };
+
+   std::vector<TestSample> train;
+   std::vector<TestSample> validation;
+   for(IntEbm i = 0; i < 200; ++i) {
+      const IntEbm bin0 = i % 5;
+      const IntEbm bin1 = (i * 3) % 4;
+      const IntEbm bin2 = 1 + (i * 7) % 2; // feature 2 has no missing or unseen bins
+      train.push_back(TestSample({ bin0, bin1, bin2 }, static_cast<double>(bin0 + bin1 + (i * i) % 3)));
+      // the validation set disagrees with the training set about feature 1, so boosting on it often worsens the metric
+      validation.push_back(TestSample({ bin0, bin1, bin2 }, static_cast<double>(bin0 - bin1)));
+   }
+
+   TestBoost test = TestBoost(OutputType_Regression, features, terms, train, validation);
+
+   std::vector<std::vector<double>> bestExpected;
+   for(size_t iTerm = 0; iTerm < terms.size(); ++iTerm) {
+      size_t cCells = 1;
+      for(const IntEbm iFeature : terms[iTerm]) {
+         cCells *= static_cast<size_t>(features[static_cast<size_t>(iFeature)].m_countBins);
+      }
+      bestExpected.push_back(std::vector<double>(cCells, 0.0));
+
+      // nothing has been boosted, so the best tensor must match the current tensor of zeros
+      std::vector<double> best(cCells, 1.0);
+      std::vector<double> current(cCells, 1.0);
+      test.GetBestTermScoresRaw(iTerm, &best[0]);
+      test.GetCurrentTermScoresRaw(iTerm, &current[0]);
+      CHECK(best == current);
+      CHECK(best == bestExpected[iTerm]);
+   }
+
+   double bestMetric = std::numeric_limits<double>::infinity();
+   size_t cImproved = 0;
+   size_t cWorsened = 0;
+   for(size_t iStep = 0; iStep < 90; ++iStep) {
+      const BoostRet ret = test.Boost(aTermPattern[iStep % (sizeof(aTermPattern) / sizeof(aTermPattern[0]))]);
+      if(ret.validationMetric < bestMetric) {
+         bestMetric = ret.validationMetric;
+         ++cImproved;
+         for(size_t iTerm = 0; iTerm < terms.size(); ++iTerm) {
+            test.GetCurrentTermScoresRaw(iTerm, &bestExpected[iTerm][0]);
+         }
+      } else {
+         ++cWorsened;
+      }
+
+      for(size_t iTerm = 0; iTerm < terms.size(); ++iTerm) {
+         std::vector<double> best(bestExpected[iTerm].size(), 1.0);
+         test.GetBestTermScoresRaw(iTerm, &best[0]);
+         CHECK(best == bestExpected[iTerm]);
+      }
+   }
+   CHECK(0 != cImproved);
+   CHECK(0 != cWorsened);
+}
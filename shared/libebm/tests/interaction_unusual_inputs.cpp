@@ -529,3 +529,115 @@ TEST_CASE("tweedie, interaction") {
    CHECK_APPROX(metricReturn, 1.25);
 }
 
+
+TEST_CASE("CalcInteractionStrengths, matches individual calls") {
+   static constexpr size_t cFeatures = 12;
+   static constexpr size_t cSamples = 150;
+
+   std::vector<FeatureTest> features;
+   for(size_t iFeature = 0; iFeature < cFeatures; ++iFeature) {
+      features.push_back(FeatureTest(static_cast<IntEbm>(2 + iFeature % 5)));
+   }
+   std::vector<TestSample> samples;
+   for(size_t iSample = 0; iSample < cSamples; ++iSample) {
+      std::vector<IntEbm> binIndexes;
+      for(size_t iFeature = 0; iFeature < cFeatures; ++iFeature) {
+         binIndexes.push_back(static_cast<IntEbm>((iSample * (iFeature + 3) + iSample / 7) % (2 + iFeature % 5)));
+      }
+      samples.push_back(TestSample(binIndexes, static_cast<double>((iSample * 5 + iSample / 3) % 3)));
+   }
+
+   // the thread pool is only created when there is more than one core
+   TestInteraction test = TestInteraction(
+      3,
+      features,
+      samples,
+      static_cast<CreateInteractionFlags>(k_testCreateInteractionFlags_Default | CreateInteractionFlags_Multithreaded)
+   );
+
+   // use more terms than fit into a single task, including some that are not pairs
+   std::vector<IntEbm> dimensionCounts;
+   std::vector<IntEbm> featureIndexes;
+   for(IntEbm iFeature1 = 0; iFeature1 < IntEbm { cFeatures }; ++iFeature1) {
+      for(IntEbm iFeature2 = iFeature1 + 1; iFeature2 < IntEbm { cFeatures }; ++iFeature2) {
+         dimensionCounts.push_back(2);
+         featureIndexes.push_back(iFeature1);
+         featureIndexes.push_back(iFeature2);
+      }
+   }
+   dimensionCounts.push_back(0);
+   dimensionCounts.push_back(1);
+   featureIndexes.push_back(3);
+   dimensionCounts.push_back(2);
+   featureIndexes.push_back(5);
+   featureIndexes.push_back(5);
+
+   const size_t cTerms = dimensionCounts.size();
+   static constexpr IntEbm k_countTopTerms = 10;
+   std::vector<double> strengths(cTerms);
+   std::vector<IntEbm> topTermIndexes(k_countTopTerms);
+   const ErrorEbm error = CalcInteractionStrengths(
+      test.GetInteractionHandle(),
+      static_cast<IntEbm>(cTerms),
+      &dimensionCounts[0],
+      &featureIndexes[0],
+      CalcInteractionFlags_Default,
+      0,
+      k_minSamplesLeafDefault,
+      &strengths[0],
+      k_countTopTerms,
+      &topTermIndexes[0]
+   );
+   CHECK(Error_None == error);
+
+   size_t iFeatureIndex = 0;
+   for(size_t iTerm = 0; iTerm < cTerms; ++iTerm) {
+      const size_t cDimensions = static_cast<size_t>(dimensionCounts[iTerm]);
+      std::vector<IntEbm> term;
+      for(size_t iDimension = 0; iDimension < cDimensions; ++iDimension) {
+         term.push_back(featureIndexes[iFeatureIndex]);
+         ++iFeatureIndex;
+      }
+      const double strength = test.TestCalcInteractionStrength(term);
+      CHECK(strength == strengths[iTerm]);
+   }
+
+   for(IntEbm iTop = 0; iTop < k_countTopTerms; ++iTop) {
+      const size_t iTerm = static_cast<size_t>(topTermIndexes[static_cast<size_t>(iTop)]);
+      CHECK(iTerm < cTerms);
+      if(IntEbm { 0 } < iTop) {
+         const size_t iTermPrev = static_cast<size_t>(topTermIndexes[static_cast<size_t>(iTop - 1)]);
+         CHECK(strengths[iTerm] < strengths[iTermPrev] || (strengths[iTerm] == strengths[iTermPrev] && iTerm < iTermPrev));
+      }
+   }
+   size_t cStronger = 0;
+   const size_t iTermLast = static_cast<size_t>(topTermIndexes[k_countTopTerms - 1]);
+   for(size_t iTerm = 0; iTerm < cTerms; ++iTerm) {
+      if(strengths[iTermLast] < strengths[iTerm] || (strengths[iTermLast] == strengths[iTerm] && iTermLast < iTerm)) {
+         ++cStronger;
+      }
+   }
+   CHECK(size_t { k_countTopTerms - 1 } == cStronger);
+}
+
+TEST_CASE("multiclass interaction, uniform weights do not change the strength") {
+   // the interaction detector keeps no hessians, so this covers binning and partitioning multiclass gradients alone
+   std::vector<TestSample> samples;
+   std::vector<TestSample> samplesWeighted;
+   for(IntEbm i = 0; i < 200; ++i) {
+      const IntEbm bin0 = i % 5;
+      const IntEbm bin1 = (i / 5) % 4;
+      const double target = static_cast<double>((bin0 * bin1 + i % 2) % 3);
+      samples.push_back(TestSample({ bin0, bin1 }, target));
+      samplesWeighted.push_back(TestSample({ bin0, bin1 }, target, 2.5));
+   }
+
+   TestInteraction test = TestInteraction(OutputType { 3 }, { FeatureTest(5), FeatureTest(4) }, samples);
+   TestInteraction testWeighted = TestInteraction(OutputType { 3 }, { FeatureTest(5), FeatureTest(4) }, samplesWeighted);
+
+   for(const CalcInteractionFlags flags : { CalcInteractionFlags_Default, CalcInteractionFlags_Pure, CalcInteractionFlags_EnableNewton }) {
+      const double strength = test.TestCalcInteractionStrength({ 0, 1 }, flags);
+      CHECK(0.0 < strength);
+      CHECK_APPROX(strength, testWeighted.TestCalcInteractionStrength({ 0, 1 }, flags));
+   }
+}
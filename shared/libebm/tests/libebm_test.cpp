@@ -56,9 +56,14 @@ extern void FAILED(const double val, TestCaseHidden * const pTestCaseHidden, con
 #pragma optimize("", on)
 #endif // _MSC_VER
 
+void (* g_pLogMessageHook)(const TraceEbm traceLevel, const char * const message) = nullptr;
+
 void EBM_CALLING_CONVENTION LogCallback(const TraceEbm traceLevel, const char * const message) {
    const size_t cChars = strlen(message); // test that the string memory is accessible
    UNUSED(cChars);
+   if(nullptr != g_pLogMessageHook) {
+      (*g_pLogMessageHook)(traceLevel, message);
+   }
    if(traceLevel <= Trace_Off) {
       // don't display log messages during tests, but having this code here makes it easy to turn on when needed
       printf("\n%s: %s\n", GetTraceLevelString(traceLevel), message);
@@ -230,7 +235,8 @@ TestBoost::TestBoost(
    const CreateBoosterFlags flags,
    const ComputeFlags disableCompute,
    const char * const sObjective,
-   const ptrdiff_t iZeroClassificationLogit
+   const ptrdiff_t iZeroClassificationLogit,
+   const std::vector<double> experimentalParams
 ) :
    m_cClasses(cClasses),
    m_features(features),
@@ -546,7 +552,7 @@ TestBoost::TestBoost(
       flags,
       disableCompute,
       nullptr == sObjective ? (IsClassification(cClasses) ? "log_loss" : "rmse") : sObjective,
-      nullptr,
+      0 == experimentalParams.size() ? nullptr : &experimentalParams[0],
       &m_boosterHandle
    );
    if(Error_None != error) {
@@ -942,6 +948,33 @@ double TestInteraction::TestCalcInteractionStrength(
    return avgInteractionStrength;
 }
 
+extern void MakeStridedSamples(
+   const IntEbm cSamples,
+   const std::vector<FeatureTest> & features,
+   const std::vector<IntEbm> & strides,
+   const IntEbm cTargets,
+   std::vector<TestSample> & train,
+   std::vector<TestSample> & validation
+) {
+   if(features.size() != strides.size()) {
+      throw TestException("strides must have one entry per feature");
+   }
+   for(IntEbm i = 0; i < cSamples; ++i) {
+      std::vector<IntEbm> bins;
+      IntEbm sum = i % 3;
+      for(size_t iFeature = 0; iFeature < features.size(); ++iFeature) {
+         const IntEbm bin = (i * strides[iFeature]) % features[iFeature].m_countBins;
+         bins.push_back(bin);
+         sum += bin;
+      }
+      const double target = static_cast<double>(sum % cTargets);
+      const double weight = 0.5 + static_cast<double>(i % 5) * 0.25;
+      train.push_back(TestSample(bins, target, weight));
+      if(0 == i % 4) {
+         validation.push_back(TestSample(bins, target, weight));
+      }
+   }
+}
 
 extern void DisplayCuts(
    IntEbm countSamples,
@@ -175,6 +175,9 @@ inline constexpr static size_t GetCountScores(const OutputType cClasses) {
 
 static constexpr SeedEbm k_seed = SeedEbm { -42 };
 
+// tests can set this to see the log messages from libebm, which LogCallback does not display
+extern void (* g_pLogMessageHook)(const TraceEbm traceLevel, const char * const message);
+
 class FeatureTest final {
 public:
 
@@ -342,6 +345,12 @@ static constexpr CreateBoosterFlags k_testCreateBoosterFlags_Default = CreateBoo
 static constexpr CreateInteractionFlags k_testCreateInteractionFlags_Default = CreateInteractionFlags_Default;
 #endif // EXPAND_BINARY_LOGITS
 
+// the tests that compare the SIMD zones against the CPU zone need to opt into the SIMD objectives
+static constexpr CreateBoosterFlags k_testCreateBoosterFlags_SIMD = 
+   k_testCreateBoosterFlags_Default | CreateBoosterFlags_EnableSIMD;
+static constexpr CreateInteractionFlags k_testCreateInteractionFlags_SIMD = 
+   k_testCreateInteractionFlags_Default | CreateInteractionFlags_EnableSIMD;
+
 static constexpr ComputeFlags k_testComputeFlags_Default = ComputeFlags_Default;
 
 static constexpr IntEbm k_leavesMaxFillDefault = 5;
@@ -452,7 +461,8 @@ public:
       const CreateBoosterFlags flags = k_testCreateBoosterFlags_Default,
       const ComputeFlags disableCompute = k_testComputeFlags_Default,
       const char * const sObjective = nullptr,
-      const ptrdiff_t iZeroClassificationLogit = k_iZeroClassificationLogitDefault
+      const ptrdiff_t iZeroClassificationLogit = k_iZeroClassificationLogitDefault,
+      const std::vector<double> experimentalParams = {}
    );
    ~TestBoost();
 
@@ -517,6 +527,18 @@ public:
    ) const;
 };
 
+// fills train with weighted samples whose bin in each feature advances by that feature's stride and wraps at its 
+// bin count.  A stride of 0 keeps every sample in bin 0.  The target is the sum of the bins plus i % 3, modulo cTargets,
+// and every 4th sample is also added to validation
+void MakeStridedSamples(
+   const IntEbm cSamples,
+   const std::vector<FeatureTest> & features,
+   const std::vector<IntEbm> & strides,
+   const IntEbm cTargets,
+   std::vector<TestSample> & train,
+   std::vector<TestSample> & validation
+);
+
 void DisplayCuts(
    IntEbm countSamples,
    double * featureVals,
@@ -11,3 +11,4 @@
 #include <cstddef>
 #include <assert.h>
 #include <string.h>
+#include <stdlib.h>